@@ -0,0 +1,282 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Takes the reports of every plant monitor on the network, through its SMTP relay (point the nodes' SMTP class at
+// it with updateServer() and no credentials) or as UDP datagrams, and sends one digest of all of them upstream
+// every period in place of hundreds of separate emails:
+//   plant_collector --upstream mail.example.com:25 --from collector@example.com --to owner@example.com
+// Without --upstream the digest is written to standard output. With --history every reading is also kept for
+// plant_history to query. SIGINT or SIGTERM sends a last digest and exits.
+
+// Include necessary header files
+#include "Digest.h"
+#include "HistoryStore.h"
+#include "NodeTable.h"
+#include "Server.h"
+#include "SmtpClient.h"
+#include <condition_variable>
+#include <getopt.h>
+#include <memory>
+#include <mutex>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <thread>
+#include <time.h>
+
+/* Definitions */
+#define DEFAULT_DIGEST_INTERVAL_S 3600
+#define DEFAULT_UPSTREAM_PORT 25
+#define EXIT_BAD_ARGUMENTS 2
+
+/* Command line settings */
+struct Options {
+  ServerConfig server;
+  std::string upstreamHost; // empty = digest to standard output
+  uint16_t upstreamPort;
+  std::string from;
+  std::vector<std::string> to;
+  unsigned digestIntervalS;
+  std::string history; // store directory, empty = readings not kept
+};
+
+/* Reports into the digest's totals, and the history if one is kept */
+class CollectorHandler : public ReportHandler {
+  public:
+    CollectorHandler(NodeTable& table, HistoryStore* history)
+      : _table(table),
+        _history(history)
+    {
+    }
+
+    // Function to take a report, counted only once it is in the history so a resend isn't counted twice
+    bool handleReport(const NodeReport& report, ReportVia via, bool alert) override {
+      if (_history != NULL && !_history->handleReport(report, via, alert)) {
+        return false;
+      }
+      return _table.handleReport(report, via, alert);
+    }
+  private:
+    NodeTable& _table;
+    HistoryStore* _history;
+};
+
+/* Variables */
+static std::mutex stopLock;
+static std::condition_variable stopSignal;
+static bool f_Stopping = false;
+
+/* Functions */
+
+// Function to print how the collector is run, returns the exit status for bad arguments
+static int usage(const char* name) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  --bind ADDRESS          IPv4 address to listen on (0.0.0.0)\n"
+          "  --smtp-port PORT        relay port the nodes send email to (%d)\n"
+          "  --udp-port PORT         port the nodes send datagrams to (%d)\n"
+          "  --threads N             worker threads (one per CPU)\n"
+          "  --hostname NAME         name the relay gives in its replies (collector)\n"
+          "  --upstream HOST[:PORT]  relay the digest is sent through (port %d), standard output if not given\n"
+          "  --from ADDRESS          sender of the digest\n"
+          "  --to ADDRESS            recipient of the digest, may be repeated\n"
+          "  --interval SECONDS      time between digests (%d)\n"
+          "  --history DIRECTORY     store every reading there, for plant_history\n",
+          name, SERVER_SMTP_PORT, SERVER_UDP_PORT, DEFAULT_UPSTREAM_PORT, DEFAULT_DIGEST_INTERVAL_S);
+  return EXIT_BAD_ARGUMENTS;
+}
+
+// Function to read a port number, false if it isn't one
+static bool parsePort(const char* text, uint16_t& port) {
+  char* end;
+  long value = strtol(text, &end, 10);
+
+  if (*text == '\0' || *end != '\0' || value < 0 || value > UINT16_MAX) {
+    return false;
+  }
+  port = value;
+  return true;
+}
+
+// Function to read the command line, false if it makes no sense
+static bool parseOptions(int argc, char** argv, Options& options) {
+  static const struct option LONG_OPTIONS[] = {
+    { "bind", required_argument, NULL, 'b' },
+    { "smtp-port", required_argument, NULL, 's' },
+    { "udp-port", required_argument, NULL, 'u' },
+    { "threads", required_argument, NULL, 'j' },
+    { "hostname", required_argument, NULL, 'n' },
+    { "upstream", required_argument, NULL, 'U' },
+    { "from", required_argument, NULL, 'f' },
+    { "to", required_argument, NULL, 't' },
+    { "interval", required_argument, NULL, 'i' },
+    { "history", required_argument, NULL, 'H' },
+    { NULL, 0, NULL, 0 }
+  };
+  int option;
+
+  options.server = Server::defaults();
+  options.upstreamPort = DEFAULT_UPSTREAM_PORT;
+  options.from = "collector@localhost";
+  options.digestIntervalS = DEFAULT_DIGEST_INTERVAL_S;
+
+  while ((option = getopt_long(argc, argv, "", LONG_OPTIONS, NULL)) != -1) {
+    switch (option) {
+      case 'b':
+        options.server.bindAddress = optarg;
+        break;
+      case 's':
+        if (!parsePort(optarg, options.server.smtpPort)) {
+          return false;
+        }
+        break;
+      case 'u':
+        if (!parsePort(optarg, options.server.udpPort)) {
+          return false;
+        }
+        break;
+      case 'j':
+        options.server.threads = atoi(optarg);
+        break;
+      case 'n':
+        options.server.hostname = optarg;
+        break;
+      case 'U': {
+        const char* colon = strrchr(optarg, ':');
+        options.upstreamHost = (colon == NULL) ? optarg : std::string(optarg, colon - optarg);
+        if (colon != NULL && !parsePort(colon + 1, options.upstreamPort)) {
+          return false;
+        }
+        break;
+      }
+      case 'f':
+        options.from = optarg;
+        break;
+      case 't':
+        options.to.push_back(optarg);
+        break;
+      case 'i':
+        options.digestIntervalS = atoi(optarg);
+        if (options.digestIntervalS == 0) {
+          return false;
+        }
+        break;
+      case 'H':
+        options.history = optarg;
+        break;
+      default:
+        return false;
+    }
+  }
+  return optind == argc && (options.upstreamHost.empty() || !options.to.empty());
+}
+
+// Function to send a digest of everything since periodStart, false if it has to wait for the next one
+// Totals that couldn't be sent go back into the table, so the next digest covers both periods
+static bool sendDigest(NodeTable& table, Server& server, const Options& options, int64_t& periodStart) {
+  std::vector<NodeTotals> nodes = table.take();
+  int64_t now = time(NULL);
+  std::string message, error;
+  ServerStats stats = server.getStats();
+
+  fprintf(stderr, "%zu nodes, %llu emailed and %llu UDP reports (%llu acked of %llu datagrams), %llu malformed, %llu other mail\n",
+          nodes.size(), (unsigned long long)stats.reports[VIA_SMTP], (unsigned long long)stats.reports[VIA_UDP],
+          (unsigned long long)stats.acks, (unsigned long long)stats.datagrams, (unsigned long long)stats.malformed,
+          (unsigned long long)stats.otherMail);
+
+  Digest::writeMessage(nodes, periodStart, now, options.from, options.to, message);
+  if (options.upstreamHost.empty()) {
+    fwrite(message.data(), 1, message.size(), stdout);
+    fflush(stdout);
+    periodStart = now;
+    return true;
+  }
+
+  SmtpClient upstream(options.upstreamHost, options.upstreamPort);
+  if (!upstream.send(options.from, options.to, message, error)) {
+    fprintf(stderr, "digest not sent, kept for the next one: %s\n", error.c_str());
+    table.merge(nodes);
+    return false;
+  }
+  if (!error.empty()) {
+    fprintf(stderr, "digest sent, but %s\n", error.c_str());
+  }
+  periodStart = now;
+  return true;
+}
+
+// Method to send a digest every interval, and a last one once the collector is stopping
+static void runDigests(NodeTable& table, Server& server, const Options& options) {
+  int64_t periodStart = time(NULL);
+  std::unique_lock<std::mutex> guard(stopLock);
+
+  while (!f_Stopping) {
+    stopSignal.wait_for(guard, std::chrono::seconds(options.digestIntervalS), [] { return f_Stopping; });
+    guard.unlock();
+    sendDigest(table, server, options, periodStart);
+    guard.lock();
+  }
+}
+
+// Method to let the process have as many sockets as it is allowed, each node holds one while it reports
+static void raiseFileLimit() {
+  struct rlimit limit;
+
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  NodeTable table;
+  std::unique_ptr<HistoryStore> history;
+  std::string error;
+  sigset_t signals;
+  int received;
+
+  if (!parseOptions(argc, argv, options)) {
+    return usage(argv[0]);
+  }
+  raiseFileLimit(); // before the history sizes what it keeps open by it
+  if (!options.history.empty()) {
+    history.reset(new HistoryStore(options.history));
+    if (!history->open(error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+  CollectorHandler handler(table, history.get());
+  Server server(handler);
+
+  // Signals are taken by sigwait() below, not by whichever thread they happen to land on
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+  if (!server.start(options.server, error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return EXIT_FAILURE;
+  }
+  fprintf(stderr, "relay on port %u, telemetry on port %u\n", server.getSmtpPort(), server.getUdpPort());
+
+  std::thread digests(runDigests, std::ref(table), std::ref(server), std::cref(options));
+  sigwait(&signals, &received);
+
+  server.stop(); // nothing more comes in, so the last digest has everything
+  {
+    std::lock_guard<std::mutex> guard(stopLock);
+    f_Stopping = true;
+  }
+  stopSignal.notify_all();
+  digests.join();
+  return EXIT_SUCCESS;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,369 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Keeps every reading the plant monitors send in a columnar store (what plant_collector --history writes) and
+// answers questions over it:
+//   plant_history ingest STORE report.eml record.cbor ...      emailed reports or bare CBOR records
+//   plant_history summary STORE --sensor moisture --from 2017-01-01 --percentiles 5,50,95
+//   plant_history downsample STORE --node Seedling --width 86400
+//   plant_history dryout STORE --threshold 20
+// Times are Unix seconds or YYYY-MM-DD[THH:MM:SS] in UTC. Results are CSV on standard output.
+
+// Include necessary header files
+#include "HistoryQuery.h"
+#include "HistoryStore.h"
+#include "MailMessage.h"
+#include <errno.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+/* Definitions */
+#define EXIT_NOT_INGESTED 1
+#define EXIT_BAD_ARGUMENTS 2
+#define DEFAULT_WIDTH_S 3600
+#define DEFAULT_LOOKBACK_H 72
+#define DEFAULT_THRESHOLD 20.0f // %, the sketch's moisture alert
+#define SECONDS_PER_HOUR 3600
+
+/* Constants */
+// Sensor names, in the nodes' order
+static const char* const SENSOR_NAMES[SENSOR_KNOWN_COUNT] = { "light", "temperature", "moisture", "battery" };
+
+/* Command line settings */
+struct Options {
+  std::string command;
+  std::string store;
+  std::vector<std::string> files; // to ingest
+  HistoryRange range;
+  bool f_At; // --at given (dryout)
+  int64_t received; // arrival time of ingested reports, 0 = the file's modification time
+  int sensor;
+  std::vector<double> percentiles;
+  int64_t widthS;
+  int64_t lookbackS;
+  float threshold;
+  int threads;
+};
+
+/* Functions */
+
+// Function to print how the tool is run, returns the exit status for bad arguments
+static int usage(const char* name) {
+  fprintf(stderr,
+          "usage: %s ingest STORE [--received TIME] FILE...\n"
+          "       %s summary STORE [--sensor NAME] [--percentiles P,P,...] [range]\n"
+          "       %s downsample STORE [--sensor NAME] [--width SECONDS] [range]\n"
+          "       %s dryout STORE [--at TIME] [--lookback HOURS] [--threshold PERCENT] [--node ID]...\n"
+          "  range: [--from TIME] [--to TIME] [--node ID]...\n"
+          "  --sensor NAME         light, temperature, moisture, battery or a sensor's index (moisture)\n"
+          "  --width SECONDS       bucket width (%d)\n"
+          "  --at TIME             predict as of (now)\n"
+          "  --lookback HOURS      readings the prediction looks at (%d)\n"
+          "  --threshold PERCENT   moisture the pot is dry at (%g)\n"
+          "  --received TIME       when the reports arrived (each file's modification time)\n"
+          "  --threads N           threads a query runs on (one per CPU)\n",
+          name, name, name, name, DEFAULT_WIDTH_S, DEFAULT_LOOKBACK_H, DEFAULT_THRESHOLD);
+  return EXIT_BAD_ARGUMENTS;
+}
+
+// Function to read a time as Unix seconds or a UTC date, false if it is neither
+static bool parseTime(const char* text, int64_t& time) {
+  struct tm utc = {};
+  char* end;
+  long long seconds = strtoll(text, &end, 10);
+
+  if (*text != '\0' && *end == '\0') {
+    time = seconds;
+    return true;
+  }
+  end = strptime(text, "%Y-%m-%d", &utc);
+  if (end != NULL && *end == 'T') {
+    end = strptime(end + 1, "%H:%M:%S", &utc);
+  }
+  if (end == NULL || *end != '\0') {
+    return false;
+  }
+  time = timegm(&utc);
+  return true;
+}
+
+// Function to read a list of percentiles, false if one isn't a number from 0 to 100
+static bool parsePercentiles(const char* text, std::vector<double>& percentiles) {
+  char* end;
+
+  percentiles.clear();
+  while (*text != '\0') {
+    double percentile = strtod(text, &end);
+    if (end == text || percentile < 0 || percentile > 100 || (*end != ',' && *end != '\0')) {
+      return false;
+    }
+    percentiles.push_back(percentile);
+    text = (*end == ',') ? end + 1 : end;
+  }
+  return true;
+}
+
+// Function to read the command line, false if it makes no sense
+static bool parseOptions(int argc, char** argv, Options& options) {
+  static const struct option LONG_OPTIONS[] = {
+    { "from", required_argument, NULL, 'f' },
+    { "to", required_argument, NULL, 't' },
+    { "node", required_argument, NULL, 'n' },
+    { "sensor", required_argument, NULL, 's' },
+    { "percentiles", required_argument, NULL, 'p' },
+    { "width", required_argument, NULL, 'w' },
+    { "at", required_argument, NULL, 'a' },
+    { "lookback", required_argument, NULL, 'l' },
+    { "threshold", required_argument, NULL, 'T' },
+    { "received", required_argument, NULL, 'r' },
+    { "threads", required_argument, NULL, 'j' },
+    { NULL, 0, NULL, 0 }
+  };
+  int option;
+
+  if (argc < 3) {
+    return false;
+  }
+  options.command = argv[1];
+  options.range.from = INT64_MIN;
+  options.range.to = INT64_MAX;
+  options.f_At = false;
+  options.received = 0;
+  options.sensor = SENSOR_MOISTURE;
+  options.percentiles = { 5, 50, 95 };
+  options.widthS = DEFAULT_WIDTH_S;
+  options.lookbackS = DEFAULT_LOOKBACK_H * SECONDS_PER_HOUR;
+  options.threshold = DEFAULT_THRESHOLD;
+  options.threads = 0;
+
+  optind = 2;
+  while ((option = getopt_long(argc, argv, "", LONG_OPTIONS, NULL)) != -1) {
+    switch (option) {
+      case 'f':
+        if (!parseTime(optarg, options.range.from)) {
+          return false;
+        }
+        break;
+      case 't':
+        if (!parseTime(optarg, options.range.to)) {
+          return false;
+        }
+        break;
+      case 'a':
+        if (!parseTime(optarg, options.range.to)) {
+          return false;
+        }
+        options.f_At = true;
+        break;
+      case 'r':
+        if (!parseTime(optarg, options.received)) {
+          return false;
+        }
+        break;
+      case 'n':
+        options.range.nodes.push_back(HistoryStore::nodeDirectory(optarg));
+        break;
+      case 's': // a stock sensor's name, or the index of any sensor a node reports
+        options.sensor = (optarg[0] >= '0' && optarg[0] <= '9' && optarg[1] == '\0') ? optarg[0] - '0' : -1;
+        for (int v = 0; v < SENSOR_KNOWN_COUNT; v++) {
+          options.sensor = (strcmp(optarg, SENSOR_NAMES[v]) == 0) ? v : options.sensor;
+        }
+        if (options.sensor < 0 || options.sensor >= REPORT_SENSORS_MAX) {
+          return false;
+        }
+        break;
+      case 'p':
+        if (!parsePercentiles(optarg, options.percentiles)) {
+          return false;
+        }
+        break;
+      case 'w':
+        options.widthS = atoll(optarg);
+        if (options.widthS <= 0) {
+          return false;
+        }
+        break;
+      case 'l':
+        options.lookbackS = atof(optarg) * SECONDS_PER_HOUR;
+        if (options.lookbackS <= 0) {
+          return false;
+        }
+        break;
+      case 'T':
+        options.threshold = atof(optarg);
+        break;
+      case 'j':
+        options.threads = atoi(optarg);
+        break;
+      default:
+        return false;
+    }
+  }
+  if (optind >= argc) {
+    return false;
+  }
+  options.store = argv[optind++];
+  options.files.assign(argv + optind, argv + argc);
+  return (options.command == "ingest") ? !options.files.empty() : options.files.empty();
+}
+
+// Function to get a Unix time as ISO 8601 UTC
+static std::string formatTime(int64_t time) {
+  time_t seconds = time;
+  struct tm utc;
+  char text[32];
+
+  gmtime_r(&seconds, &utc);
+  strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+  return text;
+}
+
+// Function to read a whole file, false if it can't be
+static bool readFile(const std::string& path, std::string& contents, int64_t& modified) {
+  FILE* in = fopen(path.c_str(), "rb");
+  struct stat status;
+  char chunk[4096];
+  size_t count;
+
+  if (in == NULL) {
+    return false;
+  }
+  while ((count = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+    contents.append(chunk, count);
+  }
+  modified = (fstat(fileno(in), &status) == 0) ? status.st_mtime : time(NULL);
+  fclose(in);
+  return true;
+}
+
+// Function to add each file's report to the store: the record attached to an email, or a bare record as a
+// node's datagram carries it. Returns the exit status, EXIT_NOT_INGESTED if any file wasn't taken.
+static int ingest(const Options& options) {
+  HistoryStore store(options.store);
+  std::string error;
+  int status = EXIT_SUCCESS;
+
+  if (!store.open(error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return EXIT_FAILURE;
+  }
+
+  for (const std::string& path : options.files) {
+    std::string contents;
+    std::vector<uint8_t> record;
+    NodeReport report;
+    int64_t modified;
+    bool f_Mail;
+
+    if (!readFile(path, contents, modified)) {
+      fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+      status = EXIT_NOT_INGESTED;
+      continue;
+    }
+    f_Mail = MailMessage::findRecord(contents, record);
+    if (!f_Mail) {
+      record.assign(contents.begin(), contents.end());
+    }
+    if (!report.parse(record.data(), record.size(), options.received != 0 ? options.received : modified)) {
+      fprintf(stderr, "%s: no report record\n", path.c_str());
+      status = EXIT_NOT_INGESTED;
+      continue;
+    }
+    if (!store.handleReport(report, f_Mail ? VIA_SMTP : VIA_UDP, f_Mail ? MailMessage::isAlert(contents) : report.alerts != 0)) {
+      status = EXIT_NOT_INGESTED;
+    }
+  }
+
+  HistoryStats stats = store.getStats();
+  fprintf(stderr, "%llu readings stored, %llu from before a power loss left out\n", (unsigned long long)stats.rows,
+          (unsigned long long)stats.untimed);
+  return status;
+}
+
+// Function to print a query's answer as CSV, returns the exit status
+static int query(const Options& options) {
+  HistoryReader reader(options.store);
+  std::string error;
+
+  if (!reader.open(error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return EXIT_FAILURE;
+  }
+  HistoryQuery history(reader, options.threads);
+
+  if (options.command == "summary") {
+    std::vector<NodeSummary> nodes;
+    if (!history.summarize(options.range, options.sensor, options.percentiles, nodes, error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return EXIT_FAILURE;
+    }
+    printf("node,count,min,max,mean");
+    for (double percentile : options.percentiles) {
+      printf(",p%g", percentile);
+    }
+    printf("\n");
+    for (const NodeSummary& node : nodes) {
+      printf("%s,%llu,%g,%g,%g", node.node.c_str(), (unsigned long long)node.stats.count, node.stats.count ? node.stats.min : NAN,
+             node.stats.count ? node.stats.max : NAN, node.stats.count ? node.stats.sum / node.stats.count : NAN);
+      for (float value : node.percentiles) {
+        printf(",%g", value);
+      }
+      printf("\n");
+    }
+  }
+  else if (options.command == "downsample") {
+    std::vector<NodeSeries> nodes;
+    if (!history.downsample(options.range, options.sensor, options.widthS, nodes, error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return EXIT_FAILURE;
+    }
+    printf("node,start,count,min,max,mean\n");
+    for (const NodeSeries& node : nodes) {
+      for (const SeriesBucket& bucket : node.buckets) {
+        printf("%s,%s,%llu,%g,%g,%g\n", node.node.c_str(), formatTime(bucket.start).c_str(), (unsigned long long)bucket.stats.count,
+               bucket.stats.min, bucket.stats.max, bucket.stats.sum / bucket.stats.count);
+      }
+    }
+  }
+  else {
+    std::vector<DryOutPrediction> nodes;
+    HistoryRange range = options.range;
+
+    range.to = options.f_At ? range.to : time(NULL);
+    range.from = range.to - options.lookbackS;
+    if (!history.predictDryOut(range, options.threshold, nodes, error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return EXIT_FAILURE;
+    }
+    printf("node,watered,readings,moisture,rate_per_day,dry_at\n");
+    for (const DryOutPrediction& node : nodes) {
+      printf("%s,%s,%u,%.1f,%.2f,%s\n", node.node.c_str(), node.wateredAt ? formatTime(node.wateredAt).c_str() : "", node.readings,
+             node.moisture, node.ratePerDay, node.f_Predicted ? formatTime(node.dryAt).c_str() : "");
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    return usage(argv[0]);
+  }
+  if (options.command == "ingest") {
+    return ingest(options);
+  }
+  if (options.command == "summary" || options.command == "downsample" || options.command == "dryout") {
+    return query(options);
+  }
+  return usage(argv[0]);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,148 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Plays hundreds of plant monitors against a collector and reports how it kept up: reports delivered per second
+// and the time each took, from the node starting to send to the relay's 250 or the datagram's ack:
+//   plant_loadgen --nodes 500 --mode mixed --interval 1000 --duration 30
+// Exits with 1 if any report failed or went unanswered.
+
+// Include necessary header files
+#include "LoadGenerator.h"
+#include "SyntheticNode.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+/* Definitions */
+#define EXIT_LOST_REPORTS 1
+#define EXIT_BAD_ARGUMENTS 2
+
+/* Functions */
+
+// Function to print how the load generator is run, returns the exit status for bad arguments
+static int usage(const char* name, const LoadConfig& defaults) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  --host ADDRESS      collector's IPv4 address (%s)\n"
+          "  --smtp-port PORT    its relay port (%u)\n"
+          "  --udp-port PORT     its telemetry port (%u)\n"
+          "  --nodes N           simulated nodes (%u)\n"
+          "  --threads N         threads driving them (%d)\n"
+          "  --duration SECONDS  how long reports are started for (%g)\n"
+          "  --mode MODE         smtp, udp or mixed (mixed)\n"
+          "  --interval MS       time between one node's reports, 0 = back to back (%u)\n"
+          "  --timeout MS        wait for a reply, per datagram attempt (%u)\n"
+          "  --samples N         samples per report, past %d go as backlog (%u)\n"
+          "  --seed N            for the nodes' readings (%u)\n",
+          name, defaults.host.c_str(), defaults.smtpPort, defaults.udpPort, defaults.nodes, defaults.threads,
+          defaults.durationS, defaults.intervalMs, defaults.timeoutMs, SYNTHETIC_SAMPLES_PER_REPORT, defaults.samplesPerReport, defaults.seed);
+  return EXIT_BAD_ARGUMENTS;
+}
+
+// Function to read the command line, false if it makes no sense
+static bool parseOptions(int argc, char** argv, LoadConfig& config) {
+  static const struct option LONG_OPTIONS[] = {
+    { "host", required_argument, NULL, 'h' },
+    { "smtp-port", required_argument, NULL, 's' },
+    { "udp-port", required_argument, NULL, 'u' },
+    { "nodes", required_argument, NULL, 'n' },
+    { "threads", required_argument, NULL, 'j' },
+    { "duration", required_argument, NULL, 'd' },
+    { "mode", required_argument, NULL, 'm' },
+    { "interval", required_argument, NULL, 'i' },
+    { "timeout", required_argument, NULL, 't' },
+    { "samples", required_argument, NULL, 'S' },
+    { "seed", required_argument, NULL, 'r' },
+    { NULL, 0, NULL, 0 }
+  };
+  int option;
+
+  while ((option = getopt_long(argc, argv, "", LONG_OPTIONS, NULL)) != -1) {
+    switch (option) {
+      case 'h':
+        config.host = optarg;
+        break;
+      case 's':
+        config.smtpPort = atoi(optarg);
+        break;
+      case 'u':
+        config.udpPort = atoi(optarg);
+        break;
+      case 'n':
+        config.nodes = atoi(optarg);
+        break;
+      case 'j':
+        config.threads = atoi(optarg);
+        break;
+      case 'd':
+        config.durationS = atof(optarg);
+        break;
+      case 'm':
+        if (strcmp(optarg, "smtp") == 0) {
+          config.mode = LOAD_SMTP;
+        }
+        else if (strcmp(optarg, "udp") == 0) {
+          config.mode = LOAD_UDP;
+        }
+        else if (strcmp(optarg, "mixed") == 0) {
+          config.mode = LOAD_MIXED;
+        }
+        else {
+          return false;
+        }
+        break;
+      case 'i':
+        config.intervalMs = atoi(optarg);
+        break;
+      case 't':
+        config.timeoutMs = atoi(optarg);
+        break;
+      case 'S':
+        config.samplesPerReport = atoi(optarg);
+        break;
+      case 'r':
+        config.seed = atoi(optarg);
+        break;
+      default:
+        return false;
+    }
+  }
+  return optind == argc && config.nodes > 0 && config.durationS > 0 && config.timeoutMs > 0;
+}
+
+int main(int argc, char** argv) {
+  LoadConfig config = LoadGenerator::defaults();
+  LoadResult result;
+  std::string error;
+  struct rlimit limit;
+
+  if (!parseOptions(argc, argv, config)) {
+    return usage(argv[0], LoadGenerator::defaults());
+  }
+
+  // Every node holds a socket
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+
+  if (!LoadGenerator::run(config, result, error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return EXIT_FAILURE;
+  }
+
+  printf("%u nodes for %.1f s: %llu reports delivered, %llu failed, %llu timed out, %llu datagrams sent again\n",
+         config.nodes, result.elapsedS, (unsigned long long)result.reports, (unsigned long long)result.failures,
+         (unsigned long long)result.timeouts, (unsigned long long)result.resends);
+  printf("throughput: %.0f reports/s, %.2f MB/s sent\n", result.reports / result.elapsedS, result.bytesSent / result.elapsedS / 1e6);
+  printf("latency (ms): p50 %.2f  p90 %.2f  p99 %.2f  p99.9 %.2f  max %.2f\n", result.percentile(50) / 1000,
+         result.percentile(90) / 1000, result.percentile(99) / 1000, result.percentile(99.9) / 1000, result.percentile(100) / 1000);
+
+  return (result.failures + result.timeouts > 0) ? EXIT_LOST_REPORTS : EXIT_SUCCESS;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
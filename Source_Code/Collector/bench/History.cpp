@@ -0,0 +1,282 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// The history store over synthetic years of hundreds of nodes (SyntheticNode's readings every ten minutes, a
+// day's worth a report, each parsed as the collector would): ingest rate and bytes a reading on disk, then a
+// moisture summary of every node over all of it with the plain loops and with AVX2, on one thread and on all,
+// percentiles, daily downsampling and the dry-out prediction. The prediction is made two weeks before the end
+// and checked against when each node's soil really got that dry. Fails if the AVX2 scans don't give what the
+// plain loops do, or a query doesn't account for every reading; the times are for comparison, not limits.
+//   bench_history [NODES [YEARS [THREADS]]]
+// The ctest run is small; the store goes under TMPDIR and is removed afterwards. Queries run on a warm page
+// cache, all but the first on columns the reader already has mapped.
+
+// Include necessary header files
+#include "HistoryQuery.h"
+#include "HistoryStore.h"
+#include "SyntheticNode.h"
+#include <algorithm>
+#include <atomic>
+#include <ftw.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <thread>
+#include <time.h>
+
+/* Definitions */
+#define DEFAULT_NODES 40
+#define DEFAULT_YEARS 1.0
+#define START_TIME 1483228800 // 2017-01-01T00:00:00Z
+#define INTERVAL_S 600 // between readings
+#define DAY_S 86400
+#define HOUR_S 3600
+#define SEED 2017
+#define DRY_THRESHOLD 30.0f // % every synthetic pot passes before it is watered (they're watered at 15 to 30%)
+#define PREDICT_BEFORE_END_S (14 * DAY_S)
+#define LOOKBACK_S (3 * DAY_S)
+#define NS_PER_S 1e9
+
+/* Functions */
+
+// Function to get the seconds between two clock readings
+static double elapsedS(const timespec& start, const timespec& end) {
+  return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / NS_PER_S;
+}
+
+// Function to remove one entry of a directory tree, for nftw()
+static int removeEntry(const char* path, const struct stat* status, int type, struct FTW* walk) {
+  (void)status; (void)type; (void)walk;
+  return remove(path);
+}
+
+// Function to write every node's readings into the store, threads taking nodes in turn, false if any failed
+// Each node's day goes out as one report, as a node that couldn't send for a day would send its backlog
+static bool ingest(HistoryStore& store, uint32_t nodes, int64_t end, int threads) {
+  std::atomic<uint32_t> next(0);
+  std::atomic<bool> f_Failed(false);
+  std::vector<std::thread> workers;
+
+  auto run = [&]() {
+    std::vector<uint8_t> record;
+    NodeReport report;
+
+    for (uint32_t index = next++; index < nodes; index = next++) {
+      SyntheticNode node(index, SEED, START_TIME);
+
+      for (int64_t day = START_TIME; day < end; day += DAY_S) {
+        for (int64_t time = day; time < day + DAY_S && time < end; time += INTERVAL_S) {
+          node.takeSample(time);
+        }
+        int64_t sentAt = std::min(day + DAY_S, end) - INTERVAL_S;
+        node.writeRecord(sentAt, record);
+        if (!report.parse(record.data(), record.size(), sentAt) || !store.handleReport(report, VIA_UDP, report.alerts != 0)) {
+          f_Failed = true;
+          return;
+        }
+      }
+    }
+  };
+
+  for (int t = 1; t < threads; t++) {
+    workers.emplace_back(run);
+  }
+  run();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  return !f_Failed;
+}
+
+// Function to time a moisture summary of every node over everything, false if it failed
+static bool timeSummary(HistoryQuery& history, const std::vector<double>& percentiles, std::vector<NodeSummary>& out, double& seconds) {
+  HistoryRange all = { INT64_MIN, INT64_MAX, {} };
+  std::string error;
+  timespec start, end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bool f_Done = history.summarize(all, SENSOR_MOISTURE, percentiles, out, error);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  seconds = elapsedS(start, end);
+  if (!f_Done) {
+    printf("summary: %s\n", error.c_str());
+  }
+  return f_Done;
+}
+
+// Function to check two summaries agree: counts, minimums and maximums exactly, sums to rounding
+static bool sameSummaries(const std::vector<NodeSummary>& a, const std::vector<NodeSummary>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t n = 0; n < a.size(); n++) {
+    if (a[n].stats.count != b[n].stats.count || a[n].stats.min != b[n].stats.min || a[n].stats.max != b[n].stats.max ||
+        fabs(a[n].stats.sum - b[n].stats.sum) > 1e-9 * fabs(a[n].stats.sum)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Function to find when a node's moisture first reached the threshold at or after a time, 0 if it didn't
+static int64_t firstDry(HistoryQuery& history, const std::string& node, int64_t from, int64_t to) {
+  HistoryRange range = { from, to, { node } };
+  std::vector<NodeSeries> series;
+  std::string error;
+
+  if (!history.downsample(range, SENSOR_MOISTURE, INTERVAL_S, series, error) || series.size() != 1) {
+    return 0;
+  }
+  for (const SeriesBucket& bucket : series[0].buckets) {
+    if (bucket.stats.min <= DRY_THRESHOLD) {
+      return bucket.start;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  uint32_t nodes = (argc > 1) ? atoi(argv[1]) : DEFAULT_NODES;
+  double years = (argc > 2) ? atof(argv[2]) : DEFAULT_YEARS;
+  int threads = (argc > 3) ? atoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+  int64_t end = START_TIME + (int64_t)(years * 365.25 * DAY_S) / DAY_S * DAY_S;
+  const char* tmp = getenv("TMPDIR");
+  std::string root = std::string(tmp != NULL ? tmp : "/tmp") + "/bench_history_XXXXXX";
+  struct rlimit limit;
+  std::string error;
+  timespec start, stop;
+  char onThreads[32];
+  bool f_Pass = true;
+
+  if (nodes == 0 || years <= 0 || threads <= 0 || mkdtemp(&root[0]) == NULL) {
+    fprintf(stderr, "usage: %s [NODES [YEARS [THREADS]]]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) { // a partition a node held open
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+
+  // Years of readings in
+  HistoryStore store(root + "/store");
+  f_Pass = store.open(error);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  f_Pass = f_Pass && ingest(store, nodes, end, threads);
+  store.close();
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  HistoryStats stats = store.getStats();
+  double ingestS = elapsedS(start, stop);
+
+  HistoryReader reader(root + "/store");
+  f_Pass = reader.open(error) && f_Pass;
+  uint64_t rows = reader.getRows();
+  printf("%u nodes, %.2f years of readings every %d s: %llu readings in %zu partitions, %.1f MB\n", nodes, years, INTERVAL_S,
+         (unsigned long long)rows, reader.getPartitions().size(), rows * (SENSOR_KNOWN_COUNT + 1) * HISTORY_VALUE_SIZE / 1e6);
+  snprintf(onThreads, sizeof(onThreads), "%d thread%s", threads, threads == 1 ? "" : "s");
+  printf("ingest                 %8.2f s  %10.0f readings/s  %s (generating and parsing the reports included)\n",
+         ingestS, stats.rows / ingestS, onThreads);
+  if (stats.rows != rows || stats.failures != 0) {
+    printf("%llu readings written, %llu listed, %llu reports failed\n", (unsigned long long)stats.rows, (unsigned long long)rows,
+           (unsigned long long)stats.failures);
+    f_Pass = false;
+  }
+
+  // Summaries: plain loops against AVX2, one thread against all
+  std::vector<NodeSummary> warm, plain, vectorized, spread, withPercentiles;
+  double firstS = 0, seconds, plainS = 0, vectorizedS = 0, spreadS = 0, percentilesS = 0;
+  bool f_Vectorized = ColumnScan::isVectorized();
+  HistoryQuery oneThread(reader, 1);
+  HistoryQuery allThreads(reader, threads);
+  double scanBytes = rows * 2.0 * HISTORY_VALUE_SIZE; // time and moisture columns
+
+  f_Pass = timeSummary(allThreads, {}, warm, firstS) && f_Pass; // maps the columns, which later queries keep
+  ColumnScan::setVectorized(false);
+  f_Pass = timeSummary(oneThread, {}, plain, plainS) && f_Pass;
+  ColumnScan::setVectorized(true);
+  f_Pass = timeSummary(oneThread, {}, vectorized, vectorizedS) && f_Pass;
+  f_Pass = timeSummary(allThreads, {}, spread, spreadS) && f_Pass;
+  f_Pass = timeSummary(allThreads, { 5, 50, 95 }, withPercentiles, percentilesS) && f_Pass;
+
+  uint64_t counted = 0;
+  for (const NodeSummary& node : plain) {
+    counted += node.stats.count;
+  }
+  printf("summary, first query   %8.3f s  %10.0f readings/s  %6.2f GB/s  %s, mapping the columns\n", firstS, rows / firstS,
+         scanBytes / firstS / 1e9, onThreads);
+  printf("summary, plain loops   %8.3f s  %10.0f readings/s  %6.2f GB/s  1 thread\n", plainS, rows / plainS, scanBytes / plainS / 1e9);
+  printf("summary, %-13s %8.3f s  %10.0f readings/s  %6.2f GB/s  1 thread (%.1fx)\n", f_Vectorized ? "AVX2" : "no AVX2", vectorizedS,
+         rows / vectorizedS, scanBytes / vectorizedS / 1e9, plainS / vectorizedS);
+  printf("summary, %-13s %8.3f s  %10.0f readings/s  %6.2f GB/s  %s (%.1fx)\n", f_Vectorized ? "AVX2" : "no AVX2", spreadS,
+         rows / spreadS, scanBytes / spreadS / 1e9, onThreads, plainS / spreadS);
+  printf("summary, p5/p50/p95    %8.3f s  %10.0f readings/s               %s\n", percentilesS, rows / percentilesS, onThreads);
+  if (!sameSummaries(plain, vectorized) || !sameSummaries(plain, spread) || !sameSummaries(plain, withPercentiles) || counted != rows) {
+    printf("the summaries don't agree, or left readings out (%llu of %llu)\n", (unsigned long long)counted, (unsigned long long)rows);
+    f_Pass = false;
+  }
+  if (!withPercentiles.empty()) {
+    const NodeSummary& first = withPercentiles[0];
+    printf("  %s: moisture %.1f to %.1f%%, mean %.1f%%, p5 %.1f%%, p50 %.1f%%, p95 %.1f%%\n", first.node.c_str(), first.stats.min,
+           first.stats.max, first.stats.sum / first.stats.count, first.percentiles[0], first.percentiles[1], first.percentiles[2]);
+  }
+
+  // Daily downsampling, every node over everything
+  HistoryRange all = { INT64_MIN, INT64_MAX, {} };
+  std::vector<NodeSeries> series;
+  uint64_t buckets = 0, bucketed = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  f_Pass = allThreads.downsample(all, SENSOR_MOISTURE, DAY_S, series, error) && f_Pass;
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  seconds = elapsedS(start, stop);
+  for (const NodeSeries& node : series) {
+    buckets += node.buckets.size();
+    for (const SeriesBucket& bucket : node.buckets) {
+      bucketed += bucket.stats.count;
+    }
+  }
+  printf("daily downsample       %8.3f s  %10.0f readings/s  %llu buckets\n", seconds, rows / seconds, (unsigned long long)buckets);
+  if (bucketed != rows) {
+    printf("%llu of %llu readings in the buckets\n", (unsigned long long)bucketed, (unsigned long long)rows);
+    f_Pass = false;
+  }
+
+  // Dry-out predicted two weeks before the end, against when the soil got there
+  HistoryRange window = { end - PREDICT_BEFORE_END_S - LOOKBACK_S, end - PREDICT_BEFORE_END_S, {} };
+  std::vector<DryOutPrediction> predictions;
+  std::vector<double> errorsH;
+  uint32_t predicted = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  f_Pass = allThreads.predictDryOut(window, DRY_THRESHOLD, predictions, error) && f_Pass;
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  seconds = elapsedS(start, stop);
+  for (const DryOutPrediction& prediction : predictions) {
+    if (!prediction.f_Predicted) {
+      continue;
+    }
+    predicted++;
+    int64_t dried = (prediction.moisture > DRY_THRESHOLD) ? firstDry(allThreads, prediction.node, window.to, end) : 0;
+    if (dried != 0) {
+      errorsH.push_back(fabs((double)(prediction.dryAt - dried)) / HOUR_S);
+    }
+  }
+  std::sort(errorsH.begin(), errorsH.end());
+  printf("dry-out prediction     %8.3f s  %u of %zu nodes drying", seconds, predicted, predictions.size());
+  if (!errorsH.empty()) {
+    printf(", %zu dried within two weeks: error median %.1f h, p90 %.1f h", errorsH.size(), errorsH[errorsH.size() / 2],
+           errorsH[errorsH.size() * 9 / 10]);
+  }
+  printf("\n");
+  if (predictions.size() != reader.getNodes().size()) {
+    f_Pass = false;
+  }
+
+  nftw(root.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+  if (!f_Pass) {
+    printf("FAILED\n");
+  }
+  return f_Pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
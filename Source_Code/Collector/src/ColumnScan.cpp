@@ -0,0 +1,225 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "ColumnScan.h"
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Definitions */
+#define LANES 8 // rows per AVX2 step (8 times, 8 floats)
+
+// Function to check the CPU has AVX2, safe before main() as the libgcc constructor may not have run yet
+static bool hasAvx2() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+/* Variables */
+static std::atomic<bool> f_Vectorized(hasAvx2());
+
+/* Functions */
+
+// Method to take in another part of the same range
+void ColumnStats::add(const ColumnStats& other) {
+  if (other.count == 0) {
+    return;
+  }
+  min = (count == 0) ? other.min : std::min(min, other.min);
+  max = (count == 0) ? other.max : std::max(max, other.max);
+  sum += other.sum;
+  count += other.count;
+}
+
+// Function to get the stats of no readings
+ColumnStats ColumnScan::empty() {
+  ColumnStats stats = {};
+
+  stats.min = INFINITY;
+  stats.max = -INFINITY;
+  return stats;
+}
+
+// Method to add up the readings taken in [from, to), a row at a time
+// A reading the node didn't have (NaN) is left out, as the time it was taken is still known
+void ColumnScan::aggregateScalar(const int32_t* times, const float* values, size_t count, int32_t from, int32_t to, ColumnStats& stats) {
+  ColumnStats part = empty();
+
+  for (size_t i = 0; i < count; i++) {
+    float value = values[i];
+
+    if (times[i] < from || times[i] >= to || isnan(value)) {
+      continue;
+    }
+    part.min = std::min(part.min, value);
+    part.max = std::max(part.max, value);
+    part.sum += value;
+    part.count++;
+  }
+  stats.add(part);
+}
+
+#if defined(__x86_64__)
+
+// Function to get the rows of a step taken in [from, to), all ones in each lane that is
+__attribute__((target("avx2"))) static inline __m256i inRange(const int32_t* times, __m256i before, __m256i to) {
+  __m256i time = _mm256_loadu_si256((const __m256i*)times);
+
+  return _mm256_and_si256(_mm256_cmpgt_epi32(time, before), _mm256_cmpgt_epi32(to, time));
+}
+
+// Method to add up the readings taken in [from, to), eight rows at a time
+// Rows out of range or NaN are blended to +/-infinity for the minimum and maximum and to 0 for the sum, which
+// is kept in doubles (four lanes each) so years of readings don't lose the mean to rounding
+__attribute__((target("avx2"))) static void aggregateAvx2(const int32_t* times, const float* values, size_t count, int32_t from, int32_t to, ColumnStats& stats) {
+  __m256i before = _mm256_set1_epi32(from - 1); // from is a partition offset, never INT32_MIN
+  __m256i end = _mm256_set1_epi32(to);
+  __m256 low = _mm256_set1_ps(INFINITY);
+  __m256 high = _mm256_set1_ps(-INFINITY);
+  __m256d sumLow = _mm256_setzero_pd();
+  __m256d sumHigh = _mm256_setzero_pd();
+  uint64_t taken = 0;
+  size_t i = 0;
+
+  for (; i + LANES <= count; i += LANES) {
+    __m256 value = _mm256_loadu_ps(values + i);
+    __m256 keep = _mm256_and_ps(_mm256_castsi256_ps(inRange(times + i, before, end)), _mm256_cmp_ps(value, value, _CMP_ORD_Q));
+    int mask = _mm256_movemask_ps(keep);
+
+    if (mask == 0) {
+      continue;
+    }
+    low = _mm256_min_ps(low, _mm256_blendv_ps(_mm256_set1_ps(INFINITY), value, keep));
+    high = _mm256_max_ps(high, _mm256_blendv_ps(_mm256_set1_ps(-INFINITY), value, keep));
+    value = _mm256_and_ps(value, keep);
+    sumLow = _mm256_add_pd(sumLow, _mm256_cvtps_pd(_mm256_castps256_ps128(value)));
+    sumHigh = _mm256_add_pd(sumHigh, _mm256_cvtps_pd(_mm256_extractf128_ps(value, 1)));
+    taken += __builtin_popcount(mask);
+  }
+
+  float lows[LANES], highs[LANES];
+  double sums[LANES / 2];
+  ColumnStats part = ColumnScan::empty();
+
+  _mm256_storeu_ps(lows, low);
+  _mm256_storeu_ps(highs, high);
+  _mm256_storeu_pd(sums, _mm256_add_pd(sumLow, sumHigh));
+  for (int lane = 0; lane < LANES; lane++) {
+    part.min = std::min(part.min, lows[lane]);
+    part.max = std::max(part.max, highs[lane]);
+  }
+  part.sum = sums[0] + sums[1] + sums[2] + sums[3];
+  part.count = taken;
+  stats.add(part);
+
+  ColumnScan::aggregateScalar(times + i, values + i, count - i, from, to, stats);
+}
+
+// Function to find the first row from start on taken outside [from, to), eight rows at a time
+__attribute__((target("avx2"))) static size_t runEndAvx2(const int32_t* times, size_t start, size_t count, int32_t from, int32_t to) {
+  __m256i before = _mm256_set1_epi32(from - 1);
+  __m256i end = _mm256_set1_epi32(to);
+  size_t i = start;
+
+  for (; i + LANES <= count; i += LANES) {
+    int inside = _mm256_movemask_ps(_mm256_castsi256_ps(inRange(times + i, before, end)));
+
+    if (inside != 0xff) {
+      return i + __builtin_ctz(~inside);
+    }
+  }
+  for (; i < count && times[i] >= from && times[i] < to; i++) {
+  }
+  return i;
+}
+
+// Method to append the readings taken in [from, to), eight rows at a time
+// Whole steps in range are copied as they are; AVX2 can't compress a vector, so a mixed step goes lane by lane
+__attribute__((target("avx2"))) static void collectAvx2(const int32_t* times, const float* values, size_t count, int32_t from, int32_t to, std::vector<float>& out) {
+  __m256i before = _mm256_set1_epi32(from - 1);
+  __m256i end = _mm256_set1_epi32(to);
+  size_t i = 0;
+
+  for (; i + LANES <= count; i += LANES) {
+    __m256 value = _mm256_loadu_ps(values + i);
+    __m256 keep = _mm256_and_ps(_mm256_castsi256_ps(inRange(times + i, before, end)), _mm256_cmp_ps(value, value, _CMP_ORD_Q));
+    int mask = _mm256_movemask_ps(keep);
+
+    if (mask == 0xff) {
+      out.insert(out.end(), values + i, values + i + LANES);
+      continue;
+    }
+    for (; mask != 0; mask &= mask - 1) {
+      out.push_back(values[i + __builtin_ctz(mask)]);
+    }
+  }
+  for (; i < count; i++) {
+    if (times[i] >= from && times[i] < to && !isnan(values[i])) {
+      out.push_back(values[i]);
+    }
+  }
+}
+
+#endif
+
+// Method to add up the readings taken in [from, to)
+void ColumnScan::aggregate(const int32_t* times, const float* values, size_t count, int32_t from, int32_t to, ColumnStats& stats) {
+#if defined(__x86_64__)
+  if (f_Vectorized.load(std::memory_order_relaxed)) {
+    aggregateAvx2(times, values, count, from, to, stats);
+    return;
+  }
+#endif
+  aggregateScalar(times, values, count, from, to, stats);
+}
+
+// Function to find the first row from start on taken outside [from, to) (count if there is none)
+size_t ColumnScan::runEnd(const int32_t* times, size_t start, size_t count, int32_t from, int32_t to) {
+#if defined(__x86_64__)
+  if (f_Vectorized.load(std::memory_order_relaxed)) {
+    return runEndAvx2(times, start, count, from, to);
+  }
+#endif
+  size_t i = start;
+
+  for (; i < count && times[i] >= from && times[i] < to; i++) {
+  }
+  return i;
+}
+
+// Method to append the readings taken in [from, to), for percentiles
+void ColumnScan::collect(const int32_t* times, const float* values, size_t count, int32_t from, int32_t to, std::vector<float>& out) {
+#if defined(__x86_64__)
+  if (f_Vectorized.load(std::memory_order_relaxed)) {
+    collectAvx2(times, values, count, from, to, out);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < count; i++) {
+    if (times[i] >= from && times[i] < to && !isnan(values[i])) {
+      out.push_back(values[i]);
+    }
+  }
+}
+
+// Function to check whether the AVX2 loops are in use
+bool ColumnScan::isVectorized() {
+  return f_Vectorized.load();
+}
+
+// Method to turn the AVX2 loops off (for comparison), or back on if the CPU has them
+void ColumnScan::setVectorized(bool enabled) {
+  f_Vectorized.store(enabled && hasAvx2());
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,43 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef ColumnScan_h
+#define ColumnScan_h
+
+// Include the necessary libraries
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/* One column's readings over a time range */
+struct ColumnStats {
+	uint64_t count; // readings in the range (NaN left out)
+	float min;
+	float max;
+	double sum; // for the mean
+
+	void add(const ColumnStats& other); // method to take in another part of the same range
+};
+
+/* ColumnScan class definition */
+// The loops every history query comes down to, over one partition's time column (seconds from the partition's
+// start) and one reading column. With AVX2 they take 8 rows at a time, masking rows outside the range with a
+// compare instead of a branch; without it (or on another architecture) they fall back to the plain loops,
+// which give the same counts, minimums and maximums (sums may differ in the last bits).
+class ColumnScan {
+	public:
+		/* Public Functions and Methods */
+		static void aggregate(const int32_t* times, const float* values, size_t count, int32_t from, int32_t to, ColumnStats& stats); // method to add up the readings taken in [from, to)
+		static void aggregateScalar(const int32_t* times, const float* values, size_t count, int32_t from, int32_t to, ColumnStats& stats); // method to do the same a row at a time
+		static size_t runEnd(const int32_t* times, size_t start, size_t count, int32_t from, int32_t to); // function to find the first row from start on taken outside [from, to)
+		static void collect(const int32_t* times, const float* values, size_t count, int32_t from, int32_t to, std::vector<float>& out); // method to append the readings taken in [from, to)
+		static bool isVectorized(); // function to check whether the AVX2 loops are in use
+		static void setVectorized(bool enabled); // method to turn the AVX2 loops off (for comparison), or back on if the CPU has them
+		static ColumnStats empty(); // function to get the stats of no readings
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,43 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Crc32.h"
+#include <array>
+
+/* Definitions */
+#define CRC32_POLYNOMIAL 0xEDB88320 // reflected IEEE 802.3, as RTCStore uses
+
+/* Constants */
+// Remainder of every byte value, built at compile time
+static constexpr std::array<uint32_t, 256> makeTable() {
+  std::array<uint32_t, 256> table = {};
+
+  for (uint32_t b = 0; b < 256; b++) {
+    uint32_t crc = b;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ ((crc & 1) ? CRC32_POLYNOMIAL : 0);
+    }
+    table[b] = crc;
+  }
+  return table;
+}
+
+static constexpr std::array<uint32_t, 256> _TABLE = makeTable();
+
+/* Functions */
+
+// Function to get the CRC-32 of a buffer, chained on from the CRC of what came before it
+uint32_t Crc32::compute(const void* data, size_t size, uint32_t crc) {
+  const uint8_t* bytes = (const uint8_t*)data;
+
+  crc = ~crc;
+  while (size--) {
+    crc = (crc >> 8) ^ _TABLE[(crc ^ *bytes++) & 0xFF];
+  }
+  return ~crc;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
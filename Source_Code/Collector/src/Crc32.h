@@ -0,0 +1,24 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Crc32_h
+#define Crc32_h
+
+// Include the necessary libraries
+#include <stddef.h>
+#include <stdint.h>
+
+/* Crc32 class definition */
+// CRC-32 (reflected IEEE 802.3) as the nodes' RTCStore::crc32() computes it, table driven. A node's UDP report is
+// acknowledged with the CRC of the whole datagram, most significant byte first.
+class Crc32 {
+	public:
+		/* Public Functions and Methods */
+		static uint32_t compute(const void* data, size_t size, uint32_t crc=0); // function to get the CRC, chained on from crc
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,119 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Digest.h"
+#include <stdio.h>
+#include <time.h>
+
+/* Definitions */
+#define CRLF "\r\n"
+#define FIELD_SIZE 256 // longest formatted field, a reading prints at most 47 characters
+
+/* Constants */
+// Sensor columns, in the nodes' order
+static const char* const SENSOR_NAMES[SENSOR_KNOWN_COUNT] = { "Light", "Temperature", "Moisture", "Battery" };
+static const char* const SENSOR_UNITS[SENSOR_KNOWN_COUNT] = { " lux", "&ordm;F", "%", "V" };
+
+/* Functions */
+
+// Method to write the headers and body, lines ending in CRLF
+// The subject gives the node and alert counts so the digest can be sorted without opening it
+void Digest::writeMessage(const std::vector<NodeTotals>& nodes, int64_t periodStart, int64_t periodEnd, const std::string& from, const std::vector<std::string>& to, std::string& out) {
+  char field[FIELD_SIZE];
+  uint32_t alerting = 0;
+
+  for (const NodeTotals& node : nodes) {
+    alerting += (node.alertReports > 0) ? 1 : 0;
+  }
+
+  out += "From: Plant Life Monitor <" + from + ">" CRLF;
+  for (size_t r = 0; r < to.size(); r++) {
+    out += (r == 0 ? "To: " : "," CRLF " ") + to[r]; // folded, so a long list of recipients stays under the line limit
+  }
+  out += to.empty() ? "" : CRLF;
+  snprintf(field, sizeof(field), DIGEST_SUBJECT ": %zu node%s, %u with alerts", nodes.size(), nodes.size() == 1 ? "" : "s", alerting);
+  out += std::string("Subject: ") + field + CRLF;
+  out += "Mime-Version: 1.0" CRLF;
+  out += "Content-Type: text/html; charset=\"UTF-8\"" CRLF;
+  out += "Content-Transfer-Encoding: 8bit" CRLF;
+  out += CRLF;
+  writeBody(nodes, periodStart, periodEnd, out);
+}
+
+// Method to write just the HTML body
+void Digest::writeBody(const std::vector<NodeTotals>& nodes, int64_t periodStart, int64_t periodEnd, std::string& out) {
+  out += "<html>" CRLF "<body>" CRLF;
+  out += "<h2><u>" DIGEST_SUBJECT "</u></h2><br>" CRLF;
+  out += "&emsp;<b>From:</b> ";
+  writeTime(periodStart, out);
+  out += "<br>" CRLF "&emsp;<b>To:</b> ";
+  writeTime(periodEnd, out);
+  out += "<br>" CRLF;
+
+  if (nodes.empty()) {
+    out += "&emsp;No node reported.<br>" CRLF;
+    out += "</body></html>" CRLF;
+    return;
+  }
+
+  out += "<table border=\"1\" cellpadding=\"3\">" CRLF;
+  out += "<tr><th>Node</th><th>Emailed</th><th>UDP</th><th>Alerts</th><th>Readings</th><th>Last Seen</th>";
+  for (int v = 0; v < SENSOR_KNOWN_COUNT; v++) {
+    out += std::string("<th>") + SENSOR_NAMES[v] + "<br>low / mean / high (now)</th>";
+  }
+  out += "</tr>" CRLF;
+
+  for (const NodeTotals& node : nodes) {
+    writeNode(node, out);
+  }
+  out += "</table>" CRLF;
+  out += "</body></html>" CRLF;
+}
+
+// Method to write one node's table row
+// Sensors that alerted in the node's newest report are in red, as in the nodes' own reports
+void Digest::writeNode(const NodeTotals& node, std::string& out) {
+  char field[FIELD_SIZE];
+
+  out += "<tr><td>" + node.id + "</td>";
+  snprintf(field, sizeof(field), "<td>%u</td><td>%u</td><td>%u</td>", node.reports[VIA_SMTP], node.reports[VIA_UDP], node.alertReports);
+  out += field;
+  if (node.untimed > 0) {
+    snprintf(field, sizeof(field), "<td>%u (%u from before a power loss)</td><td>", node.readings, node.untimed);
+  }
+  else {
+    snprintf(field, sizeof(field), "<td>%u</td><td>", node.readings);
+  }
+  out += field;
+  writeTime(node.lastSeen, out);
+  out += "</td>";
+
+  for (int v = 0; v < SENSOR_KNOWN_COUNT; v++) {
+    const SensorTotals& sensor = node.sensors[v];
+
+    if (v >= node.sensorCount || sensor.count == 0) {
+      out += "<td>-</td>";
+      continue;
+    }
+    snprintf(field, sizeof(field), "<td>%.1f / %.1f / %.1f (%s%.1f%s)%s</td>", sensor.min, sensor.sum / sensor.count, sensor.max,
+             (node.alerts & (1 << v)) ? "<font color=\"red\"><b>" : "", sensor.last, (node.alerts & (1 << v)) ? "</b></font>" : "", SENSOR_UNITS[v]);
+    out += field;
+  }
+  out += "</tr>" CRLF;
+}
+
+// Method to write a Unix time as UTC
+void Digest::writeTime(int64_t time, std::string& out) {
+  char field[FIELD_SIZE];
+  time_t seconds = time;
+  struct tm utc;
+
+  gmtime_r(&seconds, &utc);
+  strftime(field, sizeof(field), "%Y-%m-%d %H:%M:%S UTC", &utc);
+  out += field;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
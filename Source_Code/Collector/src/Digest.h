@@ -0,0 +1,33 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Digest_h
+#define Digest_h
+
+// Include the necessary libraries
+#include "NodeTable.h"
+#include <string>
+#include <vector>
+
+/* Definitions */
+#define DIGEST_SUBJECT "Plant Digest"
+
+/* Digest class definition */
+// The one email the collector sends upstream per period in place of every node's own: a line per node with its
+// reports, alerts and each sensor's low, mean, high and newest reading, as HTML like the nodes' reports.
+class Digest {
+	public:
+		/* Public Functions and Methods */
+		static void writeMessage(const std::vector<NodeTotals>& nodes, int64_t periodStart, int64_t periodEnd, const std::string& from, const std::vector<std::string>& to, std::string& out); // method to write the headers and body, lines ending in CRLF
+		static void writeBody(const std::vector<NodeTotals>& nodes, int64_t periodStart, int64_t periodEnd, std::string& out); // method to write just the HTML body
+	private:
+		/* Private Functions and Methods */
+		static void writeNode(const NodeTotals& node, std::string& out); // method to write one node's table row
+		static void writeTime(int64_t time, std::string& out); // method to write a Unix time as UTC
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,337 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "HistoryQuery.h"
+#include "HistoryStore.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <math.h>
+#include <mutex>
+#include <set>
+#include <thread>
+
+/* Definitions */
+#define SECONDS_PER_DAY 86400
+
+/* Constructors */
+// Constructor for queries over a reader's partitions (threads <= 0 = one per CPU)
+HistoryQuery::HistoryQuery(const HistoryReader& reader, int threads)
+  : _reader(reader),
+    _threads(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+    _rowsScanned(0)
+{
+}
+
+/* Functions */
+
+// Function to get a time as seconds into a partition, clamped to the offsets a partition can hold
+static int32_t offsetIn(const HistoryPartition& partition, int64_t time) {
+  int64_t offset = (time < partition.start) ? 0 : time - partition.start; // written this way round so INT64_MIN can't overflow
+
+  return (int32_t)std::min(offset, (int64_t)INT32_MAX);
+}
+
+// Function to get each node's minimum, maximum, mean and percentiles of a sensor over a range
+// Without percentiles each partition is a job of its own; with them a node's readings have to come together,
+// so each node is one, which also keeps only a node per thread in memory at once
+bool HistoryQuery::summarize(const HistoryRange& range, int sensor, const std::vector<double>& percentiles, std::vector<NodeSummary>& out, std::string& error) {
+  std::vector<const HistoryPartition*> partitions;
+  std::vector<std::pair<size_t, size_t>> nodes;
+
+  select(range, partitions, nodes);
+  out.assign(nodes.size(), NodeSummary());
+  for (size_t n = 0; n < nodes.size(); n++) {
+    out[n].node = partitions[nodes[n].first]->node;
+    out[n].stats = ColumnScan::empty();
+  }
+
+  if (percentiles.empty()) {
+    std::vector<ColumnStats> parts(partitions.size(), ColumnScan::empty());
+
+    if (!parallel(partitions.size(), [&](size_t p, std::string& failure) {
+          return scan(*partitions[p], sensor, range.from, range.to, parts[p], NULL, failure);
+        }, error)) {
+      return false;
+    }
+    for (size_t n = 0; n < nodes.size(); n++) {
+      for (size_t p = nodes[n].first; p < nodes[n].second; p++) {
+        out[n].stats.add(parts[p]);
+      }
+    }
+    return true;
+  }
+
+  return parallel(nodes.size(), [&](size_t n, std::string& failure) {
+    std::vector<float> values;
+
+    for (size_t p = nodes[n].first; p < nodes[n].second; p++) {
+      if (!scan(*partitions[p], sensor, range.from, range.to, out[n].stats, &values, failure)) {
+        return false;
+      }
+    }
+    for (double percentile : percentiles) { // nearest rank
+      size_t rank = (size_t)ceil(std::min(100.0, std::max(0.0, percentile)) / 100.0 * values.size());
+      size_t index = (rank > 0) ? rank - 1 : 0;
+
+      if (values.empty()) {
+        out[n].percentiles.push_back(NAN);
+        continue;
+      }
+      std::nth_element(values.begin(), values.begin() + index, values.end());
+      out[n].percentiles.push_back(values[index]);
+    }
+    return true;
+  }, error);
+}
+
+// Function to get each node's readings of a sensor in buckets of widthS seconds, from the start of the range
+// (or of the oldest month held, if the range starts before it). Each partition is a job; as readings needn't
+// be in time order, it goes through runs of rows that fall in one bucket, each run added up in one scan.
+bool HistoryQuery::downsample(const HistoryRange& range, int sensor, int64_t widthS, std::vector<NodeSeries>& out, std::string& error) {
+  std::vector<const HistoryPartition*> partitions;
+  std::vector<std::pair<size_t, size_t>> nodes;
+  int64_t held = INT64_MAX, heldEnd = INT64_MIN;
+
+  if (widthS <= 0) {
+    error = "the bucket width has to be at least a second";
+    return false;
+  }
+  select(range, partitions, nodes);
+  out.assign(nodes.size(), NodeSeries());
+  if (partitions.empty()) {
+    return true;
+  }
+  for (const HistoryPartition* partition : partitions) {
+    held = std::min(held, partition->start);
+    heldEnd = std::max(heldEnd, partition->end);
+  }
+
+  int64_t from = std::max(range.from, held), to = std::min(range.to, heldEnd); // so years of empty buckets aren't made around the months held
+
+  std::vector<int64_t> firstBucket(partitions.size());
+  std::vector<std::vector<ColumnStats>> parts(partitions.size());
+
+  if (!parallel(partitions.size(), [&](size_t p, std::string& failure) {
+        const HistoryPartition& partition = *partitions[p];
+        int64_t start = std::max(from, partition.start), end = std::min(to, partition.end);
+        MappedColumn spareTimes, spareValues;
+
+        if (start >= end || !HistoryReader::hasSensor(partition, sensor)) {
+          return true;
+        }
+        firstBucket[p] = (start - from) / widthS;
+        parts[p].assign((end - 1 - from) / widthS - firstBucket[p] + 1, ColumnScan::empty());
+
+        const int32_t* time = (const int32_t*)_reader.column(partition, HISTORY_TIME_COLUMN, spareTimes, failure);
+        const float* value = (const float*)_reader.column(partition, sensor, spareValues, failure);
+        if (time == NULL || value == NULL) {
+          return false;
+        }
+        int32_t low = offsetIn(partition, start), high = offsetIn(partition, end);
+        size_t row = 0;
+
+        while (row < partition.rows) {
+          if (time[row] < low || time[row] >= high) {
+            row++;
+            continue;
+          }
+          int64_t bucket = (partition.start + time[row] - from) / widthS;
+          int32_t bucketLow = std::max(low, offsetIn(partition, from + bucket * widthS));
+          int32_t bucketHigh = std::min(high, offsetIn(partition, from + (bucket + 1) * widthS));
+          size_t runEnd = ColumnScan::runEnd(time, row, partition.rows, bucketLow, bucketHigh);
+
+          ColumnScan::aggregate(time + row, value + row, runEnd - row, bucketLow, bucketHigh, parts[p][bucket - firstBucket[p]]);
+          row = runEnd;
+        }
+        return true;
+      }, error)) {
+    return false;
+  }
+
+  // A bucket can straddle two months, so a node's partitions are put together by bucket
+  for (size_t n = 0; n < nodes.size(); n++) {
+    std::map<int64_t, ColumnStats> buckets;
+
+    out[n].node = partitions[nodes[n].first]->node;
+    for (size_t p = nodes[n].first; p < nodes[n].second; p++) {
+      for (size_t b = 0; b < parts[p].size(); b++) {
+        if (parts[p][b].count > 0) {
+          buckets.emplace(firstBucket[p] + b, ColumnScan::empty()).first->second.add(parts[p][b]);
+        }
+      }
+    }
+    for (auto& bucket : buckets) {
+      out[n].buckets.push_back({ from + bucket.first * widthS, bucket.second });
+    }
+  }
+  return true;
+}
+
+// Function to predict when each node's soil reaches threshold (%), as of the end of the range
+// A node's moisture readings in the range are put in time order and the last watering found: a reading at least
+// HISTORY_WATERING_RISE above the driest since the watering before. A straight line is fitted to the readings
+// since, at most the newest HISTORY_DRYOUT_FIT_S of them, and followed down to the threshold.
+bool HistoryQuery::predictDryOut(const HistoryRange& range, float threshold, std::vector<DryOutPrediction>& out, std::string& error) {
+  std::vector<const HistoryPartition*> partitions;
+  std::vector<std::pair<size_t, size_t>> nodes;
+
+  select(range, partitions, nodes);
+  out.assign(nodes.size(), DryOutPrediction());
+
+  return parallel(nodes.size(), [&](size_t n, std::string& failure) {
+    DryOutPrediction& prediction = out[n];
+    std::vector<std::pair<int64_t, float>> readings;
+
+    prediction.node = partitions[nodes[n].first]->node;
+    prediction.moisture = NAN;
+    for (size_t p = nodes[n].first; p < nodes[n].second; p++) {
+      const HistoryPartition& partition = *partitions[p];
+      int32_t low = offsetIn(partition, range.from), high = offsetIn(partition, range.to);
+      MappedColumn spareTimes, spareValues;
+
+      if (!HistoryReader::hasSensor(partition, SENSOR_MOISTURE)) {
+        continue;
+      }
+      const int32_t* times = (const int32_t*)_reader.column(partition, HISTORY_TIME_COLUMN, spareTimes, failure);
+      const float* values = (const float*)_reader.column(partition, SENSOR_MOISTURE, spareValues, failure);
+
+      if (times == NULL || values == NULL) {
+        return false;
+      }
+      for (size_t row = 0; row < partition.rows; row++) {
+        if (times[row] >= low && times[row] < high && !isnan(values[row])) {
+          readings.push_back({ partition.start + times[row], values[row] });
+        }
+      }
+    }
+    if (readings.empty()) {
+      return true;
+    }
+    std::sort(readings.begin(), readings.end());
+
+    size_t watered = 0;
+    float driest = readings[0].second;
+    for (size_t r = 1; r < readings.size(); r++) {
+      if (readings[r].second >= driest + HISTORY_WATERING_RISE) {
+        watered = r;
+        prediction.wateredAt = readings[r].first;
+        driest = readings[r].second;
+      }
+      driest = std::min(driest, readings[r].second);
+    }
+
+    // Least squares over days before the end of the range, so the intercept is the moisture now
+    int64_t fitFrom = std::max(readings[watered].first, readings.back().first - HISTORY_DRYOUT_FIT_S);
+    double count = 0, sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+    for (size_t r = watered; r < readings.size(); r++) {
+      double x = (double)(readings[r].first - range.to) / SECONDS_PER_DAY;
+      double y = readings[r].second;
+
+      if (readings[r].first < fitFrom) {
+        continue;
+      }
+      count++;
+      sumX += x;
+      sumY += y;
+      sumXX += x * x;
+      sumXY += x * y;
+    }
+    prediction.readings = count;
+    prediction.moisture = readings.back().second;
+
+    double spread = count * sumXX - sumX * sumX;
+    if (count < HISTORY_DRYOUT_READINGS_MIN || spread <= 0) {
+      return true;
+    }
+    double slope = (count * sumXY - sumX * sumY) / spread;
+    double now = (sumY - slope * sumX) / count;
+
+    prediction.moisture = now;
+    prediction.ratePerDay = slope;
+    if (slope <= -HISTORY_DRYOUT_RATE_MIN) {
+      prediction.f_Predicted = true;
+      prediction.dryAt = range.to + (int64_t)llround((threshold - now) / slope * SECONDS_PER_DAY);
+    }
+    return true;
+  }, error);
+}
+
+// Function to get the rows held by the partitions the last query went through
+uint64_t HistoryQuery::getRowsScanned() {
+  return _rowsScanned;
+}
+
+// Method to find the partitions in range, and the span of them each node has (the reader lists them by node)
+void HistoryQuery::select(const HistoryRange& range, std::vector<const HistoryPartition*>& partitions, std::vector<std::pair<size_t, size_t>>& nodes) {
+  std::set<std::string> wanted(range.nodes.begin(), range.nodes.end());
+
+  _rowsScanned = 0;
+  for (const HistoryPartition& partition : _reader.getPartitions()) {
+    if (partition.end <= range.from || partition.start >= range.to || (!wanted.empty() && wanted.count(partition.node) == 0)) {
+      continue;
+    }
+    if (partitions.empty() || partitions.back()->node != partition.node) {
+      nodes.push_back({ partitions.size(), partitions.size() });
+    }
+    partitions.push_back(&partition);
+    nodes.back().second = partitions.size();
+    _rowsScanned += partition.rows;
+  }
+}
+
+// Function to run work on every index from 0 to count over the threads, false (with the first error) if any failed
+// The calling thread works too, so a query on one thread starts none
+bool HistoryQuery::parallel(size_t count, const std::function<bool(size_t, std::string&)>& work, std::string& error) {
+  std::atomic<size_t> next(0);
+  std::atomic<bool> f_Failed(false);
+  std::mutex errorLock;
+  std::vector<std::thread> threads;
+
+  auto run = [&]() {
+    std::string failure;
+
+    for (size_t index = next++; index < count && !f_Failed; index = next++) {
+      if (!work(index, failure)) {
+        std::lock_guard<std::mutex> guard(errorLock);
+        if (!f_Failed.exchange(true)) {
+          error = failure;
+        }
+      }
+    }
+  };
+
+  for (int t = 1; t < _threads && (size_t)t < count; t++) {
+    threads.emplace_back(run);
+  }
+  run();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return !f_Failed;
+}
+
+// Function to add up a partition's readings of a sensor taken in [from, to), and collect them if values is given
+bool HistoryQuery::scan(const HistoryPartition& partition, int sensor, int64_t from, int64_t to, ColumnStats& stats, std::vector<float>* values, std::string& error) {
+  int32_t low = offsetIn(partition, from), high = offsetIn(partition, to);
+  MappedColumn spareTimes, spareReadings;
+
+  if (low >= high || !HistoryReader::hasSensor(partition, sensor)) {
+    return true; // a node without the sensor has no readings of it
+  }
+  const int32_t* times = (const int32_t*)_reader.column(partition, HISTORY_TIME_COLUMN, spareTimes, error);
+  const float* readings = (const float*)_reader.column(partition, sensor, spareReadings, error);
+  if (times == NULL || readings == NULL) {
+    return false;
+  }
+  ColumnScan::aggregate(times, readings, partition.rows, low, high, stats);
+  if (values != NULL) {
+    ColumnScan::collect(times, readings, partition.rows, low, high, *values);
+  }
+  return true;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,87 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef HistoryQuery_h
+#define HistoryQuery_h
+
+// Include the necessary libraries
+#include "ColumnScan.h"
+#include "HistoryReader.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/* Definitions */
+#define HISTORY_WATERING_RISE 10.0f // moisture gained (%) since the driest reading that counts as the pot being watered
+#define HISTORY_DRYOUT_FIT_S (2 * 86400) // newest stretch of drying the prediction follows (soil dries slower as it dries)
+#define HISTORY_DRYOUT_READINGS_MIN 6 // readings since the watering needed for a prediction
+#define HISTORY_DRYOUT_RATE_MIN 0.05f // drying (% a day) below which the soil counts as not drying at all
+
+/* What a query covers */
+struct HistoryRange {
+	int64_t from; // Unix time, readings taken at or after
+	int64_t to; // and before
+	std::vector<std::string> nodes; // node directory names, empty = every node
+};
+
+/* One node's readings of a sensor over a range */
+struct NodeSummary {
+	std::string node;
+	ColumnStats stats;
+	std::vector<float> percentiles; // in the order asked for (NaN without readings)
+};
+
+/* One bucket of a downsampled series */
+struct SeriesBucket {
+	int64_t start; // Unix time the bucket starts
+	ColumnStats stats;
+};
+
+/* One node's downsampled series */
+struct NodeSeries {
+	std::string node;
+	std::vector<SeriesBucket> buckets; // oldest first, buckets without readings left out
+};
+
+/* When a node's pot will need watering */
+struct DryOutPrediction {
+	std::string node;
+	bool f_Predicted; // false if the soil isn't drying, or too few readings since it was watered
+	int64_t wateredAt; // Unix time of the last watering seen (0 = none in the range)
+	uint32_t readings; // readings the fit is over
+	float moisture; // fitted moisture at the end of the range (%)
+	float ratePerDay; // change per day (%, negative when drying)
+	int64_t dryAt; // Unix time the fit reaches the threshold (in the past if it already has)
+};
+
+/* HistoryQuery class definition */
+// Range aggregations over a history store, spread over threads: each takes the next partition (or node, where a
+// node's readings have to come together) off a shared counter, maps just the columns the query reads and runs
+// the ColumnScan loops over them, and the parts are put together once every thread is done.
+class HistoryQuery {
+	public:
+		/* Constructors */
+		HistoryQuery(const HistoryReader& reader, int threads); // constructor for queries over a reader's partitions (threads <= 0 = one per CPU)
+
+		/* Public Functions and Methods */
+		bool summarize(const HistoryRange& range, int sensor, const std::vector<double>& percentiles, std::vector<NodeSummary>& out, std::string& error); // function to get each node's minimum, maximum, mean and percentiles
+		bool downsample(const HistoryRange& range, int sensor, int64_t widthS, std::vector<NodeSeries>& out, std::string& error); // function to get each node's readings in buckets of widthS seconds
+		bool predictDryOut(const HistoryRange& range, float threshold, std::vector<DryOutPrediction>& out, std::string& error); // function to predict when each node's soil reaches threshold (%), as of the end of the range
+		uint64_t getRowsScanned(); // function to get the rows the last query went through
+	private:
+		/* Private Instance Variables */
+		const HistoryReader& _reader;
+		int _threads;
+		uint64_t _rowsScanned;
+
+		/* Private Functions and Methods */
+		void select(const HistoryRange& range, std::vector<const HistoryPartition*>& partitions, std::vector<std::pair<size_t, size_t>>& nodes); // method to find the partitions in range, and where each node's begin and end
+		bool parallel(size_t count, const std::function<bool(size_t, std::string&)>& work, std::string& error); // function to run work on every index from 0 to count over the threads
+		bool scan(const HistoryPartition& partition, int sensor, int64_t from, int64_t to, ColumnStats& stats, std::vector<float>* values, std::string& error); // function to add up (and collect) a partition's readings in range
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,209 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "HistoryReader.h"
+#include "HistoryStore.h"
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* MappedColumn Constructors */
+// Constructor for a column not mapped yet
+MappedColumn::MappedColumn()
+  : _data(NULL),
+    _size(0)
+{
+}
+
+// Destructor to unmap the column
+MappedColumn::~MappedColumn() {
+  if (_data != NULL) {
+    munmap(_data, _size);
+  }
+}
+
+/* MappedColumn Functions */
+
+// Function to map the first rows of a column, read ahead as the scans go straight through
+bool MappedColumn::map(const std::string& path, uint64_t rows, std::string& error) {
+  int fd;
+
+  if (rows == 0) {
+    return true; // nothing to map, mmap() won't take a length of 0
+  }
+  fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    error = "can't open " + path + ": " + strerror(errno);
+    return false;
+  }
+  _size = rows * HISTORY_VALUE_SIZE;
+  _data = mmap(NULL, _size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (_data == MAP_FAILED) {
+    _data = NULL;
+    error = "can't map " + path + ": " + strerror(errno);
+    return false;
+  }
+  madvise(_data, _size, MADV_SEQUENTIAL);
+  return true;
+}
+
+// Function to get a time column's rows
+const int32_t* MappedColumn::times() {
+  return (const int32_t*)_data;
+}
+
+// Function to get a reading column's rows
+const float* MappedColumn::values() {
+  return (const float*)_data;
+}
+
+/* HistoryReader Constructors */
+// Constructor for the store under root
+HistoryReader::HistoryReader(const std::string& root)
+  : _root(root),
+    _mapped(0)
+{
+}
+
+/* HistoryReader Functions */
+
+// Function to list the names in a directory, leaving out "." and ".."
+static bool listDirectory(const std::string& path, std::vector<std::string>& names, std::string& error) {
+  DIR* directory = opendir(path.c_str());
+  struct dirent* entry;
+
+  if (directory == NULL) {
+    error = "can't read " + path + ": " + strerror(errno);
+    return false;
+  }
+  while ((entry = readdir(directory)) != NULL) {
+    if (entry->d_name[0] != '.') {
+      names.push_back(entry->d_name);
+    }
+  }
+  closedir(directory);
+  std::sort(names.begin(), names.end());
+  return true;
+}
+
+// Function to list the store's partitions, by node and then month, dropping the columns mapped before
+// Anything that isn't a month's directory is stepped over; a partition's rows are those of its time column, and a
+// sensor column shorter than that (being made as the store was listed) is left out until the next time
+bool HistoryReader::open(std::string& error) {
+  std::vector<std::string> nodes;
+
+  _slots.reset();
+  _mapped = 0;
+  _partitions.clear();
+  if (!listDirectory(_root, nodes, error)) {
+    return false;
+  }
+
+  for (const std::string& node : nodes) {
+    std::vector<std::string> months;
+    if (!listDirectory(_root + "/" + node, months, error)) {
+      continue; // not a directory
+    }
+
+    for (const std::string& month : months) {
+      HistoryPartition partition;
+      struct tm utc = {};
+      struct stat status;
+
+      if (sscanf(month.c_str(), "%4d-%2d", &utc.tm_year, &utc.tm_mon) != 2 || month.size() != 7) {
+        continue;
+      }
+      utc.tm_year -= 1900;
+      utc.tm_mon -= 1;
+      utc.tm_mday = 1;
+      partition.node = node;
+      partition.directory = _root + "/" + node + "/" + month;
+      partition.start = timegm(&utc);
+      partition.end = HistoryStore::partitionEnd(partition.start);
+      partition.sensors = 0;
+
+      if (stat((partition.directory + "/" + HistoryStore::columnFile(HISTORY_TIME_COLUMN)).c_str(), &status) != 0) {
+        continue;
+      }
+      partition.rows = status.st_size / HISTORY_VALUE_SIZE;
+      for (int c = 0; c < HISTORY_TIME_COLUMN; c++) {
+        if (stat((partition.directory + "/" + HistoryStore::columnFile(c)).c_str(), &status) == 0 && (uint64_t)status.st_size >= partition.rows * HISTORY_VALUE_SIZE) {
+          partition.sensors |= 1u << c;
+        }
+      }
+      if (partition.rows > 0) {
+        _partitions.push_back(partition);
+      }
+    }
+  }
+  _slots.reset(new Slot[_partitions.size() * HISTORY_COLUMNS]);
+  error.clear();
+  return true;
+}
+
+// Function to get a partition's column, mapped the first time it is asked for and kept while the reader has
+// room; past that it is mapped into spare, for as long as the caller keeps spare. NULL if it can't be mapped.
+const void* HistoryReader::column(const HistoryPartition& partition, int column, MappedColumn& spare, std::string& error) const {
+  Slot& slot = _slots[(&partition - _partitions.data()) * HISTORY_COLUMNS + column];
+
+  std::call_once(slot.once, [&]() {
+    if (_mapped++ >= HISTORY_MAPPED_MAX) {
+      _mapped--;
+      return;
+    }
+    slot.f_Kept = slot.column.map(partition.directory + "/" + HistoryStore::columnFile(column), partition.rows, slot.error);
+  });
+  if (slot.f_Kept) {
+    return slot.column.values();
+  }
+  if (!slot.error.empty()) {
+    error = slot.error;
+    return NULL;
+  }
+  return spare.map(partition.directory + "/" + HistoryStore::columnFile(column), partition.rows, error) ? spare.values() : NULL;
+}
+
+// Function to check a partition has a column for a sensor, out of range sensors having none
+bool HistoryReader::hasSensor(const HistoryPartition& partition, int sensor) {
+  return sensor >= 0 && sensor < HISTORY_TIME_COLUMN && (partition.sensors & (1u << sensor)) != 0;
+}
+
+// Function to get the partitions, by node and then month
+const std::vector<HistoryPartition>& HistoryReader::getPartitions() const {
+  return _partitions;
+}
+
+// Function to get the nodes, sorted
+std::vector<std::string> HistoryReader::getNodes() const {
+  std::vector<std::string> nodes;
+
+  for (const HistoryPartition& partition : _partitions) {
+    if (nodes.empty() || nodes.back() != partition.node) {
+      nodes.push_back(partition.node);
+    }
+  }
+  return nodes;
+}
+
+// Function to get the rows held, over every partition
+uint64_t HistoryReader::getRows() const {
+  uint64_t rows = 0;
+
+  for (const HistoryPartition& partition : _partitions) {
+    rows += partition.rows;
+  }
+  return rows;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,87 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef HistoryReader_h
+#define HistoryReader_h
+
+// Include the necessary libraries
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* Definitions */
+#define HISTORY_MAPPED_MAX 32768 // columns a reader keeps mapped, half the kernel's default vm.max_map_count
+
+/* One node's month of readings */
+struct HistoryPartition {
+	std::string node; // node's directory name
+	std::string directory; // path of the month's columns
+	int64_t start; // Unix time the month starts
+	int64_t end; // and the next one does
+	uint64_t rows; // whole rows, those of the time column
+	uint32_t sensors; // bit per sensor index with a column holding every row
+};
+
+/* MappedColumn class definition */
+// One column file mapped read only, for as long as a query needs it. Only the rows counted when the store was
+// listed are mapped, so rows the collector appends meanwhile are left for the next query.
+class MappedColumn {
+	public:
+		/* Constructors */
+		MappedColumn(); // constructor for a column not mapped yet
+		~MappedColumn(); // destructor to unmap it
+		MappedColumn(const MappedColumn&) = delete;
+		MappedColumn& operator=(const MappedColumn&) = delete;
+
+		/* Public Functions and Methods */
+		bool map(const std::string& path, uint64_t rows, std::string& error); // function to map the first rows of a column
+		const int32_t* times(); // function to get a time column's rows
+		const float* values(); // function to get a reading column's rows
+	private:
+		/* Private Instance Variables */
+		void* _data;
+		size_t _size;
+};
+
+/* HistoryReader class definition */
+// The partitions a history store holds, as they were when it was opened. A column is mapped the first time a
+// query reads it and stays mapped for the next, as mapping costs more than scanning a month of readings. Years of
+// hundreds of nodes can be more files than a process may have mapped, so past HISTORY_MAPPED_MAX a query maps
+// the columns it reads only while it reads them.
+class HistoryReader {
+	public:
+		/* Constructors */
+		HistoryReader(const std::string& root); // constructor for the store under root
+		HistoryReader(const HistoryReader&) = delete;
+		HistoryReader& operator=(const HistoryReader&) = delete;
+
+		/* Public Functions and Methods */
+		bool open(std::string& error); // function to list the store's partitions, by node and then month (again = as they are now, mappings dropped)
+		const std::vector<HistoryPartition>& getPartitions() const; // function to get the partitions
+		std::vector<std::string> getNodes() const; // function to get the nodes, sorted
+		uint64_t getRows() const; // function to get the rows held, over every partition
+		const void* column(const HistoryPartition& partition, int column, MappedColumn& spare, std::string& error) const; // function to get a partition's column, mapped into spare if the reader can't keep it (NULL if it can't be mapped)
+		static bool hasSensor(const HistoryPartition& partition, int sensor); // function to check a partition has a column for a sensor
+	private:
+		/* Private Instance Variables */
+		struct Slot {
+			std::once_flag once;
+			MappedColumn column;
+			bool f_Kept = false; // mapped and kept, false if the reader had too many
+			std::string error; // why it couldn't be mapped
+		};
+		std::string _root;
+		std::vector<HistoryPartition> _partitions;
+		std::unique_ptr<Slot[]> _slots; // HISTORY_COLUMNS a partition
+		mutable std::atomic<size_t> _mapped; // columns kept mapped
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
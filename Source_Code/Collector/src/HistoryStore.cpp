@@ -0,0 +1,324 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "HistoryStore.h"
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <map>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+/* Definitions */
+#define PAD_ROWS 1024 // NaN rows written at once when a new column is padded
+
+/* Constructors */
+// Constructor for the store under root, nothing is touched until open()
+// Every node reports every interval, so the partitions kept open have to cover them all or each report would
+// open a file per column; half the process's descriptors are left for the nodes' connections
+HistoryStore::HistoryStore(const std::string& root)
+  : _root(root),
+    _openMax(HISTORY_OPEN_PARTITIONS_MIN),
+    _stats()
+{
+  struct rlimit limit;
+
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+    _openMax = std::max(_openMax, (size_t)(limit.rlim_cur / 2 / HISTORY_COLUMNS));
+  }
+}
+
+// Destructor to close the open partitions
+HistoryStore::~HistoryStore() {
+  close();
+}
+
+/* Functions */
+
+// Function to make sure the store's directory is there
+bool HistoryStore::open(std::string& error) {
+  if (mkdir(_root.c_str(), 0755) != 0 && errno != EEXIST) {
+    error = "can't make " + _root + ": " + strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+// Function to append a report's readings
+// Readings from before a power loss have no time to be filed under and are only counted
+bool HistoryStore::handleReport(const NodeReport& report, ReportVia via, bool alert) {
+  std::string error;
+
+  (void)via;
+  (void)alert;
+  if (!append(report.id, report.readings.data(), report.readings.size(), report.sensorCount, error)) {
+    fprintf(stderr, "history: %s\n", error.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Function to append readings to a node's history, each to the month it was taken in
+// A partition a write failed part way through is closed, so the next append trims it back to whole rows
+bool HistoryStore::append(const std::string& node, const Reading* readings, size_t count, uint8_t sensorCount, std::string& error) {
+  std::map<int64_t, std::vector<const Reading*>> months;
+  uint64_t untimed = 0;
+
+  for (size_t r = 0; r < count; r++) {
+    if (readings[r].time == REPORT_TIME_UNKNOWN) {
+      untimed++;
+      continue;
+    }
+    months[partitionStart(readings[r].time)].push_back(&readings[r]);
+  }
+
+  std::lock_guard<std::mutex> guard(_lock);
+  _stats.untimed += untimed;
+
+  for (auto& month : months) {
+    std::string key = nodeDirectory(node) + "/" + partitionName(month.first);
+    auto found = _open.find(key);
+
+    if (found == _open.end()) {
+      Partition partition;
+      if (_open.size() >= _openMax) {
+        closeAll(); // only more nodes than descriptors get here, and then there is no order worth keeping track of
+      }
+      if (!openPartition(node, month.first, partition, error)) {
+        _stats.failures++;
+        return false;
+      }
+      found = _open.emplace(key, partition).first;
+    }
+
+    if (!writeRows(found->second, month.second.data(), month.second.size(), month.first, sensorCount, error)) {
+      closePartition(found->second);
+      _open.erase(found);
+      _stats.failures++;
+      return false;
+    }
+    _stats.rows += month.second.size();
+  }
+  return true;
+}
+
+// Method to close the open partitions
+void HistoryStore::close() {
+  std::lock_guard<std::mutex> guard(_lock);
+
+  closeAll();
+}
+
+// Method to close the open partitions, with the lock held
+void HistoryStore::closeAll() {
+  for (auto& entry : _open) {
+    closePartition(entry.second);
+  }
+  _open.clear();
+}
+
+// Method to close a partition's columns
+void HistoryStore::closePartition(Partition& partition) {
+  for (int fd : partition.fds) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+}
+
+// Function to get what the store has been given
+HistoryStats HistoryStore::getStats() {
+  std::lock_guard<std::mutex> guard(_lock);
+
+  return _stats;
+}
+
+// Function to get the start of the UTC month a time is in
+int64_t HistoryStore::partitionStart(int64_t time) {
+  time_t seconds = time;
+  struct tm utc;
+
+  gmtime_r(&seconds, &utc);
+  utc.tm_mday = 1;
+  utc.tm_hour = 0;
+  utc.tm_min = 0;
+  utc.tm_sec = 0;
+  return timegm(&utc);
+}
+
+// Function to get the start of the month after the one starting at start
+int64_t HistoryStore::partitionEnd(int64_t start) {
+  time_t seconds = start;
+  struct tm utc;
+
+  gmtime_r(&seconds, &utc);
+  utc.tm_mon++; // timegm() carries December into January
+  return timegm(&utc);
+}
+
+// Function to get a month's directory name (YYYY-MM)
+std::string HistoryStore::partitionName(int64_t start) {
+  time_t seconds = start;
+  struct tm utc;
+  char name[16];
+
+  gmtime_r(&seconds, &utc);
+  strftime(name, sizeof(name), "%Y-%m", &utc);
+  return name;
+}
+
+// Function to get a node's directory name, characters a path can't take (and a leading dot) replaced by '_'
+// Stock hostnames are letters, digits and dashes, so they come through as they are
+std::string HistoryStore::nodeDirectory(const std::string& node) {
+  std::string name = node.empty() ? "_" : node;
+
+  for (size_t i = 0; i < name.size(); i++) {
+    char c = name[i];
+    if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || (c == '.' && i > 0))) {
+      name[i] = '_';
+    }
+  }
+  return name;
+}
+
+// Function to get a column's file name: sensor<index>.f32, or time.i32 for the time column
+std::string HistoryStore::columnFile(int column) {
+  return (column == HISTORY_TIME_COLUMN) ? "time.i32" : "sensor" + std::to_string(column) + ".f32";
+}
+
+// Function to write all of a buffer to a descriptor, false with errno set if it can't
+static bool writeAll(int fd, const void* buffer, size_t size) {
+  const uint8_t* data = (const uint8_t*)buffer;
+
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      errno = (written == 0) ? EIO : errno;
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+// Function to append rows of NaN to a column
+static bool writePadding(int fd, off_t rows) {
+  std::vector<float> padding(std::min(rows, (off_t)PAD_ROWS), NAN);
+
+  for (off_t left = rows; left > 0; left -= padding.size()) {
+    if (!writeAll(fd, padding.data(), std::min(left, (off_t)padding.size()) * HISTORY_VALUE_SIZE)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Function to open a partition for appending, making its directories and time column
+// The time column is written last, so its whole rows are the partition's: sensor columns longer (a write cut off
+// by a crash) are trimmed back to them, and shorter ones (a crash while a new column was padded) padded out
+bool HistoryStore::openPartition(const std::string& node, int64_t start, Partition& partition, std::string& error) {
+  std::string directory = _root + "/" + nodeDirectory(node);
+  struct stat status;
+
+  for (const std::string& path : { directory, directory + "/" + partitionName(start) }) {
+    if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+      error = "can't make " + path + ": " + strerror(errno);
+      return false;
+    }
+  }
+  partition.directory = directory + "/" + partitionName(start);
+  std::fill(partition.fds, partition.fds + HISTORY_COLUMNS, -1);
+
+  for (int c = HISTORY_TIME_COLUMN; c >= 0; c--) {
+    std::string path = partition.directory + "/" + columnFile(c);
+    int flags = O_WRONLY | O_APPEND | O_CLOEXEC | ((c == HISTORY_TIME_COLUMN) ? O_CREAT : 0);
+
+    partition.fds[c] = ::open(path.c_str(), flags, 0644);
+    if (partition.fds[c] < 0 && errno == ENOENT && c != HISTORY_TIME_COLUMN) {
+      continue; // no report has carried this sensor yet
+    }
+    if (partition.fds[c] < 0 || fstat(partition.fds[c], &status) != 0) {
+      error = "can't open " + path + ": " + strerror(errno);
+      closePartition(partition);
+      return false;
+    }
+    if (c == HISTORY_TIME_COLUMN) {
+      partition.rows = status.st_size / HISTORY_VALUE_SIZE;
+    }
+
+    off_t size = partition.rows * HISTORY_VALUE_SIZE;
+    bool f_Whole = (status.st_size > size) ? ftruncate(partition.fds[c], size) == 0
+                   : writePadding(partition.fds[c], (size - status.st_size) / HISTORY_VALUE_SIZE);
+    if (!f_Whole) {
+      error = path + ": can't repair a torn row: " + strerror(errno);
+      closePartition(partition);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Function to make a sensor's column, padded with NaN to the rows already written
+bool HistoryStore::addColumn(Partition& partition, int column, std::string& error) {
+  std::string path = partition.directory + "/" + columnFile(column);
+
+  partition.fds[column] = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (partition.fds[column] < 0) {
+    error = "can't make " + path + ": " + strerror(errno);
+    return false;
+  }
+  if (!writePadding(partition.fds[column], partition.rows)) {
+    error = "can't pad " + path + ": " + strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+// Function to append rows to each column, the time column last so a row only counts once it is whole
+// Sensors the node has that the partition has no column for yet get one first
+bool HistoryStore::writeRows(Partition& partition, const Reading* const* rows, size_t count, int64_t start, uint8_t sensorCount, std::string& error) {
+  std::vector<uint32_t> column(count);
+
+  for (int c = 0; c < HISTORY_COLUMNS; c++) {
+    if (partition.fds[c] < 0) {
+      if (c >= sensorCount) {
+        continue;
+      }
+      if (!addColumn(partition, c, error)) {
+        return false;
+      }
+    }
+    for (size_t r = 0; r < count; r++) {
+      if (c == HISTORY_TIME_COLUMN) {
+        int32_t offset = rows[r]->time - start;
+        memcpy(&column[r], &offset, HISTORY_VALUE_SIZE);
+      }
+      else {
+        float value = (c < sensorCount) ? rows[r]->values[c] : NAN;
+        memcpy(&column[r], &value, HISTORY_VALUE_SIZE);
+      }
+    }
+
+    if (!writeAll(partition.fds[c], column.data(), count * HISTORY_VALUE_SIZE)) {
+      error = "can't append to " + partition.directory + "/" + columnFile(c) + ": " + strerror(errno);
+      return false;
+    }
+  }
+  partition.rows += count;
+  return true;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,78 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef HistoryStore_h
+#define HistoryStore_h
+
+// Include the necessary libraries
+#include "ReportHandler.h"
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+
+/* Definitions */
+#define HISTORY_TIME_COLUMN REPORT_SENSORS_MAX // columns 0 to 7 are the sensors, by their index in the nodes' order, then the time
+#define HISTORY_COLUMNS (REPORT_SENSORS_MAX + 1)
+#define HISTORY_VALUE_SIZE 4 // bytes per row in every column (float readings, int32 seconds)
+#define HISTORY_OPEN_PARTITIONS_MIN 16 // partitions kept open for appending, however few descriptors the process may have
+
+/* What the store has been given */
+struct HistoryStats {
+	uint64_t rows; // readings written
+	uint64_t untimed; // readings left out, taken before a power loss (time unknown)
+	uint64_t failures; // reports that couldn't be written
+};
+
+/* HistoryStore class definition */
+// Every reading the nodes send, kept for good in columns: one directory per node per UTC month
+// (root/<node>/<YYYY-MM>/), holding a file of 32-bit seconds from the start of the month and a file of 32-bit
+// floats per sensor the node has reported (sensor0.f32, sensor1.f32, ...), row i of each being one reading.
+// Files are only ever appended to, value columns before the time column, so a reader that takes the time
+// column's length as the row count never sees half a row; if the collector died part way, the next append
+// trims the longer files back first. A sensor's column is made the first time a report carries it, padded
+// with NaN for the rows before, as are the rows of a report that carries fewer sensors. Readings are written
+// in the order they arrive, so a backlog lands after newer samples: the scans don't count on times being sorted.
+class HistoryStore : public ReportHandler {
+	public:
+		/* Constructors */
+		HistoryStore(const std::string& root); // constructor for the store under root, holding open at most half the descriptors the process may have
+		~HistoryStore(); // destructor to close the open partitions
+
+		/* Public Functions and Methods */
+		bool open(std::string& error); // function to make sure the store's directory is there
+		bool handleReport(const NodeReport& report, ReportVia via, bool alert) override; // function to append a report's readings (false = not written, the node sends it again)
+		bool append(const std::string& node, const Reading* readings, size_t count, uint8_t sensorCount, std::string& error); // function to append readings to a node's history
+		void close(); // method to close the open partitions
+		HistoryStats getStats(); // function to get what the store has been given
+		static int64_t partitionStart(int64_t time); // function to get the start of the UTC month a time is in
+		static int64_t partitionEnd(int64_t start); // function to get the start of the next month
+		static std::string partitionName(int64_t start); // function to get a month's directory name (YYYY-MM)
+		static std::string nodeDirectory(const std::string& node); // function to get a node's directory name, characters a path can't take replaced
+		static std::string columnFile(int column); // function to get a column's file name
+	private:
+		/* Private Instance Variables */
+		struct Partition {
+			std::string directory;
+			int fds[HISTORY_COLUMNS]; // -1 for sensors without a column yet
+			off_t rows; // whole rows in every column
+		};
+		std::string _root;
+		std::mutex _lock;
+		std::unordered_map<std::string, Partition> _open; // by "node/YYYY-MM"
+		size_t _openMax; // partitions kept open, all are closed when there would be more
+		HistoryStats _stats;
+
+		/* Private Functions and Methods */
+		void closeAll(); // method to close the open partitions, with the lock held
+		static void closePartition(Partition& partition); // method to close a partition's columns
+		bool openPartition(const std::string& node, int64_t start, Partition& partition, std::string& error); // function to open a partition for appending, trimming a torn row
+		bool addColumn(Partition& partition, int column, std::string& error); // function to make a sensor's column, padded to the rows already written
+		bool writeRows(Partition& partition, const Reading* const* rows, size_t count, int64_t start, uint8_t sensorCount, std::string& error); // function to append rows to each column
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
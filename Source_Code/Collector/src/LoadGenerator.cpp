@@ -0,0 +1,629 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "LoadGenerator.h"
+#include "Crc32.h"
+#include "SyntheticNode.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <math.h>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+
+/* Definitions */
+#define CRLF "\r\n"
+#define EPOLL_EVENTS 64 // events taken from epoll_wait() at a time
+#define WAIT_MAX_MS 100 // longest sleep between looks at the nodes' timers
+#define READ_BUFFER_SIZE 4096
+#define SAMPLE_INTERVAL_S 300 // synthetic time between a node's samples
+#define ACK_SIZE 4
+#define US_PER_MS 1000
+#define US_PER_S 1000000
+
+/* Where a node is in a report */
+enum NodeState {
+  NODE_IDLE, // waiting for its next report
+  NODE_CONNECTING, // TCP connect in progress
+  NODE_GREETING, // waiting for 220
+  NODE_EHLO, // waiting for 250
+  NODE_ENVELOPE, // MAIL FROM, RCPT TO and DATA sent, waiting for 250, 250 and 354
+  NODE_MESSAGE, // message and QUIT sent, waiting for 250
+  NODE_QUIT, // delivered, waiting for 221
+  NODE_WAITING_ACK // datagram sent, waiting for its CRC
+};
+
+/* How a report ended */
+enum ReportOutcome {
+  OUTCOME_DELIVERED,
+  OUTCOME_FAILED,
+  OUTCOME_TIMED_OUT
+};
+
+/* One simulated node */
+struct SimulatedNode {
+  SyntheticNode model;
+  bool f_Udp; // reports by datagram, else through the relay
+  int fd; // relay connection while in a session, telemetry socket all along
+  NodeState state;
+  int64_t nextStartUs; // when its next report is due
+  int64_t startUs; // when the report in progress started
+  int64_t deadlineUs; // when the reply being waited for is given up on
+  int64_t simTime; // synthetic clock of its readings
+  std::vector<uint8_t> record; // report in progress
+  std::string message; // the email around it, dot stuffed, with the end of data and QUIT after it
+  std::string out; // bytes not yet written
+  size_t outPos;
+  std::string in; // reply text not yet handled
+  int replies; // replies still due in this state
+  uint32_t crc; // of the datagram, what the ack has to be
+  int attempts; // sends of the datagram
+  bool f_Writing; // waiting for EPOLLOUT
+
+  SimulatedNode(uint32_t index, uint32_t seed, int64_t bootTime, bool udp)
+    : model(index, seed, bootTime), f_Udp(udp), fd(-1), state(NODE_IDLE), nextStartUs(0), startUs(0), deadlineUs(0),
+      simTime(0), outPos(0), replies(0), crc(0), attempts(0), f_Writing(false) { }
+};
+
+/* LoadWorker class definition */
+// One thread's share of the simulated nodes, all on one epoll instance
+class LoadWorker {
+  public:
+    /* Constructors */
+    LoadWorker(const LoadConfig& config, const struct sockaddr_in& smtp, const struct sockaddr_in& udp); // constructor for nodes that report to the given addresses
+    ~LoadWorker(); // destructor that closes every socket
+
+    /* Public Functions and Methods */
+    void addNode(uint32_t index, bool udp); // method to give the worker another node
+    bool begin(std::string& error); // function to open the epoll instance and the telemetry sockets
+    void run(int64_t startUs, int64_t endUs); // method to send reports until endUs, then let those under way finish
+    LoadResult result; // what this worker's nodes did
+    int64_t lastFinishUs; // when its last report ended
+  private:
+    /* Private Instance Variables */
+    LoadConfig _config;
+    struct sockaddr_in _smtp;
+    struct sockaddr_in _udp;
+    int _epollFd;
+    std::vector<std::unique_ptr<SimulatedNode>> _nodes;
+
+    /* Private Functions and Methods */
+    void startReport(SimulatedNode& node, int64_t now); // method to take the report's samples and send it
+    void startSession(SimulatedNode& node, int64_t now); // method to connect to the relay
+    void sendDatagram(SimulatedNode& node, int64_t now); // method to send (or send again) the report datagram
+    void onSessionEvent(SimulatedNode& node, uint32_t events, int64_t now); // method to move a relay session on
+    void onReply(SimulatedNode& node, int code, int64_t now); // method to act on one relay reply
+    void onAck(SimulatedNode& node, int64_t now); // method to read acks, finishing the report if one matches
+    void onTimeout(SimulatedNode& node, int64_t now); // method to give up on a reply, or send a datagram again
+    void queue(SimulatedNode& node, const std::string& data, int64_t now); // method to write to the relay, waiting for the replies
+    void flush(SimulatedNode& node, int64_t now); // method to write what the socket will take
+    void finish(SimulatedNode& node, ReportOutcome outcome, int64_t now); // method to count a report and schedule the next
+    void endSession(SimulatedNode& node); // method to close the relay connection
+    static bool isBusy(const SimulatedNode& node); // function to check whether a report is under way (QUIT doesn't count)
+};
+
+// Function to get a monotonic time in microseconds
+static int64_t nowUs() {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * US_PER_S + now.tv_nsec / 1000;
+}
+
+/* LoadResult Functions */
+
+// Function to get the latency below which p percent of reports were (us)
+double LoadResult::percentile(double p) const {
+  if (latenciesUs.empty()) {
+    return 0;
+  }
+  size_t rank = (size_t)ceil(p / 100.0 * latenciesUs.size());
+  return latenciesUs[std::min(latenciesUs.size(), std::max((size_t)1, rank)) - 1];
+}
+
+/* LoadGenerator Functions */
+
+// Function to get a configuration for a collector on this host with the nodes' ports
+LoadConfig LoadGenerator::defaults() {
+  LoadConfig config;
+
+  config.host = "127.0.0.1";
+  config.smtpPort = 2525;
+  config.udpPort = 5684;
+  config.nodes = 200;
+  config.threads = 2;
+  config.durationS = 10;
+  config.mode = LOAD_MIXED;
+  config.intervalMs = 1000;
+  config.timeoutMs = 2000;
+  config.samplesPerReport = SYNTHETIC_SAMPLES_PER_REPORT;
+  config.seed = 1;
+  return config;
+}
+
+// Function to run the load and gather what happened
+bool LoadGenerator::run(const LoadConfig& config, LoadResult& result, std::string& error) {
+  struct sockaddr_in smtp = {};
+  struct sockaddr_in udp = {};
+  std::vector<std::unique_ptr<LoadWorker>> workers;
+  std::vector<std::thread> threads;
+  int threadCount = std::max(1, std::min(config.threads, (int)std::max(1u, config.nodes)));
+
+  result = LoadResult();
+  smtp.sin_family = udp.sin_family = AF_INET;
+  smtp.sin_port = htons(config.smtpPort);
+  udp.sin_port = htons(config.udpPort);
+  if (inet_pton(AF_INET, config.host.c_str(), &smtp.sin_addr) != 1) {
+    error = "not an IPv4 address: " + config.host;
+    return false;
+  }
+  udp.sin_addr = smtp.sin_addr;
+
+  for (int t = 0; t < threadCount; t++) {
+    workers.emplace_back(new LoadWorker(config, smtp, udp));
+  }
+  for (uint32_t n = 0; n < config.nodes; n++) {
+    bool f_Udp = (config.mode == LOAD_UDP) || (config.mode == LOAD_MIXED && n % 2 == 1);
+    workers[(n / 2) % threadCount]->addNode(n, f_Udp); // pairs, so mixed nodes are mixed on every thread
+  }
+  for (auto& worker : workers) {
+    if (!worker->begin(error)) {
+      return false;
+    }
+  }
+
+  int64_t startUs = nowUs();
+  int64_t endUs = startUs + (int64_t)(config.durationS * US_PER_S);
+  int64_t lastFinishUs = startUs;
+  for (auto& worker : workers) {
+    threads.emplace_back(&LoadWorker::run, worker.get(), startUs, endUs);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (auto& worker : workers) {
+    const LoadResult& part = worker->result;
+    result.reports += part.reports;
+    result.failures += part.failures;
+    result.timeouts += part.timeouts;
+    result.resends += part.resends;
+    result.bytesSent += part.bytesSent;
+    result.latenciesUs.insert(result.latenciesUs.end(), part.latenciesUs.begin(), part.latenciesUs.end());
+    lastFinishUs = std::max(lastFinishUs, worker->lastFinishUs);
+  }
+  std::sort(result.latenciesUs.begin(), result.latenciesUs.end());
+  result.elapsedS = (double)(lastFinishUs - startUs) / US_PER_S;
+  return true;
+}
+
+/* LoadWorker Functions */
+
+// Constructor for nodes that report to the given addresses
+LoadWorker::LoadWorker(const LoadConfig& config, const struct sockaddr_in& smtp, const struct sockaddr_in& udp)
+  : result(),
+    lastFinishUs(0),
+    _config(config),
+    _smtp(smtp),
+    _udp(udp),
+    _epollFd(-1)
+{
+}
+
+// Destructor that closes every socket
+LoadWorker::~LoadWorker() {
+  for (auto& node : _nodes) {
+    if (node->fd >= 0) {
+      close(node->fd);
+    }
+  }
+  if (_epollFd >= 0) {
+    close(_epollFd);
+  }
+}
+
+// Method to give the worker another node
+// Nodes have been up for a few days to a month, so the record's "t" and backlog times look like a real node's
+void LoadWorker::addNode(uint32_t index, bool udp) {
+  int64_t now = time(NULL);
+  SimulatedNode* node = new SimulatedNode(index, _config.seed, now - 86400 * (1 + index % 30), udp);
+
+  node->simTime = now;
+  _nodes.emplace_back(node);
+}
+
+// Function to open the epoll instance and the telemetry sockets
+// Each UDP node has a socket of its own, so acks come back to it by its source port as they would to a real node
+bool LoadWorker::begin(std::string& error) {
+  _epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (_epollFd < 0) {
+    error = std::string("epoll: ") + strerror(errno);
+    return false;
+  }
+
+  for (auto& node : _nodes) {
+    if (!node->f_Udp) {
+      continue;
+    }
+    struct epoll_event event = {};
+    node->fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    event.events = EPOLLIN;
+    event.data.ptr = node.get();
+    if (node->fd < 0 || connect(node->fd, (struct sockaddr*)&_udp, sizeof(_udp)) < 0 ||
+        epoll_ctl(_epollFd, EPOLL_CTL_ADD, node->fd, &event) < 0) {
+      error = std::string("telemetry socket: ") + strerror(errno);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Method to send reports until endUs, then let those under way finish
+// Nodes start spread over their first interval, so they don't all arrive in the same instant
+void LoadWorker::run(int64_t startUs, int64_t endUs) {
+  struct epoll_event events[EPOLL_EVENTS];
+  int64_t intervalUs = (int64_t)_config.intervalMs * US_PER_MS;
+  int64_t timeoutUs = (int64_t)_config.timeoutMs * US_PER_MS;
+  int64_t drainUntilUs = endUs + timeoutUs * (LOAD_UDP_ATTEMPTS + 1); // every reply of a report under way has had its chance
+
+  for (size_t n = 0; n < _nodes.size(); n++) {
+    _nodes[n]->nextStartUs = startUs + (intervalUs * (int64_t)n) / (int64_t)_nodes.size();
+  }
+  lastFinishUs = startUs;
+
+  while (true) {
+    int64_t now = nowUs();
+    int64_t wakeUs = now + WAIT_MAX_MS * US_PER_MS;
+    bool f_Busy = false;
+
+    for (auto& entry : _nodes) {
+      SimulatedNode& node = *entry;
+
+      if (node.state == NODE_IDLE && now < endUs && now >= node.nextStartUs) {
+        startReport(node, now);
+      }
+      else if (node.state != NODE_IDLE && now >= node.deadlineUs) {
+        onTimeout(node, now);
+      }
+
+      if (node.state == NODE_IDLE) {
+        wakeUs = std::min(wakeUs, std::max(node.nextStartUs, now));
+      }
+      else {
+        wakeUs = std::min(wakeUs, node.deadlineUs);
+        f_Busy = f_Busy || isBusy(node);
+      }
+    }
+
+    if (now >= endUs && (!f_Busy || now >= drainUntilUs)) {
+      break;
+    }
+
+    int waitMs = (int)std::max((int64_t)0, (wakeUs - now + US_PER_MS - 1) / US_PER_MS);
+    int count = epoll_wait(_epollFd, events, EPOLL_EVENTS, waitMs);
+    now = nowUs();
+    for (int e = 0; e < count; e++) {
+      SimulatedNode& node = *(SimulatedNode*)events[e].data.ptr;
+
+      if (node.f_Udp) {
+        onAck(node, now);
+      }
+      else {
+        onSessionEvent(node, events[e].events, now);
+      }
+    }
+  }
+
+  for (auto& node : _nodes) { // anything still under way never got its reply
+    if (isBusy(*node)) {
+      finish(*node, OUTCOME_TIMED_OUT, nowUs());
+    }
+    if (!node->f_Udp) {
+      endSession(*node);
+    }
+  }
+}
+
+// Method to take the report's samples and send it
+void LoadWorker::startReport(SimulatedNode& node, int64_t now) {
+  uint32_t samples = std::max(1u, _config.samplesPerReport);
+
+  for (uint32_t s = 0; s < samples; s++) {
+    node.simTime += SAMPLE_INTERVAL_S;
+    node.model.takeSample(node.simTime);
+  }
+  bool f_Alert = node.model.getAlerts() != 0;
+  node.model.writeRecord(node.simTime, node.record);
+  node.startUs = now;
+
+  if (node.f_Udp) {
+    node.crc = Crc32::compute(node.record.data(), node.record.size());
+    node.attempts = 0;
+    sendDatagram(node, now);
+    return;
+  }
+
+  std::string email;
+  node.model.writeEmail(node.record, f_Alert, email);
+  node.message.clear();
+  for (size_t i = 0; i < email.size(); i++) { // dot stuffing, as ReportWriter does on the way out
+    if (email[i] == '.' && (i == 0 || email[i - 1] == '\n')) {
+      node.message += '.';
+    }
+    node.message += email[i];
+  }
+  node.message += "." CRLF "QUIT" CRLF; // pipelined, as the SMTP class does with its last message
+  startSession(node, now);
+}
+
+// Method to connect to the relay
+void LoadWorker::startSession(SimulatedNode& node, int64_t now) {
+  struct epoll_event event = {};
+  int on = 1;
+
+  node.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (node.fd < 0) {
+    finish(node, OUTCOME_FAILED, now);
+    return;
+  }
+  setsockopt(node.fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  if (connect(node.fd, (struct sockaddr*)&_smtp, sizeof(_smtp)) < 0 && errno != EINPROGRESS) {
+    finish(node, OUTCOME_FAILED, now);
+    return;
+  }
+
+  event.events = EPOLLIN | EPOLLOUT;
+  event.data.ptr = &node;
+  epoll_ctl(_epollFd, EPOLL_CTL_ADD, node.fd, &event);
+  node.state = NODE_CONNECTING;
+  node.in.clear();
+  node.out.clear();
+  node.outPos = 0;
+  node.f_Writing = true;
+  node.deadlineUs = now + (int64_t)_config.timeoutMs * US_PER_MS;
+}
+
+// Method to send (or send again) the report datagram
+void LoadWorker::sendDatagram(SimulatedNode& node, int64_t now) {
+  if (node.attempts > 0) {
+    result.resends++;
+  }
+  node.attempts++;
+  if (send(node.fd, node.record.data(), node.record.size(), 0) == (ssize_t)node.record.size()) {
+    result.bytesSent += node.record.size();
+  }
+  node.state = NODE_WAITING_ACK;
+  node.deadlineUs = now + (int64_t)_config.timeoutMs * US_PER_MS; // a lost send waits out its timeout like a lost ack
+}
+
+// Method to move a relay session on
+void LoadWorker::onSessionEvent(SimulatedNode& node, uint32_t events, int64_t now) {
+  char buffer[READ_BUFFER_SIZE];
+
+  if (node.fd < 0) { // closed by an earlier event in this batch
+    return;
+  }
+  if (node.state == NODE_CONNECTING) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+
+    getsockopt(node.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error != 0) {
+      finish(node, OUTCOME_FAILED, now);
+      return;
+    }
+    node.state = NODE_GREETING;
+    node.replies = 1;
+    flush(node, now); // nothing to write yet, back to waiting for input only
+  }
+  else if ((events & EPOLLOUT) && node.f_Writing) {
+    flush(node, now);
+  }
+
+  bool f_HungUp = false;
+  while (!f_HungUp && (events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+    ssize_t count = recv(node.fd, buffer, sizeof(buffer), 0);
+
+    if (count < 0 && (errno == EAGAIN || errno == EINTR)) {
+      break;
+    }
+    if (count <= 0) {
+      f_HungUp = true; // the relay closed, after the replies already read
+    }
+    else {
+      node.in.append(buffer, count);
+    }
+  }
+
+  size_t end;
+  while (node.fd >= 0 && (end = node.in.find(CRLF)) != std::string::npos) {
+    std::string line = node.in.substr(0, end);
+
+    node.in.erase(0, end + 2);
+    if (line.size() >= 4 && line[3] == '-') {
+      continue; // more lines of the same reply to come
+    }
+    onReply(node, atoi(line.substr(0, 3).c_str()), now);
+  }
+
+  if (f_HungUp) {
+    if (isBusy(node)) {
+      finish(node, OUTCOME_FAILED, now);
+    }
+    endSession(node);
+  }
+}
+
+// Method to act on one relay reply, as the SMTP class moves through its session
+void LoadWorker::onReply(SimulatedNode& node, int code, int64_t now) {
+  node.replies--;
+  switch (node.state) {
+    case NODE_GREETING:
+      if (code != 220) {
+        break;
+      }
+      node.state = NODE_EHLO;
+      node.replies = 1;
+      queue(node, "EHLO Seedling" CRLF, now);
+      return;
+    case NODE_EHLO:
+      if (code != 250) {
+        break;
+      }
+      node.state = NODE_ENVELOPE;
+      node.replies = 3;
+      queue(node, "MAIL FROM: <PLANT@MONITOR.EMAIL>" CRLF "RCPT TO: <" SYNTHETIC_RECIPIENT ">" CRLF "DATA" CRLF, now);
+      return;
+    case NODE_ENVELOPE:
+      if (code != ((node.replies == 0) ? 354 : 250)) {
+        break;
+      }
+      if (node.replies == 0) {
+        node.state = NODE_MESSAGE;
+        node.replies = 1;
+        queue(node, node.message, now);
+      }
+      return;
+    case NODE_MESSAGE:
+      if (code != 250) {
+        break;
+      }
+      finish(node, OUTCOME_DELIVERED, now);
+      node.state = NODE_QUIT; // finish() left the connection open for the 221
+      node.replies = 1;
+      node.deadlineUs = now + (int64_t)_config.timeoutMs * US_PER_MS;
+      return;
+    case NODE_QUIT:
+      endSession(node);
+      return;
+    default:
+      return;
+  }
+
+  finish(node, OUTCOME_FAILED, now); // refused
+}
+
+// Method to read acks, finishing the report if one matches
+// An ack for an earlier send of the same report matches too; any other is stale and ignored
+void LoadWorker::onAck(SimulatedNode& node, int64_t now) {
+  uint8_t ack[ACK_SIZE + 1];
+
+  while (true) {
+    ssize_t count = recv(node.fd, ack, sizeof(ack), 0);
+    if (count < 0) {
+      return; // EAGAIN, or ECONNREFUSED from the ICMP of a send nobody listened to
+    }
+    if (count != ACK_SIZE || node.state != NODE_WAITING_ACK) {
+      continue;
+    }
+    uint32_t crc = ((uint32_t)ack[0] << 24) | ((uint32_t)ack[1] << 16) | ((uint32_t)ack[2] << 8) | ack[3];
+    if (crc == node.crc) {
+      finish(node, OUTCOME_DELIVERED, now);
+    }
+  }
+}
+
+// Method to give up on a reply, or send a datagram again
+void LoadWorker::onTimeout(SimulatedNode& node, int64_t now) {
+  if (node.state == NODE_WAITING_ACK && node.attempts < LOAD_UDP_ATTEMPTS) {
+    sendDatagram(node, now);
+    return;
+  }
+  if (node.state == NODE_QUIT) { // already counted, the 221 just never came
+    endSession(node);
+    return;
+  }
+  finish(node, OUTCOME_TIMED_OUT, now);
+}
+
+// Method to write to the relay, waiting for the replies
+void LoadWorker::queue(SimulatedNode& node, const std::string& data, int64_t now) {
+  node.out.append(data);
+  node.deadlineUs = now + (int64_t)_config.timeoutMs * US_PER_MS;
+  flush(node, now);
+}
+
+// Method to write what the socket will take
+void LoadWorker::flush(SimulatedNode& node, int64_t now) {
+  while (node.outPos < node.out.size()) {
+    ssize_t count = send(node.fd, node.out.data() + node.outPos, node.out.size() - node.outPos, MSG_NOSIGNAL);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN) {
+        finish(node, OUTCOME_FAILED, now);
+        return;
+      }
+      break;
+    }
+    result.bytesSent += count;
+    node.outPos += count;
+  }
+
+  bool f_Writing = node.outPos < node.out.size();
+  if (f_Writing != node.f_Writing) {
+    struct epoll_event event = {};
+    event.events = f_Writing ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    event.data.ptr = &node;
+    epoll_ctl(_epollFd, EPOLL_CTL_MOD, node.fd, &event);
+    node.f_Writing = f_Writing;
+  }
+  if (!f_Writing) {
+    node.out.clear();
+    node.outPos = 0;
+  }
+}
+
+// Method to count a report and schedule the next
+// A failed or timed out session is closed; a delivered one is left for the caller to see through QUIT
+void LoadWorker::finish(SimulatedNode& node, ReportOutcome outcome, int64_t now) {
+  int64_t intervalUs = (int64_t)_config.intervalMs * US_PER_MS;
+
+  switch (outcome) {
+    case OUTCOME_DELIVERED:
+      result.reports++;
+      result.latenciesUs.push_back((uint32_t)std::min(now - node.startUs, (int64_t)UINT32_MAX));
+      break;
+    case OUTCOME_FAILED:
+      result.failures++;
+      break;
+    case OUTCOME_TIMED_OUT:
+      result.timeouts++;
+      break;
+  }
+  lastFinishUs = std::max(lastFinishUs, now);
+  node.nextStartUs = std::max(now, node.startUs + intervalUs);
+  node.state = NODE_IDLE;
+  if (outcome != OUTCOME_DELIVERED && !node.f_Udp) {
+    endSession(node);
+  }
+}
+
+// Method to close the relay connection
+void LoadWorker::endSession(SimulatedNode& node) {
+  if (node.fd >= 0) {
+    epoll_ctl(_epollFd, EPOLL_CTL_DEL, node.fd, NULL);
+    close(node.fd);
+    node.fd = -1;
+  }
+  node.state = NODE_IDLE;
+  node.f_Writing = false;
+}
+
+// Function to check whether a report is under way (QUIT doesn't count)
+bool LoadWorker::isBusy(const SimulatedNode& node) {
+  return node.state != NODE_IDLE && node.state != NODE_QUIT;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,67 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef LoadGenerator_h
+#define LoadGenerator_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* Definitions */
+#define LOAD_UDP_ATTEMPTS 3 // sends of a datagram before it counts as lost (UDPTelemetry's retries)
+
+/* How the simulated nodes send their reports */
+enum LoadMode {
+	LOAD_SMTP, // every node through the relay
+	LOAD_UDP, // every node by datagram
+	LOAD_MIXED // half of each
+};
+
+/* How the load is set up */
+struct LoadConfig {
+	std::string host; // collector's IPv4 address
+	uint16_t smtpPort; // its relay port
+	uint16_t udpPort; // its telemetry port
+	uint32_t nodes; // simulated nodes
+	int threads; // threads to spread them over
+	double durationS; // how long new reports are started for
+	LoadMode mode;
+	uint32_t intervalMs; // time from the start of one of a node's reports to the start of its next (0 = back to back)
+	uint32_t timeoutMs; // wait for a reply (for an ack, per attempt)
+	uint32_t samplesPerReport; // samples in each record (more than SYNTHETIC_SAMPLES_PER_REPORT go as backlog)
+	uint32_t seed; // for the nodes' readings
+};
+
+/* What the load did */
+struct LoadResult {
+	uint64_t reports; // delivered (250 after the message, or a matching ack)
+	uint64_t failures; // refused or connection lost
+	uint64_t timeouts; // no reply in time (a datagram after every attempt)
+	uint64_t resends; // datagrams sent again after a missing ack
+	uint64_t bytesSent;
+	double elapsedS; // from the first report started to the last finished
+	std::vector<uint32_t> latenciesUs; // of each delivered report, from its start to the 250 or ack, sorted
+
+	double percentile(double p) const; // function to get the latency below which p percent of reports were (us)
+};
+
+/* LoadGenerator class definition */
+// Plays a crowd of nodes against a collector: each has its own synthetic plant, and sends a report every interval
+// either as the SMTP class does through a relay (EHLO, then MAIL FROM, RCPT TO and DATA pipelined, the message and
+// QUIT together) or as UDPTelemetry does (a datagram, sent again until its CRC comes back). Every thread drives its
+// share of the nodes as non-blocking state machines on one epoll instance, so a few threads can hold hundreds of
+// nodes mid-report at once.
+class LoadGenerator {
+	public:
+		/* Public Functions and Methods */
+		static LoadConfig defaults(); // function to get a configuration for a collector on this host with the nodes' ports
+		static bool run(const LoadConfig& config, LoadResult& result, std::string& error); // function to run the load and gather what happened
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,143 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "MailMessage.h"
+#include <algorithm>
+#include <array>
+#include <ctype.h>
+#include <string.h>
+
+/* Definitions */
+#define CRLF "\r\n"
+#define SUBJECT_HEADER "Subject:"
+#define ALERT_SUBJECT "Plant Alert!" // SMTP_ALERT_SUBJECT_LINE in the sketch
+#define RECORD_CONTENT_TYPE "Content-Type: application/cbor"
+#define PART_DELIMITER "--"
+#define BASE64_PAD '='
+#define BASE64_INVALID 0xFF
+
+/* Constants */
+// Value of every base64 character, BASE64_INVALID for the rest, built at compile time
+static constexpr std::array<uint8_t, 256> makeBase64Values() {
+  const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::array<uint8_t, 256> values = {};
+
+  for (int c = 0; c < 256; c++) {
+    values[c] = BASE64_INVALID;
+  }
+  for (int i = 0; i < 64; i++) {
+    values[(uint8_t)alphabet[i]] = i;
+  }
+  return values;
+}
+
+static constexpr std::array<uint8_t, 256> _BASE64_VALUES = makeBase64Values();
+
+/* Functions */
+
+// Function to decode the record attached to a message, the base64 body of its application/cbor part
+bool MailMessage::findRecord(const std::string& message, std::vector<uint8_t>& record) {
+  size_t pos = 0;
+  size_t bodyStart = std::string::npos; // where the record's base64 starts
+  bool f_InRecordPart = false; // inside the record part's headers
+
+  record.clear();
+  while (pos < message.size()) {
+    size_t end = message.find(CRLF, pos);
+    if (end == std::string::npos) {
+      end = message.size();
+    }
+
+    if (bodyStart != std::string::npos) {
+      if (startsWith(message, pos, PART_DELIMITER)) { // next part, or the end of the message
+        break;
+      }
+    }
+    else if (f_InRecordPart) {
+      if (end == pos) { // part headers end with an empty line
+        bodyStart = end + 2;
+      }
+    }
+    else {
+      f_InRecordPart = startsWith(message, pos, RECORD_CONTENT_TYPE);
+    }
+    pos = end + 2;
+  }
+
+  if (bodyStart == std::string::npos || bodyStart >= message.size()) {
+    return false;
+  }
+  // Decoded in one go, line breaks can fall anywhere in the encoding
+  return decodeBase64(message.data() + bodyStart, std::min(pos, message.size()) - bodyStart, record) && !record.empty();
+}
+
+// Function to check whether the subject marks the report as an alert
+bool MailMessage::isAlert(const std::string& message) {
+  size_t pos = 0;
+
+  while (pos < message.size()) {
+    size_t end = message.find(CRLF, pos);
+    if (end == std::string::npos || end == pos) { // headers end at the first empty line
+      return false;
+    }
+    if (startsWith(message, pos, SUBJECT_HEADER)) {
+      return message.compare(pos, end - pos, SUBJECT_HEADER " " ALERT_SUBJECT) == 0;
+    }
+    pos = end + 2;
+  }
+  return false;
+}
+
+// Function to append the bytes a run of base64 text decodes to, skipping whitespace; false on anything else
+bool MailMessage::decodeBase64(const char* text, size_t length, std::vector<uint8_t>& out) {
+  uint32_t bits = 0;
+  int count = 0;
+  bool f_Padded = false;
+
+  for (size_t i = 0; i < length; i++) {
+    uint8_t c = text[i];
+    if (isspace(c)) {
+      continue;
+    }
+    if (c == BASE64_PAD) {
+      f_Padded = true;
+      continue;
+    }
+    if (f_Padded || _BASE64_VALUES[c] == BASE64_INVALID) { // nothing may follow the padding
+      return false;
+    }
+
+    bits = (bits << 6) | _BASE64_VALUES[c];
+    if (++count == 4) {
+      out.push_back(bits >> 16);
+      out.push_back(bits >> 8);
+      out.push_back(bits);
+      bits = 0;
+      count = 0;
+    }
+  }
+
+  if (count == 1) { // a single character can't make a byte
+    return false;
+  }
+  if (count == 2) {
+    out.push_back(bits >> 4);
+  }
+  else if (count == 3) {
+    out.push_back(bits >> 10);
+    out.push_back(bits >> 2);
+  }
+  return true;
+}
+
+// Function to compare the start of the line at pos with prefix, ignoring case
+bool MailMessage::startsWith(const std::string& message, size_t pos, const char* prefix) {
+  size_t length = strlen(prefix);
+
+  return message.size() - pos >= length && strncasecmp(message.data() + pos, prefix, length) == 0;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
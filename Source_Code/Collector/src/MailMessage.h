@@ -0,0 +1,32 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef MailMessage_h
+#define MailMessage_h
+
+// Include the necessary libraries
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* MailMessage class definition */
+// Reads what the collector needs out of a report emailed through its relay: the subject (alerts go out at once
+// under their own subject) and the CBOR record the node attaches as a base64 application/cbor part after the
+// HTML report, the same record a UDP report carries.
+class MailMessage {
+	public:
+		/* Public Functions and Methods */
+		static bool findRecord(const std::string& message, std::vector<uint8_t>& record); // function to decode the attached record (false if there is none)
+		static bool isAlert(const std::string& message); // function to check whether the subject marks the report as an alert
+		static bool decodeBase64(const char* text, size_t length, std::vector<uint8_t>& out); // function to append decoded base64 (whitespace skipped)
+	private:
+		/* Private Functions and Methods */
+		static bool startsWith(const std::string& message, size_t pos, const char* prefix); // function to compare the start of a line, ignoring case
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
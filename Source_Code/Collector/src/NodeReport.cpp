@@ -0,0 +1,145 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "NodeReport.h"
+#include "CborReader.h"
+#include <string.h>
+
+/* Definitions */
+#define KEY_SIZE 8 // longest map key read, the record's keys are one or two letters
+
+/* Functions */
+
+// Function to decode a record that arrived at arrivedAt, returns false if it is malformed
+// Sample i was taken ages[i] seconds before the node sent the report; a backlog reading carries the node's seconds
+// since power up, which only places it in time if the node hasn't lost power since (it is then later than "t").
+// Every item takes at least a byte, so an array said to hold more items than there are bytes left is refused before
+// anything is sized from it: the count comes off the network, from anyone.
+bool NodeReport::parse(const uint8_t* data, size_t size, int64_t arrivedAt) {
+  CborReader record(data, size);
+  std::vector<uint32_t> ages;
+  std::vector<uint32_t> backlogTimes;
+  size_t samples = 0;
+  uint32_t pairs, count;
+  char key[KEY_SIZE];
+
+  id[0] = '\0';
+  nodeTime = 0;
+  receivedAt = arrivedAt;
+  alerts = 0;
+  sensorCount = 0;
+  readings.clear();
+
+  if (!record.readMap(pairs) || pairs == CBOR_READER_INDEFINITE) {
+    return false;
+  }
+
+  for (uint32_t p = 0; p < pairs; p++) {
+    if (!record.readText(key, sizeof(key))) {
+      if (!record.skip() || !record.skip()) { // a key this collector can't hold is someone else's, step over it
+        return false;
+      }
+      continue;
+    }
+
+    if (strcmp(key, "id") == 0) {
+      if (!record.readText(id, sizeof(id))) {
+        return false;
+      }
+    }
+    else if (strcmp(key, "t") == 0) {
+      if (!record.readUInt(nodeTime)) {
+        return false;
+      }
+    }
+    else if (strcmp(key, "al") == 0) {
+      uint32_t flags;
+      if (!record.readUInt(flags) || flags > UINT8_MAX) {
+        return false;
+      }
+      alerts = flags;
+    }
+    else if (strcmp(key, "a") == 0) {
+      if (!record.readArray(count) || count == CBOR_READER_INDEFINITE || count > size - record.getPosition()) {
+        return false;
+      }
+      ages.resize(count);
+      for (uint32_t i = 0; i < count; i++) {
+        if (!record.readUInt(ages[i])) {
+          return false;
+        }
+      }
+    }
+    else if (strcmp(key, "s") == 0 || strcmp(key, "b") == 0) {
+      bool f_Backlog = (key[0] == 'b');
+      if (!record.readArray(count) || (count != CBOR_READER_INDEFINITE && count > size - record.getPosition())) {
+        return false;
+      }
+      for (uint32_t i = 0; (count == CBOR_READER_INDEFINITE) ? !record.readBreak() : (i < count); i++) {
+        uint32_t length, time = 0;
+        Reading reading = {};
+
+        if (!record.readArray(length) || length == CBOR_READER_INDEFINITE || (f_Backlog && length == 0)) {
+          return false;
+        }
+        if (f_Backlog) {
+          if (!record.readUInt(time)) {
+            return false;
+          }
+          length--;
+          backlogTimes.push_back(time);
+        }
+        if (!readValues(record, length, reading.values)) {
+          return false;
+        }
+        if (f_Backlog) {
+          readings.push_back(reading); // after the samples, placed in time below
+        }
+        else {
+          readings.insert(readings.begin() + samples++, reading);
+        }
+      }
+    }
+    else if (!record.skip()) {
+      return false;
+    }
+  }
+
+  if (id[0] == '\0' || !record.atEnd() || (ages.size() != samples && !ages.empty())) {
+    return false;
+  }
+
+  // Place every reading on the collector's clock
+  for (size_t s = 0; s < samples; s++) {
+    readings[s].time = receivedAt - (ages.empty() ? 0 : ages[s]);
+  }
+  for (size_t b = 0; b < backlogTimes.size(); b++) {
+    readings[samples + b].time = (backlogTimes[b] <= nodeTime) ? receivedAt - (nodeTime - backlogTimes[b]) : REPORT_TIME_UNKNOWN;
+  }
+  return true;
+}
+
+// Function to read count readings of a sample, every sample of a report must have as many
+bool NodeReport::readValues(CborReader& record, uint32_t count, float* values) {
+  if (count == 0 || count > REPORT_SENSORS_MAX || (sensorCount != 0 && count != sensorCount)) {
+    return false;
+  }
+  sensorCount = count;
+
+  for (uint32_t v = 0; v < count; v++) {
+    int32_t whole;
+    if (record.readFloat(values[v])) {
+      continue;
+    }
+    if (!record.readInt(whole)) { // CborWriter always writes floats, but a reading that happens to be whole is fine too
+      return false;
+    }
+    values[v] = whole;
+  }
+  return true;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
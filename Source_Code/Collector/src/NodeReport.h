@@ -0,0 +1,61 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef NodeReport_h
+#define NodeReport_h
+
+// Include the necessary libraries
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class CborReader;
+
+/* Definitions */
+#define REPORT_ID_SIZE 33 // longest node hostname plus terminator (CONFIG_HOSTNAME_SIZE on the node)
+#define REPORT_SENSORS_MAX 8 // readings a sample can carry (the node keeps its alert flags in 8 bits)
+#define REPORT_TIME_UNKNOWN 0 // reading taken before the node last lost power, its time can't be worked out
+
+/* Sensors in the order the nodes list them (NodeSensors) */
+enum ReportSensor {
+	SENSOR_LIGHT, // lux
+	SENSOR_TEMPERATURE, // ºF
+	SENSOR_MOISTURE, // %
+	SENSOR_BATTERY, // V
+	SENSOR_KNOWN_COUNT // sensors the stock firmware has (not a sensor)
+};
+
+/* One set of readings */
+struct Reading {
+	int64_t time; // Unix time it was taken (REPORT_TIME_UNKNOWN if it can't be known)
+	float values[REPORT_SENSORS_MAX]; // in sensor order
+};
+
+/* NodeReport class definition */
+// A node's report record as writeReportRecord() in the sketch builds it, one CBOR map:
+//   { "id": hostname, "t": seconds since power up, "al": alert flags, "a": [ sample ages ], "s": [ [reading, ...] ],
+//     "b": [ [seconds since power up, reading, ...] ] }
+// with the samples and the backlog turned into readings on the collector's clock. Unknown keys are skipped, so
+// a newer node can add to the record without breaking older collectors.
+class NodeReport {
+	public:
+		/* Public Instance Variables */
+		char id[REPORT_ID_SIZE]; // node's hostname
+		uint32_t nodeTime; // node's seconds since power up when it sent the report
+		int64_t receivedAt; // Unix time the report arrived
+		uint8_t alerts; // bit i set if reading i of the newest sample was outside its thresholds
+		uint8_t sensorCount; // readings in each sample
+		std::vector<Reading> readings; // the samples, then the backlog, each oldest first
+
+		/* Public Functions and Methods */
+		bool parse(const uint8_t* data, size_t size, int64_t arrivedAt); // function to decode a record that arrived at arrivedAt (Unix time)
+	private:
+		/* Private Functions and Methods */
+		bool readValues(CborReader& record, uint32_t count, float* values); // function to read count readings of a sample
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,148 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "NodeTable.h"
+#include <algorithm>
+#include <functional>
+
+/* Constructors */
+// Constructor for an empty table
+NodeTable::NodeTable()
+  : _shards(new Shard[NODE_TABLE_SHARDS])
+{
+}
+
+/* Functions */
+
+// Function to add a report to its node, every reading to the sensor totals
+bool NodeTable::handleReport(const NodeReport& report, ReportVia via, bool alert) {
+  std::string id(report.id);
+  Shard& shard = shardFor(id);
+  std::lock_guard<std::mutex> guard(shard.lock);
+  auto found = shard.nodes.find(id);
+
+  if (found == shard.nodes.end()) {
+    NodeTotals fresh = {};
+    fresh.id = id;
+    fresh.firstSeen = INT64_MAX;
+    for (SensorTotals& sensor : fresh.sensors) {
+      sensor.lastTime = INT64_MIN;
+    }
+    found = shard.nodes.emplace(id, fresh).first;
+  }
+
+  NodeTotals& node = found->second;
+
+  node.reports[via]++;
+  node.alertReports += alert ? 1 : 0;
+  node.alerts = report.alerts;
+  node.firstSeen = std::min(node.firstSeen, report.receivedAt);
+  node.lastSeen = std::max(node.lastSeen, report.receivedAt);
+  node.sensorCount = std::max(node.sensorCount, report.sensorCount);
+
+  for (const Reading& reading : report.readings) {
+    node.readings++;
+    node.untimed += (reading.time == REPORT_TIME_UNKNOWN) ? 1 : 0;
+
+    for (int v = 0; v < report.sensorCount; v++) {
+      SensorTotals& sensor = node.sensors[v];
+      float value = reading.values[v];
+
+      sensor.min = (sensor.count == 0) ? value : std::min(sensor.min, value);
+      sensor.max = (sensor.count == 0) ? value : std::max(sensor.max, value);
+      sensor.sum += value;
+      sensor.count++;
+      if (reading.time >= sensor.lastTime) {
+        sensor.last = value;
+        sensor.lastTime = reading.time;
+      }
+    }
+  }
+  return true;
+}
+
+// Function to get every node's totals, sorted by name, and start a new period
+std::vector<NodeTotals> NodeTable::take() {
+  std::vector<NodeTotals> totals;
+
+  for (int s = 0; s < NODE_TABLE_SHARDS; s++) {
+    std::unordered_map<std::string, NodeTotals> nodes;
+    {
+      std::lock_guard<std::mutex> guard(_shards[s].lock);
+      nodes.swap(_shards[s].nodes);
+    }
+    for (auto& entry : nodes) {
+      totals.push_back(std::move(entry.second));
+    }
+  }
+
+  std::sort(totals.begin(), totals.end(), [](const NodeTotals& a, const NodeTotals& b) { return a.id < b.id; });
+  return totals;
+}
+
+// Method to put back totals whose digest couldn't be sent, so the next digest covers both periods
+void NodeTable::merge(const std::vector<NodeTotals>& totals) {
+  for (const NodeTotals& node : totals) {
+    Shard& shard = shardFor(node.id);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto found = shard.nodes.find(node.id);
+
+    if (found == shard.nodes.end()) {
+      shard.nodes.emplace(node.id, node);
+    }
+    else {
+      combine(found->second, node);
+    }
+  }
+}
+
+// Function to get the number of nodes heard from this period
+size_t NodeTable::size() {
+  size_t count = 0;
+
+  for (int s = 0; s < NODE_TABLE_SHARDS; s++) {
+    std::lock_guard<std::mutex> guard(_shards[s].lock);
+    count += _shards[s].nodes.size();
+  }
+  return count;
+}
+
+// Function to get the part of the table a node is kept in
+NodeTable::Shard& NodeTable::shardFor(const std::string& id) {
+  return _shards[std::hash<std::string>()(id) % NODE_TABLE_SHARDS];
+}
+
+// Method to add an older period's totals (from) to a newer one (into)
+void NodeTable::combine(NodeTotals& into, const NodeTotals& from) {
+  for (int v = 0; v < VIA_COUNT; v++) {
+    into.reports[v] += from.reports[v];
+  }
+  into.alertReports += from.alertReports;
+  into.readings += from.readings;
+  into.untimed += from.untimed;
+  into.firstSeen = std::min(into.firstSeen, from.firstSeen);
+  into.lastSeen = std::max(into.lastSeen, from.lastSeen);
+  into.sensorCount = std::max(into.sensorCount, from.sensorCount);
+
+  for (int v = 0; v < REPORT_SENSORS_MAX; v++) {
+    SensorTotals& sensor = into.sensors[v];
+    const SensorTotals& older = from.sensors[v];
+
+    if (older.count == 0) {
+      continue;
+    }
+    sensor.min = (sensor.count == 0) ? older.min : std::min(sensor.min, older.min);
+    sensor.max = (sensor.count == 0) ? older.max : std::max(sensor.max, older.max);
+    sensor.sum += older.sum;
+    sensor.count += older.count;
+    if (older.lastTime > sensor.lastTime) {
+      sensor.last = older.last;
+      sensor.lastTime = older.lastTime;
+    }
+  }
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,72 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef NodeTable_h
+#define NodeTable_h
+
+// Include the necessary libraries
+#include "ReportHandler.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Definitions */
+#define NODE_TABLE_SHARDS 64 // independently locked parts of the table, so workers rarely wait on each other
+
+/* One sensor's readings over a digest period */
+struct SensorTotals {
+	uint32_t count; // readings
+	float min;
+	float max;
+	double sum; // for the mean
+	float last; // newest reading
+	int64_t lastTime; // when it was taken (REPORT_TIME_UNKNOWN if no reading had a known time)
+};
+
+/* One node over a digest period */
+struct NodeTotals {
+	std::string id; // node's hostname
+	uint32_t reports[VIA_COUNT]; // reports taken, by transport
+	uint32_t alertReports; // reports sent as alerts
+	uint8_t alerts; // alert flags of the newest report
+	uint32_t readings; // readings taken, samples and backlog
+	uint32_t untimed; // of those, taken before a power loss (time unknown)
+	int64_t firstSeen; // Unix time of the first report in the period
+	int64_t lastSeen; // and of the last
+	uint8_t sensorCount; // readings in each sample
+	SensorTotals sensors[REPORT_SENSORS_MAX];
+};
+
+/* NodeTable class definition */
+// Every node's reports added up since the last digest. Nodes are spread over NODE_TABLE_SHARDS separately locked
+// maps by a hash of their name, so reports arriving on different worker threads don't queue on one lock.
+class NodeTable : public ReportHandler {
+	public:
+		/* Constructors */
+		NodeTable(); // constructor for an empty table
+
+		/* Public Functions and Methods */
+		bool handleReport(const NodeReport& report, ReportVia via, bool alert) override; // function to add a report to its node
+		std::vector<NodeTotals> take(); // function to get every node's totals, sorted by name, and start a new period
+		void merge(const std::vector<NodeTotals>& totals); // method to put back totals whose digest couldn't be sent
+		size_t size(); // function to get the number of nodes heard from this period
+	private:
+		/* Private Instance Variables */
+		struct Shard {
+			std::mutex lock;
+			std::unordered_map<std::string, NodeTotals> nodes;
+		};
+		std::unique_ptr<Shard[]> _shards;
+
+		/* Private Functions and Methods */
+		Shard& shardFor(const std::string& id); // function to get the part of the table a node is kept in
+		static void combine(NodeTotals& into, const NodeTotals& from); // method to add one period's totals to another
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
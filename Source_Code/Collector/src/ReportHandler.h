@@ -0,0 +1,32 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef ReportHandler_h
+#define ReportHandler_h
+
+// Include the necessary libraries
+#include "NodeReport.h"
+#include "SmtpSession.h"
+
+/* How a report reached the collector */
+enum ReportVia {
+	VIA_SMTP, // emailed through the relay
+	VIA_UDP, // CBOR datagram
+	VIA_COUNT // number of transports (not a transport)
+};
+
+/* ReportHandler class definition */
+// What the collector does with what the nodes send. Called from every worker thread at once, so implementations
+// have to do their own locking.
+class ReportHandler {
+	public:
+		virtual ~ReportHandler() { }
+		virtual bool handleReport(const NodeReport& report, ReportVia via, bool alert) = 0; // function to take a report (false = not kept, a datagram goes unacknowledged)
+		virtual void handleOtherMail(const RelayedMessage& message) { (void)message; } // method to take mail that carries no report record
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,576 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Server.h"
+#include "Crc32.h"
+#include "MailMessage.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <exception>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <unordered_map>
+
+/* Definitions */
+#define EPOLL_EVENTS 64 // events taken from epoll_wait() at a time
+#define SWEEP_INTERVAL_MS 1000 // how often idle connections are looked for
+#define READ_BUFFER_SIZE 16384 // bytes read from a connection at a time
+#define DATAGRAM_BATCH 32 // datagrams read and acknowledged per system call
+#define DATAGRAM_SIZE_MAX 2048 // largest report datagram taken, the nodes keep theirs inside one Ethernet frame
+#define UDP_RECEIVE_BUFFER (1024 * 1024) // socket buffer for bursts of reports while a worker is busy
+#define ACK_SIZE 4 // CRC-32 of the datagram, most significant byte first
+
+/* Counters every worker adds to */
+struct ServerCounters {
+  std::atomic<uint64_t> connections{0};
+  std::atomic<uint64_t> messages{0};
+  std::atomic<uint64_t> reports[VIA_COUNT] = {};
+  std::atomic<uint64_t> datagrams{0};
+  std::atomic<uint64_t> acks{0};
+  std::atomic<uint64_t> malformed{0};
+  std::atomic<uint64_t> otherMail{0};
+  std::atomic<uint64_t> timeouts{0};
+  std::atomic<uint64_t> bytesIn{0};
+};
+
+/* ServerWorker class definition */
+// One worker thread's share of the server: its own relay and telemetry sockets, every relay connection the kernel
+// handed to it, and the epoll instance that waits on all of them. Nothing here is touched by another thread
+// except stop(), which only writes to the eventfd.
+class ServerWorker : public MessageSink {
+  public:
+    /* Constructors */
+    ServerWorker(ReportHandler& handler, ServerCounters& counters, const ServerConfig& config, int listenFd, int udpFd); // constructor that takes ownership of the sockets
+    ~ServerWorker(); // destructor that closes every socket
+
+    /* Public Functions and Methods */
+    bool begin(std::string& error); // function to set up the epoll instance
+    void run(); // method to serve the sockets until stop() is called
+    void stop(); // method to wake the worker and have run() return
+    bool deliver(const RelayedMessage& message) override; // function to take a message from a relay session
+  private:
+    /* One relay connection */
+    struct Connection {
+      int fd;
+      SmtpSession session;
+      std::string out; // replies not yet written
+      size_t outPos; // how much of out has been written
+      time_t lastActive; // when the client last sent anything
+      bool f_Writing; // waiting for EPOLLOUT
+
+      Connection(int socket, MessageSink& sink, const char* hostname)
+        : fd(socket), session(sink, hostname), outPos(0), lastActive(time(NULL)), f_Writing(false) { }
+    };
+
+    /* Private Instance Variables */
+    ReportHandler& _handler;
+    ServerCounters& _counters;
+    ServerConfig _config;
+    int _listenFd;
+    int _udpFd;
+    int _epollFd;
+    int _stopFd;
+    std::unordered_map<int, std::unique_ptr<Connection>> _connections;
+
+    /* Private Functions and Methods */
+    void acceptConnections(); // method to take every connection waiting on the listen socket
+    void readConnection(Connection& connection); // method to read what a client has sent and queue the replies
+    void writeConnection(Connection& connection); // method to write queued replies, closing the connection after QUIT
+    void closeConnection(Connection& connection); // method to close and forget a connection
+    void receiveDatagrams(); // method to read, handle and acknowledge the datagrams waiting
+    void closeIdle(); // method to close connections that have gone quiet
+    bool readRecord(const uint8_t* data, size_t size, NodeReport& report); // function to decode a record, counting it if malformed
+    bool keepReport(const NodeReport& report, ReportVia via, bool alert); // function to hand a report on (false if it wasn't kept)
+};
+
+/* Server Functions */
+
+// Constructor that hands reports to handler
+Server::Server(ReportHandler& handler)
+  : _handler(handler),
+    _counters(new ServerCounters()),
+    _smtpPort(0),
+    _udpPort(0)
+{
+}
+
+// Destructor that stops the workers
+Server::~Server() {
+  stop();
+}
+
+// Function to get the configuration the nodes' defaults expect
+ServerConfig Server::defaults() {
+  ServerConfig config;
+
+  config.bindAddress = "0.0.0.0";
+  config.smtpPort = SERVER_SMTP_PORT;
+  config.udpPort = SERVER_UDP_PORT;
+  config.threads = 0;
+  config.idleTimeoutS = SERVER_IDLE_TIMEOUT_S;
+  config.hostname = "collector";
+  return config;
+}
+
+// Function to open a non-blocking socket bound to address:port, shared with the other workers
+static int openSocket(int type, const std::string& address, uint16_t port, std::string& error) {
+  struct sockaddr_in local = {};
+  int on = 1;
+  int fd = socket(AF_INET, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+  if (fd < 0) {
+    error = std::string("socket: ") + strerror(errno);
+    return -1;
+  }
+
+  local.sin_family = AF_INET;
+  local.sin_port = htons(port);
+  if (inet_pton(AF_INET, address.c_str(), &local.sin_addr) != 1) {
+    error = "not an IPv4 address: " + address;
+    close(fd);
+    return -1;
+  }
+
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0 ||
+      bind(fd, (struct sockaddr*)&local, sizeof(local)) < 0 ||
+      (type == SOCK_STREAM && listen(fd, SOMAXCONN) < 0)) {
+    error = std::string((type == SOCK_STREAM) ? "relay port " : "telemetry port ") + std::to_string(port) + ": " + strerror(errno);
+    close(fd);
+    return -1;
+  }
+
+  if (type == SOCK_DGRAM) {
+    int size = UDP_RECEIVE_BUFFER;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  }
+  return fd;
+}
+
+// Function to get the port a socket ended up bound to
+static uint16_t boundPort(int fd) {
+  struct sockaddr_in local = {};
+  socklen_t length = sizeof(local);
+
+  getsockname(fd, (struct sockaddr*)&local, &length);
+  return ntohs(local.sin_port);
+}
+
+// Function to open the sockets and start the workers
+// The first worker's sockets settle a port left at 0, the rest bind to the same one
+bool Server::start(const ServerConfig& config, std::string& error) {
+  ServerConfig shared = config;
+  int threads = (config.threads > 0) ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+
+  stop();
+  for (int t = 0; t < threads; t++) {
+    int listenFd = openSocket(SOCK_STREAM, shared.bindAddress, shared.smtpPort, error);
+    int udpFd = (listenFd < 0) ? -1 : openSocket(SOCK_DGRAM, shared.bindAddress, shared.udpPort, error);
+
+    if (udpFd < 0) {
+      if (listenFd >= 0) {
+        close(listenFd);
+      }
+      _workers.clear();
+      return false;
+    }
+    shared.smtpPort = boundPort(listenFd);
+    shared.udpPort = boundPort(udpFd);
+
+    _workers.emplace_back(new ServerWorker(_handler, *_counters, shared, listenFd, udpFd));
+    if (!_workers.back()->begin(error)) {
+      _workers.clear();
+      return false;
+    }
+  }
+
+  _smtpPort = shared.smtpPort;
+  _udpPort = shared.udpPort;
+  for (auto& worker : _workers) {
+    _threads.emplace_back(&ServerWorker::run, worker.get());
+  }
+  return true;
+}
+
+// Method to close every connection and stop the workers
+void Server::stop() {
+  for (auto& worker : _workers) {
+    worker->stop();
+  }
+  for (std::thread& thread : _threads) {
+    thread.join();
+  }
+  _threads.clear();
+  _workers.clear();
+}
+
+// Function to get the relay port listened on
+uint16_t Server::getSmtpPort() {
+  return _smtpPort;
+}
+
+// Function to get the telemetry port listened on
+uint16_t Server::getUdpPort() {
+  return _udpPort;
+}
+
+// Function to get what has been handled so far
+ServerStats Server::getStats() {
+  ServerStats stats = {};
+
+  stats.connections = _counters->connections;
+  stats.messages = _counters->messages;
+  for (int v = 0; v < VIA_COUNT; v++) {
+    stats.reports[v] = _counters->reports[v];
+  }
+  stats.datagrams = _counters->datagrams;
+  stats.acks = _counters->acks;
+  stats.malformed = _counters->malformed;
+  stats.otherMail = _counters->otherMail;
+  stats.timeouts = _counters->timeouts;
+  stats.bytesIn = _counters->bytesIn;
+  return stats;
+}
+
+/* ServerWorker Functions */
+
+// Constructor that takes ownership of the sockets
+ServerWorker::ServerWorker(ReportHandler& handler, ServerCounters& counters, const ServerConfig& config, int listenFd, int udpFd)
+  : _handler(handler),
+    _counters(counters),
+    _config(config),
+    _listenFd(listenFd),
+    _udpFd(udpFd),
+    _epollFd(-1),
+    _stopFd(-1)
+{
+}
+
+// Destructor that closes every socket
+ServerWorker::~ServerWorker() {
+  for (auto& entry : _connections) {
+    close(entry.first);
+  }
+  for (int fd : {_listenFd, _udpFd, _epollFd, _stopFd}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+// Function to set up the epoll instance
+// The listen and telemetry sockets are level triggered, so whatever one pass leaves behind wakes the next
+bool ServerWorker::begin(std::string& error) {
+  struct epoll_event event = {};
+
+  _epollFd = epoll_create1(EPOLL_CLOEXEC);
+  _stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (_epollFd < 0 || _stopFd < 0) {
+    error = std::string("epoll: ") + strerror(errno);
+    return false;
+  }
+
+  event.events = EPOLLIN;
+  for (int fd : {_listenFd, _udpFd, _stopFd}) {
+    event.data.fd = fd;
+    if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+      error = std::string("epoll_ctl: ") + strerror(errno);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Method to serve the sockets until stop() is called
+void ServerWorker::run() {
+  struct epoll_event events[EPOLL_EVENTS];
+  bool f_Stopping = false;
+  time_t lastSweep = time(NULL);
+
+  while (!f_Stopping) {
+    int count = epoll_wait(_epollFd, events, EPOLL_EVENTS, SWEEP_INTERVAL_MS);
+
+    for (int e = 0; e < count; e++) {
+      int fd = events[e].data.fd;
+
+      if (fd == _stopFd) {
+        f_Stopping = true;
+      }
+      else if (fd == _listenFd) {
+        acceptConnections();
+      }
+      else if (fd == _udpFd) {
+        receiveDatagrams();
+      }
+      else {
+        auto found = _connections.find(fd);
+        if (found == _connections.end()) { // closed by an earlier event in this batch
+          continue;
+        }
+        Connection& connection = *found->second;
+        if (events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+          readConnection(connection); // a hang up or error shows up as a failed read
+        }
+        else if (events[e].events & EPOLLOUT) {
+          writeConnection(connection);
+        }
+      }
+    }
+
+    if (time(NULL) != lastSweep) {
+      lastSweep = time(NULL);
+      closeIdle();
+    }
+  }
+}
+
+// Method to wake the worker and have run() return
+void ServerWorker::stop() {
+  uint64_t one = 1;
+  ssize_t written = write(_stopFd, &one, sizeof(one)); // can only fail if the counter is near overflow
+
+  (void)written;
+}
+
+// Method to take every connection waiting on the listen socket
+void ServerWorker::acceptConnections() {
+  int on = 1;
+
+  while (true) {
+    int fd = accept4(_listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      return; // EAGAIN, or another worker took it
+    }
+
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // replies are a line or two, don't hold them back
+    if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+      close(fd);
+      continue;
+    }
+
+    Connection* connection = new Connection(fd, *this, _config.hostname.c_str());
+    _connections[fd].reset(connection);
+    _counters.connections++;
+    connection->session.greet(connection->out);
+    writeConnection(*connection);
+  }
+}
+
+// Method to read what a client has sent and queue the replies
+void ServerWorker::readConnection(Connection& connection) {
+  char buffer[READ_BUFFER_SIZE];
+
+  while (!connection.session.isClosed()) {
+    ssize_t count = read(connection.fd, buffer, sizeof(buffer));
+
+    if (count > 0) {
+      _counters.bytesIn += count;
+      connection.lastActive = time(NULL);
+      connection.session.receive(buffer, count, connection.out);
+      continue;
+    }
+    if (count < 0 && (errno == EAGAIN || errno == EINTR)) {
+      break;
+    }
+    closeConnection(connection); // the client went away
+    return;
+  }
+  writeConnection(connection);
+}
+
+// Method to write queued replies, closing the connection after QUIT
+// Whatever the socket won't take now waits for EPOLLOUT; reading stops meanwhile, so a client that pipelines
+// without reading its replies can't make the worker buffer without limit
+void ServerWorker::writeConnection(Connection& connection) {
+  while (connection.outPos < connection.out.size()) {
+    ssize_t count = send(connection.fd, connection.out.data() + connection.outPos, connection.out.size() - connection.outPos, MSG_NOSIGNAL);
+
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN) {
+        closeConnection(connection);
+        return;
+      }
+      if (!connection.f_Writing) {
+        struct epoll_event event = {};
+        event.events = EPOLLOUT;
+        event.data.fd = connection.fd;
+        epoll_ctl(_epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.f_Writing = true;
+      }
+      return;
+    }
+    connection.outPos += count;
+  }
+
+  connection.out.clear();
+  connection.outPos = 0;
+  if (connection.session.isClosed()) {
+    closeConnection(connection);
+    return;
+  }
+  if (connection.f_Writing) {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = connection.fd;
+    epoll_ctl(_epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.f_Writing = false;
+  }
+}
+
+// Method to close and forget a connection
+void ServerWorker::closeConnection(Connection& connection) {
+  int fd = connection.fd;
+
+  epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, NULL);
+  close(fd);
+  _connections.erase(fd); // connection is gone from here on
+}
+
+// Method to read, handle and acknowledge the datagrams waiting
+// Only a datagram whose report was read and taken is acknowledged; the node sends anything else again
+void ServerWorker::receiveDatagrams() {
+  static thread_local uint8_t buffers[DATAGRAM_BATCH][DATAGRAM_SIZE_MAX];
+  struct mmsghdr messages[DATAGRAM_BATCH];
+  struct iovec vectors[DATAGRAM_BATCH];
+  struct sockaddr_in sources[DATAGRAM_BATCH];
+  uint8_t acks[DATAGRAM_BATCH][ACK_SIZE];
+  struct mmsghdr replies[DATAGRAM_BATCH];
+  struct iovec replyVectors[DATAGRAM_BATCH];
+
+  memset(messages, 0, sizeof(messages));
+  for (int d = 0; d < DATAGRAM_BATCH; d++) {
+    vectors[d].iov_base = buffers[d];
+    vectors[d].iov_len = DATAGRAM_SIZE_MAX;
+    messages[d].msg_hdr.msg_iov = &vectors[d];
+    messages[d].msg_hdr.msg_iovlen = 1;
+    messages[d].msg_hdr.msg_name = &sources[d];
+    messages[d].msg_hdr.msg_namelen = sizeof(sources[d]);
+  }
+
+  int count = recvmmsg(_udpFd, messages, DATAGRAM_BATCH, MSG_DONTWAIT, NULL);
+  if (count <= 0) {
+    return;
+  }
+
+  NodeReport report;
+  int ackCount = 0;
+  memset(replies, 0, sizeof(replies));
+  for (int d = 0; d < count; d++) {
+    size_t size = messages[d].msg_len;
+
+    _counters.datagrams++;
+    _counters.bytesIn += size;
+    if ((messages[d].msg_hdr.msg_flags & MSG_TRUNC) || !readRecord(buffers[d], size, report) || !keepReport(report, VIA_UDP, report.alerts != 0)) {
+      continue;
+    }
+
+    uint32_t crc = Crc32::compute(buffers[d], size);
+    acks[ackCount][0] = crc >> 24;
+    acks[ackCount][1] = crc >> 16;
+    acks[ackCount][2] = crc >> 8;
+    acks[ackCount][3] = crc;
+    replyVectors[ackCount].iov_base = acks[ackCount];
+    replyVectors[ackCount].iov_len = ACK_SIZE;
+    replies[ackCount].msg_hdr.msg_iov = &replyVectors[ackCount];
+    replies[ackCount].msg_hdr.msg_iovlen = 1;
+    replies[ackCount].msg_hdr.msg_name = &sources[d]; // back to the port the report came from
+    replies[ackCount].msg_hdr.msg_namelen = messages[d].msg_hdr.msg_namelen;
+    ackCount++;
+  }
+
+  int sent = 0;
+  while (sent < ackCount) {
+    int count = sendmmsg(_udpFd, replies + sent, ackCount - sent, MSG_DONTWAIT);
+    if (count <= 0) {
+      break; // the node sends the report again and gets another go at an ack
+    }
+    sent += count;
+  }
+  _counters.acks += sent;
+}
+
+// Method to close connections that have gone quiet, with a 421 so the client knows it wasn't an accident
+void ServerWorker::closeIdle() {
+  time_t now = time(NULL);
+  std::vector<int> idle;
+
+  for (auto& entry : _connections) {
+    if (now - entry.second->lastActive >= (time_t)_config.idleTimeoutS) {
+      idle.push_back(entry.first);
+    }
+  }
+
+  for (int fd : idle) {
+    Connection& connection = *_connections[fd];
+    std::string reply;
+
+    connection.session.timeOut(reply);
+    send(fd, reply.data(), reply.size(), MSG_NOSIGNAL | MSG_DONTWAIT); // best effort, the connection closes either way
+    _counters.timeouts++;
+    closeConnection(connection);
+  }
+}
+
+// Function to take a message from a relay session
+// Mail that carries no record is still taken and handed on as other mail; a record that can't be read is taken
+// too, the node would only send the same one again
+bool ServerWorker::deliver(const RelayedMessage& message) {
+  std::vector<uint8_t> record;
+
+  NodeReport report;
+
+  _counters.messages++;
+  if (!MailMessage::findRecord(message.text, record)) {
+    _counters.otherMail++;
+    _handler.handleOtherMail(message);
+    return true;
+  }
+  if (!readRecord(record.data(), record.size(), report)) {
+    return true;
+  }
+  return keepReport(report, VIA_SMTP, MailMessage::isAlert(message.text)); // not kept = 451, the node tries again later
+}
+
+// Function to decode a record, counting it if malformed (or if decoding it throws, so a record can't take the worker down)
+bool ServerWorker::readRecord(const uint8_t* data, size_t size, NodeReport& report) {
+  bool f_Parsed;
+
+  try {
+    f_Parsed = report.parse(data, size, time(NULL));
+  }
+  catch (const std::exception&) {
+    f_Parsed = false;
+  }
+  if (!f_Parsed) {
+    _counters.malformed++;
+    return false;
+  }
+  return true;
+}
+
+// Function to hand a report on (false if it wasn't kept)
+bool ServerWorker::keepReport(const NodeReport& report, ReportVia via, bool alert) {
+  if (!_handler.handleReport(report, via, alert)) {
+    return false;
+  }
+  _counters.reports[via]++;
+  return true;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,78 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Server_h
+#define Server_h
+
+// Include the necessary libraries
+#include "ReportHandler.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Definitions */
+#define SERVER_SMTP_PORT 2525 // SMTP_RELAY_PORT in the sketch
+#define SERVER_UDP_PORT 5684 // TELEMETRY_PORT in the sketch
+#define SERVER_IDLE_TIMEOUT_S 60 // a connection that sends nothing for this long is closed
+
+/* How the server is set up */
+struct ServerConfig {
+	std::string bindAddress; // IPv4 address to listen on ("0.0.0.0" = every interface)
+	uint16_t smtpPort; // relay port (0 = any free port, see getSmtpPort())
+	uint16_t udpPort; // telemetry port (0 = any free port)
+	int threads; // worker threads (0 = one per CPU)
+	unsigned idleTimeoutS; // seconds a connection may sit idle
+	std::string hostname; // name the relay gives in its replies
+};
+
+/* What the server has handled since it started */
+struct ServerStats {
+	uint64_t connections; // relay connections accepted
+	uint64_t messages; // mail taken through the relay
+	uint64_t reports[VIA_COUNT]; // node reports handed on, by transport
+	uint64_t datagrams; // datagrams received
+	uint64_t acks; // of those, acknowledged
+	uint64_t malformed; // reports whose record couldn't be read (datagrams aren't acknowledged, mail is still taken)
+	uint64_t otherMail; // mail without a report record
+	uint64_t timeouts; // connections closed for being idle
+	uint64_t bytesIn; // TCP and UDP payload received
+};
+
+struct ServerCounters;
+class ServerWorker;
+
+/* Server class definition */
+// The collector's network side: the SMTP relay and the UDP telemetry listener, served by a pool of worker threads.
+// Every worker has its own epoll instance and its own relay and telemetry sockets bound to the shared ports with
+// SO_REUSEPORT, so the kernel spreads connections and datagrams over the workers and no lock or queue sits between
+// a socket and the thread that serves it. Datagrams are read and acknowledged in batches (recvmmsg/sendmmsg);
+// each is acknowledged with its CRC-32 once the handler has taken the report it carries.
+class Server {
+	public:
+		/* Constructors */
+		Server(ReportHandler& handler); // constructor that hands reports to handler
+		~Server(); // stops the workers
+
+		/* Public Functions and Methods */
+		static ServerConfig defaults(); // function to get the configuration the nodes' defaults expect
+		bool start(const ServerConfig& config, std::string& error); // function to open the sockets and start the workers
+		void stop(); // method to close every connection and stop the workers
+		uint16_t getSmtpPort(); // function to get the relay port listened on
+		uint16_t getUdpPort(); // function to get the telemetry port listened on
+		ServerStats getStats(); // function to get what has been handled so far
+	private:
+		/* Private Instance Variables */
+		ReportHandler& _handler;
+		std::unique_ptr<ServerCounters> _counters; // shared by the workers
+		std::vector<std::unique_ptr<ServerWorker>> _workers;
+		std::vector<std::thread> _threads;
+		uint16_t _smtpPort;
+		uint16_t _udpPort;
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,234 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SmtpClient.h"
+#include <errno.h>
+#include <netdb.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/* Definitions */
+#define CRLF "\r\n"
+#define REPLY_GREETING 220
+#define REPLY_CLOSING 221
+#define REPLY_OKAY 250
+#define REPLY_WILL_FORWARD 251
+#define REPLY_START_DATA 354
+#define REPLY_LINES_MAX 100 // lines of one multiline reply before the relay is taken to be broken
+
+/* Constructors */
+// Constructor for the relay at host:port
+SmtpClient::SmtpClient(const std::string& host, uint16_t port, unsigned timeoutS)
+  : _host(host),
+    _port(port),
+    _timeoutS(timeoutS),
+    _fd(-1)
+{
+}
+
+/* Functions */
+
+// Function to deliver a message (headers and body), true once the relay has queued it
+// Recipients the relay refuses are left out, as long as one of them is taken; the error then names them
+bool SmtpClient::send(const std::string& from, const std::vector<std::string>& to, const std::string& message, std::string& error) {
+  std::string text, body;
+  std::string refused;
+  int code;
+  size_t accepted = 0;
+
+  if (!connectRelay(error)) {
+    return false;
+  }
+
+  if (!readReply(code, text) || code != REPLY_GREETING) {
+    error = "no greeting from " + _host + ": " + text;
+    disconnect();
+    return false;
+  }
+  if (!command("EHLO collector", REPLY_OKAY, error) && !command("HELO collector", REPLY_OKAY, error)) {
+    disconnect();
+    return false;
+  }
+  if (!command("MAIL FROM:<" + from + ">", REPLY_OKAY, error)) {
+    disconnect();
+    return false;
+  }
+
+  for (const std::string& recipient : to) {
+    if (!writeAll("RCPT TO:<" + recipient + ">" CRLF) || !readReply(code, text)) {
+      error = "connection lost at RCPT TO";
+      disconnect();
+      return false;
+    }
+    if (code == REPLY_OKAY || code == REPLY_WILL_FORWARD) {
+      accepted++;
+    }
+    else {
+      refused += (refused.empty() ? "" : ", ") + recipient + " (" + text + ")";
+    }
+  }
+  if (accepted == 0) {
+    error = "every recipient refused: " + refused;
+    disconnect();
+    return false;
+  }
+
+  if (!command("DATA", REPLY_START_DATA, error)) {
+    disconnect();
+    return false;
+  }
+  stuffDots(message, body);
+  body += "." CRLF;
+  if (!writeAll(body) || !readReply(code, text) || code != REPLY_OKAY) {
+    error = "message not taken: " + text;
+    disconnect();
+    return false;
+  }
+
+  command("QUIT", REPLY_CLOSING, text); // queued already, a bad goodbye changes nothing
+  disconnect();
+  error = refused.empty() ? "" : "refused: " + refused;
+  return true;
+}
+
+// Function to open the connection
+bool SmtpClient::connectRelay(std::string& error) {
+  struct addrinfo hints = {};
+  struct addrinfo* found;
+  struct timeval timeout = { (time_t)_timeoutS, 0 };
+  std::string port = std::to_string(_port);
+
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  int result = getaddrinfo(_host.c_str(), port.c_str(), &hints, &found);
+  if (result != 0) {
+    error = _host + ": " + gai_strerror(result);
+    return false;
+  }
+
+  error = "can't connect to " + _host + ":" + port;
+  for (struct addrinfo* address = found; address != NULL && _fd < 0; address = address->ai_next) {
+    _fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+    if (_fd < 0) {
+      continue;
+    }
+    setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)); // connect() honours it too
+    if (connect(_fd, address->ai_addr, address->ai_addrlen) < 0) {
+      error += std::string(": ") + strerror(errno);
+      disconnect();
+    }
+  }
+  freeaddrinfo(found);
+
+  _in.clear();
+  return _fd >= 0;
+}
+
+// Function to send a command line and check the reply's code
+bool SmtpClient::command(const std::string& line, int expected, std::string& error) {
+  std::string text;
+  int code;
+
+  if (!writeAll(line + CRLF) || !readReply(code, text)) {
+    error = "connection lost at " + line;
+    return false;
+  }
+  if (code != expected) {
+    error = line + ": " + text;
+    return false;
+  }
+  return true;
+}
+
+// Function to read a reply, every line of a multiline one ("250-..." lines up to the "250 ..." one)
+// text holds the last line, which is the one that says what happened
+bool SmtpClient::readReply(int& code, std::string& text) {
+  char buffer[512];
+
+  for (int lines = 0; lines < REPLY_LINES_MAX; ) {
+    size_t end = _in.find(CRLF);
+    if (end == std::string::npos) {
+      ssize_t count = recv(_fd, buffer, sizeof(buffer), 0);
+      if (count <= 0) {
+        text = (count == 0) ? "connection closed" : strerror(errno);
+        return false;
+      }
+      _in.append(buffer, count);
+      continue;
+    }
+
+    text = _in.substr(0, end);
+    _in.erase(0, end + 2);
+    lines++;
+    if (text.size() < 3 || text[0] < '2' || text[0] > '5') {
+      return false;
+    }
+    code = atoi(text.substr(0, 3).c_str());
+    if (text.size() == 3 || text[3] != '-') {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Function to write everything, waiting up to the timeout
+bool SmtpClient::writeAll(const std::string& data) {
+  size_t written = 0;
+
+  while (written < data.size()) {
+    ssize_t count = ::send(_fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    written += count;
+  }
+  return true;
+}
+
+// Method to close the connection
+void SmtpClient::disconnect() {
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+// Method to make the message safe to send after DATA
+// Every line ends in CRLF whatever it ended in before, and a line starting with '.' gets a second one (RFC 5321 4.5.2)
+void SmtpClient::stuffDots(const std::string& message, std::string& out) {
+  bool f_LineStart = true;
+
+  out.reserve(message.size() + message.size() / 64);
+  for (size_t i = 0; i < message.size(); i++) {
+    char c = message[i];
+
+    if (f_LineStart && c == '.') {
+      out += '.';
+    }
+    if (c == '\r' && i + 1 < message.size() && message[i + 1] == '\n') {
+      continue; // written with the '\n'
+    }
+    if (c == '\n' || c == '\r') {
+      out += CRLF;
+      f_LineStart = true;
+      continue;
+    }
+    out += c;
+    f_LineStart = false;
+  }
+  if (!f_LineStart) {
+    out += CRLF;
+  }
+}
+
+// ©2017 Jeremy Maxey-Vesperman
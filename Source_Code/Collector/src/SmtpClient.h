@@ -0,0 +1,48 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SmtpClient_h
+#define SmtpClient_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* Definitions */
+#define SMTP_CLIENT_TIMEOUT_S 30 // longest wait for any one reply
+
+/* SmtpClient class definition */
+// Sends the collector's digest upstream over plain SMTP, one message per connection, to a relay that takes mail
+// from the collector without a login (the site's own mail server, or an MTA on the collector's host that holds
+// the credentials for the outside world), the same arrangement the nodes use with the collector. Blocking,
+// on the digest thread only.
+class SmtpClient {
+	public:
+		/* Constructors */
+		SmtpClient(const std::string& host, uint16_t port, unsigned timeoutS=SMTP_CLIENT_TIMEOUT_S); // constructor for the relay at host:port
+
+		/* Public Functions and Methods */
+		bool send(const std::string& from, const std::vector<std::string>& to, const std::string& message, std::string& error); // function to deliver a message (headers and body), true once the relay has queued it
+	private:
+		/* Private Instance Variables */
+		std::string _host;
+		uint16_t _port;
+		unsigned _timeoutS;
+		int _fd; // connection, -1 between messages
+		std::string _in; // reply text read but not yet used
+
+		/* Private Functions and Methods */
+		bool connectRelay(std::string& error); // function to open the connection
+		bool command(const std::string& line, int expected, std::string& error); // function to send a command line and check the reply's code
+		bool readReply(int& code, std::string& text); // function to read a reply, every line of a multiline one
+		bool writeAll(const std::string& data); // function to write everything, waiting up to the timeout
+		void disconnect(); // method to close the connection
+		static void stuffDots(const std::string& message, std::string& out); // method to make the message safe to send after DATA
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
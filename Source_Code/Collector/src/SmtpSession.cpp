@@ -0,0 +1,266 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SmtpSession.h"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+/* Definitions */
+#define CRLF "\r\n"
+#define DATA_END "." // line that ends the message text
+
+// Replies
+#define REPLY_GREETING "220 %s Plant collector ready" CRLF
+#define REPLY_EHLO "250-%s" CRLF \
+                   "250-PIPELINING" CRLF \
+                   "250-8BITMIME" CRLF \
+                   "250 SIZE %u" CRLF
+#define REPLY_HELO "250 %s" CRLF
+#define REPLY_OK "250 2.0.0 OK" CRLF
+#define REPLY_SENDER_OK "250 2.1.0 Sender OK" CRLF
+#define REPLY_RECIPIENT_OK "250 2.1.5 Recipient OK" CRLF
+#define REPLY_QUEUED "250 2.0.0 Queued" CRLF
+#define REPLY_START_DATA "354 End data with <CR><LF>.<CR><LF>" CRLF
+#define REPLY_CLOSING "221 2.0.0 Bye" CRLF
+#define REPLY_CANNOT_VERIFY "252 2.1.5 Cannot verify, will try to deliver" CRLF
+#define REPLY_TIMEOUT "421 4.4.2 %s Idle too long, closing" CRLF
+#define REPLY_NOT_TAKEN "451 4.3.0 Message not taken, try again later" CRLF
+#define REPLY_TOO_MANY_RECIPIENTS "452 4.5.3 Too many recipients" CRLF
+#define REPLY_UNKNOWN "500 5.5.2 Command not recognized" CRLF
+#define REPLY_LINE_TOO_LONG "500 5.5.2 Line too long" CRLF
+#define REPLY_BAD_SYNTAX "501 5.5.4 Syntax error in parameters" CRLF
+#define REPLY_NO_AUTH "502 5.5.1 No login needed, send MAIL FROM" CRLF
+#define REPLY_NO_GREETING "503 5.5.1 Send EHLO or HELO first" CRLF
+#define REPLY_NESTED_MAIL "503 5.5.1 MAIL FROM already given" CRLF
+#define REPLY_NO_MAIL "503 5.5.1 Send MAIL FROM first" CRLF
+#define REPLY_NO_RECIPIENTS "503 5.5.1 No valid recipients" CRLF
+#define REPLY_TOO_BIG "552 5.3.4 Message too big" CRLF
+#define REPLY_BAD_LINE "554 5.6.0 Message has a line over 998 characters" CRLF
+
+#define REPLY_SIZE 256 // longest formatted reply
+
+/* Constructors */
+// Constructor that delivers to sink, naming itself hostname in replies
+SmtpSession::SmtpSession(MessageSink& sink, const char* hostname)
+  : _sink(sink), _hostname(hostname), _messageCount(0), f_Greeted(false), f_Mail(false), f_Data(false),
+    f_LineTooLong(false), f_MessageRejected(false), f_Closed(false)
+{
+}
+
+/* Functions */
+
+// Method to write the greeting a new connection gets
+void SmtpSession::greet(std::string& out) {
+  char reply[REPLY_SIZE];
+
+  snprintf(reply, sizeof(reply), REPLY_GREETING, _hostname.c_str());
+  out += reply;
+}
+
+// Method to handle bytes from the client, every complete line in order, writing the replies to out
+void SmtpSession::receive(const char* data, size_t size, std::string& out) {
+  for (size_t i = 0; i < size && !f_Closed; i++) {
+    char c = data[i];
+
+    if (c == '\n') { // a bare LF is taken as a line end too
+      if (!_line.empty() && _line.back() == '\r') {
+        _line.pop_back();
+      }
+      if (f_LineTooLong) {
+        f_LineTooLong = false;
+        if (!f_Data) {
+          out += REPLY_LINE_TOO_LONG;
+        }
+      }
+      else {
+        onLine(_line, out);
+      }
+      _line.clear();
+    }
+    else if (f_LineTooLong) {
+      continue; // thrown away up to the next line end
+    }
+    else if (_line.size() >= SMTP_LINE_MAX - 1) { // only room left for the LF
+      f_LineTooLong = true;
+      f_MessageRejected = f_MessageRejected || f_Data;
+      _line.clear();
+    }
+    else {
+      _line += c;
+    }
+  }
+}
+
+// Method to write the reply a connection idle for too long gets before it is closed
+void SmtpSession::timeOut(std::string& out) {
+  char reply[REPLY_SIZE];
+
+  snprintf(reply, sizeof(reply), REPLY_TIMEOUT, _hostname.c_str());
+  out += reply;
+  f_Closed = true;
+}
+
+// Function to check whether the client has quit
+bool SmtpSession::isClosed() {
+  return f_Closed;
+}
+
+// Function to get the number of messages delivered
+uint32_t SmtpSession::getMessageCount() {
+  return _messageCount;
+}
+
+// Method to handle one line, CRLF removed
+void SmtpSession::onLine(const std::string& line, std::string& out) {
+  if (f_Data) {
+    onDataLine(line, out);
+  }
+  else {
+    onCommand(line, out);
+  }
+}
+
+// Method to handle a command line
+void SmtpSession::onCommand(const std::string& line, std::string& out) {
+  char reply[REPLY_SIZE];
+  std::string address;
+
+  if (strncasecmp(line.c_str(), "EHLO", 4) == 0 && (line.size() == 4 || line[4] == ' ')) {
+    resetEnvelope();
+    f_Greeted = true;
+    snprintf(reply, sizeof(reply), REPLY_EHLO, _hostname.c_str(), (unsigned)SMTP_MESSAGE_MAX);
+    out += reply;
+  }
+  else if (strncasecmp(line.c_str(), "HELO", 4) == 0 && (line.size() == 4 || line[4] == ' ')) {
+    resetEnvelope();
+    f_Greeted = true;
+    snprintf(reply, sizeof(reply), REPLY_HELO, _hostname.c_str());
+    out += reply;
+  }
+  else if (strncasecmp(line.c_str(), "MAIL FROM:", 10) == 0) {
+    if (!f_Greeted) {
+      out += REPLY_NO_GREETING;
+    }
+    else if (f_Mail) {
+      out += REPLY_NESTED_MAIL;
+    }
+    else if (!parsePath(line, 10, address)) {
+      out += REPLY_BAD_SYNTAX;
+    }
+    else {
+      f_Mail = true;
+      _message.from = address;
+      out += REPLY_SENDER_OK;
+    }
+  }
+  else if (strncasecmp(line.c_str(), "RCPT TO:", 8) == 0) {
+    if (!f_Mail) {
+      out += REPLY_NO_MAIL;
+    }
+    else if (!parsePath(line, 8, address) || address.empty()) {
+      out += REPLY_BAD_SYNTAX;
+    }
+    else if (_message.recipients.size() >= SMTP_RECIPIENTS_MAX) {
+      out += REPLY_TOO_MANY_RECIPIENTS;
+    }
+    else {
+      _message.recipients.push_back(address);
+      out += REPLY_RECIPIENT_OK;
+    }
+  }
+  else if (strcasecmp(line.c_str(), "DATA") == 0) {
+    if (!f_Mail) {
+      out += REPLY_NO_MAIL;
+    }
+    else if (_message.recipients.empty()) {
+      out += REPLY_NO_RECIPIENTS;
+    }
+    else {
+      f_Data = true;
+      f_MessageRejected = false;
+      _message.text.clear();
+      out += REPLY_START_DATA;
+    }
+  }
+  else if (strcasecmp(line.c_str(), "RSET") == 0) {
+    resetEnvelope();
+    out += REPLY_OK;
+  }
+  else if (strncasecmp(line.c_str(), "NOOP", 4) == 0) {
+    out += REPLY_OK;
+  }
+  else if (strcasecmp(line.c_str(), "QUIT") == 0) {
+    out += REPLY_CLOSING;
+    f_Closed = true;
+  }
+  else if (strncasecmp(line.c_str(), "VRFY", 4) == 0) {
+    out += REPLY_CANNOT_VERIFY;
+  }
+  else if (strncasecmp(line.c_str(), "AUTH", 4) == 0) { // the relay trusts the local network
+    out += REPLY_NO_AUTH;
+  }
+  else {
+    out += REPLY_UNKNOWN;
+  }
+}
+
+// Method to handle a line of message text, delivering the message at the line holding a single dot
+void SmtpSession::onDataLine(const std::string& line, std::string& out) {
+  if (line == DATA_END) {
+    if (f_MessageRejected) {
+      out += (_message.text.size() > SMTP_MESSAGE_MAX) ? REPLY_TOO_BIG : REPLY_BAD_LINE;
+    }
+    else if (_sink.deliver(_message)) {
+      out += REPLY_QUEUED;
+      _messageCount++;
+    }
+    else {
+      out += REPLY_NOT_TAKEN;
+    }
+    resetEnvelope();
+    return;
+  }
+
+  if (f_MessageRejected) { // refused when it ends, nothing more is kept
+    return;
+  }
+  if (_message.text.size() + line.size() + 2 > SMTP_MESSAGE_MAX) {
+    f_MessageRejected = true;
+    _message.text.resize(SMTP_MESSAGE_MAX + 1); // remembered as too big, not as a long line
+    return;
+  }
+
+  _message.text.append(line, (!line.empty() && line[0] == '.') ? 1 : 0, std::string::npos); // undo dot stuffing
+  _message.text += CRLF;
+}
+
+// Method to drop the message in progress
+void SmtpSession::resetEnvelope() {
+  f_Mail = false;
+  f_Data = false;
+  f_MessageRejected = false;
+  _message.from.clear();
+  _message.recipients.clear();
+  _message.text.clear();
+}
+
+// Function to read the <address> that follows MAIL FROM: or RCPT TO:, a space before it is allowed (the nodes send one)
+bool SmtpSession::parsePath(const std::string& line, size_t start, std::string& address) {
+  size_t open = line.find_first_not_of(' ', start);
+
+  if (open == std::string::npos || line[open] != '<') {
+    return false;
+  }
+  size_t close = line.find('>', open);
+  if (close == std::string::npos) {
+    return false;
+  }
+  address.assign(line, open + 1, close - open - 1);
+  return true;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
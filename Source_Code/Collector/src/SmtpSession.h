@@ -0,0 +1,75 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SmtpSession_h
+#define SmtpSession_h
+
+// Include the necessary libraries
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* Definitions */
+#define SMTP_LINE_MAX 1000 // longest command or message line, CRLF included (RFC 5321 4.5.3.1)
+#define SMTP_MESSAGE_MAX (1024 * 1024) // largest message taken, advertised as SIZE
+#define SMTP_RECIPIENTS_MAX 100 // recipients of one message (RFC 5321 asks servers to take at least this many)
+
+/* One message a session has taken */
+struct RelayedMessage {
+	std::string from; // MAIL FROM address
+	std::vector<std::string> recipients; // RCPT TO addresses
+	std::string text; // headers and body, dot stuffing undone, lines ending in CRLF
+};
+
+/* Where a session hands its messages */
+class MessageSink {
+	public:
+		virtual ~MessageSink() { }
+		virtual bool deliver(const RelayedMessage& message) = 0; // function to take a message, false = try again later (4xx)
+};
+
+/* SmtpSession class definition */
+// Server side of one SMTP relay connection, as plain SMTP without a login, the way the nodes' SMTP class speaks
+// to a collector (updateServer() to the collector, updateCredentials(NULL, NULL)). Bytes go in as they arrive
+// and the replies come out to be written back, so any number of sessions can share a thread. Commands may be
+// pipelined (RFC 2920): every complete line is handled in order, and a write holding MAIL FROM, RCPT TO, DATA
+// and the start of the message (or the end of it and QUIT) gets all of its replies back at once.
+class SmtpSession {
+	public:
+		/* Constructors */
+		SmtpSession(MessageSink& sink, const char* hostname); // constructor that delivers to sink, naming itself hostname in replies
+
+		/* Public Functions and Methods */
+		void greet(std::string& out); // method to write the greeting a new connection gets
+		void receive(const char* data, size_t size, std::string& out); // method to handle bytes from the client, writing replies to out
+		void timeOut(std::string& out); // method to write the reply a connection idle for too long gets before it is closed
+		bool isClosed(); // function to check whether the client has quit (close once the replies are written)
+		uint32_t getMessageCount(); // function to get the number of messages delivered
+	private:
+		/* Private Instance Variables */
+		MessageSink& _sink; // where messages go
+		std::string _hostname; // name in the greeting and EHLO reply
+		std::string _line; // partial line
+		RelayedMessage _message; // envelope and text of the message being received
+		uint32_t _messageCount; // messages delivered
+		bool f_Greeted; // EHLO or HELO seen
+		bool f_Mail; // MAIL FROM seen
+		bool f_Data; // receiving message text
+		bool f_LineTooLong; // the current line ran past SMTP_LINE_MAX and is being thrown away
+		bool f_MessageRejected; // message ran past a limit, refused when it ends
+		bool f_Closed; // QUIT seen
+
+		/* Private Functions and Methods */
+		void onLine(const std::string& line, std::string& out); // method to handle one line, CRLF removed
+		void onCommand(const std::string& line, std::string& out); // method to handle a command line
+		void onDataLine(const std::string& line, std::string& out); // method to handle a line of message text
+		void resetEnvelope(); // method to drop the message in progress
+		static bool parsePath(const std::string& line, size_t start, std::string& address); // function to read the <address> of MAIL FROM and RCPT TO
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
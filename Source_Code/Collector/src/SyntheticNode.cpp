@@ -0,0 +1,257 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SyntheticNode.h"
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Definitions */
+#define CRLF "\r\n"
+#define SECONDS_PER_DAY 86400
+#define DAYS_PER_YEAR 365.25
+#define BATTERY_FULL 4.2f // V, just charged
+#define BATTERY_CHARGE_AT 3.45f // V, the owner charges it when the node complains
+#define BATTERY_DRAIN_PER_DAY 0.012f // V
+#define MOISTURE_ALERT 20.0f // % (below = alert), as the sketch's defaults
+#define BATTERY_ALERT 3.5f // V
+#define TEMPERATURE_LOW_ALERT 45.0f // ºF
+#define TEMPERATURE_HIGH_ALERT 95.0f // ºF
+#define BASE64_LINE_LENGTH 76 // characters per line, as the nodes' Base64Writer
+
+/* Constants */
+static const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Constructors */
+// Constructor for node index, powered up at bootTime (Unix time)
+SyntheticNode::SyntheticNode(uint32_t index, uint32_t seed, int64_t bootTime)
+  : _random(seed * 2654435761u + index),
+    _bootTime(bootTime),
+    _lastTime(bootTime)
+{
+  char id[REPORT_ID_SIZE];
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+  snprintf(id, sizeof(id), "Seedling-%04u", index);
+  _id = id;
+  _luxPeak = 2000.0f + 38000.0f * uniform(_random); // from a dim corner to a south window
+  _indoorTemperature = 64.0f + 10.0f * uniform(_random);
+  _dryingRate = 4.0f + 8.0f * uniform(_random); // a cactus mix to a small terracotta pot
+  _waterBelow = 15.0f + 15.0f * uniform(_random);
+  _moisture = _waterBelow + (90.0f - _waterBelow) * uniform(_random);
+  _battery = BATTERY_CHARGE_AT + (BATTERY_FULL - BATTERY_CHARGE_AT) * uniform(_random);
+}
+
+/* Functions */
+
+// Function to get the node's hostname
+const std::string& SyntheticNode::getId() {
+  return _id;
+}
+
+// Method to get the readings at a time, in the nodes' sensor order
+// Light follows the sun with the seasons and passing clouds, temperature the room's day and year
+void SyntheticNode::read(int64_t time, float* values) {
+  double day = fmod((double)time / SECONDS_PER_DAY, 1.0); // 0 = midnight UTC, taken as local
+  double year = fmod((double)time / (SECONDS_PER_DAY * DAYS_PER_YEAR), 1.0); // 0 = 1 January
+  double season = -cos(2 * M_PI * (year - 0.03)); // -1 midwinter, 1 midsummer
+  double dayLength = 0.5 + 0.12 * season; // fraction of the day the sun is up
+  double sun = sin(M_PI * (day - (0.5 - dayLength / 2)) / dayLength);
+
+  advance(time);
+  values[SENSOR_LIGHT] = (sun > 0) ? std::max(0.0f, (float)(_luxPeak * (0.7 + 0.3 * season) * sun * (0.6f + 0.4f * fabsf(1.0f + noise(0.3f))))) : 0.0f;
+  values[SENSOR_TEMPERATURE] = _indoorTemperature + 6.0f * season - 4.0f * cos(2 * M_PI * (day - 0.1)) + noise(0.5f);
+  values[SENSOR_MOISTURE] = std::min(100.0f, std::max(0.0f, _moisture + noise(0.4f)));
+  values[SENSOR_BATTERY] = _battery + noise(0.01f);
+}
+
+// Method to read the sensors and hold the readings for the next report
+void SyntheticNode::takeSample(int64_t time) {
+  Sample sample;
+
+  sample.time = time;
+  read(time, sample.values);
+  _samples.push_back(sample);
+}
+
+// Function to get the number of samples held
+size_t SyntheticNode::getSampleCount() {
+  return _samples.size();
+}
+
+// Function to get the alert flags of the newest sample (bit i = reading i)
+uint8_t SyntheticNode::getAlerts() {
+  uint8_t alerts = 0;
+
+  if (_samples.empty()) {
+    return 0;
+  }
+  const float* values = _samples.back().values;
+  if (values[SENSOR_TEMPERATURE] < TEMPERATURE_LOW_ALERT || values[SENSOR_TEMPERATURE] > TEMPERATURE_HIGH_ALERT) {
+    alerts |= 1 << SENSOR_TEMPERATURE;
+  }
+  if (values[SENSOR_MOISTURE] < MOISTURE_ALERT) {
+    alerts |= 1 << SENSOR_MOISTURE;
+  }
+  if (values[SENSOR_BATTERY] < BATTERY_ALERT) {
+    alerts |= 1 << SENSOR_BATTERY;
+  }
+  return alerts;
+}
+
+// Method to write a CBOR item's type and argument in the shortest form, as CborWriter does
+static void writeHead(std::vector<uint8_t>& out, uint8_t majorType, uint32_t value) {
+  uint8_t type = majorType << 5;
+
+  if (value < 24) {
+    out.push_back(type | value);
+  }
+  else if (value <= UINT8_MAX) {
+    out.insert(out.end(), { (uint8_t)(type | 24), (uint8_t)value });
+  }
+  else if (value <= UINT16_MAX) {
+    out.insert(out.end(), { (uint8_t)(type | 25), (uint8_t)(value >> 8), (uint8_t)value });
+  }
+  else {
+    out.insert(out.end(), { (uint8_t)(type | 26), (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value });
+  }
+}
+
+// Method to write a CBOR text string
+static void writeText(std::vector<uint8_t>& out, const std::string& text) {
+  writeHead(out, 3, text.size());
+  out.insert(out.end(), text.begin(), text.end());
+}
+
+// Method to write a CBOR single precision float
+static void writeFloat(std::vector<uint8_t>& out, float value) {
+  uint32_t bits;
+
+  memcpy(&bits, &value, sizeof(bits));
+  out.insert(out.end(), { 0xfa, (uint8_t)(bits >> 24), (uint8_t)(bits >> 16), (uint8_t)(bits >> 8), (uint8_t)bits });
+}
+
+// Method to write the held samples as a report record, and let them go
+// The newest SYNTHETIC_SAMPLES_PER_REPORT go as samples and anything older as backlog, the way a node that
+// couldn't deliver its earlier reports sends them
+void SyntheticNode::writeRecord(int64_t sentAt, std::vector<uint8_t>& out) {
+  size_t backlog = (_samples.size() > SYNTHETIC_SAMPLES_PER_REPORT) ? _samples.size() - SYNTHETIC_SAMPLES_PER_REPORT : 0;
+
+  out.clear();
+  writeHead(out, 5, 6);
+  writeText(out, "id");
+  writeText(out, _id);
+  writeText(out, "t");
+  writeHead(out, 0, sentAt - _bootTime);
+  writeText(out, "al");
+  writeHead(out, 0, getAlerts());
+
+  writeText(out, "a");
+  writeHead(out, 4, _samples.size() - backlog);
+  for (size_t s = backlog; s < _samples.size(); s++) {
+    writeHead(out, 0, sentAt - _samples[s].time);
+  }
+  writeText(out, "s");
+  writeHead(out, 4, _samples.size() - backlog);
+  for (size_t s = backlog; s < _samples.size(); s++) {
+    writeHead(out, 4, SENSOR_KNOWN_COUNT);
+    for (float value : _samples[s].values) {
+      writeFloat(out, value);
+    }
+  }
+
+  writeText(out, "b");
+  out.push_back(0x9f); // indefinite array, as the sketch writes it
+  for (size_t s = 0; s < backlog; s++) {
+    writeHead(out, 4, 1 + SENSOR_KNOWN_COUNT);
+    writeHead(out, 0, _samples[s].time - _bootTime);
+    for (float value : _samples[s].values) {
+      writeFloat(out, value);
+    }
+  }
+  out.push_back(0xff);
+
+  _samples.clear();
+}
+
+// Method to write the email carrying a record, as the SMTP class would
+// The HTML part is a short stand in for the node's report, the record part is what the collector reads
+void SyntheticNode::writeEmail(const std::vector<uint8_t>& record, bool alert, std::string& out) {
+  size_t lineLength = 0;
+
+  out = "From: Plant Life Monitor <plantlifemonitor@gmail.com>" CRLF;
+  out += std::string("Subject: ") + (alert ? "Plant Alert!" : "Plant Report") + CRLF;
+  out += "To: " SYNTHETIC_RECIPIENT CRLF;
+  out += "Mime-Version: 1.0" CRLF
+         "Content-Type: multipart/mixed; boundary=\"PlantReportPart\"" CRLF
+         CRLF
+         "--PlantReportPart" CRLF
+         "Content-Type: text/html; charset=\"ISO-8859-1\"" CRLF
+         "Content-Transfer-Encoding: 7bit" CRLF
+         CRLF
+         "<html>\r\n<body>\r\n";
+  out += "<h2><u>" + _id + "</u></h2><br>\r\n";
+  out += "\r\n</body></html>" CRLF;
+  out += "--PlantReportPart" CRLF
+         "Content-Type: application/cbor; name=\"report.cbor\"" CRLF
+         "Content-Transfer-Encoding: base64" CRLF
+         "Content-Disposition: attachment; filename=\"report.cbor\"" CRLF
+         CRLF;
+
+  for (size_t i = 0; i < record.size(); i += 3) {
+    uint32_t group = record[i] << 16;
+    size_t length = std::min((size_t)3, record.size() - i);
+
+    group |= (length > 1) ? record[i + 1] << 8 : 0;
+    group |= (length > 2) ? record[i + 2] : 0;
+    out += BASE64_ALPHABET[(group >> 18) & 0x3f];
+    out += BASE64_ALPHABET[(group >> 12) & 0x3f];
+    out += (length > 1) ? BASE64_ALPHABET[(group >> 6) & 0x3f] : '=';
+    out += (length > 2) ? BASE64_ALPHABET[group & 0x3f] : '=';
+    lineLength += 4;
+    if (lineLength >= BASE64_LINE_LENGTH) {
+      out += CRLF;
+      lineLength = 0;
+    }
+  }
+  if (lineLength > 0) {
+    out += CRLF;
+  }
+  out += "--PlantReportPart--" CRLF;
+}
+
+// Method to run the soil and battery on to a time
+// Wet soil dries faster than dry soil, and the owner waters it once it is dry enough, not always on the day
+void SyntheticNode::advance(int64_t time) {
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  float days = (float)(time - _lastTime) / SECONDS_PER_DAY;
+
+  if (days <= 0) {
+    return;
+  }
+  _lastTime = time;
+
+  _moisture -= _dryingRate * days * (_moisture / 60.0f + 0.2f);
+  if (_moisture < _waterBelow && uniform(_random) < std::min(1.0f, days * 4.0f)) { // about six hours late on average
+    _moisture = 70.0f + 20.0f * uniform(_random);
+  }
+  _moisture = std::max(0.0f, _moisture);
+
+  _battery -= BATTERY_DRAIN_PER_DAY * days;
+  if (_battery < BATTERY_CHARGE_AT) {
+    _battery = BATTERY_FULL;
+  }
+}
+
+// Function to get normally distributed noise
+float SyntheticNode::noise(float spread) {
+  std::normal_distribution<float> normal(0.0f, spread);
+
+  return normal(_random);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,62 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SyntheticNode_h
+#define SyntheticNode_h
+
+// Include the necessary libraries
+#include "NodeReport.h"
+#include <random>
+#include <string>
+#include <vector>
+
+/* Definitions */
+#define SYNTHETIC_SAMPLES_PER_REPORT 6 // samples a report carries as "s", older ones go as backlog (the sketch's default batch)
+#define SYNTHETIC_RECIPIENT "DEFAULT@RECEIPIENT.HERE" // the SMTP class's default recipient
+
+/* SyntheticNode class definition */
+// A plant monitor that exists only on the collector's side: readings that follow the day, the seasons, soil drying
+// out until it is watered and a battery running down until it is charged, sent as the real nodes send them (the
+// CBOR record of writeReportRecord(), and the email the SMTP class builds around it). Each node gets its own
+// plant, pot and climate from its seed, so hundreds of them don't move in step. Sample times must not go backwards.
+class SyntheticNode {
+	public:
+		/* Constructors */
+		SyntheticNode(uint32_t index, uint32_t seed, int64_t bootTime); // constructor for node index, powered up at bootTime (Unix time)
+
+		/* Public Functions and Methods */
+		const std::string& getId(); // function to get the node's hostname
+		void read(int64_t time, float* values); // method to get the readings at a time, in the nodes' sensor order
+		void takeSample(int64_t time); // method to read the sensors and hold the readings for the next report
+		size_t getSampleCount(); // function to get the number of samples held
+		uint8_t getAlerts(); // function to get the alert flags of the newest sample (bit i = reading i)
+		void writeRecord(int64_t sentAt, std::vector<uint8_t>& out); // method to write the held samples as a report record, and let them go
+		void writeEmail(const std::vector<uint8_t>& record, bool alert, std::string& out); // method to write the email carrying a record, as the SMTP class would
+	private:
+		/* Private Instance Variables */
+		struct Sample {
+			int64_t time;
+			float values[SENSOR_KNOWN_COUNT];
+		};
+		std::string _id;
+		std::mt19937 _random;
+		int64_t _bootTime; // "t" counts from here
+		int64_t _lastTime; // time of the last reading
+		float _luxPeak; // midsummer noon in the plant's spot
+		float _indoorTemperature; // mean of the room (ºF)
+		float _dryingRate; // moisture lost per day at 48% (%)
+		float _waterBelow; // moisture the owner waters at (%)
+		float _moisture; // soil moisture (%)
+		float _battery; // battery voltage (V)
+		std::vector<Sample> _samples; // held for the next report, oldest first
+
+		/* Private Functions and Methods */
+		void advance(int64_t time); // method to run the soil and battery on to a time
+		float noise(float spread); // function to get normally distributed noise
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
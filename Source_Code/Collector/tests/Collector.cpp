@@ -0,0 +1,231 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// The collector end to end over loopback: simulated nodes reporting by both transports at once are all answered
+// (every datagram acknowledged with its CRC), every report lands in its node's totals, a datagram that isn't a
+// report goes unacknowledged, and the digest of the period goes upstream through a second relay. A digest the
+// upstream relay can't take is kept for the next one, and a connection left idle is closed with a 421.
+
+// Include necessary header files
+#include "Digest.h"
+#include "LoadGenerator.h"
+#include "NodeTable.h"
+#include "Server.h"
+#include "SmtpClient.h"
+#include "SyntheticNode.h"
+#include "Check.h"
+#include <arpa/inet.h>
+#include <mutex>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Definitions */
+#define LOOPBACK "127.0.0.1"
+#define TEST_NODES 60
+#define TEST_DURATION_S 2
+#define TEST_INTERVAL_MS 200
+#define TEST_TIMEOUT_MS 3000
+#define NO_ACK_WAIT_MS 300
+#define IDLE_TIMEOUT_S 1
+#define REPLY_WAIT_S 5
+
+/* Upstream relay that keeps the mail it is sent */
+class UpstreamMailbox : public ReportHandler {
+  public:
+    std::mutex lock;
+    std::vector<RelayedMessage> messages;
+
+    bool handleReport(const NodeReport& report, ReportVia via, bool alert) override {
+      (void)report; (void)via; (void)alert;
+      return true;
+    }
+    void handleOtherMail(const RelayedMessage& message) override {
+      std::lock_guard<std::mutex> guard(lock);
+      messages.push_back(message);
+    }
+};
+
+/* Functions */
+
+// Function to get a server configuration on loopback with ports picked by the kernel
+static ServerConfig loopbackConfig(int threads) {
+  ServerConfig config = Server::defaults();
+
+  config.bindAddress = LOOPBACK;
+  config.smtpPort = 0;
+  config.udpPort = 0;
+  config.threads = threads;
+  return config;
+}
+
+// Function to get a loopback address
+static struct sockaddr_in loopback(uint16_t port) {
+  struct sockaddr_in address = {};
+
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  inet_pton(AF_INET, LOOPBACK, &address.sin_addr);
+  return address;
+}
+
+// Method to run the simulated nodes against the collector and check every report was taken and added up
+static void testLoad(Server& collector, NodeTable& table) {
+  LoadConfig config = LoadGenerator::defaults();
+  LoadResult result;
+  std::string error;
+
+  config.smtpPort = collector.getSmtpPort();
+  config.udpPort = collector.getUdpPort();
+  config.nodes = TEST_NODES;
+  config.durationS = TEST_DURATION_S;
+  config.intervalMs = TEST_INTERVAL_MS;
+  config.timeoutMs = TEST_TIMEOUT_MS;
+  config.mode = LOAD_MIXED;
+
+  CHECK(LoadGenerator::run(config, result, error));
+  CHECK(result.failures == 0);
+  CHECK(result.timeouts == 0);
+  CHECK(result.reports >= TEST_NODES); // every node got at least one report in
+  CHECK(result.latenciesUs.size() == result.reports);
+  CHECK(result.percentile(50) <= result.percentile(99) && result.percentile(99) <= result.percentile(100));
+  printf("%llu reports in %.2f s, p50 %.2f ms, p99 %.2f ms\n", (unsigned long long)result.reports, result.elapsedS,
+         result.percentile(50) / 1000, result.percentile(99) / 1000);
+
+  ServerStats stats = collector.getStats();
+  CHECK(stats.reports[VIA_SMTP] > 0 && stats.reports[VIA_UDP] > 0);
+  CHECK(stats.reports[VIA_SMTP] + stats.reports[VIA_UDP] == result.reports + result.resends);
+  CHECK(stats.messages == stats.reports[VIA_SMTP]);
+  CHECK(stats.acks == stats.datagrams);
+  CHECK(stats.malformed == 0 && stats.otherMail == 0);
+
+  // Even nodes email, odd nodes send datagrams; every report carried SYNTHETIC_SAMPLES_PER_REPORT samples
+  std::vector<NodeTotals> totals = table.take();
+  uint64_t reports = 0;
+  CHECK(totals.size() == TEST_NODES);
+  for (size_t n = 0; n < totals.size(); n++) {
+    const NodeTotals& node = totals[n];
+    char id[REPORT_ID_SIZE];
+    int transport = (n % 2 == 0) ? VIA_SMTP : VIA_UDP;
+
+    snprintf(id, sizeof(id), "Seedling-%04u", (unsigned)n);
+    CHECK(node.id == id);
+    CHECK(node.reports[transport] > 0 && node.reports[1 - transport] == 0);
+    CHECK(node.readings == (node.reports[VIA_SMTP] + node.reports[VIA_UDP]) * SYNTHETIC_SAMPLES_PER_REPORT);
+    CHECK(node.untimed == 0);
+    CHECK(node.sensorCount == SENSOR_KNOWN_COUNT);
+    CHECK(node.sensors[SENSOR_BATTERY].min >= 3.0f && node.sensors[SENSOR_BATTERY].max <= 4.5f);
+    reports += node.reports[VIA_SMTP] + node.reports[VIA_UDP];
+  }
+  CHECK(reports == stats.reports[VIA_SMTP] + stats.reports[VIA_UDP]);
+  table.merge(totals); // for the digest
+}
+
+// Method to check a datagram that isn't a report gets no ack
+static void testNoAckForGarbage(Server& collector) {
+  struct sockaddr_in address = loopback(collector.getUdpPort());
+  struct timeval wait = { 0, NO_ACK_WAIT_MS * 1000 };
+  uint64_t malformed = collector.getStats().malformed;
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  uint8_t ack[4];
+
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof(wait));
+  sendto(fd, "hello", 5, 0, (struct sockaddr*)&address, sizeof(address));
+  CHECK(recv(fd, ack, sizeof(ack), 0) < 0);
+  CHECK(collector.getStats().malformed == malformed + 1);
+  close(fd);
+}
+
+// Method to send the digest upstream, and keep it when it can't be sent
+static void testDigest(NodeTable& table, Server& upstream, UpstreamMailbox& mailbox) {
+  std::vector<NodeTotals> totals = table.take();
+  std::vector<std::string> to = { "owner@example.com", "spare@example.com" };
+  std::string message, error;
+  int64_t now = time(NULL);
+
+  Digest::writeMessage(totals, now - 60, now, "collector@example.com", to, message);
+  CHECK(message.find("Subject: " DIGEST_SUBJECT ": 60 nodes") != std::string::npos);
+
+  SmtpClient client(LOOPBACK, upstream.getSmtpPort());
+  CHECK(client.send("collector@example.com", to, message, error));
+  CHECK(error.empty());
+  {
+    std::lock_guard<std::mutex> guard(mailbox.lock);
+    CHECK(mailbox.messages.size() == 1);
+    if (mailbox.messages.size() == 1) {
+      const RelayedMessage& received = mailbox.messages[0];
+      CHECK(received.from == "collector@example.com");
+      CHECK(received.recipients == to);
+      CHECK(received.text == message); // every line within limits and nothing lost to dot stuffing
+      CHECK(received.text.find("<td>Seedling-0059</td>") != std::string::npos);
+    }
+  }
+
+  // Nobody listening: the totals go back for the next digest
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address = loopback(0);
+  socklen_t length = sizeof(address);
+  bind(fd, (struct sockaddr*)&address, sizeof(address));
+  getsockname(fd, (struct sockaddr*)&address, &length);
+  close(fd); // a port nothing listens on
+
+  SmtpClient closed(LOOPBACK, ntohs(address.sin_port));
+  CHECK(!closed.send("collector@example.com", to, message, error));
+  CHECK(!error.empty());
+  table.merge(totals);
+  CHECK(table.size() == TEST_NODES);
+}
+
+// Method to check a connection that goes quiet is told so and closed
+static void testIdleTimeout(Server& upstream) {
+  struct sockaddr_in address = loopback(upstream.getSmtpPort());
+  struct timeval wait = { REPLY_WAIT_S, 0 };
+  std::string replies;
+  char buffer[256];
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof(wait));
+  CHECK(connect(fd, (struct sockaddr*)&address, sizeof(address)) == 0);
+  while (true) {
+    ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+    if (count <= 0) {
+      CHECK(count == 0); // closed by the server, not a timeout here
+      break;
+    }
+    replies.append(buffer, count);
+  }
+  CHECK(replies.compare(0, 4, "220 ") == 0);
+  CHECK(replies.find("\r\n421 ") != std::string::npos);
+  CHECK(upstream.getStats().timeouts == 1);
+  close(fd);
+}
+
+int main() {
+  NodeTable table;
+  UpstreamMailbox mailbox;
+  Server collector(table);
+  Server upstream(mailbox);
+  ServerConfig upstreamConfig = loopbackConfig(1);
+  std::string error;
+
+  upstreamConfig.idleTimeoutS = IDLE_TIMEOUT_S;
+  CHECK(collector.start(loopbackConfig(2), error));
+  CHECK(upstream.start(upstreamConfig, error));
+  CHECK(collector.getSmtpPort() != 0 && collector.getUdpPort() != 0);
+
+  testLoad(collector, table);
+  testNoAckForGarbage(collector);
+  testDigest(table, upstream, mailbox);
+  testIdleTimeout(upstream);
+
+  collector.stop();
+  upstream.stop();
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
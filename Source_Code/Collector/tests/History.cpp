@@ -0,0 +1,299 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// The history store and its queries: the AVX2 scans give what the plain loops do over every length and alignment
+// (NaN left out), reports land in the month they were taken in with untimed readings left out and missing
+// sensors as NaN, a row torn by a crash is trimmed before the next append, a sensor beyond the stock ones gets
+// a column of its own the first time a report carries it, and the summary, downsampling and dry-out prediction
+// give what the readings put in say, on one thread or several.
+
+// Include necessary header files
+#include "ColumnScan.h"
+#include "HistoryQuery.h"
+#include "HistoryStore.h"
+#include "Check.h"
+#include <fcntl.h>
+#include <ftw.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Definitions */
+#define MARCH_2017 1488326400 // 2017-03-01T00:00:00Z
+#define APRIL_2017 1491004800 // 2017-04-01T00:00:00Z
+#define HOUR_S 3600
+#define DAY_S 86400
+#define SCAN_ROWS 100
+#define EXTRA_SENSORS 2 // beyond the stock ones, carried by the middle report of testExtraSensors()
+
+/* Functions */
+
+// Function to remove one entry of a directory tree, for nftw()
+static int removeEntry(const char* path, const struct stat* status, int type, struct FTW* walk) {
+  (void)status; (void)type; (void)walk;
+  return remove(path);
+}
+
+// Method to check the AVX2 loops against the plain ones, over every length and start from 0 to 7 (unaligned)
+static void testScans() {
+  int32_t times[SCAN_ROWS + 8];
+  float values[SCAN_ROWS + 8];
+  uint32_t random = 1;
+
+  for (int i = 0; i < SCAN_ROWS + 8; i++) {
+    random = random * 1103515245u + 12345u;
+    times[i] = (random >> 8) % 1000;
+    values[i] = (i % 13 == 0) ? NAN : (float)((int)(random >> 16) % 2000 - 1000) / 10.0f;
+  }
+
+  for (int start = 0; start < 8; start++) {
+    for (size_t count = 0; count <= SCAN_ROWS; count++) {
+      ColumnStats fast = ColumnScan::empty(), plain = ColumnScan::empty();
+      std::vector<float> fastValues, plainValues;
+
+      ColumnScan::aggregate(times + start, values + start, count, 200, 700, fast);
+      ColumnScan::collect(times + start, values + start, count, 200, 700, fastValues);
+      ColumnScan::setVectorized(false);
+      ColumnScan::aggregateScalar(times + start, values + start, count, 200, 700, plain);
+      ColumnScan::collect(times + start, values + start, count, 200, 700, plainValues);
+      ColumnScan::setVectorized(true);
+
+      CHECK(fast.count == plain.count);
+      CHECK(fast.count == 0 || (fast.min == plain.min && fast.max == plain.max));
+      CHECK(fabs(fast.sum - plain.sum) < 1e-9);
+      CHECK(fastValues == plainValues);
+      CHECK(fastValues.size() == fast.count);
+    }
+  }
+
+  // A run ends at the first row out of range, wherever it is
+  int32_t run[20];
+  for (int end = 0; end < 20; end++) {
+    for (int i = 0; i < 20; i++) {
+      run[i] = (i < end) ? 50 + i : 10;
+    }
+    CHECK(ColumnScan::runEnd(run, 0, 20, 50, 100) == (size_t)end);
+    CHECK(ColumnScan::runEnd(run, end, 20, 50, 100) == (size_t)end);
+  }
+  printf("scans %s\n", ColumnScan::isVectorized() ? "vectorized (AVX2)" : "scalar (no AVX2 here)");
+}
+
+// Function to get a reading taken at a time, all four sensors derived from it
+static Reading reading(int64_t time, float moisture) {
+  Reading made = {};
+
+  made.time = time;
+  made.values[SENSOR_LIGHT] = (float)(time % DAY_S) / 100.0f;
+  made.values[SENSOR_TEMPERATURE] = 70.0f;
+  made.values[SENSOR_MOISTURE] = moisture;
+  made.values[SENSOR_BATTERY] = 3.9f;
+  return made;
+}
+
+// Function to get the size of a partition's column file, -1 if it isn't there
+static off_t columnSize(const std::string& partition, int column) {
+  struct stat status;
+
+  return (stat((partition + HistoryStore::columnFile(column)).c_str(), &status) == 0) ? status.st_size : -1;
+}
+
+// Method to write two nodes' readings and read them back: hourly through March and April, soil drying 1% a day
+// from 60% after a watering on 20 April, one node without a battery reading, and a reading sent late
+static void testStore(const std::string& root) {
+  HistoryStore store(root);
+  std::string error;
+  NodeReport report;
+
+  CHECK(store.open(error));
+  CHECK(HistoryStore::partitionStart(APRIL_2017 - 1) == MARCH_2017);
+  CHECK(HistoryStore::partitionEnd(MARCH_2017) == APRIL_2017);
+  CHECK(HistoryStore::partitionName(APRIL_2017) == "2017-04");
+  CHECK(HistoryStore::nodeDirectory("Seedling-01") == "Seedling-01");
+  CHECK(HistoryStore::nodeDirectory("../a b") == "_._a_b");
+
+  // A day a report, the newest half first as the nodes send samples before backlog
+  for (int64_t day = MARCH_2017; day < APRIL_2017 + 30 * DAY_S; day += DAY_S) {
+    for (const char* node : { "Seedling-01", "Seedling-02" }) {
+      strcpy(report.id, node);
+      report.sensorCount = (strcmp(node, "Seedling-02") == 0) ? SENSOR_MOISTURE + 1 : SENSOR_KNOWN_COUNT;
+      report.readings.clear();
+      for (int h = 12; h < 36; h++) {
+        int64_t time = day + (h % 24) * HOUR_S;
+        float moisture = (time < APRIL_2017 + 19 * DAY_S) ? 50.0f : 60.0f - (float)(time - (APRIL_2017 + 19 * DAY_S)) / DAY_S;
+        report.readings.push_back(reading(time, moisture));
+      }
+      report.readings.push_back(reading(REPORT_TIME_UNKNOWN, 0.0f));
+      CHECK(store.handleReport(report, VIA_UDP, false));
+    }
+  }
+  HistoryStats stats = store.getStats();
+  CHECK(stats.rows == 2 * 61 * 24);
+  CHECK(stats.untimed == 2 * 61);
+  CHECK(stats.failures == 0);
+  store.close();
+
+  // A crash after the value columns of a row, but before its time: the next append trims it off first
+  std::string march = root + "/Seedling-01/2017-03/";
+  int fd = open((march + HistoryStore::columnFile(SENSOR_LIGHT)).c_str(), O_WRONLY | O_APPEND);
+  CHECK(fd >= 0 && write(fd, "torn", 4) == 4);
+  close(fd);
+  HistoryReader torn(root);
+  CHECK(torn.open(error));
+  CHECK(torn.getPartitions().size() == 4 && torn.getPartitions()[0].rows == 31 * 24); // the reader doesn't see it
+  strcpy(report.id, "Seedling-01");
+  report.sensorCount = SENSOR_KNOWN_COUNT;
+  report.readings.assign(1, reading(MARCH_2017 + 30 * DAY_S + 23 * HOUR_S + 30 * 60, 50.0f));
+  CHECK(store.handleReport(report, VIA_SMTP, false));
+  store.close();
+  CHECK(columnSize(march, SENSOR_LIGHT) == (31 * 24 + 1) * HISTORY_VALUE_SIZE);
+  CHECK(columnSize(root + "/Seedling-02/2017-03/", SENSOR_BATTERY) == -1); // a sensor the node doesn't have
+}
+
+// Method to write a node that adds sensors: a row with the stock four, two with two more, then one without
+// them again. The new columns are padded for the rows before, a crash while one is padded leaves it out of the
+// reader until the next append pads it out, and the extra sensors are queried like the stock ones.
+static void testExtraSensors(const std::string& root) {
+  HistoryStore store(root);
+  std::string partition = root + "/Probe/2017-03/";
+  std::string error;
+  NodeReport report;
+  int extra = SENSOR_KNOWN_COUNT + EXTRA_SENSORS;
+  int64_t time = MARCH_2017;
+
+  CHECK(store.open(error));
+  strcpy(report.id, "Probe");
+  for (int sensors : { (int)SENSOR_KNOWN_COUNT, extra, (int)SENSOR_KNOWN_COUNT }) {
+    report.sensorCount = sensors;
+    report.readings.clear();
+    for (int r = 0; r < ((sensors == extra) ? 2 : 1); r++, time += HOUR_S) {
+      Reading made = reading(time, 40.0f);
+      made.values[SENSOR_KNOWN_COUNT] = 10.0f + r;
+      made.values[SENSOR_KNOWN_COUNT + 1] = -5.0f;
+      report.readings.push_back(made);
+    }
+    CHECK(store.handleReport(report, VIA_UDP, false));
+  }
+  store.close();
+  CHECK(columnSize(partition, HISTORY_TIME_COLUMN) == 4 * HISTORY_VALUE_SIZE);
+  CHECK(columnSize(partition, SENSOR_KNOWN_COUNT) == 4 * HISTORY_VALUE_SIZE);
+  CHECK(columnSize(partition, extra - 1) == 4 * HISTORY_VALUE_SIZE);
+  CHECK(columnSize(partition, extra) == -1);
+
+  HistoryReader reader(root);
+  CHECK(reader.open(error));
+  CHECK(reader.getPartitions().size() == 1 && reader.getPartitions()[0].sensors == (1u << extra) - 1);
+
+  HistoryQuery history(reader, 1);
+  HistoryRange all = { INT64_MIN, INT64_MAX, {} };
+  std::vector<NodeSummary> summaries;
+  CHECK(history.summarize(all, SENSOR_KNOWN_COUNT, { 100 }, summaries, error));
+  CHECK(summaries.size() == 1 && summaries[0].stats.count == 2);
+  CHECK(summaries[0].stats.min == 10.0f && summaries[0].stats.max == 11.0f);
+  CHECK(history.summarize(all, extra - 1, {}, summaries, error) && summaries[0].stats.count == 2);
+  CHECK(history.summarize(all, extra, {}, summaries, error) && summaries[0].stats.count == 0); // no column
+  CHECK(history.summarize(all, SENSOR_MOISTURE, {}, summaries, error) && summaries[0].stats.count == 4);
+
+  // Cut a column short as a crash while it was padded would: left out, then padded out by the next append
+  CHECK(truncate((partition + HistoryStore::columnFile(extra - 1)).c_str(), HISTORY_VALUE_SIZE) == 0);
+  CHECK(reader.open(error));
+  CHECK(!HistoryReader::hasSensor(reader.getPartitions()[0], extra - 1));
+  CHECK(HistoryReader::hasSensor(reader.getPartitions()[0], SENSOR_KNOWN_COUNT));
+  report.sensorCount = SENSOR_KNOWN_COUNT;
+  report.readings.assign(1, reading(time, 40.0f));
+  CHECK(store.handleReport(report, VIA_UDP, false));
+  store.close();
+  CHECK(columnSize(partition, extra - 1) == 5 * HISTORY_VALUE_SIZE);
+  CHECK(reader.open(error));
+  CHECK(HistoryReader::hasSensor(reader.getPartitions()[0], extra - 1));
+}
+
+// Method to check the queries against what testStore() put in, on the given threads
+static void testQueries(const std::string& root, int threads) {
+  HistoryReader reader(root);
+  std::string error;
+
+  CHECK(reader.open(error));
+  CHECK(reader.getNodes() == std::vector<std::string>({ "Seedling-01", "Seedling-02" }));
+  CHECK(reader.getRows() == 2 * 61 * 24 + 1);
+
+  HistoryQuery history(reader, threads);
+  HistoryRange all = { INT64_MIN, INT64_MAX, {} };
+  std::vector<NodeSummary> summaries;
+
+  // Battery 3.9 V throughout for the first node; the second has no battery reading
+  CHECK(history.summarize(all, SENSOR_BATTERY, {}, summaries, error));
+  CHECK(summaries.size() == 2);
+  CHECK(summaries[0].node == "Seedling-01" && summaries[0].stats.count == 61 * 24 + 1);
+  CHECK(summaries[0].stats.min == 3.9f && summaries[0].stats.max == 3.9f);
+  CHECK(summaries[1].stats.count == 0);
+  CHECK(history.getRowsScanned() == reader.getRows());
+
+  // Light over April's first day is the hour of the day: 0, 36 ... 828
+  HistoryRange day = { APRIL_2017, APRIL_2017 + DAY_S, { "Seedling-02" } };
+  CHECK(history.summarize(day, SENSOR_LIGHT, { 0, 50, 100 }, summaries, error));
+  CHECK(summaries.size() == 1 && summaries[0].node == "Seedling-02");
+  CHECK(summaries[0].stats.count == 24);
+  CHECK(summaries[0].stats.min == 0.0f && summaries[0].stats.max == 828.0f);
+  CHECK(fabs(summaries[0].stats.sum / 24 - 414.0) < 1e-3);
+  CHECK(summaries[0].percentiles == std::vector<float>({ 0.0f, 396.0f, 828.0f }));
+  CHECK(history.getRowsScanned() == 30 * 24);
+
+  // Daily buckets over a range that straddles the months, starting part way through a day
+  std::vector<NodeSeries> series;
+  HistoryRange days = { APRIL_2017 - 2 * DAY_S + 6 * HOUR_S, APRIL_2017 + 2 * DAY_S, { "Seedling-01" } };
+  CHECK(history.downsample(days, SENSOR_LIGHT, DAY_S, series, error));
+  CHECK(series.size() == 1 && series[0].buckets.size() == 4);
+  if (series.size() == 1 && series[0].buckets.size() == 4) {
+    uint64_t total = 0;
+    for (size_t b = 0; b < 4; b++) {
+      CHECK(series[0].buckets[b].start == days.from + (int64_t)b * DAY_S);
+      total += series[0].buckets[b].stats.count;
+    }
+    CHECK(series[0].buckets[1].stats.count == 25); // 6:00 to 6:00 the next day, and the late reading at 23:30
+    CHECK(series[0].buckets[3].stats.count == 18); // cut off at the end of the range
+    CHECK(total == 4 * 24 - 6 + 1);
+  }
+  CHECK(!history.downsample(days, SENSOR_LIGHT, 0, series, error));
+
+  // Watered to 60% on 20 April, 1% a day since: 20% is 40 days on; without the watering in range the prediction
+  // still follows the drying, and flat soil isn't predicted at all
+  std::vector<DryOutPrediction> predictions;
+  HistoryRange dryout = { APRIL_2017 + 17 * DAY_S, APRIL_2017 + 25 * DAY_S, {} };
+  CHECK(history.predictDryOut(dryout, 20.0f, predictions, error));
+  CHECK(predictions.size() == 2);
+  for (const DryOutPrediction& prediction : predictions) {
+    CHECK(prediction.f_Predicted);
+    CHECK(prediction.wateredAt == APRIL_2017 + 19 * DAY_S);
+    CHECK(fabs(prediction.ratePerDay + 1.0f) < 1e-3);
+    CHECK(fabs(prediction.moisture - (60.0f - 6.0f)) < 0.05f);
+    CHECK(llabs(prediction.dryAt - (APRIL_2017 + 59 * DAY_S)) < HOUR_S);
+    CHECK(prediction.readings == 2 * 24 + 1); // the newest two days, both ends in
+  }
+  HistoryRange flat = { APRIL_2017 + 5 * DAY_S, APRIL_2017 + 8 * DAY_S, { "Seedling-01" } };
+  CHECK(history.predictDryOut(flat, 20.0f, predictions, error));
+  CHECK(predictions.size() == 1 && !predictions[0].f_Predicted && predictions[0].wateredAt == 0);
+}
+
+int main() {
+  char root[] = "/tmp/plant_history_XXXXXX";
+
+  testScans();
+  CHECK(mkdtemp(root) != NULL);
+  testStore(std::string(root) + "/store");
+  testQueries(std::string(root) + "/store", 1);
+  testQueries(std::string(root) + "/store", 4);
+  ColumnScan::setVectorized(false);
+  testQueries(std::string(root) + "/store", 4);
+  ColumnScan::setVectorized(true);
+  testExtraSensors(std::string(root) + "/extra");
+  nftw(root, removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
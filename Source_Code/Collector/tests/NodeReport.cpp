@@ -0,0 +1,170 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Reports as the collector reads them: the ack CRC matches the standard check value, a record as the sketch
+// writes it decodes to readings placed on the collector's clock (backlog from before a power loss left
+// untimed), records cut short or missing their id are refused and keys the collector doesn't know are stepped
+// over. An emailed report gives back the same record, wherever its base64 lines break.
+
+// Include necessary header files
+#include "Crc32.h"
+#include "MailMessage.h"
+#include "NodeReport.h"
+#include "SyntheticNode.h"
+#include "Check.h"
+#include <math.h>
+#include <string.h>
+
+/* Definitions */
+#define ARRIVED_AT 1700000000 // Unix time the test records are taken to arrive at
+#define BOOT_TIME (ARRIVED_AT - 86400) // synthetic node powered up a day earlier
+#define SAMPLE_SPACING 300 // s
+#define TEST_SAMPLES 8 // 6 samples and 2 of backlog
+
+/* Constants */
+// {"id": "n", "t": 10, "b": [_ [20, 1.0]]}, a backlog reading from after "t" (the node has lost power since)
+static const uint8_t _AFTER_POWER_LOSS[] = { 0xa3, 0x62, 'i', 'd', 0x61, 'n', 0x61, 't', 0x0a, 0x61, 'b', 0x9f, 0x82, 0x14, 0xfa, 0x3f, 0x80, 0x00, 0x00, 0xff };
+// {"id": "n", "x": [1, 2], 1: 0}, a key this collector doesn't know and one that isn't text
+static const uint8_t _UNKNOWN_KEYS[] = { 0xa3, 0x62, 'i', 'd', 0x61, 'n', 0x61, 'x', 0x82, 0x01, 0x02, 0x01, 0x00 };
+// {"t": 10}, no id
+static const uint8_t _NO_ID[] = { 0xa1, 0x61, 't', 0x0a };
+// {"id": "n", "a": [0, 1], "s": [[1.0]]}, more ages than samples
+static const uint8_t _AGES_MISMATCH[] = { 0xa3, 0x62, 'i', 'd', 0x61, 'n', 0x61, 'a', 0x82, 0x00, 0x01, 0x61, 's', 0x81, 0x81, 0xfa, 0x3f, 0x80, 0x00, 0x00 };
+
+// {"id": "x", "a": [4294967280 items]}, 13 bytes claiming an array that would take 16 GB to hold
+static const uint8_t _HUGE_ARRAY[] = { 0xa2, 0x62, 'i', 'd', 0x61, 'x', 0x61, 'a', 0x9a, 0xff, 0xff, 0xff, 0xf0 };
+// {"id": "x", "s": [65535 items, [0]]}, the same for the samples
+static const uint8_t _HUGE_SAMPLES[] = { 0xa2, 0x62, 'i', 'd', 0x61, 'x', 0x61, 's', 0x99, 0xff, 0xff, 0x81, 0x00 };
+
+/* Functions */
+
+// Method to check the ack CRC against the CRC-32 check value, whole and chained
+static void testCrc() {
+  const char* check = "123456789";
+
+  CHECK(Crc32::compute(check, 9) == 0xCBF43926);
+  CHECK(Crc32::compute(check + 4, 5, Crc32::compute(check, 4)) == 0xCBF43926);
+  CHECK(Crc32::compute(check, 0) == 0);
+}
+
+// Method to decode a record as the sketch writes it: samples first, then the backlog
+static void testRecord(std::vector<uint8_t>& record, float (*values)[SENSOR_KNOWN_COUNT]) {
+  SyntheticNode node(7, 1, BOOT_TIME);
+  int64_t sentAt = ARRIVED_AT - TEST_SAMPLES * SAMPLE_SPACING;
+  NodeReport report;
+
+  for (int s = 0; s < TEST_SAMPLES; s++) {
+    node.takeSample(sentAt - (TEST_SAMPLES - 1 - s) * SAMPLE_SPACING);
+  }
+  node.writeRecord(sentAt, record);
+  CHECK(node.getSampleCount() == 0);
+
+  CHECK(report.parse(record.data(), record.size(), ARRIVED_AT));
+  CHECK(strcmp(report.id, "Seedling-0007") == 0);
+  CHECK(report.nodeTime == (uint32_t)(sentAt - BOOT_TIME));
+  CHECK(report.receivedAt == ARRIVED_AT);
+  CHECK(report.sensorCount == SENSOR_KNOWN_COUNT);
+  CHECK(report.readings.size() == TEST_SAMPLES);
+  if (report.readings.size() != TEST_SAMPLES) {
+    return;
+  }
+
+  // The newest six are samples, then the two oldest as backlog; all land where the node took them, shifted by
+  // the time the report spent in flight
+  for (int r = 0; r < TEST_SAMPLES; r++) {
+    int s = (r < SYNTHETIC_SAMPLES_PER_REPORT) ? r + 2 : r - SYNTHETIC_SAMPLES_PER_REPORT;
+    int64_t taken = sentAt - (TEST_SAMPLES - 1 - s) * SAMPLE_SPACING;
+    CHECK(report.readings[r].time == taken + (ARRIVED_AT - sentAt));
+    memcpy(values[s], report.readings[r].values, sizeof(values[s]));
+  }
+  CHECK(values[0][SENSOR_BATTERY] > 3.0f && values[0][SENSOR_BATTERY] < 4.5f);
+  CHECK(values[0][SENSOR_MOISTURE] >= 0.0f && values[0][SENSOR_MOISTURE] <= 100.0f);
+}
+
+// Method to check records that don't add up, or carry what the collector doesn't know
+static void testOddRecords(const std::vector<uint8_t>& record) {
+  NodeReport report;
+
+  CHECK(report.parse(_AFTER_POWER_LOSS, sizeof(_AFTER_POWER_LOSS), ARRIVED_AT));
+  CHECK(report.readings.size() == 1 && report.readings[0].time == REPORT_TIME_UNKNOWN);
+  CHECK(report.sensorCount == 1 && report.readings[0].values[0] == 1.0f);
+
+  CHECK(report.parse(_UNKNOWN_KEYS, sizeof(_UNKNOWN_KEYS), ARRIVED_AT));
+  CHECK(strcmp(report.id, "n") == 0 && report.readings.empty());
+
+  CHECK(!report.parse(_NO_ID, sizeof(_NO_ID), ARRIVED_AT));
+  CHECK(!report.parse(_AGES_MISMATCH, sizeof(_AGES_MISMATCH), ARRIVED_AT));
+
+  // Array counts bigger than what is left of the record are refused before anything is allocated for them
+  CHECK(!report.parse(_HUGE_ARRAY, sizeof(_HUGE_ARRAY), ARRIVED_AT));
+  CHECK(!report.parse(_HUGE_SAMPLES, sizeof(_HUGE_SAMPLES), ARRIVED_AT));
+
+  // Any record cut short is refused, as is one with something after it
+  int accepted = 0;
+  for (size_t length = 0; length < record.size(); length++) {
+    accepted += report.parse(record.data(), length, ARRIVED_AT) ? 1 : 0;
+  }
+  CHECK(accepted == 0);
+
+  std::vector<uint8_t> trailing(record);
+  trailing.push_back(0x00);
+  CHECK(!report.parse(trailing.data(), trailing.size(), ARRIVED_AT));
+}
+
+// Method to find the record in an email as the SMTP class sends it, and the subject's alert
+static void testEmail(const std::vector<uint8_t>& record) {
+  SyntheticNode node(7, 1, BOOT_TIME);
+  std::vector<uint8_t> found;
+  std::string email;
+
+  node.writeEmail(record, false, email);
+  CHECK(MailMessage::findRecord(email, found));
+  CHECK(found == record);
+  CHECK(!MailMessage::isAlert(email));
+
+  node.writeEmail(record, true, email);
+  CHECK(MailMessage::isAlert(email));
+
+  // Lines broken at other lengths than 76 still decode to the same record
+  size_t start = email.find("\r\n\r\n", email.find("application/cbor")) + 4;
+  size_t end = email.find("--PlantReportPart--");
+  std::string base64;
+  for (size_t i = start; i < end; i++) {
+    if (email[i] != '\r' && email[i] != '\n') {
+      base64 += email[i];
+    }
+  }
+  std::string rewrapped = email.substr(0, start);
+  for (size_t i = 0; i < base64.size(); i += 7) {
+    rewrapped += base64.substr(i, 7) + "\r\n";
+  }
+  rewrapped += email.substr(end);
+  found.clear();
+  CHECK(MailMessage::findRecord(rewrapped, found));
+  CHECK(found == record);
+
+  // A report from before records were attached has none to find
+  CHECK(!MailMessage::findRecord("Subject: Plant Report\r\n\r\n<html>\r\n<body>\r\n</body></html>\r\n", found));
+
+  found.clear();
+  CHECK(MailMessage::decodeBase64("TWFu\r\nTWE=", 10, found));
+  CHECK(found.size() == 5 && memcmp(found.data(), "ManMa", 5) == 0);
+  CHECK(!MailMessage::decodeBase64("TW*u", 4, found));
+  CHECK(!MailMessage::decodeBase64("TWE=TWFu", 8, found));
+}
+
+int main() {
+  std::vector<uint8_t> record;
+  float values[TEST_SAMPLES][SENSOR_KNOWN_COUNT];
+
+  testCrc();
+  testRecord(record, values);
+  testOddRecords(record);
+  testEmail(record);
+
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
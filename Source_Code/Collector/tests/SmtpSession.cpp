@@ -0,0 +1,191 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// The relay's side of the dialogue the nodes' SMTP class has with it: the pipelined envelope and the message
+// with QUIT behind it are answered in order however the bytes are split up, dot stuffing is undone, mail the
+// sink can't take gets a 451, and commands out of order, over-long lines and over-size messages are refused
+// without losing the session.
+
+// Include necessary header files
+#include "SmtpSession.h"
+#include "Check.h"
+#include <string.h>
+
+/* Definitions */
+#define NODE_ENVELOPE "MAIL FROM: <PLANT@MONITOR.EMAIL>\r\nRCPT TO: <DEFAULT@RECEIPIENT.HERE>\r\nDATA\r\n"
+#define NODE_MESSAGE "Subject: Plant Report\r\n\r\n<html>\r\n..hidden\r\n.\r\n"
+
+/* Sink that keeps what it is given */
+class RecordingSink : public MessageSink {
+  public:
+    std::vector<RelayedMessage> messages;
+    bool f_Refuse = false;
+
+    bool deliver(const RelayedMessage& message) override {
+      if (f_Refuse) {
+        return false;
+      }
+      messages.push_back(message);
+      return true;
+    }
+};
+
+/* Functions */
+
+// Function to get the reply codes in out, one per reply (continuation lines left out)
+static std::string replyCodes(const std::string& out) {
+  std::string codes;
+  size_t pos = 0;
+
+  while (pos < out.size()) {
+    size_t end = out.find("\r\n", pos);
+    if (end == std::string::npos) {
+      break;
+    }
+    if (end - pos >= 4 && out[pos + 3] != '-') {
+      codes += (codes.empty() ? "" : " ") + out.substr(pos, 3);
+    }
+    pos = end + 2;
+  }
+  return codes;
+}
+
+// Method to play the node's session in one write per step, then a byte at a time
+static void testNodeDialogue() {
+  const char* steps[] = { "EHLO Seedling\r\n", NODE_ENVELOPE, NODE_MESSAGE "QUIT\r\n" };
+  const char* expected[] = { "250", "250 250 354", "250 221" };
+
+  for (int f_ByteAtATime = 0; f_ByteAtATime <= 1; f_ByteAtATime++) {
+    RecordingSink sink;
+    SmtpSession session(sink, "collector");
+    std::string out;
+
+    session.greet(out);
+    CHECK(replyCodes(out) == "220");
+    CHECK(out.find("collector") != std::string::npos);
+
+    for (int s = 0; s < 3; s++) {
+      out.clear();
+      if (f_ByteAtATime) {
+        for (size_t i = 0; i < strlen(steps[s]); i++) {
+          session.receive(steps[s] + i, 1, out);
+        }
+      }
+      else {
+        session.receive(steps[s], strlen(steps[s]), out);
+      }
+      CHECK(replyCodes(out) == expected[s]);
+      if (s == 0) {
+        CHECK(out.find("PIPELINING") != std::string::npos);
+      }
+    }
+
+    CHECK(session.isClosed());
+    CHECK(session.getMessageCount() == 1);
+    CHECK(sink.messages.size() == 1);
+    if (sink.messages.size() == 1) {
+      const RelayedMessage& message = sink.messages[0];
+      CHECK(message.from == "PLANT@MONITOR.EMAIL");
+      CHECK(message.recipients.size() == 1 && message.recipients[0] == "DEFAULT@RECEIPIENT.HERE");
+      CHECK(message.text == "Subject: Plant Report\r\n\r\n<html>\r\n.hidden\r\n");
+    }
+  }
+}
+
+// Method to check a message the sink won't take now is refused for later, and the session carries on
+static void testNotTaken() {
+  RecordingSink sink;
+  SmtpSession session(sink, "collector");
+  std::string out;
+
+  sink.f_Refuse = true;
+  session.receive("HELO Seedling\r\n" NODE_ENVELOPE NODE_MESSAGE, strlen("HELO Seedling\r\n" NODE_ENVELOPE NODE_MESSAGE), out);
+  CHECK(replyCodes(out) == "250 250 250 354 451");
+
+  out.clear();
+  sink.f_Refuse = false;
+  session.receive(NODE_ENVELOPE NODE_MESSAGE, strlen(NODE_ENVELOPE NODE_MESSAGE), out);
+  CHECK(replyCodes(out) == "250 250 354 250");
+  CHECK(sink.messages.size() == 1);
+}
+
+// Method to check commands given out of order or not understood
+static void testOutOfOrder() {
+  RecordingSink sink;
+  SmtpSession session(sink, "collector");
+  std::string out;
+  const char* commands = "MAIL FROM:<a@b>\r\n" // before EHLO
+                         "EHLO x\r\n"
+                         "RCPT TO:<c@d>\r\n" // before MAIL
+                         "DATA\r\n" // before MAIL
+                         "MAIL FROM:<a@b>\r\n"
+                         "MAIL FROM:<a@b>\r\n" // twice
+                         "DATA\r\n" // no recipients
+                         "RCPT TO:c@d\r\n" // no brackets
+                         "AUTH PLAIN AGFAYg==\r\n"
+                         "VRFY c@d\r\n"
+                         "FROB\r\n"
+                         "RSET\r\n"
+                         "RCPT TO:<c@d>\r\n" // the reset dropped MAIL
+                         "NOOP\r\n";
+
+  session.receive(commands, strlen(commands), out);
+  CHECK(replyCodes(out) == "503 250 503 503 250 503 503 501 502 252 500 250 503 250");
+  CHECK(!session.isClosed());
+  CHECK(sink.messages.empty());
+}
+
+// Method to check the line and message limits
+static void testLimits() {
+  RecordingSink sink;
+  SmtpSession session(sink, "collector");
+  std::string out;
+  std::string longLine(SMTP_LINE_MAX + 10, 'x');
+
+  // A command line too long is refused as a whole and the next one is read as usual
+  session.receive((longLine + "\r\nEHLO x\r\n").c_str(), longLine.size() + 10, out);
+  CHECK(replyCodes(out) == "500 250");
+
+  // A message line too long fails the message when it ends
+  out.clear();
+  std::string message = NODE_ENVELOPE + longLine + "\r\nshort\r\n.\r\n";
+  session.receive(message.c_str(), message.size(), out);
+  CHECK(replyCodes(out) == "250 250 354 554");
+
+  // So does a message too big, however short its lines
+  out.clear();
+  std::string big = NODE_ENVELOPE;
+  std::string line(SMTP_LINE_MAX - 3, 'y');
+  for (size_t size = 0; size <= SMTP_MESSAGE_MAX; size += line.size() + 2) {
+    big += line + "\r\n";
+  }
+  big += ".\r\n";
+  session.receive(big.c_str(), big.size(), out);
+  CHECK(replyCodes(out) == "250 250 354 552");
+  CHECK(sink.messages.empty());
+
+  // The session still works afterwards
+  out.clear();
+  session.receive(NODE_ENVELOPE NODE_MESSAGE, strlen(NODE_ENVELOPE NODE_MESSAGE), out);
+  CHECK(replyCodes(out) == "250 250 354 250");
+  CHECK(sink.messages.size() == 1);
+
+  // An idle connection gets a 421 and counts as closed
+  out.clear();
+  session.timeOut(out);
+  CHECK(replyCodes(out) == "421");
+  CHECK(session.isClosed());
+}
+
+int main() {
+  testNodeDialogue();
+  testNotTaken();
+  testOutOfOrder();
+  testLimits();
+
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,69 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "Base64Writer.h"
+
+/* Constants */
+static const char _ALPHABET[] PROGMEM = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Constructors */
+// Constructor that writes the encoded text to the specified output
+Base64Writer::Base64Writer(Print& out, uint8_t lineLength)
+  : _out(out), _group(0), _groupLength(0), _maxLineLength(lineLength), _lineLength(0), f_Finished(false)
+{
+}
+
+// Destructor that makes sure the last bytes are written
+Base64Writer::~Base64Writer() {
+  finish();
+}
+
+/* Functions */
+
+// Function for encoding a single byte, every third one completes a group of 4 characters
+size_t Base64Writer::write(uint8_t c) {
+  _group = (_group << 8) | c;
+  if (++_groupLength == 3) {
+    writeGroup(3);
+  }
+
+  return 1;
+}
+
+// Method for padding out the last group and ending the last line
+void Base64Writer::finish() {
+  if (f_Finished) {
+    return;
+  }
+
+  if (_groupLength > 0) {
+    uint8_t length = _groupLength;
+    _group <<= 8 * (3 - length); // line the bytes up as if the group were full
+    writeGroup(length);
+  }
+  if (_lineLength > 0) {
+    _out.print(F("\r\n"));
+  }
+  f_Finished = true;
+}
+
+// Method for writing the group as 4 characters of 6 bits each, '=' standing in for missing bytes
+void Base64Writer::writeGroup(uint8_t length) {
+  for (int i = 0; i < 4; i++) {
+    _out.write((i <= length) ? pgm_read_byte(&_ALPHABET[(_group >> (18 - (6 * i))) & 0x3F]) : '=');
+  }
+  _group = 0;
+  _groupLength = 0;
+
+  _lineLength += 4;
+  if (_maxLineLength != BASE64_SINGLE_LINE && _lineLength >= _maxLineLength) {
+    _out.print(F("\r\n"));
+    _lineLength = 0;
+  }
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,45 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Base64Writer_h
+#define Base64Writer_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+/* Definitions */
+#define BASE64_LINE_LENGTH 76 // characters per line, the MIME limit
+#define BASE64_SINGLE_LINE 0 // line length for encoding everything on one line (e.g. a command argument)
+
+/* Base64Writer class definition */
+// Base64 encodes whatever is written to it on the way through to another Print, in CRLF terminated
+// lines, so binary data (e.g. a CBOR record or the AUTH PLAIN credentials) can go into an email or command
+// without being held in memory
+class Base64Writer : public Print {
+	public:
+		/* Constructors */
+		Base64Writer(Print& out, uint8_t lineLength=BASE64_LINE_LENGTH); // constructor that writes the encoded text to the specified output, in lines of lineLength characters
+		~Base64Writer(); // destructor that finishes the encoding
+
+		/* Public Functions and Methods */
+		size_t write(uint8_t c) override; // function for encoding a single byte
+		using Print::write; // several bytes go through write(uint8_t) one at a time
+		void finish(); // method for padding out the last group and ending the last line
+	private:
+		/* Private Instance Variables */
+		Print& _out; // where the encoded text ends up
+		uint32_t _group; // bytes waiting to make up a group of 3
+		uint8_t _groupLength; // number of bytes in the group
+		uint8_t _maxLineLength; // characters per line (BASE64_SINGLE_LINE = no limit)
+		uint16_t _lineLength; // characters written on the current line
+		bool f_Finished; // whether finish() has already ended the encoding
+
+		/* Private Functions and Methods */
+		void writeGroup(uint8_t length); // method for writing the group as 4 characters, padding for fewer than 3 bytes
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
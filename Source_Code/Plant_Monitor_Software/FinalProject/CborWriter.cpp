@@ -0,0 +1,130 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "CborWriter.h"
+
+/* Definitions */
+// Major types (top 3 bits of the initial byte)
+#define CBOR_UNSIGNED 0
+#define CBOR_NEGATIVE 1
+#define CBOR_TEXT 3
+#define CBOR_ARRAY 4
+#define CBOR_MAP 5
+#define CBOR_SIMPLE 7
+
+// Additional information (bottom 5 bits), saying how many bytes of argument follow
+#define CBOR_INLINE_MAX 23 // arguments up to this fit in the initial byte
+#define CBOR_ARG_1 24
+#define CBOR_ARG_2 25
+#define CBOR_ARG_4 26 // also marks a single precision float under CBOR_SIMPLE
+#define CBOR_INDEFINITE 31 // length not given, items run until a break
+#define CBOR_BREAK 0xFF // ends an item of indefinite length
+
+/* Constructors */
+// Constructor that writes to the specified output
+CborWriter::CborWriter(Print& out)
+  : _out(out)
+{
+}
+
+/* Functions */
+
+// Method for writing an unsigned integer
+void CborWriter::writeUInt(uint32_t value) {
+  writeHead(CBOR_UNSIGNED, value);
+}
+
+// Method for writing a signed integer
+// Negative numbers are stored as -1 - n
+void CborWriter::writeInt(int32_t value) {
+  if (value < 0) {
+    writeHead(CBOR_NEGATIVE, (uint32_t)(-1 - value));
+  }
+  else {
+    writeHead(CBOR_UNSIGNED, (uint32_t)value);
+  }
+}
+
+// Method for writing a single precision float, big-endian like every CBOR argument
+void CborWriter::writeFloat(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  uint8_t item[5] = { (uint8_t)((CBOR_SIMPLE << 5) | CBOR_ARG_4),
+                      (uint8_t)(bits >> 24), (uint8_t)(bits >> 16), (uint8_t)(bits >> 8), (uint8_t)bits };
+  _out.write(item, sizeof(item));
+}
+
+// Method for writing a text string from RAM
+void CborWriter::writeText(const char* text) {
+  size_t len = strlen(text);
+
+  writeHead(CBOR_TEXT, len);
+  _out.write((const uint8_t*)text, len);
+}
+
+// Method for writing a text string from flash
+void CborWriter::writeTextP(PGM_P text) {
+  size_t len = strlen_P(text);
+
+  writeHead(CBOR_TEXT, len);
+  _out.print(FPSTR(text));
+}
+
+// Method for starting an array of count items
+void CborWriter::beginArray(uint32_t count) {
+  writeHead(CBOR_ARRAY, count);
+}
+
+// Method for starting an array of unknown length
+void CborWriter::beginArray() {
+  _out.write((uint8_t)((CBOR_ARRAY << 5) | CBOR_INDEFINITE));
+}
+
+// Method for ending an array started without a length
+void CborWriter::endArray() {
+  _out.write((uint8_t)CBOR_BREAK);
+}
+
+// Method for starting a map of count key/value pairs
+void CborWriter::beginMap(uint32_t count) {
+  writeHead(CBOR_MAP, count);
+}
+
+// Method for writing an item's type and argument in the shortest form
+void CborWriter::writeHead(uint8_t majorType, uint32_t value) {
+  uint8_t head[5];
+  size_t len;
+
+  if (value <= CBOR_INLINE_MAX) {
+    head[0] = (majorType << 5) | value;
+    len = 1;
+  }
+  else if (value <= 0xFF) {
+    head[0] = (majorType << 5) | CBOR_ARG_1;
+    head[1] = value;
+    len = 2;
+  }
+  else if (value <= 0xFFFF) {
+    head[0] = (majorType << 5) | CBOR_ARG_2;
+    head[1] = value >> 8;
+    head[2] = value;
+    len = 3;
+  }
+  else {
+    head[0] = (majorType << 5) | CBOR_ARG_4;
+    head[1] = value >> 24;
+    head[2] = value >> 16;
+    head[3] = value >> 8;
+    head[4] = value;
+    len = 5;
+  }
+
+  _out.write(head, len);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
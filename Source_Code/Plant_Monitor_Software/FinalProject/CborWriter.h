@@ -0,0 +1,40 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef CborWriter_h
+#define CborWriter_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+/* CborWriter class definition */
+// Writes CBOR (RFC 7049) items to any Print. Maps have a definite length, so the number of entries has to be
+// known up front; arrays can also be left open and ended with endArray(). Floats are always single precision.
+class CborWriter {
+	public:
+		/* Constructors */
+		CborWriter(Print& out); // constructor that writes to the specified output
+		
+		/* Public Functions and Methods */
+		void writeUInt(uint32_t value); // method for writing an unsigned integer
+		void writeInt(int32_t value); // method for writing a signed integer
+		void writeFloat(float value); // method for writing a single precision float
+		void writeText(const char* text); // method for writing a text string from RAM
+		void writeTextP(PGM_P text); // method for writing a text string from flash
+		void beginArray(uint32_t count); // method for starting an array of count items
+		void beginArray(); // method for starting an array of unknown length
+		void endArray(); // method for ending an array started without a length
+		void beginMap(uint32_t count); // method for starting a map of count key/value pairs
+	private:
+		/* Private Instance Variables */
+		Print& _out; // where the encoded items go
+	
+		/* Private Functions and Methods */
+		void writeHead(uint8_t majorType, uint32_t value); // method for writing an item's type and argument in the shortest form
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,229 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "ConnectionManager.h"
+#include "RTCStore.h"
+#include "WakeClock.h"
+#include "Hal.h"
+#include <ESP8266WiFi.h>
+
+/* Definitions */
+#define FAST_CONNECT_TIMEOUT 3000 // longest we give the cached settings before falling back to a full scan (ms)
+#define CONNECT_POLL_INTERVAL 10 // how often to check the connection status (ms)
+#define BSSID_SIZE 6
+#define DEFAULT_LEASE_TIME 3600 // lease length assumed if the DHCP client can't tell (s), the shortest routers commonly give
+
+/* Variables */
+// Settings of the last good connection, persisted in RTC memory between wakes
+struct ConnectionCache {
+  uint8_t bssid[BSSID_SIZE]; // MAC address of the access point
+  uint8_t channel; // WiFi channel the access point was on
+  uint8_t valid; // whether the rest of the cache may be used
+  uint32_t ip; // address, gateway, mask and DNS server from the DHCP lease
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  uint32_t leaseStart; // WakeClock time the lease was obtained
+  uint32_t leaseTime; // its length (s)
+};
+
+static_assert(RTCStore::blocksFor(sizeof(ConnectionCache)) <= RTC_CONNECTION_CACHE_BLOCKS, "ConnectionCache does not fit its RTC slot");
+
+static ConnectionCache _cache;
+static ConnectAttempt _attempts[CONNECT_MAX_ATTEMPTS];
+static int _attemptCount = 0;
+static ConnectState _state = CONNECT_IDLE;
+static const char* _ssid; // network being joined
+static const char* _pass;
+static unsigned long _timeout; // time allowed for joining (ms)
+static unsigned long _start; // millis() when joining began
+static unsigned long _attemptStart; // millis() when the current attempt began
+static unsigned long _doneAt = 0; // millis() when joining succeeded or gave up (0 = not yet)
+
+/* Functions */
+
+// Function to join the network, giving up once timeout ms have passed
+bool ConnectionManager::connect(const char* ssid, const char* pass, const char* hostname, unsigned long timeout) {
+  begin(ssid, pass, hostname, timeout);
+  return finish();
+}
+
+// Method to start joining the network, giving up once timeout ms have passed
+// The cached access point and IP settings skip the channel scan and DHCP exchange, and a full
+// connection is only made when there is no cache or it no longer works (e.g. AP moved channel).
+// A static configuration never talks to the DHCP server, so the lease would run out and the address could be
+// handed to another host; once half of it has passed (when a DHCP client renews) the full connection renews it.
+void ConnectionManager::begin(const char* ssid, const char* pass, const char* hostname, unsigned long timeout) {
+  _ssid = ssid;
+  _pass = pass;
+  _timeout = timeout;
+  _start = Hal::millis();
+  _doneAt = 0;
+  _attemptCount = 0;
+
+  WiFi.persistent(false); // don't rewrite the credentials to flash on every wake
+  WiFi.mode(WIFI_STA);
+  WiFi.hostname(hostname); // change hostname to something more friendly
+
+  if (RTCStore::load(RTC_CONNECTION_CACHE_SLOT, &_cache, sizeof(_cache)) && _cache.valid && !isLeaseDue()) {
+    _attemptStart = Hal::millis();
+    // Reuse the previous lease as a static configuration and go straight to the known AP and channel
+    WiFi.config(IPAddress(_cache.ip), IPAddress(_cache.gateway), IPAddress(_cache.subnet), IPAddress(_cache.dns));
+    WiFi.begin(ssid, pass, _cache.channel, _cache.bssid);
+    _state = CONNECT_FAST;
+  }
+  else {
+    beginFullConnect();
+  }
+}
+
+// Function to check on the connection, moving on to the next attempt or giving up when one runs out of time
+ConnectState ConnectionManager::poll() {
+  unsigned long now = Hal::millis();
+  bool connected = (WiFi.status() == WL_CONNECTED);
+
+  switch (_state) {
+    case CONNECT_FAST:
+      if (connected) {
+        recordAttempt(true, true, _attemptStart);
+        _state = CONNECT_DONE;
+      }
+      else if ((now - _attemptStart) >= min((unsigned long)FAST_CONNECT_TIMEOUT, _timeout)) {
+        recordAttempt(true, false, _attemptStart);
+        if ((now - _attemptStart) >= FAST_CONNECT_TIMEOUT) { // cut short by the caller's timeout says nothing about the settings
+          invalidateCache(); // stale settings, don't try them again next wake
+        }
+        WiFi.disconnect();
+        WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0)); // back to DHCP
+
+        if ((now - _start) >= _timeout) { // no time left for a full connection
+          _state = CONNECT_FAILED;
+        }
+        else {
+          beginFullConnect();
+        }
+      }
+      break;
+
+    case CONNECT_FULL:
+      if (connected) {
+        recordAttempt(false, true, _attemptStart);
+        saveCache();
+        _state = CONNECT_DONE;
+      }
+      else if ((now - _start) >= _timeout) {
+        recordAttempt(false, false, _attemptStart);
+        _state = CONNECT_FAILED;
+      }
+      break;
+
+    default: // nothing in progress
+      break;
+  }
+
+  if ((_state == CONNECT_DONE || _state == CONNECT_FAILED) && _doneAt == 0) {
+    _doneAt = max(now, 1UL); // 0 means still going
+  }
+
+  return _state;
+}
+
+// Function to wait for a connection begun with begin(), returns true once joined
+bool ConnectionManager::finish() {
+  ConnectState state;
+
+  while ((state = poll()) == CONNECT_FAST || state == CONNECT_FULL) {
+    Hal::delay(CONNECT_POLL_INTERVAL);
+  }
+
+  return (state == CONNECT_DONE);
+}
+
+// Method to abandon the connection and turn the radio off (e.g. nothing turned out to need sending)
+void ConnectionManager::cancel() {
+  WiFi.disconnect(true);
+  WiFi.forceSleepBegin();
+  _state = CONNECT_IDLE;
+}
+
+// Function to get the progress of the connection without advancing it
+ConnectState ConnectionManager::getState() {
+  return _state;
+}
+
+// Function to get how long joining took, or has taken so far (ms)
+unsigned long ConnectionManager::getConnectTime() {
+  return ((_doneAt != 0) ? _doneAt : Hal::millis()) - _start;
+}
+
+// Function to get the number of attempts made by the last call to connect()
+int ConnectionManager::getAttemptCount() {
+  return _attemptCount;
+}
+
+// Function to get the timing of one of the attempts made by the last call to connect()
+ConnectAttempt ConnectionManager::getAttempt(int index) {
+  return _attempts[index];
+}
+
+// Method to output the attempt timings over serial
+void ConnectionManager::printAttempts() {
+  for (int i = 0; i < _attemptCount; i++) {
+    Serial.print(_attempts[i].fastPath ? "Cached connect " : "Full connect ");
+    Serial.print(_attempts[i].connected ? "succeeded in " : "failed after ");
+    Serial.print(_attempts[i].duration);
+    Serial.println(" ms");
+  }
+}
+
+// Method to start a connection that scans all channels and asks for a lease
+void ConnectionManager::beginFullConnect() {
+  _attemptStart = Hal::millis();
+  WiFi.begin(_ssid, _pass);
+  _state = CONNECT_FULL;
+}
+
+// Method to note the timing of an attempt
+void ConnectionManager::recordAttempt(bool fastPath, bool connected, unsigned long start) {
+  if (_attemptCount < CONNECT_MAX_ATTEMPTS) {
+    _attempts[_attemptCount].fastPath = fastPath;
+    _attempts[_attemptCount].connected = connected;
+    _attempts[_attemptCount].duration = Hal::millis() - start;
+    _attemptCount++;
+  }
+}
+
+// Method to remember the current connection settings in RTC memory
+void ConnectionManager::saveCache() {
+  memcpy(_cache.bssid, WiFi.BSSID(), BSSID_SIZE);
+  _cache.channel = WiFi.channel();
+  _cache.valid = true;
+  _cache.ip = WiFi.localIP();
+  _cache.gateway = WiFi.gatewayIP();
+  _cache.subnet = WiFi.subnetMask();
+  _cache.dns = WiFi.dnsIP();
+  _cache.leaseStart = WakeClock::now(); // only a full connection gets a lease, so it was obtained just now
+  _cache.leaseTime = Hal::leaseTime();
+  if (_cache.leaseTime == 0) {
+    _cache.leaseTime = DEFAULT_LEASE_TIME;
+  }
+
+  RTCStore::save(RTC_CONNECTION_CACHE_SLOT, &_cache, sizeof(_cache));
+}
+
+// Function to check whether half the cached lease has passed, so the settings shouldn't be reused as they are
+bool ConnectionManager::isLeaseDue() {
+  return (WakeClock::now() - _cache.leaseStart) >= (_cache.leaseTime / 2);
+}
+
+// Method to forget the cached connection settings
+void ConnectionManager::invalidateCache() {
+  memset(&_cache, 0, sizeof(_cache));
+  RTCStore::save(RTC_CONNECTION_CACHE_SLOT, &_cache, sizeof(_cache));
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,61 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef ConnectionManager_h
+#define ConnectionManager_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include <ESP8266WiFi.h>
+
+/* Definitions */
+#define CONNECT_MAX_ATTEMPTS 2 // cached fast path, then a full scan with DHCP
+
+/* Progress of joining the network */
+enum ConnectState {
+	CONNECT_IDLE, // not started (or cancelled)
+	CONNECT_FAST, // trying the cached access point and IP settings
+	CONNECT_FULL, // scanning for the network and asking for a lease
+	CONNECT_DONE, // joined, with an address
+	CONNECT_FAILED // ran out of time
+};
+
+/* Timing of a single association attempt */
+struct ConnectAttempt {
+	bool fastPath; // whether the cached BSSID, channel and IP settings were used
+	bool connected; // whether the attempt succeeded
+	unsigned long duration; // how long the attempt took (ms)
+};
+
+/* ConnectionManager class definition */
+// Joins the WiFi network, reusing the access point and IP settings of the last successful connection until
+// half of its DHCP lease has passed.
+// Association runs in the background once begun, so other work (e.g. reading the sensors) can go on while
+// poll() is called now and then to move between attempts; connect() does the whole thing in one go.
+class ConnectionManager {
+	public:
+		/* Public Functions and Methods */
+		static bool connect(const char* ssid, const char* pass, const char* hostname, unsigned long timeout); // function to join the network within timeout ms
+		static void begin(const char* ssid, const char* pass, const char* hostname, unsigned long timeout); // method to start joining the network without waiting
+		static ConnectState poll(); // function to check on (and advance) a connection begun with begin(), never blocks
+		static bool finish(); // function to wait for a connection begun with begin(), returns true once joined
+		static void cancel(); // method to abandon the connection and turn the radio off
+		static ConnectState getState(); // function to get the progress of the connection without advancing it
+		static unsigned long getConnectTime(); // function to get how long joining took, or has taken so far (ms)
+		static int getAttemptCount(); // function to get the number of attempts made by the last connect()
+		static ConnectAttempt getAttempt(int index); // function to get the timing of one of those attempts
+		static void printAttempts(); // method to output the attempt timings over serial
+	private:
+		/* Private Functions and Methods */
+		static void beginFullConnect(); // method to start a connection with a channel scan and DHCP
+		static void recordAttempt(bool fastPath, bool connected, unsigned long start); // method to note the timing of an attempt
+		static void saveCache(); // method to remember the current connection settings in RTC memory
+		static bool isLeaseDue(); // function to check whether half the cached lease has passed
+		static void invalidateCache(); // method to forget the cached connection settings
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,73 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef ConstMath_h
+#define ConstMath_h
+
+/* Definitions */
+#define CONST_MATH_LN2 0.69314718055994530942
+#define CONST_MATH_LN2_HI 6.93147180369123816490e-01 // ln(2) split so k * LN2_HI is exact for the k exp() meets
+#define CONST_MATH_LN2_LO 1.90821492927058770002e-10
+#define CONST_MATH_SQRT2 1.41421356237309504880
+#define CONST_MATH_EPSILON 1e-17 // series stop once a term no longer changes a double
+
+/* ConstMath class definition */
+// Natural log and exp usable in constant expressions, for tables the compiler fills in (see SensorMetrics).
+// Plain C++ rather than math builtins, so any compiler can fold them, not only ones that happen to treat
+// the builtins as constexpr. Both reduce the argument to a small range and sum a series there, which is
+// good to a few ulp in double precision; at run time use log() and exp() instead.
+class ConstMath {
+	public:
+		/* Public Functions and Methods */
+		// Function to get ln(x) for x > 0
+		// x = m * 2^k with m in [sqrt(1/2), sqrt(2)), then ln(m) = 2 atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172
+		static constexpr double log(double x) {
+			int k = 0;
+			while (x >= CONST_MATH_SQRT2) {
+				x /= 2;
+				k++;
+			}
+			while (x < CONST_MATH_SQRT2 / 2) {
+				x *= 2;
+				k--;
+			}
+
+			double s = (x - 1) / (x + 1);
+			double s2 = s * s;
+			double power = s;
+			double sum = 0;
+			for (int n = 1; power > CONST_MATH_EPSILON || power < -CONST_MATH_EPSILON; n += 2) {
+				sum += power / n;
+				power *= s2;
+			}
+			return (2 * sum) + (k * CONST_MATH_LN2);
+		}
+
+		// Function to get e^x
+		// x = r + k ln(2) with |r| <= ln(2) / 2, then e^x = e^r * 2^k with e^r from its Taylor series (ln(2) in two
+		// parts keeps r exact for large x)
+		static constexpr double exp(double x) {
+			int k = (int)((x / CONST_MATH_LN2) + ((x < 0) ? -0.5 : 0.5));
+			double r = (x - (k * CONST_MATH_LN2_HI)) - (k * CONST_MATH_LN2_LO);
+			double term = 1;
+			double sum = 1;
+			for (int n = 1; term > CONST_MATH_EPSILON || term < -CONST_MATH_EPSILON; n++) {
+				term *= r / n;
+				sum += term;
+			}
+
+			for (; k > 0; k--) {
+				sum *= 2;
+			}
+			for (; k < 0; k++) {
+				sum /= 2;
+			}
+			return sum;
+		}
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,227 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "EventLog.h"
+#include "RTCStore.h"
+#include "ReportWriter.h"
+#include "Varint.h"
+
+/* Definitions */
+#define EVENT_LOG_BYTES 40 // record bytes kept, as many as fit the RTC slot (about 19 records of a wake logged at DEBUG)
+#define EVENT_RECORD_MAX (1 + VARINT_MAX_BYTES) // event ID and the longest argument
+#define EVENT_LOG_DROPPED_TEMPLATE "(%u older records overwritten)\r\n"
+#define EVENT_LOG_LINE_END "\r\n"
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+/* Variables */
+// Everything that is persisted in RTC memory between wakes: a ring of records packed end to end, each an
+// event ID followed by the zig-zag varint argument if the event's format takes one (records wrap around)
+struct LogRing {
+  uint32_t tableId; // _EVENT_TABLE_ID of the firmware that wrote the records
+  uint8_t data[EVENT_LOG_BYTES]; // the records
+  uint8_t head; // offset of the oldest record
+  uint8_t length; // bytes the records take
+  uint8_t count; // number of records held
+  uint8_t dropped; // records overwritten before being read
+};
+
+static_assert(RTCStore::blocksFor(sizeof(LogRing)) <= RTC_EVENT_LOG_BLOCKS, "EventLog does not fit its RTC slot");
+static_assert(EVENT_COUNT <= UINT8_MAX, "event IDs are kept in a byte");
+
+static LogRing _ring;
+
+/* Compile time helpers for the tables below */
+
+// Function to get the FNV-1a hash of a string, at compile time
+static constexpr uint32_t fnv1a(const char* text) {
+  uint32_t hash = FNV_OFFSET_BASIS;
+  for (; *text != '\0'; text++) {
+    hash = (hash ^ (uint8_t)*text) * FNV_PRIME;
+  }
+  return hash;
+}
+
+// Function to check whether a format has a placeholder (%% prints a percent sign and isn't one), at compile time
+static constexpr bool hasPlaceholder(const char* format) {
+  for (; *format != '\0'; format++) {
+    if (*format == '%') {
+      if (format[1] != '%') {
+        return true;
+      }
+      format++;
+    }
+  }
+  return false;
+}
+
+/* Constants */
+static const char _LEVEL_TAGS[] PROGMEM = "-EWID"; // tag printed in front of each record, by level
+
+// Format, level and whether an argument is stored, by event ID
+#define EVENT_FORMAT_STRING(name, level, format) static const char _FORMAT_##name[] PROGMEM = format;
+LOG_EVENTS(EVENT_FORMAT_STRING)
+
+#define EVENT_FORMAT(name, level, format) _FORMAT_##name,
+static const char* const _EVENT_FORMATS[EVENT_COUNT] PROGMEM = { LOG_EVENTS(EVENT_FORMAT) };
+
+#define EVENT_LEVEL(name, level, format) LOG_LEVEL_##level,
+static const uint8_t _EVENT_LEVELS[EVENT_COUNT] PROGMEM = { LOG_EVENTS(EVENT_LEVEL) };
+
+#define EVENT_ARGUMENT(name, level, format) hasPlaceholder(format),
+static const bool _EVENT_ARGUMENTS[EVENT_COUNT] PROGMEM = { LOG_EVENTS(EVENT_ARGUMENT) };
+
+// Identifies the event table the records refer to: a reflash that adds, removes or reorders events (or changes
+// a format or level) changes the ID, and records written by the old firmware are discarded instead of being
+// printed against the wrong formats (RTC memory keeps through a reset)
+#define EVENT_TABLE_ENTRY(name, level, format) #name " " #level " " format "\n"
+static constexpr uint32_t _EVENT_TABLE_ID = fnv1a(LOG_EVENTS(EVENT_TABLE_ENTRY));
+
+/* Functions */
+
+// Function to restore the records from RTC memory, starting empty after power loss or a reflash
+bool EventLog::begin() {
+  if (RTCStore::load(RTC_EVENT_LOG_SLOT, &_ring, sizeof(_ring)) && _ring.tableId == _EVENT_TABLE_ID &&
+      _ring.head < EVENT_LOG_BYTES && _ring.length <= EVENT_LOG_BYTES) {
+    return true;
+  }
+
+  memset(&_ring, 0, sizeof(_ring));
+  _ring.tableId = _EVENT_TABLE_ID;
+  return false;
+}
+
+// Method to add a record; nothing is formatted until the log is flushed
+void EventLog::write(LogEvent event, long arg) {
+#if LOG_ECHO
+  print(Serial, event, arg);
+#endif
+
+  uint8_t record[EVENT_RECORD_MAX];
+  size_t size = 0;
+
+  record[size++] = event;
+  if (takesArgument(event)) {
+    size += Varint::put(record + size, arg);
+  }
+
+  while (_ring.length + size > EVENT_LOG_BYTES) { // full, the oldest records make way
+    dropOldest();
+  }
+
+  for (size_t i = 0; i < size; i++) {
+    _ring.data[(_ring.head + _ring.length + i) % EVENT_LOG_BYTES] = record[i];
+  }
+  _ring.length += size;
+  _ring.count++;
+  save();
+}
+
+// Function to get the number of records held
+int EventLog::getCount() {
+  return _ring.count;
+}
+
+// Function to get how many records were overwritten before being read
+uint8_t EventLog::getDropped() {
+  return _ring.dropped;
+}
+
+// Function to get how much of the ring the records take
+int EventLog::getBytesUsed() {
+  return _ring.length;
+}
+
+// Method to print the records oldest first, then discard them
+void EventLog::flush(Print& out) {
+  if (_ring.dropped > 0) {
+    ReportWriter(out).printTemplate(PSTR(EVENT_LOG_DROPPED_TEMPLATE), (unsigned long)_ring.dropped);
+  }
+
+  LogEvent event;
+  long arg;
+  for (uint8_t offset = 0; offset < _ring.length; ) {
+    size_t size = readRecord(offset, event, arg);
+    if (size == 0) { // only a bug could garble a record that passed the CRC, stop rather than print nonsense
+      break;
+    }
+    print(out, event, arg);
+    offset += size;
+  }
+
+  memset(&_ring, 0, sizeof(_ring));
+  _ring.tableId = _EVENT_TABLE_ID;
+  save();
+}
+
+// Function to check whether an event's format has a placeholder, so its record carries the argument
+bool EventLog::takesArgument(LogEvent event) {
+  return pgm_read_byte(&_EVENT_ARGUMENTS[event]);
+}
+
+// Function to decode the record that starts offset bytes after the oldest, returns its size (0 if garbled)
+size_t EventLog::readRecord(uint8_t offset, LogEvent& event, long& arg) {
+  uint8_t record[EVENT_RECORD_MAX];
+  size_t available = min((size_t)(_ring.length - offset), sizeof(record));
+
+  for (size_t i = 0; i < available; i++) { // unwrapped, so the varint can be read in one piece
+    record[i] = _ring.data[(_ring.head + offset + i) % EVENT_LOG_BYTES];
+  }
+
+  if (available == 0 || record[0] >= EVENT_COUNT) {
+    return 0;
+  }
+  event = (LogEvent)record[0];
+  arg = 0;
+
+  size_t pos = 1;
+  int32_t value;
+  if (takesArgument(event)) {
+    if (!Varint::get(record, available, pos, value)) {
+      return 0;
+    }
+    arg = value;
+  }
+  return pos;
+}
+
+// Method to make way by removing the oldest record
+void EventLog::dropOldest() {
+  LogEvent event;
+  long arg;
+  size_t size = readRecord(0, event, arg);
+
+  if (size == 0) { // garbled, start over
+    _ring.length = 0;
+    _ring.count = 0;
+  }
+  else {
+    _ring.head = (_ring.head + size) % EVENT_LOG_BYTES;
+    _ring.length -= size;
+    _ring.count--;
+  }
+  if (_ring.dropped < UINT8_MAX) {
+    _ring.dropped++;
+  }
+}
+
+// Method to print a single record as its level tag followed by the filled in format
+void EventLog::print(Print& out, LogEvent event, long arg) {
+  ReportWriter line(out);
+
+  line.write(pgm_read_byte(&_LEVEL_TAGS[min(pgm_read_byte(&_EVENT_LEVELS[event]), (uint8_t)LOG_LEVEL_DEBUG)]));
+  line.write(' ');
+  line.printTemplate((PGM_P)pgm_read_ptr(&_EVENT_FORMATS[event]), arg);
+  line.print(F(EVENT_LOG_LINE_END));
+}
+
+// Method to write the records back to RTC memory
+void EventLog::save() {
+  RTCStore::save(RTC_EVENT_LOG_SLOT, &_ring, sizeof(_ring));
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,83 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef EventLog_h
+#define EventLog_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+/* Definitions */
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1 // the wake couldn't do what it set out to
+#define LOG_LEVEL_WARN 2 // something was lost or reset, but the wake carried on
+#define LOG_LEVEL_INFO 3 // what the wake decided to do
+#define LOG_LEVEL_DEBUG 4 // step by step progress
+
+// *** MODIFY THESE TO CHANGE HOW MUCH IS LOGGED ***
+// Calls above LOG_LEVEL compile to nothing, format strings included
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+// Echoing prints every record over serial as it happens, which a node on its own has no use for
+#ifndef LOG_ECHO
+#define LOG_ECHO (LOG_LEVEL >= LOG_LEVEL_DEBUG)
+#endif
+
+#include "LogEvents.h"
+
+// Logging calls, by event name from LogEvents.h with its argument if the format takes one, e.g.
+// LOG_INFO(ATTEMPT, attempts). The level has to be the one the event is listed with.
+#define LOG_EVENT(level, event, ...) do { \
+		static_assert(EVENT_LEVEL_##event == level, #event " is listed at another level in LogEvents.h"); \
+		EventLog::write(EVENT_##event, ##__VA_ARGS__); \
+	} while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(event, ...) LOG_EVENT(LOG_LEVEL_ERROR, event, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(event, ...) do { } while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(event, ...) LOG_EVENT(LOG_LEVEL_WARN, event, ##__VA_ARGS__)
+#else
+#define LOG_WARN(event, ...) do { } while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(event, ...) LOG_EVENT(LOG_LEVEL_INFO, event, ##__VA_ARGS__)
+#else
+#define LOG_INFO(event, ...) do { } while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(event, ...) LOG_EVENT(LOG_LEVEL_DEBUG, event, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(event, ...) do { } while (0)
+#endif
+
+/* EventLog class definition */
+// Keeps the latest log records in RTC memory as event IDs plus their argument, a varint only for formats that
+// take one (one to six bytes a record), so logging costs a few µs instead of a serial write and the records
+// survive deep sleep until someone reads them. Levels and formats stay in flash in the LogEvents.h table.
+class EventLog {
+	public:
+		/* Public Functions and Methods */
+		static bool begin(); // function to restore the records from RTC memory, returns false if they were lost
+		static void write(LogEvent event, long arg=0); // method to add a record, overwriting the oldest ones when full
+		static int getCount(); // function to get the number of records held
+		static uint8_t getDropped(); // function to get how many records were overwritten before being read (stops at 255)
+		static int getBytesUsed(); // function to get how much of the ring the records take
+		static void flush(Print& out); // method to print the records oldest first, then discard them
+	private:
+		/* Private Functions and Methods */
+		static bool takesArgument(LogEvent event); // function to check whether an event's format has a placeholder
+		static size_t readRecord(uint8_t offset, LogEvent& event, long& arg); // function to decode the record at a ring offset, returns its size (0 if garbled)
+		static void dropOldest(); // method to make way by removing the oldest record
+		static void print(Print& out, LogEvent event, long arg); // method to print a single record
+		static void save(); // method to write the records back to RTC memory
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
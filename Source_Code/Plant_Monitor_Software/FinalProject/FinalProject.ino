@@ -7,6 +7,22 @@
 #include <ESP8266WiFi.h>
 #include "SMTP.h"
 #include "SensorMetrics.h"
+#include "SensorRegistry.h"
+#include "SampleBuffer.h"
+#include "ConnectionManager.h"
+#include "WakeClock.h"
+#include "ReportWriter.h"
+#include "Profiler.h"
+#include "Transport.h"
+#include "UDPTelemetry.h"
+#include "CborWriter.h"
+#include "ReportPolicy.h"
+#include "SampleLog.h"
+#include "RTTEstimator.h"
+#include "NodeConfig.h"
+#include "EventLog.h"
+#include "WakeBudget.h"
+#include "Hal.h"
 
 /* Definitions */
 #define RED_LED_PIN 0
@@ -15,107 +31,382 @@
 
 #define BAUD_RATE 115200
 
-#define DEFAULT_NETWORK_NAME "PlantLifeMonitor"
-#define DEFAULT_NETWORK_PASS "PlzSenpaiGiveMeA"
-#define DEFAULT_HOSTNAME "Plant_Node_1"
-
-#define STARTUP_WAIT 5000
+#define STARTUP_WAIT 5000 // only after a reset or power up, timer wakes from deep sleep go straight to work
+#define CONFIG_IDLE_TIMEOUT 120000 // leave the settings console after this long without input (ms)
+#define WIFI_CONNECT_TIMEOUT 15000 // give up on the network after this long (ms), readings are kept for next wake
 #define RETRY_ATTEMPTS 3
-#define RETRY_DELAY 5000
-#define TIMEOUT_INCREMENT 500
-#define SLEEP_TIME 30e6 // 30e6 µSec is 30 seconds
+#define RETRY_BACKOFF_BASE 1000 // ms, longest wait before the second attempt, doubles for each one after
+#define RETRY_BACKOFF_CAP 16000 // ms, longest wait between attempts
+#define RADIO_RESTART_TIME 100e3 // µSec asleep before rebooting with the radio, when an alert turns up on a radio-off wake
+
+#define SMTP_SUBJECT_LINE "Plant Report"
+#define SMTP_ALERT_SUBJECT_LINE "Plant Alert!"
+
+// Routine reports can go to a telemetry listener as one CBOR datagram instead of an email
+#ifndef REPORT_OVER_UDP
+#define REPORT_OVER_UDP 0 // 1 = send reports to the listener below, 0 = email them
+#endif
+#define TELEMETRY_HOST "192.168.1.10" // name or address of the listener
+#define TELEMETRY_PORT 5684 // UDP port of the listener
 
-#define SMTP_SUBJECT_LINE "Plant Alert!"
+// Readings that couldn't be delivered are kept in flash (SampleLog) and go out with later reports
+#if REPORT_OVER_UDP
+#define BACKLOG_SEGMENTS_PER_REPORT 1 // keeps the record inside one datagram
+#else
+#define BACKLOG_SEGMENTS_PER_REPORT 4 // about 120 readings, keeps an email (and the time sending it) small; a long backlog goes out over several reports
+#endif
+
+// Emails can go through a collector on the local network instead of straight to Gmail, which takes
+// plain SMTP without a login from every node and forwards one digest upstream
+#ifndef USE_SMTP_RELAY
+#define USE_SMTP_RELAY 0 // 1 = email through the collector below, 0 = email Gmail directly
+#endif
+#define SMTP_RELAY_HOST "192.168.1.10" // name or address of the collector
+#define SMTP_RELAY_PORT 2525 // plain SMTP port of the collector
+
+// Report templates (see ReportWriter for the placeholders), every line CRLF terminated so a long series never
+// runs into the 998 character line limit of RFC 5322
+#define REPORT_HEADER_TEMPLATE "<h2><u>%r</u></h2><br>\r\n" \
+                               "<h3>&emsp;Configuration:</h3><br>\r\n" \
+                               "&emsp;&emsp;<b>Mode:</b> Monitor<br>\r\n" \
+                               "&emsp;&emsp;<b>Update Interval:</b> %d seconds (adjusts to how fast readings change)<br>\r\n" \
+                               "&emsp;&emsp;<b>Samples per Report:</b> %d<br>\r\n" \
+                               "<h3>&emsp;Sensor Readings:</h3><br>\r\n"
+#define REPORT_SAMPLE_TEMPLATE "&emsp;<u>%d seconds ago:</u><br>\r\n"
+#define REPORT_BACKLOG_HEADER "<h3>&emsp;Delivered Late:</h3><br>\r\n"
+#define REPORT_BACKLOG_POWER_LOSS "&emsp;<u>Before the last power loss:</u><br>\r\n"
 
 /* Global variables */
-/* *** INSERT PLANT MONITOR EMAIL ADDRESS HERE *** */
-SMTP updater("PLANT@MONITOR.EMAIL");
+SMTP updater; // recipient comes from NodeConfig
+UDPTelemetry telemetry(TELEMETRY_HOST, TELEMETRY_PORT);
+#if REPORT_OVER_UDP
+Transport& transport = telemetry; // how reports are delivered
+#else
+Transport& transport = updater;
+#endif
 int attempts = 1;
 bool f_Sent = false;
+bool f_Refused = false; // report was refused for good, its readings are dropped rather than kept for later
+
+/* Function prototypes */
+bool sendReport(PGM_P subject); // connects and sends every reading held in the sample buffer, returns true if delivered
+void beginConnecting(); // starts joining the network, association carries on in the background
+void pollConnection(); // background task that steps the connection along while other work waits
+void writeReportBody(Print& out); // writes the report body for the readings held in the sample buffer
+void writeReportRecord(Print& out); // writes the CBOR record of the readings held in the sample buffer
 
 void setup() {
+  bool f_TimerWake = (Hal::resetReason() == REASON_DEEP_SLEEP_AWAKE); // nobody is at the serial monitor on a timer wake
 
   // startup delay
   // wait so that a normal human has time to connect the serial monitor before program starts
-  delay(STARTUP_WAIT);
+  if (!f_TimerWake) {
+    Hal::delay(STARTUP_WAIT);
+  }
   // begin serial communication at the defined baud rate
   Serial.begin(BAUD_RATE);
 
   // Wait for serial to initialize.
-  while(!Serial) { }
+  while(!f_TimerWake && !Serial) { }
+
+  WakeClock::begin(); // time since power up, for expiring cached network settings
+  EventLog::begin(); // records of earlier wakes that haven't been read yet
 
-  pinMode(0, OUTPUT); // red LED
-  pinMode(2, OUTPUT); // blue LED
-  digitalWrite(0, HIGH);
-  digitalWrite(2, HIGH);
+  // Settings saved from the console, or the built-in ones
+  if (!NodeConfig::begin()) {
+    LOG_DEBUG(DEFAULT_CONFIG);
+  }
+
+  // Holding the config pin low through a reset opens the settings console, then the node starts over
+  // as an ordinary wake so the console time stays out of the timing statistics
+  Hal::pinMode(CONFIG_UDPATE_PIN, INPUT_PULLUP);
+  if (!f_TimerWake && Hal::digitalRead(CONFIG_UDPATE_PIN) == LOW) {
+    NodeConfig::configure(Serial, CONFIG_IDLE_TIMEOUT);
+    WakeClock::deepSleep(RADIO_RESTART_TIME, WAKE_RF_DEFAULT);
+    return; // not reached, deep sleep ends in a reset
+  }
+  updater.updateRecipientAddr(NodeConfig::get().recipient);
+
+  // Every phase from here on has a deadline, out of a time allowance that shrinks as the battery runs down
+  WakeBudget::begin(SensorMetrics::getBatteryLvl());
+  LOG_DEBUG(WAKE_ALLOWANCE, WakeBudget::getAllowance());
+
+  // Restore the phase timing statistics of previous wakes and add this one's startup
+  if (!Profiler::begin()) {
+    LOG_WARN(PROFILER_RESET);
+  }
+  Profiler::record(PHASE_STARTUP, Hal::micros());
+
+  Hal::pinMode(0, OUTPUT); // red LED
+  Hal::pinMode(2, OUTPUT); // blue LED
+  Hal::digitalWrite(0, HIGH);
+  Hal::digitalWrite(2, HIGH);
+
+  // Restore readings from previous wakes (starts empty after power loss or if RTC memory was corrupted)
+  if (!SampleBuffer::begin()) {
+    LOG_WARN(SAMPLE_BUFFER_RESET);
+  }
+  if (!ReportPolicy::begin()) {
+    LOG_WARN(REPORT_POLICY_RESET);
+  }
+  if (!RTTEstimator::begin()) {
+    LOG_WARN(RTT_RESET);
+  }
+
+  // A wake that booted with the radio is expected to report, so start joining the network straight away
+  // and let association run while the sensors power up and settle, rather than one after the other
+  if (ReportPolicy::isRadioOn()) {
+    beginConnecting();
+    Hal::setBackgroundTask(pollConnection);
+  }
 
   // Turn on red LED to indicate sensor reading is in progress (remove for actual product implementation)
-  digitalWrite(RED_LED_PIN , LOW);
-  float * sensors = SensorMetrics::getSensors(); // read all sensors and store them in a float array
-  digitalWrite(RED_LED_PIN, HIGH); // turn off the red LED (remove for actual product implementation)
+  Hal::digitalWrite(RED_LED_PIN , LOW);
+  float sensors[SAMPLE_SENSOR_COUNT];
+  {
+    ProfileTimer timer(PHASE_SENSORS);
+    NodeSensors::read(sensors); // read all sensors and store them in a float array
+  }
+  Hal::setBackgroundTask(NULL);
+  Hal::digitalWrite(RED_LED_PIN, HIGH); // turn off the red LED (remove for actual product implementation)
+  if (WakeBudget::timeLeft(BUDGET_SENSORS) == 0) { // settling is bounded already, so this only shows up as less time to send
+    LOG_WARN(SENSORS_OVERRAN);
+  }
+  LOG_DEBUG(SENSORS_SETTLED, SensorMetrics::getSettleTime());
+
+  SampleBuffer::append(sensors); // add this wake's readings to the series
 
-  // Init variables for creating SMTP message
-  String emailSubject = SMTP_SUBJECT_LINE; // Subject line of email message
-  String emailBody = "";
+  LOG_DEBUG(SAMPLES_HELD, SampleBuffer::getCount());
 
-  emailBody += "<h2><u>Plant Node 1</u></h2><br>";
-  emailBody += "<h3>&emsp;Configuration:</h3><br>";
-  emailBody += "&emsp;&emsp;<b>Mode:</b> Monitor<br>";
-  emailBody += "&emsp;&emsp;<b>Update Interval:</b> " + String(SLEEP_TIME/1000000) + " seconds<br>";
-  emailBody += "<h3>&emsp;Sensor Readings:</h3><br>";
+  // Only bring up the radio for an alert, or once enough readings have accumulated (or the buffer can't hold
+  // any more) and they have changed enough to be worth reporting
+  bool batchDue = (SampleBuffer::getCount() >= NodeConfig::get().samplesPerReport || SampleBuffer::isFull());
+  ReportDecision decision = ReportPolicy::evaluate(sensors, batchDue);
 
-  for(int i = 0; i < SensorMetrics::_SENSOR_DESCRIPTIONS_SIZE; i++) {
-    emailBody += ("<b>" + SensorMetrics::_SENSOR_DESCRIPTIONS[i][0] + "</b>" + sensors[i] + SensorMetrics::_SENSOR_DESCRIPTIONS[i][1]);
+  if (decision != REPORT_HOLD && !ReportPolicy::isRadioOn()) { // radio wasn't calibrated at boot, so it can't be used this wake
+    LOG_INFO(RADIO_RESTART);
+    ReportPolicy::prepareSleep(true);
+    Profiler::end();
+    WakeClock::deepSleep(RADIO_RESTART_TIME, WAKE_RF_DEFAULT);
+    return; // not reached, deep sleep ends in a reset
   }
 
-  delete [] sensors; // Clean up memory
+  if (decision != REPORT_HOLD) {
+    if (sendReport(decision == REPORT_ALERT ? PSTR(SMTP_ALERT_SUBJECT_LINE) : PSTR(SMTP_SUBJECT_LINE))) {
+      ReportPolicy::reportSent(sensors);
+    }
+    else {
+      if (SampleBuffer::getCount() > 0) { // network is down, keep the readings safe in flash until it is back (a refused report left none)
+        if (SampleLog::spillSampleBuffer()) {
+          LOG_INFO(READINGS_SPILLED);
+        }
+        else {
+          LOG_ERROR(SPILL_FAILED);
+        }
+      }
+      EventLog::flush(Serial); // what led up to the failure, for anyone at the serial monitor
+    }
+  }
+  else if (batchDue) {
+    LOG_INFO(REPORT_SKIPPED);
+  }
 
-  WiFi.forceSleepWake(); // workaround for Deep Sleep Mode bug #2186 
-  WiFi.hostname(DEFAULT_HOSTNAME); // change hostname to something more friendly
-  // attempt to connect to the specified wireless network
-  WiFi.begin(DEFAULT_NETWORK_NAME, DEFAULT_NETWORK_PASS);
-  
-  Serial.print("Connecting...");
+  if (decision == REPORT_HOLD && ConnectionManager::getState() != CONNECT_IDLE) { // joined for nothing, radio off again
+    ConnectionManager::cancel();
+  }
+
+  // Radio only needs calibrating and powering at boot if the next wake is expected to send a report
+  bool batchDueNext = (SampleBuffer::getCount() + 1 >= NodeConfig::get().samplesPerReport || SampleBuffer::isFull());
+  RFMode wakeMode = ReportPolicy::prepareSleep(batchDueNext);
+
+  LOG_INFO(DEEP_SLEEP, ReportPolicy::getSleepTime());
+  Profiler::end(); // save the timing statistics, including this wake
+  WakeClock::deepSleep(ReportPolicy::getSleepTime() * 1000000ULL, wakeMode);
+}
+
+/* main loop */
+void loop() {
+
+}
+
+/* Writes the report of every reading held in the sample buffer, straight from flash templates */
+void writeReportBody(Print& out) {
+  ReportWriter report(out);
+  float sensors[SAMPLE_SENSOR_COUNT];
+  int count = SampleBuffer::getCount();
+
+  report.printTemplate(PSTR(REPORT_HEADER_TEMPLATE), NodeConfig::get().hostname, (long)ReportPolicy::getSleepTime(), (long)NodeConfig::get().samplesPerReport);
+
+  // Oldest reading first, each labelled with how long before this report it was taken (out of range readings in red)
+  for(int s = 0; s < count; s++) {
+    SampleBuffer::getSample(s, sensors);
 
-  // Wait to be connected
-  while(WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
+    if (count > 1) {
+      report.printTemplate(PSTR(REPORT_SAMPLE_TEMPLATE), (long)SampleBuffer::getSampleAge(s));
+    }
+
+    NodeSensors::writeReport(report, sensors);
+  }
+
+  // Readings that couldn't be delivered when they were taken, oldest first
+  uint32_t time;
+  uint32_t now = WakeClock::now();
+  bool f_Backlog = false;
+  SampleLog::rewind(BACKLOG_SEGMENTS_PER_REPORT);
+  while (SampleLog::readNext(time, sensors)) {
+    if (!f_Backlog) {
+      report.printTemplate(PSTR(REPORT_BACKLOG_HEADER));
+      f_Backlog = true;
+    }
+
+    if (time <= now) {
+      report.printTemplate(PSTR(REPORT_SAMPLE_TEMPLATE), (long)(now - time));
+    }
+    else { // WakeClock started over since
+      report.printTemplate(PSTR(REPORT_BACKLOG_POWER_LOSS));
+    }
+
+    NodeSensors::writeReport(report, sensors);
+  }
+
+  Profiler::writeReport(report); // where the node's awake time has been going
+}
+
+/* Writes the readings held in the sample buffer as one CBOR map */
+// { "id": hostname, "t": seconds since power up, "al": alert flags (bit i = reading i),
+//   "a": [ seconds each sample was taken before the newest, ... ],
+//   "s": [ [reading, ...] per sample, oldest first, in NodeSensors order ],
+//   "b": [ [seconds since power up, reading, ...] per reading that couldn't be delivered earlier, oldest first ] }
+void writeReportRecord(Print& out) {
+  CborWriter record(out);
+  float sensors[SAMPLE_SENSOR_COUNT];
+  int count = SampleBuffer::getCount();
+  uint32_t time;
+
+  record.beginMap(6);
+  record.writeTextP(PSTR("id"));
+  record.writeText(NodeConfig::get().hostname);
+  record.writeTextP(PSTR("t"));
+  record.writeUInt(WakeClock::now());
+  record.writeTextP(PSTR("al"));
+  record.writeUInt(ReportPolicy::getAlerts());
+  record.writeTextP(PSTR("a"));
+  record.beginArray(count);
+  for(int s = 0; s < count; s++) {
+    record.writeUInt(SampleBuffer::getSampleAge(s));
+  }
+  record.writeTextP(PSTR("s"));
+  record.beginArray(count);
+
+  for(int s = 0; s < count; s++) {
+    SampleBuffer::getSample(s, sensors);
+
+    record.beginArray(SAMPLE_SENSOR_COUNT);
+    for(int v = 0; v < SAMPLE_SENSOR_COUNT; v++) {
+      record.writeFloat(sensors[v]);
+    }
+  }
+
+  record.writeTextP(PSTR("b"));
+  record.beginArray(); // length isn't known until the log has been read
+  SampleLog::rewind(BACKLOG_SEGMENTS_PER_REPORT);
+  while (SampleLog::readNext(time, sensors)) {
+    record.beginArray(1 + SAMPLE_SENSOR_COUNT);
+    record.writeUInt(time);
+    for(int v = 0; v < SAMPLE_SENSOR_COUNT; v++) {
+      record.writeFloat(sensors[v]);
+    }
   }
+  record.endArray();
+}
+
+/* Starts joining the network, reusing the last good settings where possible */
+void beginConnecting() {
+  WiFi.forceSleepWake(); // workaround for Deep Sleep Mode bug #2186
+
+  LOG_DEBUG(CONNECTING);
+  unsigned long timeout = min((unsigned long)WIFI_CONNECT_TIMEOUT, WakeBudget::timeLeft(BUDGET_WIFI));
+  ConnectionManager::begin(NodeConfig::get().ssid, NodeConfig::get().password, NodeConfig::get().hostname, timeout);
+}
+
+/* Steps the connection along (falling back from the cached settings, giving up) while other work waits */
+void pollConnection() {
+  ConnectionManager::poll();
+}
 
-  Serial.println();
+/* Connects to the network and sends every reading held in the sample buffer */
+bool sendReport(PGM_P subject) {
+#if USE_SMTP_RELAY
+  updater.updateServer(SMTP_RELAY_HOST, SMTP_RELAY_PORT, false); // no TLS on the local network
+  updater.updateCredentials(NULL, NULL); // and no login, the collector holds the mail account
+#endif
 
-  // Let the user know we've connected and what our IP address is
-  Serial.print("Connected!\tIP Address: ");
-  Serial.println(WiFi.localIP());
+  // Join the network if that didn't already start while the sensors were read, and wait for it
+  if (ConnectionManager::getState() == CONNECT_IDLE) {
+    beginConnecting();
+  }
+  bool connected = ConnectionManager::finish();
+  Profiler::record(PHASE_WIFI, ConnectionManager::getConnectTime() * 1000);
+#if LOG_ECHO
+  ConnectionManager::printAttempts();
+#endif
+
+  if (!connected) { // readings stay in the buffer and go out with the next report
+    LOG_ERROR(CONNECT_FAILED);
+    return false;
+  }
+
+  // Let the user know we've connected and how long it took
+  LOG_DEBUG(CONNECTED, ConnectionManager::getConnectTime());
   
   // Turn on blue LED to indicate an attempt to email (remove for actual product implementation)
-  digitalWrite(BLUE_LED_PIN, LOW);
+  Hal::digitalWrite(BLUE_LED_PIN, LOW);
   // atempt to send the email up to 3 times before waiting for next cycle
+  ProfileTimer reportTimer(PHASE_REPORT);
+  ReportContent report = { subject, writeReportBody, writeReportRecord };
   while(attempts <= RETRY_ATTEMPTS && !f_Sent) {
-    Serial.println("\r\nAttempt #" + String(attempts));
-    if(updater.sendUpdateEmail(emailSubject, emailBody)) { // if we successfully sent the update email...
+    if (WakeBudget::isSpent()) { // readings are kept for a later wake rather than draining the battery now
+      LOG_ERROR(BUDGET_SPENT);
+      break;
+    }
+
+    // The first attempt has to be connected by the end of its share, retries can use whatever is left
+    unsigned long connectBy = WakeBudget::getDeadline(attempts == 1 ? BUDGET_CONNECT : BUDGET_SEND);
+    transport.updateDeadline(connectBy, WakeBudget::getDeadline(BUDGET_SEND));
+
+    LOG_INFO(ATTEMPT, attempts);
+    if(transport.sendReport(report)) { // if we successfully sent the report...
       f_Sent = true; // indicate to the loop that the email sent successfully
     }
-    else {
-      // increment the timeout by TIMEOUT_INCREMENT per attempt to try to resolve comms issues
-      int timeout = updater.getTimeout();
-      timeout += TIMEOUT_INCREMENT;
-      updater.updateTimeout(timeout);
-      attempts++;
-      // wait 5 seconds before trying again
-      delay(RETRY_DELAY);
+    else if (transport.isPermanentFailure()) { // refused for good, another attempt (now or from flash later) would be too
+      LOG_ERROR(REPORT_REFUSED);
+      f_Refused = true;
+      break;
+    }
+    else if (attempts++ < RETRY_ATTEMPTS) {
+      // wait a random time up to an exponentially growing limit, so nodes that failed together don't retry together
+      unsigned long backoff = min((unsigned long)RETRY_BACKOFF_CAP, (unsigned long)RETRY_BACKOFF_BASE << (attempts - 2));
+      Hal::delay(min((unsigned long)Hal::random(backoff + 1), WakeBudget::timeLeft(BUDGET_SEND)));
     }
   }
-  digitalWrite(BLUE_LED_PIN, HIGH); // turn off the blue LED (remove for actual product implementation)
-
-  Serial.println("Going into deep sleep for " + String(SLEEP_TIME/1000000) + " seconds");
-  ESP.deepSleep(SLEEP_TIME, WAKE_RF_DEFAULT);
-}
+  Hal::digitalWrite(BLUE_LED_PIN, HIGH); // turn off the blue LED (remove for actual product implementation)
+  LOG_DEBUG(SMOOTHED_RTT, RTTEstimator::getSmoothedRTT());
+  LOG_DEBUG(FREE_HEAP, ESP.getFreeHeap());
+  LOG_DEBUG(MAX_FREE_BLOCK, ESP.getMaxFreeBlockSize());
+  LOG_DEBUG(HEAP_FRAGMENTATION, ESP.getHeapFragmentation());
+#if LOG_ECHO
+  Profiler::printStats();
+#endif
 
-/* main loop */
-void loop() {
+  if (f_Sent) { // readings have been delivered, start a new series
+    SampleBuffer::clear();
+    SampleLog::markUploaded(); // along with the part of the backlog that went with them
+  }
+  else if (f_Refused) { // nobody will ever take these readings, so they aren't kept for later (an older backlog stays in flash)
+    SampleBuffer::clear();
+  }
 
+  return f_Sent;
 }
 
 // ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,104 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Hal_h
+#define Hal_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include <SPI.h>
+#include <ESP8266WiFi.h>
+#include <lwip/netif.h>
+#include <lwip/dhcp.h>
+
+/* Definitions */
+#define BACKGROUND_TASK_INTERVAL 10 // longest stretch (ms) delay() waits between runs of the background task
+
+// A backend that wants to see each profiled phase as it ends (the host simulation charges it energy) defines
+// HAL_TRACE_PHASE as the name of a void(uint8_t phase, uint32_t elapsedUs) function
+#ifdef HAL_TRACE_PHASE
+void HAL_TRACE_PHASE(uint8_t phase, uint32_t elapsedUs);
+#endif
+
+/* Hal class definition */
+// Thin hardware abstraction layer. The project's timing, GPIO, ADC, SPI, RTC memory, sleep and socket accesses
+// all go through here rather than straight to the ESP8266 core. The host build (../host) compiles this same
+// header against stand-ins for the core that run on a virtual clock with a scripted ADC, a loopback network and
+// simulated deep sleep. On the ESP8266 every call is an inline forward to the core and costs nothing.
+// Waits made through delay() run the background task, if one is set, so a phase that spends its time waiting
+// (sensor settling) lets another make progress (stepping WiFi association along) instead of idling.
+class Hal {
+	public:
+		/* Types */
+		typedef void (*BackgroundTask)(); // short, non-blocking function run while waiting
+		typedef WiFiClientSecure SecureClient; // TLS socket the SMTP session normally runs over
+		typedef WiFiClient PlainClient; // TCP socket for servers on the local network that don't use TLS
+
+		/* Time */
+		static inline unsigned long millis() { return ::millis(); } // function to get ms since boot
+		static inline unsigned long micros() { return ::micros(); } // function to get µs since boot
+		static inline uint32_t cycleCount() { return ESP.getCycleCount(); } // function to get the CPU cycle counter
+		static inline unsigned long timeUntil(unsigned long deadline) { long left = (long)(deadline - ::millis()); return (left > 0) ? left : 0; } // function to get the ms left before a millis() deadline (0 = passed)
+		static inline void delay(unsigned long ms) { // method to wait, letting the WiFi stack and the background task run
+			if (_backgroundTask == NULL) {
+				::delay(ms);
+				return;
+			}
+			unsigned long start = ::millis();
+			while ((::millis() - start) < ms) {
+				_backgroundTask();
+				::delay(min(ms - (::millis() - start), (unsigned long)BACKGROUND_TASK_INTERVAL));
+			}
+		}
+		static inline void setBackgroundTask(BackgroundTask task) { _backgroundTask = task; } // method to set (or clear with NULL) the task run while waiting
+		static inline void yield() { ::yield(); } // method to let the WiFi stack run
+		static inline long random(long howBig) { return ::secureRandom(howBig); } // function to get a random number below howBig (hardware RNG)
+
+		/* GPIO and ADC */
+		static inline void pinMode(uint8_t pin, uint8_t mode) { ::pinMode(pin, mode); } // method to set a pin's mode
+		static inline void digitalWrite(uint8_t pin, uint8_t value) { ::digitalWrite(pin, value); } // method to drive a pin
+		static inline int digitalRead(uint8_t pin) { return ::digitalRead(pin); } // function to read a pin
+		static inline int analogRead() { return ::analogRead(A0); } // function to read the internal adc (only A0 exists)
+
+		/* SPI */
+		static inline void spiBegin(uint32_t freq) { // method to start the SPI bus (MSB first, mode 0)
+			SPI.begin();
+			SPI.setBitOrder(MSBFIRST);
+			SPI.setDataMode(SPI_MODE0);
+			SPI.setFrequency(freq);
+		}
+		static inline void spiSetFrequency(uint32_t freq) { SPI.setFrequency(freq); } // method to change the SPI clock
+		static inline uint8_t spiTransfer(uint8_t data) { return SPI.transfer(data); } // function to exchange one byte
+		static inline void spiTransferBytes(const uint8_t* out, uint8_t* in, uint32_t size) { SPI.transferBytes(out, in, size); } // method to exchange several bytes
+
+		/* Network */
+		static inline uint32_t leaseTime() { // function to get the length (s) of the station's DHCP lease, 0 if it has none
+			struct dhcp* dhcp = (netif_default != NULL) ? netif_dhcp_data(netif_default) : NULL;
+			return (dhcp != NULL && dhcp_supplied_address(netif_default)) ? dhcp->offered_t0_lease : 0;
+		}
+
+		/* RTC memory and power */
+		static inline bool rtcRead(uint32_t block, uint32_t* data) { return ESP.rtcUserMemoryRead(block, data, sizeof(*data)); } // function to read one block of RTC user memory
+		static inline bool rtcWrite(uint32_t block, uint32_t* data) { return ESP.rtcUserMemoryWrite(block, data, sizeof(*data)); } // function to write one block of RTC user memory
+		static inline uint32_t resetReason() { return ESP.getResetInfoPtr()->reason; } // function to get why the chip last started (REASON_ constants)
+		static inline void deepSleep(uint64_t sleepTime, RFMode mode) { ESP.deepSleep(sleepTime, mode); } // method to enter deep sleep (µs)
+
+		/* Tracing */
+		static inline void phaseEnded(uint8_t phase, uint32_t elapsedUs) { // method to tell the backend a profiled phase just ended
+#ifdef HAL_TRACE_PHASE
+			HAL_TRACE_PHASE(phase, elapsedUs);
+#else
+			(void)phase;
+			(void)elapsedUs;
+#endif
+		}
+	private:
+		/* Private Instance Variables */
+		static inline BackgroundTask _backgroundTask = NULL; // run by delay() while waiting
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,97 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef LogEvents_h
+#define LogEvents_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+// (included by EventLog.h once the LOG_LEVEL_ values are defined)
+
+/* Definitions */
+// Everything the firmware logs, as X(name, level, format): the event log keeps a one byte ID per record (plus
+// the argument if the format takes one) and looks the level and format up here when the records are printed.
+// Formats take at most one %d or %u. Add new events anywhere; records written by firmware with a different
+// table are discarded after a reflash rather than printed against the wrong formats.
+#define LOG_EVENTS(X) \
+	/* Sketch */ \
+	X(DEFAULT_CONFIG, DEBUG, "Using default configuration") \
+	X(WAKE_ALLOWANCE, DEBUG, "Wake allowance: %u ms") \
+	X(PROFILER_RESET, WARN, "Timing statistics reset") \
+	X(SAMPLE_BUFFER_RESET, WARN, "Sample buffer reset") \
+	X(REPORT_POLICY_RESET, WARN, "Report policy reset") \
+	X(RTT_RESET, WARN, "Round trip estimate reset") \
+	X(SENSORS_OVERRAN, WARN, "Sensors overran their budget") \
+	X(SENSORS_SETTLED, DEBUG, "Sensors settled in %u ms") \
+	X(SAMPLES_HELD, DEBUG, "Samples held: %d") \
+	X(RADIO_RESTART, INFO, "Restarting with the radio on") \
+	X(READINGS_SPILLED, INFO, "Readings moved to flash") \
+	X(SPILL_FAILED, ERROR, "Readings could not be moved to flash") \
+	X(REPORT_SKIPPED, INFO, "Readings unchanged, report skipped") \
+	X(DEEP_SLEEP, INFO, "Going into deep sleep for %u seconds") \
+	X(CONNECTING, DEBUG, "Connecting...") \
+	X(CONNECT_FAILED, ERROR, "Failed to connect to network") \
+	X(CONNECTED, DEBUG, "Connected in %u ms") \
+	X(BUDGET_SPENT, ERROR, "Wake budget spent, report deferred") \
+	X(REPORT_REFUSED, ERROR, "Report refused for good, readings dropped") \
+	X(ATTEMPT, INFO, "Attempt #%d") \
+	X(SMOOTHED_RTT, DEBUG, "Smoothed round trip: %u ms") \
+	X(FREE_HEAP, DEBUG, "Free heap: %u bytes") \
+	X(MAX_FREE_BLOCK, DEBUG, "Largest free block: %u bytes") \
+	X(HEAP_FRAGMENTATION, DEBUG, "Heap fragmentation: %u %%") \
+	/* SampleLog */ \
+	X(SAMPLE_LOG_DROPPED, WARN, "Sample log full, dropped oldest segment") \
+	X(SAMPLE_LOG_FORMATTED, ERROR, "Flash filesystem unusable, formatting") \
+	/* SMTP */ \
+	X(EMAIL_SENT, INFO, "Email Sent Successfully!") \
+	X(SMTP_CONNECTED, DEBUG, "Successfully connected to SMTP Server!") \
+	X(SMTP_CONNECT_FAILED, ERROR, "Failed to connect to SMTP server") \
+	X(SMTP_CACHED_ADDR_FAILED, WARN, "Cached SMTP server address failed, resolving again") \
+	X(SMTP_GREETING, DEBUG, "Waiting for server greeting") \
+	X(SMTP_EHLO, DEBUG, "Issuing EHLO command") \
+	X(SMTP_HELO, DEBUG, "EHLO rejected, issuing HELO command") \
+	X(SMTP_NO_AUTH, DEBUG, "No credentials, skipping authentication") \
+	X(SMTP_AUTH_LOGIN, DEBUG, "Issuing AUTH LOGIN command") \
+	X(SMTP_AUTH_PLAIN, DEBUG, "Issuing AUTH PLAIN command") \
+	X(SMTP_PIPELINE, DEBUG, "Pipelining MAIL FROM, RCPT TO and DATA commands") \
+	X(SMTP_USERNAME, DEBUG, "Issuing USERNAME command") \
+	X(SMTP_PASSWORD, DEBUG, "Issuing PASSWORD command") \
+	X(SMTP_MAIL_FROM, DEBUG, "Issuing MAIL FROM command") \
+	X(SMTP_RCPT_TO, DEBUG, "Issuing RCPT TO command for recipient %d") \
+	X(SMTP_DATA, DEBUG, "Issuing DATA command") \
+	X(SMTP_BODY, DEBUG, "Sending body of message...") \
+	X(SMTP_EOM, DEBUG, "Sending EOM character") \
+	X(SMTP_QUIT, DEBUG, "Issuing QUIT command") \
+	X(SMTP_RSET, DEBUG, "No recipient accepted the message, issuing RSET command") \
+	X(SMTP_RCPT_REFUSED, WARN, "Recipient %d refused") \
+	X(SMTP_MESSAGE_REFUSED, ERROR, "Every recipient refused message %d, dropped") \
+	X(SMTP_DEADLINE, ERROR, "Out of time for the session") \
+	X(SMTP_UNEXPECTED_REPLY, ERROR, "Unexpected reply %d") \
+	X(SMTP_NO_DATA_REPLY, ERROR, "No reply to DATA") \
+	X(SMTP_REPLY, DEBUG, "Reply %d") \
+	/* UDPTelemetry */ \
+	X(UDP_LOOKUP_FAILED, ERROR, "Failed to resolve telemetry listener") \
+	X(UDP_SEND_FAILED, ERROR, "Failed to send telemetry datagram") \
+	X(UDP_NO_ACK, ERROR, "Telemetry not acknowledged") \
+	X(UDP_SENT, INFO, "Telemetry delivered")
+
+/* Event IDs, in table order */
+#define LOG_EVENT_ID(name, level, format) EVENT_##name,
+enum LogEvent : uint8_t {
+	LOG_EVENTS(LOG_EVENT_ID)
+	EVENT_COUNT
+};
+#undef LOG_EVENT_ID
+
+/* Level each event is logged at, checked against the logging call at compile time */
+#define LOG_EVENT_LEVEL(name, level, format) EVENT_LEVEL_##name = LOG_LEVEL_##level,
+enum LogEventLevel {
+	LOG_EVENTS(LOG_EVENT_LEVEL)
+};
+#undef LOG_EVENT_LEVEL
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
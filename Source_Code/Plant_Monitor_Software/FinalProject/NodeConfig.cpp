@@ -0,0 +1,195 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "NodeConfig.h"
+#include "RTCStore.h"
+#include "SampleBuffer.h"
+#include "EventLog.h"
+#include "Hal.h"
+#include <EEPROM.h>
+
+/* Definitions */
+// Built-in settings, used until others have been saved from the console
+#define DEFAULT_NETWORK_NAME "PlantLifeMonitor"
+#define DEFAULT_NETWORK_PASS "PlzSenpaiGiveMeA"
+#define DEFAULT_HOSTNAME "Plant_Node_1"
+/* *** INSERT PLANT MONITOR EMAIL ADDRESS HERE *** */
+#define DEFAULT_RECIPIENT "PLANT@MONITOR.EMAIL"
+#define DEFAULT_SAMPLES_PER_REPORT 10 // wakes between emails, readings in between are kept in RTC memory (1 = email every wake)
+
+#define CONFIG_FLASH_SIZE (sizeof(uint32_t) + sizeof(ConfigData)) // CRC followed by the settings
+#define CONSOLE_LINE_SIZE 96 // longest console line, "pass=" plus the longest passphrase
+#define CONSOLE_POLL_INTERVAL 10 // how often to check for console input (ms)
+
+// Console text
+#define CONSOLE_BANNER "Configuration console: key=value to change a setting, show, save, log, exit"
+#define CONSOLE_HELP "Keys: ssid, pass, host, to, samples (1 to " // followed by the sample buffer capacity
+#define CONSOLE_OK "OK"
+#define CONSOLE_SAVED "Saved"
+#define CONSOLE_SAVE_FAILED "Could not save"
+#define CONSOLE_IDLE "Console idle, carrying on"
+
+/* Variables */
+static ConfigData _config;
+
+/* Functions */
+
+// Function to load the settings saved in flash, falling back to the built-in ones
+// Flash holds the struct exactly as it's used, so loading is a copy and a CRC check
+bool NodeConfig::begin() {
+  uint32_t storedCrc;
+
+  EEPROM.begin(CONFIG_FLASH_SIZE); // reads the whole area in one go
+  memcpy(&storedCrc, EEPROM.getConstDataPtr(), sizeof(storedCrc));
+  memcpy(&_config, EEPROM.getConstDataPtr() + sizeof(storedCrc), sizeof(_config));
+  EEPROM.end();
+
+  if (RTCStore::crc32(&_config, sizeof(_config)) == storedCrc && _config.version == CONFIG_VERSION) {
+    return true;
+  }
+
+  loadDefaults();
+  return false;
+}
+
+// Function to get the current settings
+const ConfigData& NodeConfig::get() {
+  return _config;
+}
+
+// Function to change one setting; strings that don't fit are refused rather than cut short
+bool NodeConfig::set(const char* key, const char* value) {
+  char* field = NULL;
+  size_t size = 0;
+
+  if (strcmp(key, "ssid") == 0) {
+    field = _config.ssid;
+    size = sizeof(_config.ssid);
+  }
+  else if (strcmp(key, "pass") == 0) {
+    field = _config.password;
+    size = sizeof(_config.password);
+  }
+  else if (strcmp(key, "host") == 0) {
+    field = _config.hostname;
+    size = sizeof(_config.hostname);
+  }
+  else if (strcmp(key, "to") == 0) {
+    field = _config.recipient;
+    size = sizeof(_config.recipient);
+  }
+  else if (strcmp(key, "samples") == 0) {
+    long samples = atol(value);
+    if (samples < 1 || samples > (long)SAMPLE_BUFFER_CAPACITY) {
+      return false;
+    }
+    _config.samplesPerReport = samples;
+    return true;
+  }
+
+  if (field == NULL || strlen(value) >= size) {
+    return false;
+  }
+
+  strcpy(field, value);
+  return true;
+}
+
+// Function to write the current settings to flash, along with the CRC that marks them valid
+bool NodeConfig::save() {
+  uint32_t crc = RTCStore::crc32(&_config, sizeof(_config));
+
+  EEPROM.begin(CONFIG_FLASH_SIZE);
+  memcpy(EEPROM.getDataPtr(), &crc, sizeof(crc));
+  memcpy(EEPROM.getDataPtr() + sizeof(crc), &_config, sizeof(_config));
+  return EEPROM.end(); // commits the sector
+}
+
+// Method to read console commands until "exit", or until nothing has been typed for idleTimeout ms
+// Changes only last past this wake once saved
+void NodeConfig::configure(Stream& console, unsigned long idleTimeout) {
+  char line[CONSOLE_LINE_SIZE];
+  size_t len = 0;
+  unsigned long lastInput = Hal::millis();
+
+  console.println(F(CONSOLE_BANNER));
+  print(console);
+
+  while ((Hal::millis() - lastInput) < idleTimeout) {
+    if (!console.available()) {
+      Hal::delay(CONSOLE_POLL_INTERVAL);
+      continue;
+    }
+
+    int c = console.read();
+    lastInput = Hal::millis();
+
+    if (c == '\r') {
+      continue;
+    }
+    if (c != '\n') { // keep collecting the line, anything past the buffer is dropped
+      if (len < sizeof(line) - 1) {
+        line[len++] = c;
+      }
+      continue;
+    }
+
+    line[len] = '\0';
+    len = 0;
+
+    if (strcmp(line, "show") == 0) {
+      print(console);
+    }
+    else if (strcmp(line, "save") == 0) {
+      console.println(save() ? F(CONSOLE_SAVED) : F(CONSOLE_SAVE_FAILED));
+    }
+    else if (strcmp(line, "log") == 0) { // records left by earlier wakes
+      EventLog::flush(console);
+    }
+    else if (strcmp(line, "exit") == 0) {
+      return;
+    }
+    else {
+      char* value = strchr(line, '=');
+      if (value != NULL) {
+        *value++ = '\0';
+      }
+
+      if (value != NULL && set(line, value)) {
+        console.println(F(CONSOLE_OK));
+      }
+      else {
+        console.print(F(CONSOLE_HELP));
+        console.print((int)SAMPLE_BUFFER_CAPACITY);
+        console.println(')');
+      }
+    }
+  }
+
+  console.println(F(CONSOLE_IDLE));
+}
+
+// Method to print the current settings, leaving out the passphrase
+void NodeConfig::print(Print& out) {
+  out.print(F("ssid=")); out.println(_config.ssid);
+  out.print(F("host=")); out.println(_config.hostname);
+  out.print(F("to=")); out.println(_config.recipient);
+  out.print(F("samples=")); out.println(_config.samplesPerReport);
+}
+
+// Method to fill in the built-in settings
+void NodeConfig::loadDefaults() {
+  memset(&_config, 0, sizeof(_config));
+  _config.version = CONFIG_VERSION;
+  _config.samplesPerReport = DEFAULT_SAMPLES_PER_REPORT;
+  strcpy(_config.ssid, DEFAULT_NETWORK_NAME);
+  strcpy(_config.password, DEFAULT_NETWORK_PASS);
+  strcpy(_config.hostname, DEFAULT_HOSTNAME);
+  strcpy(_config.recipient, DEFAULT_RECIPIENT);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,47 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef NodeConfig_h
+#define NodeConfig_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+#define CONFIG_VERSION 1 // bump whenever ConfigData changes, older copies in flash are then ignored
+#define CONFIG_SSID_SIZE 33 // longest network name plus terminator
+#define CONFIG_PASS_SIZE 65 // longest WPA passphrase plus terminator
+#define CONFIG_HOSTNAME_SIZE 33
+#define CONFIG_RECIPIENT_SIZE 65
+
+// Settings that can be changed without reflashing, kept in flash exactly as they are used
+struct ConfigData {
+	uint16_t version; // CONFIG_VERSION the settings were saved with
+	uint16_t samplesPerReport; // wakes between reports
+	char ssid[CONFIG_SSID_SIZE]; // network to join
+	char password[CONFIG_PASS_SIZE]; // passphrase of the network
+	char hostname[CONFIG_HOSTNAME_SIZE]; // name of the node on the network and in reports
+	char recipient[CONFIG_RECIPIENT_SIZE]; // email address reports are sent to
+};
+
+/* NodeConfig class definition */
+// Loads the settings from the flash sector reserved for EEPROM emulation (no filesystem to mount,
+// nothing to parse), and offers a serial console for changing them
+class NodeConfig {
+	public:
+		/* Public Functions and Methods */
+		static bool begin(); // function to load the settings from flash, returns false if the built-in defaults are used
+		static const ConfigData& get(); // function to get the current settings
+		static bool set(const char* key, const char* value); // function to change one setting, returns false for an unknown key or bad value
+		static bool save(); // function to write the current settings to flash
+		static void configure(Stream& console, unsigned long idleTimeout); // method to run the settings console until it's closed or left idle (ms)
+		static void print(Print& out); // method to print the current settings (without the password)
+	private:
+		/* Private Functions and Methods */
+		static void loadDefaults(); // method to fill in the built-in settings
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
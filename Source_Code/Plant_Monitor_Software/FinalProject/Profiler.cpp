@@ -0,0 +1,146 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "Profiler.h"
+#include "RTCStore.h"
+#include "Hal.h"
+
+/* Definitions */
+#define PROFILE_COUNT_LIMIT 0xFFFF // largest count a phase can hold before it is halved
+#define PROFILE_BUCKET_LIMIT 0xFF // largest count a histogram bucket can hold before the histogram is halved
+#define PROFILE_DURATION_LIMIT 0xFFFF // longest duration (ms) min and max can hold
+
+// Summary written into reports, one line per phase that has been recorded (host/tools/decode_profile reads it back):
+//   name: n=count min=ms mean=ms max=ms hist=<10ms/<100ms/<500ms/<2s/<5s/longer
+#define PROFILE_REPORT_HEADER "<h3>&emsp;Timing (ms):</h3><br>\r\n"
+#define PROFILE_REPORT_TEMPLATE "&emsp;&emsp;%s: n=%u min=%u mean=%u max=%u hist=%u/%u/%u/%u/%u/%u<br>\r\n"
+#define PROFILE_PRINT_TEMPLATE "%s: n=%u min=%u mean=%u max=%u ms\r\n"
+
+/* Variables */
+static PhaseStats _stats[PHASE_COUNT];
+
+static_assert(RTCStore::blocksFor(sizeof(_stats)) <= RTC_PROFILER_BLOCKS, "Profiler does not fit its RTC slot");
+
+/* Constants */
+static const uint32_t _BUCKET_LIMITS_MS[PROFILE_HISTOGRAM_BUCKETS - 1] = { 10, 100, 500, 2000, 5000 }; // upper bound of each bucket but the last
+
+static const char _AWAKE_NAME[] PROGMEM = "awake";
+static const char _STARTUP_NAME[] PROGMEM = "startup";
+static const char _SENSORS_NAME[] PROGMEM = "sensors";
+static const char _WIFI_NAME[] PROGMEM = "wifi";
+static const char _TLS_NAME[] PROGMEM = "tls";
+static const char _REPLY_NAME[] PROGMEM = "reply";
+static const char _REPORT_NAME[] PROGMEM = "report";
+static const char* const _PHASE_NAMES[PHASE_COUNT] = { // in ProfilePhase order
+  _AWAKE_NAME, _STARTUP_NAME, _SENSORS_NAME, _WIFI_NAME, _TLS_NAME, _REPLY_NAME, _REPORT_NAME
+};
+
+/* Functions */
+
+// Function to restore the statistics from RTC memory
+// A CRC mismatch (first power up, brown-out, flashing) starts them again from empty
+bool Profiler::begin() {
+  if (RTCStore::load(RTC_PROFILER_SLOT, _stats, sizeof(_stats))) {
+    return true;
+  }
+
+  memset(_stats, 0, sizeof(_stats));
+  return false;
+}
+
+// Method to add one duration of a phase
+void Profiler::record(ProfilePhase phase, uint32_t elapsedUs) {
+  PhaseStats& stats = _stats[phase];
+  uint32_t elapsedMs = elapsedUs / 1000;
+  uint16_t clamped = (uint16_t)min(elapsedMs, (uint32_t)PROFILE_DURATION_LIMIT);
+  int bucket = 0;
+
+  Hal::phaseEnded(phase, elapsedUs);
+
+  while (bucket < (PROFILE_HISTOGRAM_BUCKETS - 1) && elapsedMs >= _BUCKET_LIMITS_MS[bucket]) {
+    bucket++;
+  }
+
+  if (stats.count == PROFILE_COUNT_LIMIT) { // halve rather than wrap, which keeps the mean
+    stats.count /= 2;
+    stats.totalMs /= 2;
+  }
+  if (stats.histogram[bucket] == PROFILE_BUCKET_LIMIT) { // halve every bucket, which keeps their proportions
+    for (int b = 0; b < PROFILE_HISTOGRAM_BUCKETS; b++) {
+      stats.histogram[b] /= 2;
+    }
+  }
+
+  if (stats.count == 0 || clamped < stats.minMs) {
+    stats.minMs = clamped;
+  }
+  if (clamped > stats.maxMs) {
+    stats.maxMs = clamped;
+  }
+  stats.totalMs += elapsedMs;
+  stats.count++;
+  stats.histogram[bucket]++;
+}
+
+// Method to record the whole wake and save the statistics
+void Profiler::end() {
+  record(PHASE_AWAKE, Hal::micros());
+  RTCStore::save(RTC_PROFILER_SLOT, _stats, sizeof(_stats));
+}
+
+// Function to get the statistics of a phase
+const PhaseStats& Profiler::getStats(ProfilePhase phase) {
+  return _stats[phase];
+}
+
+// Method to write a compact summary of every phase into a report
+// Each line has the same fixed layout so the numbers can be picked back out of the email
+void Profiler::writeReport(ReportWriter& report) {
+  report.printTemplate(PSTR(PROFILE_REPORT_HEADER));
+
+  for (int p = 0; p < PHASE_COUNT; p++) {
+    const PhaseStats& stats = _stats[p];
+
+    if (stats.count == 0) { // phase hasn't happened yet (e.g. no report sent)
+      continue;
+    }
+
+    report.printTemplate(PSTR(PROFILE_REPORT_TEMPLATE), _PHASE_NAMES[p], (unsigned long)stats.count,
+                         (unsigned long)stats.minMs, (unsigned long)(stats.totalMs / stats.count), (unsigned long)stats.maxMs,
+                         (unsigned long)stats.histogram[0], (unsigned long)stats.histogram[1],
+                         (unsigned long)stats.histogram[2], (unsigned long)stats.histogram[3],
+                         (unsigned long)stats.histogram[4], (unsigned long)stats.histogram[5]);
+  }
+}
+
+// Method to print the statistics of every phase to serial
+void Profiler::printStats() {
+  ReportWriter out(Serial);
+
+  for (int p = 0; p < PHASE_COUNT; p++) {
+    const PhaseStats& stats = _stats[p];
+
+    if (stats.count > 0) {
+      out.printTemplate(PSTR(PROFILE_PRINT_TEMPLATE), _PHASE_NAMES[p], (unsigned long)stats.count,
+                        (unsigned long)stats.minMs, (unsigned long)(stats.totalMs / stats.count), (unsigned long)stats.maxMs);
+    }
+  }
+}
+
+/* Constructors */
+// Constructor that starts timing the phase
+ProfileTimer::ProfileTimer(ProfilePhase phase)
+  : _phase(phase), _start(Hal::micros())
+{
+}
+
+// Destructor that records the time taken
+ProfileTimer::~ProfileTimer() {
+  Profiler::record(_phase, Hal::micros() - _start);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,66 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Profiler_h
+#define Profiler_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include "ReportWriter.h"
+
+/* Definitions */
+#define PROFILE_HISTOGRAM_BUCKETS 6 // durations are counted as < 10 ms, < 100 ms, < 500 ms, < 2 s, < 5 s and longer
+
+/* Parts of a wake that are timed */
+enum ProfilePhase {
+	PHASE_AWAKE, // whole wake, from boot to deep sleep
+	PHASE_STARTUP, // startup wait and serial setup
+	PHASE_SENSORS, // powering, settling and reading the sensors
+	PHASE_WIFI, // associating with the network and getting an address
+	PHASE_TLS, // resolving the SMTP server and the TLS handshake
+	PHASE_REPLY, // waiting on a single server response (one round trip)
+	PHASE_REPORT, // every email attempt of a report, including retry delays
+	PHASE_COUNT // number of phases (not a phase)
+};
+
+/* Statistics kept for one phase */
+struct PhaseStats {
+	uint32_t totalMs; // sum of every recorded duration, for the mean
+	uint16_t count; // number of recorded durations
+	uint16_t minMs; // shortest duration
+	uint16_t maxMs; // longest duration
+	uint8_t histogram[PROFILE_HISTOGRAM_BUCKETS]; // recorded durations by bucket
+};
+
+/* Profiler class definition */
+// Accumulates how long each phase of a wake takes, over many wakes, in RTC memory.
+// Counters that would overflow are halved (along with their totals) so the mean and the shape of the histogram are kept.
+class Profiler {
+	public:
+		/* Public Functions and Methods */
+		static bool begin(); // function to restore the statistics from RTC memory, returns false if they restarted empty
+		static void record(ProfilePhase phase, uint32_t elapsedUs); // method to add one duration of a phase
+		static void end(); // method to record the whole wake and save the statistics (call right before deep sleep)
+		static const PhaseStats& getStats(ProfilePhase phase); // function to get the statistics of a phase
+		static void writeReport(ReportWriter& report); // method to write a compact summary of every phase into a report
+		static void printStats(); // method to print the statistics of every phase to serial
+};
+
+/* ProfileTimer class definition */
+// Times the enclosing scope and records it against a phase when it goes out of scope
+class ProfileTimer {
+	public:
+		/* Constructors */
+		ProfileTimer(ProfilePhase phase); // constructor that starts timing the phase
+		~ProfileTimer(); // destructor that records the time taken
+	private:
+		/* Private Instance Variables */
+		ProfilePhase _phase; // phase the time is recorded against
+		unsigned long _start; // micros() when timing started
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
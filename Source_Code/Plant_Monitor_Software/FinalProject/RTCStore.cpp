@@ -0,0 +1,73 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "RTCStore.h"
+#include "Hal.h"
+
+/* Definitions */
+#define CRC32_POLY 0xEDB88320 // reflected CRC-32 (IEEE 802.3) polynomial
+#define RTC_BLOCK_SIZE 4 // bytes per block of RTC memory
+
+/* Functions */
+
+// Function to read a slot back from RTC memory
+// Returns false if the stored CRC doesn't match the data (power loss, brown-out or never written)
+bool RTCStore::load(uint32_t slot, void* data, size_t size) {
+  uint32_t storedCrc, block;
+  uint8_t* dest = (uint8_t*)data;
+
+  if ((slot + blocksFor(size)) > RTC_USER_BLOCKS) { // slot runs past the end of RTC memory
+    return false;
+  }
+
+  Hal::rtcRead(slot, &storedCrc); // CRC lives in the first block of the slot
+
+  // RTC memory is only word addressable, so copy one block at a time into the (possibly unaligned) destination
+  for (size_t i = 0; i < size; i += RTC_BLOCK_SIZE) {
+    Hal::rtcRead(slot + 1 + (i / RTC_BLOCK_SIZE), &block);
+    memcpy(dest + i, &block, min((size_t)RTC_BLOCK_SIZE, size - i));
+  }
+
+  return (crc32(data, size) == storedCrc);
+}
+
+// Function to write a slot to RTC memory along with the CRC of its data
+bool RTCStore::save(uint32_t slot, const void* data, size_t size) {
+  uint32_t crc, block;
+  const uint8_t* src = (const uint8_t*)data;
+
+  if ((slot + blocksFor(size)) > RTC_USER_BLOCKS) { // slot runs past the end of RTC memory
+    return false;
+  }
+
+  for (size_t i = 0; i < size; i += RTC_BLOCK_SIZE) {
+    block = 0; // pad the last block with zeros
+    memcpy(&block, src + i, min((size_t)RTC_BLOCK_SIZE, size - i));
+    Hal::rtcWrite(slot + 1 + (i / RTC_BLOCK_SIZE), &block);
+  }
+
+  crc = crc32(data, size); // write the CRC last so a reset part way through leaves the slot invalid
+  return Hal::rtcWrite(slot, &crc);
+}
+
+// Function to compute the CRC-32 of a buffer
+// Bitwise rather than table driven, since the slots are small and flash/RAM for a table is not
+uint32_t RTCStore::crc32(const void* data, size_t size, uint32_t crc) {
+  const uint8_t* bytes = (const uint8_t*)data;
+
+  crc = ~crc;
+  while (size--) {
+    crc ^= *bytes++;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (CRC32_POLY & (0 - (crc & 1)));
+    }
+  }
+
+  return ~crc;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,50 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef RTCStore_h
+#define RTCStore_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+/* RTC user memory layout */
+// The ESP8266 keeps 512 bytes (128 blocks of 4 bytes) of user RTC memory powered through deep sleep.
+// Each slot below is a CRC32 block followed by the owner's data; offsets and sizes are in blocks.
+// (The first 32 blocks are also used by eboot for OTA updates, which this project does not use.)
+#define RTC_USER_BLOCKS 128
+#define RTC_SAMPLE_BUFFER_SLOT 0 // SampleBuffer ring of sensor readings
+#define RTC_SAMPLE_BUFFER_BLOCKS 33
+#define RTC_CONNECTION_CACHE_SLOT 33 // ConnectionManager access point, IP settings and lease
+#define RTC_CONNECTION_CACHE_BLOCKS 9
+#define RTC_WAKE_CLOCK_SLOT 42 // WakeClock time since power up
+#define RTC_WAKE_CLOCK_BLOCKS 3
+#define RTC_SMTP_CACHE_SLOT 45 // SMTP server address and TLS session
+#define RTC_SMTP_CACHE_BLOCKS 26
+#define RTC_SETTLE_HISTORY_SLOT 71 // SensorMetrics learned sensor settle time
+#define RTC_SETTLE_HISTORY_BLOCKS 2
+#define RTC_PROFILER_SLOT 73 // Profiler phase timing statistics
+#define RTC_PROFILER_BLOCKS 29
+#define RTC_REPORT_POLICY_SLOT 102 // ReportPolicy last reported values, trend and sleep interval
+#define RTC_REPORT_POLICY_BLOCKS 10
+#define RTC_RTT_SLOT 112 // RTTEstimator smoothed server round trip time
+#define RTC_RTT_BLOCKS 3
+#define RTC_EVENT_LOG_SLOT 115 // EventLog latest log records
+#define RTC_EVENT_LOG_BLOCKS 13
+
+/* RTCStore class definition */
+class RTCStore {
+	public:
+		/* Public Functions and Methods */
+		static bool load(uint32_t slot, void* data, size_t size); // function to read a slot back, returns false if its CRC doesn't match
+		static bool save(uint32_t slot, const void* data, size_t size); // function to write a slot along with its CRC
+		static uint32_t crc32(const void* data, size_t size, uint32_t crc=0); // function to compute the CRC-32 of a buffer
+
+		/* Helper for sizing slots at compile time */
+		static constexpr uint32_t blocksFor(size_t size) { return ((size + 3) / 4) + 1; } // data rounded up to whole blocks plus the CRC block
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
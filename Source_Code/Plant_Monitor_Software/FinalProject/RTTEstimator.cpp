@@ -0,0 +1,93 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "RTTEstimator.h"
+#include "RTCStore.h"
+
+/* Definitions */
+#define RTT_INITIAL_TIMEOUT 3000 // deadline (ms) before anything has been measured
+#define RTT_MIN_TIMEOUT 1250 // shortest deadline (ms): lwIP resends a lost segment after 1 s at the earliest, and
+                            // giving up sooner turns one lost segment into a failed session and a new handshake
+#define RTT_MAX_TIMEOUT 10000 // longest deadline (ms) backing off can reach
+#define RTT_MAX_BACKOFF 5 // deadline doubles at most this many times
+#define RTT_CLOCK_GRANULARITY 10 // smallest variation term (ms), as millis() steps and the SDK schedules
+
+/* Variables */
+// Everything that is persisted in RTC memory between wakes
+struct RTTState {
+  uint16_t srtt; // smoothed round trip time (ms), 0 = nothing measured yet
+  uint16_t rttvar; // smoothed mean deviation of the round trip time (ms)
+  uint8_t backoff; // deadlines missed since the last measurement
+};
+
+static_assert(RTCStore::blocksFor(sizeof(RTTState)) <= RTC_RTT_BLOCKS, "RTTEstimator does not fit its RTC slot");
+
+static RTTState _state;
+
+/* Functions */
+
+// Function to restore the estimate from RTC memory, starting over after power loss
+bool RTTEstimator::begin() {
+  if (RTCStore::load(RTC_RTT_SLOT, &_state, sizeof(_state)) && _state.backoff <= RTT_MAX_BACKOFF) {
+    return true;
+  }
+
+  memset(&_state, 0, sizeof(_state));
+  return false;
+}
+
+// Method to fold a measured round trip into the estimate (gains of 1/8 and 1/4 as in RFC 6298)
+void RTTEstimator::addSample(unsigned long rtt) {
+  rtt = min(rtt, (unsigned long)RTT_MAX_TIMEOUT);
+
+  if (_state.srtt == 0) { // first measurement
+    _state.srtt = max(rtt, 1UL);
+    _state.rttvar = rtt / 2;
+  }
+  else {
+    long error = (long)rtt - (long)_state.srtt;
+
+    _state.rttvar = (3 * _state.rttvar + abs(error)) / 4;
+    _state.srtt = max((long)_state.srtt + (error / 8), 1L);
+  }
+
+  _state.backoff = 0; // a good measurement ends any backing off
+  save();
+}
+
+// Method to double the deadline after a response didn't arrive in time
+void RTTEstimator::backOff() {
+  if (_state.backoff < RTT_MAX_BACKOFF) {
+    _state.backoff++;
+    save();
+  }
+}
+
+// Function to get the current response deadline
+// Floored before backing off (as RFC 6298 does), so every missed deadline lengthens the next one
+unsigned long RTTEstimator::getTimeout() {
+  unsigned long timeout = RTT_INITIAL_TIMEOUT;
+
+  if (_state.srtt != 0) {
+    timeout = _state.srtt + max(4UL * _state.rttvar, (unsigned long)RTT_CLOCK_GRANULARITY);
+  }
+
+  timeout = max(timeout, (unsigned long)RTT_MIN_TIMEOUT) << _state.backoff;
+  return min(timeout, (unsigned long)RTT_MAX_TIMEOUT);
+}
+
+// Function to get the smoothed round trip time
+unsigned long RTTEstimator::getSmoothedRTT() {
+  return _state.srtt;
+}
+
+// Method to write the estimate back to RTC memory
+void RTTEstimator::save() {
+  RTCStore::save(RTC_RTT_SLOT, &_state, sizeof(_state));
+}
+
+// ©2017 Jeremy Maxey-Vesperman
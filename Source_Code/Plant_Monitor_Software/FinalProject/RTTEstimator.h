@@ -0,0 +1,32 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef RTTEstimator_h
+#define RTTEstimator_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+/* RTTEstimator class definition */
+// Smoothed round trip time and its variation, measured from server responses and kept in RTC memory so each
+// wake starts from what the network was last like. Response deadlines are derived from them the way TCP
+// derives its retransmission timeout (RFC 6298): srtt + 4 * rttvar, doubled for every deadline missed since
+// the last good measurement.
+class RTTEstimator {
+	public:
+		/* Public Functions and Methods */
+		static bool begin(); // function to restore the estimate from RTC memory, returns false if it restarted
+		static void addSample(unsigned long rtt); // method to fold a measured round trip (ms) into the estimate
+		static void backOff(); // method to double the deadline after a response didn't arrive in time
+		static unsigned long getTimeout(); // function to get the current response deadline (ms)
+		static unsigned long getSmoothedRTT(); // function to get the smoothed round trip time (ms, 0 before any measurement)
+	private:
+		/* Private Functions and Methods */
+		static void save(); // method to write the estimate back to RTC memory
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
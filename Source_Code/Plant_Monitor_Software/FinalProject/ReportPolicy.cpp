@@ -0,0 +1,145 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "ReportPolicy.h"
+#include "RTCStore.h"
+#include "WakeClock.h"
+
+/* Definitions */
+#define POLICY_DEFAULT_SLEEP 30 // sleep interval (s) after power up
+#define POLICY_MIN_SLEEP 30 // shortest sleep interval (s), used while readings change fast or an alert is active
+#define POLICY_MAX_SLEEP 1800 // longest sleep interval (s), deep sleep can't go much past 3 hours anyway
+#define POLICY_HEARTBEAT 21600 // report at least this often (s) even if nothing changed, so a dead node gets noticed
+#define POLICY_EMA_ALPHA 0.3f // weight of a new reading in the smoothed trend
+#define POLICY_FAST_RATE 0.5f // trend moving more than half a deadband per wake halves the interval
+#define POLICY_SLOW_RATE 0.1f // trend moving less than a tenth of a deadband per wake stretches it
+#define POLICY_STRETCH 1.5f // factor the interval grows by while readings are steady
+
+// Flags
+#define POLICY_PRIMED 0x01 // trend holds real readings
+#define POLICY_RADIO_ON 0x02 // this wake booted with the radio enabled
+
+/* Variables */
+// Everything that is persisted in RTC memory between wakes
+struct PolicyState {
+  int16_t lastSent[NodeSensors::count]; // values in the last report delivered, packed like the sample buffer
+  float trend[NodeSensors::count]; // smoothed readings
+  uint32_t lastSentTime; // WakeClock time of the last report delivered
+  uint16_t sleepTime; // current sleep interval (s)
+  uint8_t alerts; // alert flags of the latest readings
+  uint8_t reportedAlerts; // alert flags that have already been reported
+  uint8_t flags; // POLICY_ flags
+};
+
+static_assert(RTCStore::blocksFor(sizeof(PolicyState)) <= RTC_REPORT_POLICY_BLOCKS, "ReportPolicy does not fit its RTC slot");
+
+static PolicyState _state;
+static bool _changed; // whether the latest readings moved past a deadband since the last report
+
+/* Functions */
+
+// Function to restore the policy state from RTC memory
+// Starts over after power loss; the radio is on by default at power up
+bool ReportPolicy::begin() {
+  if (RTCStore::load(RTC_REPORT_POLICY_SLOT, &_state, sizeof(_state)) &&
+      _state.sleepTime >= POLICY_MIN_SLEEP && _state.sleepTime <= POLICY_MAX_SLEEP) {
+    return true;
+  }
+
+  memset(&_state, 0, sizeof(_state));
+  _state.sleepTime = POLICY_DEFAULT_SLEEP;
+  _state.flags = POLICY_RADIO_ON;
+  return false;
+}
+
+// Function to decide what to do with this wake's readings, updating the trend and sleep interval on the way
+ReportDecision ReportPolicy::evaluate(const float* sensors, bool batchDue) {
+  float previous[NodeSensors::count];
+  float lastSent[NodeSensors::count];
+  ReportDecision decision = REPORT_HOLD;
+
+  // Smooth each reading so a single noisy wake doesn't change the interval
+  memcpy(previous, _state.trend, sizeof(previous));
+  for (int i = 0; i < NodeSensors::count; i++) {
+    _state.trend[i] = (_state.flags & POLICY_PRIMED) ? _state.trend[i] + (POLICY_EMA_ALPHA * (sensors[i] - _state.trend[i])) : sensors[i];
+  }
+
+  // Sleep less while readings are on the move, more while they are steady
+  if (_state.flags & POLICY_PRIMED) {
+    float rate = NodeSensors::changeRate(_state.trend, previous);
+
+    if (rate > POLICY_FAST_RATE) {
+      _state.sleepTime = max(_state.sleepTime / 2, POLICY_MIN_SLEEP);
+    }
+    else if (rate < POLICY_SLOW_RATE) {
+      _state.sleepTime = min((int)(_state.sleepTime * POLICY_STRETCH), POLICY_MAX_SLEEP);
+    }
+  }
+  _state.flags |= POLICY_PRIMED;
+
+  // An alert goes out once when it starts; one that clears can go out again next time
+  _state.alerts = NodeSensors::alerts(sensors);
+  _state.reportedAlerts &= _state.alerts;
+
+  NodeSensors::unpack(_state.lastSent, lastSent);
+  _changed = (_state.lastSentTime == 0) || NodeSensors::changed(sensors, lastSent);
+
+  if (_state.alerts & ~_state.reportedAlerts) {
+    decision = REPORT_ALERT;
+    _state.sleepTime = POLICY_MIN_SLEEP; // look again soon, the interval stretches back out if things settle
+  }
+  else if (batchDue && (_changed || (WakeClock::now() - _state.lastSentTime) >= POLICY_HEARTBEAT)) {
+    decision = REPORT_SEND;
+  }
+
+  save();
+  return decision;
+}
+
+// Method to remember what was just delivered, so only changes from it are reported
+void ReportPolicy::reportSent(const float* sensors) {
+  NodeSensors::pack(sensors, _state.lastSent);
+  _state.lastSentTime = max(WakeClock::now(), (uint32_t)1); // 0 means nothing sent yet
+  _state.reportedAlerts = _state.alerts;
+  _changed = false;
+  save();
+}
+
+// Function to choose whether the next wake needs the radio, and remember the choice for that wake
+// Booting with the radio disabled saves its calibration and idle current, at the cost of a quick restart
+// if an alert turns up on that wake anyway
+RFMode ReportPolicy::prepareSleep(bool batchDueNext) {
+  bool heartbeatDue = (WakeClock::now() + _state.sleepTime - _state.lastSentTime) >= POLICY_HEARTBEAT;
+  bool radioOn = batchDueNext && (_changed || heartbeatDue);
+
+  _state.flags = radioOn ? (_state.flags | POLICY_RADIO_ON) : (_state.flags & ~POLICY_RADIO_ON);
+  save();
+
+  return radioOn ? WAKE_RF_DEFAULT : WAKE_RF_DISABLED;
+}
+
+// Function to check whether this wake booted with the radio enabled
+bool ReportPolicy::isRadioOn() {
+  return (_state.flags & POLICY_RADIO_ON);
+}
+
+// Function to get the current sleep interval (s)
+uint32_t ReportPolicy::getSleepTime() {
+  return _state.sleepTime;
+}
+
+// Function to get the alert flags of this wake's readings
+uint8_t ReportPolicy::getAlerts() {
+  return _state.alerts;
+}
+
+// Method to write the policy state back to RTC memory
+void ReportPolicy::save() {
+  RTCStore::save(RTC_REPORT_POLICY_SLOT, &_state, sizeof(_state));
+}
+
+// ©2017 Jeremy Maxey-Vesperman
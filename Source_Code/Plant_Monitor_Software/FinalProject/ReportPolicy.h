@@ -0,0 +1,42 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef ReportPolicy_h
+#define ReportPolicy_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include "SensorRegistry.h"
+
+/* What to do with this wake's readings */
+enum ReportDecision {
+	REPORT_HOLD, // keep them in the sample buffer, radio stays off
+	REPORT_SEND, // a batch is due and something changed (or nothing has been sent for a long while)
+	REPORT_ALERT // a reading crossed an alert threshold, send straight away
+};
+
+/* ReportPolicy class definition */
+// Decides when a report is worth the radio, and how long to sleep between readings, from state kept in RTC memory:
+// the last values reported, a smoothed (EMA) trend of each reading and which alerts have already gone out.
+// Readings that stay inside every sensor's deadband aren't reported except as an occasional heartbeat, and
+// the sleep interval stretches while readings are steady and shrinks while they are changing.
+class ReportPolicy {
+	public:
+		/* Public Functions and Methods */
+		static bool begin(); // function to restore the policy state from RTC memory, returns false if it restarted
+		static ReportDecision evaluate(const float* sensors, bool batchDue); // function to decide what to do with this wake's readings
+		static void reportSent(const float* sensors); // method to remember what was just delivered
+		static RFMode prepareSleep(bool batchDueNext); // function to choose whether the next wake needs the radio, and remember it
+		static bool isRadioOn(); // function to check whether this wake booted with the radio enabled
+		static uint32_t getSleepTime(); // function to get the current sleep interval (s)
+		static uint8_t getAlerts(); // function to get the alert flags of this wake's readings (bit i = reading i)
+	private:
+		/* Private Functions and Methods */
+		static void save(); // method to write the policy state back to RTC memory
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
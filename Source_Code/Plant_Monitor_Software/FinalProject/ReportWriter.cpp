@@ -0,0 +1,96 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "ReportWriter.h"
+#include <stdarg.h>
+
+/* Definitions */
+#define TEMPLATE_PLACEHOLDER '%'
+#define FLOAT_DECIMALS 2
+
+/* Constructors */
+// Constructor that writes through to the specified output
+ReportWriter::ReportWriter(Print& out)
+  : _out(out), _length(0)
+{
+}
+
+// Destructor that makes sure nothing is left in the buffer
+ReportWriter::~ReportWriter() {
+  flush();
+}
+
+/* Functions */
+
+// Method for writing a flash template, filling its placeholders from the arguments in order
+// Numbers go through Print's own formatting, which uses a small stack buffer rather than String
+void ReportWriter::printTemplate(PGM_P tmpl, ...) {
+  va_list args;
+  char c;
+
+  va_start(args, tmpl);
+  while ((c = pgm_read_byte(tmpl++)) != '\0') {
+    if (c != TEMPLATE_PLACEHOLDER) { // plain text
+      write(c);
+      continue;
+    }
+
+    switch (c = pgm_read_byte(tmpl++)) {
+      case 's': // flash string
+        print(FPSTR(va_arg(args, PGM_P)));
+        break;
+      case 'r': // RAM string
+        print(va_arg(args, const char*));
+        break;
+      case 'd':
+        print(va_arg(args, long));
+        break;
+      case 'u':
+        print(va_arg(args, unsigned long));
+        break;
+      case 'f': // floats are promoted to double when passed through ...
+        print(va_arg(args, double), FLOAT_DECIMALS);
+        break;
+      case '\0': // template ended on a lone placeholder character
+        tmpl--;
+        break;
+      default: // %% and anything unrecognised are written as is
+        write(c);
+        break;
+    }
+  }
+  va_end(args);
+}
+
+// Function for writing a single character
+size_t ReportWriter::write(uint8_t c) {
+  if (_length >= REPORT_BUFFER_SIZE) {
+    flush();
+  }
+  _buffer[_length++] = c;
+
+  return 1;
+}
+
+// Function for writing several characters
+size_t ReportWriter::write(const uint8_t* buffer, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    write(buffer[i]);
+  }
+
+  return size;
+}
+
+// Method for handing the buffered characters to the output in one write
+void ReportWriter::flush() {
+  if (_length > 0) {
+    _out.write(_buffer, _length);
+    _length = 0;
+  }
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,39 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef ReportWriter_h
+#define ReportWriter_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+/* Definitions */
+#define REPORT_BUFFER_SIZE 128 // bytes collected before they are handed to the output (one TLS record at most)
+
+/* ReportWriter class definition */
+// Streams report text to any Print (e.g. the SMTP socket) through a small buffer, without touching the heap.
+// Templates are flash strings with placeholders that are filled in from the arguments in order:
+//   %s flash string, %r RAM string, %d integer (long), %u unsigned integer (unsigned long), %f float (2 decimals), %% percent sign
+class ReportWriter : public Print {
+	public:
+		/* Constructors */
+		ReportWriter(Print& out); // constructor that writes through to the specified output
+		~ReportWriter(); // destructor that flushes anything still buffered
+		
+		/* Public Functions and Methods */
+		void printTemplate(PGM_P tmpl, ...); // method for writing a flash template with its placeholders filled in
+		size_t write(uint8_t c) override; // function for writing a single character
+		size_t write(const uint8_t* buffer, size_t size) override; // function for writing several characters
+		void flush() override; // method for handing buffered characters to the output
+	private:
+		/* Private Instance Variables */
+		Print& _out; // where the report ends up
+		uint8_t _buffer[REPORT_BUFFER_SIZE]; // characters waiting to be written
+		size_t _length; // number of characters in the buffer
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
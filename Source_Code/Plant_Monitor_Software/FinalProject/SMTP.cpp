@@ -6,30 +6,76 @@
 // Include necessary header files
 #include "Arduino.h"
 #include "SMTP.h"
+#include "RTCStore.h"
+#include "WakeClock.h"
+#include "ReportWriter.h"
+#include "Profiler.h"
+#include "RTTEstimator.h"
+#include "Base64Writer.h"
+#include "EventLog.h"
+#include "Hal.h"
 #include <ESP8266WiFi.h>
+#include <limits.h>
+#include <stdio.h>
 
 /* Definitions */
-// Only support connection to Google's SMTP server through SSL socket
+// Google's SMTP server through SSL socket by default, see updateServer() for sending through a local collector
 #define SMTP_SERVER "smtp.gmail.com"
 #define SMTP_PORT 465
-#define DEFAULT_RESPONSE_TIMEOUT 750 // Default wait time for responses from server
+#define DNS_CACHE_TTL 3600 // seconds a resolved server address is reused (lwIP doesn't hand us the record's own TTL)
+#define DEFAULT_RESPONSE_TIMEOUT 10000 // Default longest deadline (ms) for a complete response from server
+#define DEFAULT_CONNECT_TIMEOUT 5000 // Default time (ms) allowed for opening the connection, TLS handshake included
+#define DEFAULT_LOOKUP_TIMEOUT 10000 // Default time (ms) allowed for looking up the server's address
 
 
 // Various SMTP commands and friendly names of commands
+#define GREETING_CMD "Greeting"
+#define CRLF "\r\n"
+#define EHLO_CMD "EHLO Seedling"
 #define HELO_CMD "HELO Seedling"
 #define AUTH_LOGIN_CMD "AUTH LOGIN"
+#define AUTH_PLAIN_CMD "AUTH PLAIN"
 #define USERNAME_CMD "Username"
 #define PASSWORD_CMD "Password"
 /* *** MODIFY THIS TO SPECIFY THE EMAIL ACCOUNT FOR THE MONITOR *** */
 #define MAIL_FROM_CMD "MAIL FROM: <PLANT@MONITOR.EMAIL>" // No support for sending from different address atm
 #define RCPT_TO_CMD_1 "RCPT TO: <"
 #define RCPT_TO_CMD_2 ">"
+#define RCPT_TO_TEMPLATE RCPT_TO_CMD_1 "%r" RCPT_TO_CMD_2 CRLF
 #define DATA_CMD "DATA"
-#define FROM_INPUT "From: Plant Life Monitor <plantlifemonitor@gmail.com>"
-#define TO_INPUT "To: "
-#define SUBJECT_INPUT "Subject: "
+// Message framing, %s is the subject and %r a recipient address (see ReportWriter)
+#define MESSAGE_START_TEMPLATE "From: Plant Life Monitor <plantlifemonitor@gmail.com>" CRLF \
+                               "Subject: %s" CRLF \
+                               "To: " // the recipients follow, separated by MESSAGE_RECIPIENT_SEPARATOR
+#define MESSAGE_RECIPIENT_SEPARATOR ", "
+#define MESSAGE_HEADER CRLF \
+                       "Mime-Version: 1.0" CRLF \
+                       "Content-Type: text/html; charset=\"ISO-8859-1\"" CRLF \
+                       "Content-Transfer-Encoding: 7bit" CRLF \
+                       CRLF \
+                       "<html>\r\n<body>\r\n"
+#define MESSAGE_FOOTER "\r\n</body></html>" CRLF
+// Messages with a record attached are multipart, the HTML report first and the base64 encoded record after it,
+// so whatever collects the emails gets the same binary record a UDP listener would
+#define MIME_BOUNDARY "PlantReportPart"
+#define MULTIPART_HEADER CRLF \
+                         "Mime-Version: 1.0" CRLF \
+                         "Content-Type: multipart/mixed; boundary=\"" MIME_BOUNDARY "\"" CRLF \
+                         CRLF \
+                         "--" MIME_BOUNDARY CRLF \
+                         "Content-Type: text/html; charset=\"ISO-8859-1\"" CRLF \
+                         "Content-Transfer-Encoding: 7bit" CRLF \
+                         CRLF \
+                         "<html>\r\n<body>\r\n"
+#define RECORD_PART_HEADER "--" MIME_BOUNDARY CRLF \
+                           "Content-Type: application/cbor; name=\"report.cbor\"" CRLF \
+                           "Content-Transfer-Encoding: base64" CRLF \
+                           "Content-Disposition: attachment; filename=\"report.cbor\"" CRLF \
+                           CRLF
+#define MULTIPART_END "--" MIME_BOUNDARY "--" CRLF
 #define EOM_CMD "EOM"
 #define QUIT_CMD "QUIT"
+#define RSET_CMD "RSET"
 #define SMTP_TERMINATE_CHAR "." // EOM character for body of email
 // ToDo: REMOVE THIS AND FORCE USER TO SPECIFY RECIPIENT ADDRESS AT SETUP
 // *** MODIFY THIS TO SPECIFIY THE DEFAULT RECEIPIENT EMAIL ADDRESS ***
@@ -40,116 +86,395 @@
 #define B64_USERNAME "INSERT_B64_ENCODED_USERNAME"
 #define B64_PASSWORD "INSERT_B64_ENCODED_PASSWORD"
 
+// ESMTP extensions we make use of when the server advertises them in its EHLO response
+#define CAP_PIPELINING 0x01 // several commands may be written before reading their responses (RFC 2920)
+#define CAP_AUTH_PLAIN 0x02 // credentials can be sent in a single AUTH PLAIN command (RFC 4616)
+#define CAP_PIPELINING_KEYWORD "PIPELINING"
+#define CAP_AUTH_KEYWORD "AUTH "
+#define CAP_AUTH_PLAIN_KEYWORD "PLAIN"
+#define RESP_LINE_BUFFER_SIZE 48 // longest response line text kept for capability parsing
+#define AUTH_PLAIN_BUFFER_SIZE 128 // room for the decoded username and password plus separators
+
 // SMTP server response codes
 #define RESP_SERVICE_READY 220
+#define RESP_NO_RESPONSE -1 // deadline passed before a complete response arrived
+#define RESP_MALFORMED 0 // response did not begin with a numeric reply code
 #define RESP_ACTION_OKAY 250
+#define RESP_WILL_FORWARD 251 // recipient accepted, the server forwards to its actual mailbox
 #define RESP_AUTH_LOGIN 334
 #define RESP_AUTHENTICATED 235
 #define RESP_START_MAIL 354
 #define RESP_CLOSE 221
+#define RESP_TRANSIENT_MIN 400 // 4xx replies: refused for now, the same command may succeed later
+#define RESP_TRANSIENT_MAX 499
 
 // Formatting for error messages
-#define INVAL_RESP_1 "Did not receive response "
-#define INVAL_RESP_2 " to "
-#define INVAL_RESP_3 " command."
+#define INVAL_RESP_TEMPLATE "Did not receive response %d to %s command."
+#define INVAL_RCPT_RESP_TEMPLATE "Did not receive response %d to " RCPT_TO_CMD_1 "%s" RCPT_TO_CMD_2 " command."
+#define REFUSED_TEMPLATE "Every recipient refused message %u, dropped."
+#define DEFERRED_TEMPLATE "Recipients refused message %u for now, kept for the next attempt."
 
-// Diagnostics messages
+// Status messages
 #define EMAIL_SUCCESS_MSG "Email Sent Successfully!"
-#define SMTP_CONNECT_SUCCESS_MSG "Successfully connected to SMTP Server!"
-#define SMTP_CONNECT_FAILED_MSG "Failed to connect to SMTP server"
-#define HELO_MSG "Issuing HELO command"
-#define AUTH_LOGIN_MSG "Issuing AUTH LOGIN command"
-#define USERNAME_MSG "Issuing USERNAME command"
-#define PASSWORD_MSG "Issuing PASSWORD command"
-#define MAIL_FROM_MSG "Issuing MAIL FROM command"
-#define RCPT_TO_MSG "Issuing RCPT TO command: "
-#define DATA_MSG "Issuing DATA command"
-#define BODY_MSG "Sending body of message..."
-#define EOM_MSG "Sending EOM character"
-#define QUIT_MSG "Issuing QUIT command"
+#define CONNECT_FAILED_MSG "Failed to connect to SMTP server."
 
 /* Variables */
-WiFiClientSecure _smtpClient; // create a secure client object
-int _timeout;
-String _recipientAddr;
-// Output message and flag
-String _emailStatusMsg;
-boolean f_EmailSuccessful;
+// Server address and TLS session parameters persisted in RTC memory between wakes
+struct SMTPCache {
+  uint8_t session[sizeof(BearSSL::Session)]; // session ID and master secret of the last handshake
+  uint32_t serverId; // CRC of the server name and port the rest of the cache belongs to
+  uint32_t serverAddr; // resolved address of the server (0 = none)
+  uint32_t addrExpires; // WakeClock time at which the address must be looked up again
+};
+
+static_assert(RTCStore::blocksFor(sizeof(SMTPCache)) <= RTC_SMTP_CACHE_BLOCKS, "SMTPCache does not fit its RTC slot");
 
 /* Constructors */
 // Default constructor uses default recipient address and timeout
 SMTP::SMTP()
-  : _recipientAddr(DEFAULT_RECIPIENT_ADDR), _timeout(DEFAULT_RESPONSE_TIMEOUT)
+  : _client(&_smtpClient),
+    _server(SMTP_SERVER), _port(SMTP_PORT), _secure(true), _b64Username(B64_USERNAME), _b64Password(B64_PASSWORD),
+    _timeout(DEFAULT_RESPONSE_TIMEOUT), _sentAt(0), _connectBy(NO_DEADLINE), _doneBy(NO_DEADLINE), f_RTTPending(false),
+    _recipientCount(0), _messageCount(0), f_PermanentFailure(false)
 {
+  addRecipient(DEFAULT_RECIPIENT_ADDR);
 }
 
 // Constructor that initializes recipient address to the one specified
 SMTP::SMTP(String recipientAddr)
-  : _recipientAddr(recipientAddr), _timeout(DEFAULT_RESPONSE_TIMEOUT)
+  : _client(&_smtpClient),
+    _server(SMTP_SERVER), _port(SMTP_PORT), _secure(true), _b64Username(B64_USERNAME), _b64Password(B64_PASSWORD),
+    _timeout(DEFAULT_RESPONSE_TIMEOUT), _sentAt(0), _connectBy(NO_DEADLINE), _doneBy(NO_DEADLINE), f_RTTPending(false),
+    _recipientCount(0), _messageCount(0), f_PermanentFailure(false)
 {
+  addRecipient(recipientAddr);
 }
 
 /* Functions */
 
 /* Method for sending update email via SMTP */
-bool SMTP::sendUpdateEmail(String subject, String body) {
+// The subject is a flash string, and the body is written straight into the socket by writeBody
+bool SMTP::sendUpdateEmail(PGM_P subject, MessageBodyWriter writeBody) {
+  clearMessages();
+  queueMessage(subject, writeBody);
+  return sendQueued();
+}
+
+/* Adds a message to be delivered by the next sendQueued() */
+bool SMTP::queueMessage(PGM_P subject, MessageBodyWriter writeBody, MessageBodyWriter writeRecord) {
+  if (_messageCount >= SMTP_MAX_MESSAGES) {
+    return false;
+  }
+  _subjects[_messageCount] = subject;
+  _bodies[_messageCount] = writeBody;
+  _records[_messageCount] = writeRecord;
+  _messageCount++;
+  return true;
+}
+
+/* Method for delivering every queued message to every recipient over one connection */
+// The handshake and login, the costliest part of a send, are paid once; each message is then its own
+// MAIL FROM ... DATA transaction. Delivered messages leave the queue, and so do messages every recipient
+// refused for good (5xx), which would only be refused again; only a message deferred by a 4xx refusal or a
+// failed session stays for the next attempt. Returns true if every message was delivered,
+// getRecipientStatus() tells which addresses got everything.
+bool SMTP::sendQueued() {
+  bool f_Refused = false; // whether a message was dropped
   // reinit output variables of the instance
-  _emailStatusMsg = EMAIL_SUCCESS_MSG;
+  strncpy_P(_emailStatusMsg, PSTR(EMAIL_SUCCESS_MSG), sizeof(_emailStatusMsg));
   f_EmailSuccessful = true;
+  f_QuitSent = false;
+  for (uint8_t i = 0; i < _recipientCount; i++) {
+    _recipientDelivered[i] = true;
+  }
 
   // if we successfully connect to the SMTP server...
-  if (_smtpClient.connect(SMTP_SERVER, SMTP_PORT)) { // connect via SSL socket
-    Serial.println(SMTP_CONNECT_SUCCESS_MSG);
+  if (connectServer()) { // connect via SSL socket
+    LOG_DEBUG(SMTP_CONNECTED);
+    login();
+
+    uint8_t remaining = 0;
+    for (uint8_t i = 0; i < _messageCount; i++) {
+      if (f_EmailSuccessful && timeLeft(_doneBy) == 0) { // no time to start another message
+        LOG_ERROR(SMTP_DEADLINE);
+        f_EmailSuccessful = false;
+      }
+      MessageOutcome outcome = f_EmailSuccessful ? sendMessage(i, i == (_messageCount - 1)) : MESSAGE_DEFERRED;
+      if (outcome == MESSAGE_DEFERRED) { // keep it for the next attempt
+        if (f_EmailSuccessful && remaining == 0 && !f_Refused) { // refused for now in a session that went fine
+          snprintf(_emailStatusMsg, sizeof(_emailStatusMsg), DEFERRED_TEMPLATE, (unsigned)i);
+        }
+        _subjects[remaining] = _subjects[i];
+        _bodies[remaining] = _bodies[i];
+        _records[remaining] = _records[i];
+        remaining++;
+      }
+      else if (outcome == MESSAGE_REFUSED) { // drop it, but say so
+        LOG_ERROR(SMTP_MESSAGE_REFUSED, i);
+        if (!f_Refused && f_EmailSuccessful) {
+          snprintf(_emailStatusMsg, sizeof(_emailStatusMsg), REFUSED_TEMPLATE, (unsigned)i);
+        }
+        f_Refused = true;
+      }
+    }
+    _messageCount = remaining;
+
+    if (f_EmailSuccessful && !f_QuitSent) {
+      LOG_DEBUG(SMTP_QUIT);
+      sendCmd(QUIT_CMD, RESP_CLOSE, QUIT_CMD); // issue QUIT command to terminate session
+    }
     
-    // create the recipient command string from the specified recipient address
-    String recipientCmd = (RCPT_TO_CMD_1 + _recipientAddr + RCPT_TO_CMD_2);
+    // output status message upon completion
+    if (_messageCount == 0 && !f_Refused) {
+      LOG_INFO(EMAIL_SENT);
+    }
+
+    _client->stop(); // 
+  }
+  else { // otherwise... output error
+    strncpy_P(_emailStatusMsg, PSTR(CONNECT_FAILED_MSG), sizeof(_emailStatusMsg));
+    LOG_ERROR(SMTP_CONNECT_FAILED);
+  }
+
+  if (_messageCount > 0) { // a message that didn't go out reached nobody
+    for (uint8_t i = 0; i < _recipientCount; i++) {
+      _recipientDelivered[i] = false;
+    }
+  }
 
-    Serial.println(HELO_MSG);
-    sendCmd(HELO_CMD, RESP_SERVICE_READY, HELO_CMD); // issue HELO command
-    Serial.println(AUTH_LOGIN_MSG);
+  f_PermanentFailure = (_messageCount == 0 && f_Refused); // nothing left that another attempt could deliver
+  return (_messageCount == 0 && !f_Refused);
+}
+
+/* Greets the server, negotiates extensions and authenticates if credentials are set */
+void SMTP::login() {
+  LOG_DEBUG(SMTP_GREETING);
+  expectResponse(RESP_SERVICE_READY, GREETING_CMD); // server speaks first once the socket is open
+  LOG_DEBUG(SMTP_EHLO);
+  sendEhlo(); // learn which extensions the server supports (falls back to HELO)
+
+  if (_b64Username == NULL) { // server trusts us without a login (e.g. a collector on the LAN)
+    LOG_DEBUG(SMTP_NO_AUTH);
+  }
+  else if (_capabilities & CAP_AUTH_PLAIN) { // credentials fit in a single command...
+    LOG_DEBUG(SMTP_AUTH_PLAIN);
+    sendAuthPlain(); // issue one-shot authentication command
+  }
+  else {
+    LOG_DEBUG(SMTP_AUTH_LOGIN);
     sendCmd(AUTH_LOGIN_CMD, RESP_AUTH_LOGIN, AUTH_LOGIN_CMD); // issue authentication command
-    Serial.println(USERNAME_MSG);
-    sendCmd(B64_USERNAME, RESP_AUTH_LOGIN, USERNAME_CMD); // send username
-    Serial.println(PASSWORD_MSG);
-    sendCmd(B64_PASSWORD, RESP_AUTHENTICATED, PASSWORD_CMD); // send password
-    Serial.println(MAIL_FROM_MSG);
+    LOG_DEBUG(SMTP_USERNAME);
+    sendCmd(_b64Username, RESP_AUTH_LOGIN, USERNAME_CMD); // send username
+    LOG_DEBUG(SMTP_PASSWORD);
+    sendCmd(_b64Password, RESP_AUTHENTICATED, PASSWORD_CMD); // send password
+  }
+}
+
+/* Sends one queued message to every recipient the server accepts. Returns whether it was delivered to any. */
+// MESSAGE_REFUSED if every recipient refused it for good, MESSAGE_DEFERRED if it is worth sending again.
+// A refused recipient only fails that address; a message nobody accepted is reset with RSET so the session
+// can go on to the next one. With pipelining, QUIT rides along with the end of the last message.
+MessageOutcome SMTP::sendMessage(uint8_t index, bool last) {
+  bool accepted[SMTP_MAX_RECIPIENTS];
+  bool f_AnyAccepted = false;
+  bool f_Delivered = false;
+
+  f_RetryLater = false;
+
+  if (_capabilities & CAP_PIPELINING) { // envelope can go out in one write...
+    LOG_DEBUG(SMTP_PIPELINE);
+    sendEnvelope(); // MAIL FROM, every RCPT TO and DATA together
+    expectResponse(RESP_ACTION_OKAY, MAIL_FROM_CMD); // then collect the replies in order
+    for (uint8_t i = 0; i < _recipientCount; i++) {
+      accepted[i] = expectRecipient(i);
+      f_AnyAccepted |= accepted[i];
+    }
+    if (f_AnyAccepted) {
+      expectResponse(RESP_START_MAIL, DATA_CMD);
+    }
+    else if (f_EmailSuccessful && readResponse() == RESP_NO_RESPONSE) { // DATA is refused without recipients, but must still be answered
+      setInvalResponse(DATA_CMD, RESP_START_MAIL);
+      LOG_ERROR(SMTP_NO_DATA_REPLY);
+      f_EmailSuccessful = false;
+    }
+  }
+  else {
+    LOG_DEBUG(SMTP_MAIL_FROM);
     sendCmd(MAIL_FROM_CMD, RESP_ACTION_OKAY, MAIL_FROM_CMD); // specify address we are sending from
-    Serial.println(RCPT_TO_MSG + recipientCmd);
-    sendCmd(recipientCmd, RESP_ACTION_OKAY, recipientCmd); // specify address of the receiver
-    Serial.println(DATA_MSG);
-    sendCmd(DATA_CMD, RESP_START_MAIL, DATA_CMD); // issue DATA command to start sending message
-    
-    Serial.println(BODY_MSG); 
-
-    _smtpClient.println(FROM_INPUT); // send the From line
-    delay(_timeout);
-    _smtpClient.println(SUBJECT_INPUT + subject); // send the Subject line
-    delay(_timeout);
-    _smtpClient.println(TO_INPUT + _recipientAddr); // send the To line
-	  delay(_timeout);
-    _smtpClient.println("Mime-Version: 1.0;\r\nContent-Type: text/html; charset=\"ISO-8859-1\r\nContent-Transfer-Encoding: 7bit;");
-    delay(_timeout);
-	  _smtpClient.println();
-    delay(_timeout);
-    _smtpClient.println("<html>\r\n<body>\r\n" + body + "\r\n</body></html>"); // send message
-    delay(_timeout);
-
-    Serial.println(EOM_MSG);
-    sendCmd(SMTP_TERMINATE_CHAR, RESP_ACTION_OKAY, EOM_CMD); // send terminating character to end message
-    Serial.println(QUIT_MSG);
-    sendCmd(QUIT_CMD, RESP_CLOSE, QUIT_CMD); // issue QUIT command to terminate session
-    
-    // output status message upon completion and return flag
-    Serial.println(_emailStatusMsg);
+    for (uint8_t i = 0; i < _recipientCount; i++) {
+      accepted[i] = false;
+      if (f_EmailSuccessful) {
+        LOG_DEBUG(SMTP_RCPT_TO, i);
+        {
+          ReportWriter command(*_client);
+          writeRecipient(command, i); // specify address of the receiver
+        }
+        commandSent();
+        accepted[i] = expectRecipient(i);
+        f_AnyAccepted |= accepted[i];
+      }
+    }
+    if (f_AnyAccepted) {
+      LOG_DEBUG(SMTP_DATA);
+      sendCmd(DATA_CMD, RESP_START_MAIL, DATA_CMD); // issue DATA command to start sending message
+    }
+  }
 
-    _smtpClient.stop(); // 
-    
-    return f_EmailSuccessful;
+  // The server does not reply to individual lines of the message, so it is streamed straight into the socket
+  if (f_AnyAccepted && f_EmailSuccessful) {
+    LOG_DEBUG(SMTP_BODY);
+    ReportWriter message(*_client);
+
+    writeHeader(message, index); // From, Subject, To and MIME lines
+    if (_records[index] == NULL) { // just the report
+      _bodies[index](message); // the message itself
+      message.print(F(MESSAGE_FOOTER));
+    }
+    else { // the report followed by its record
+      _bodies[index](message);
+      message.print(F(MESSAGE_FOOTER));
+      message.print(F(RECORD_PART_HEADER));
+      {
+        Base64Writer record(message); // encoded on the way into the socket, nothing is held in memory
+        _records[index](record);
+      }
+      message.print(F(MULTIPART_END));
+    }
+
+    if (last && (_capabilities & CAP_PIPELINING)) { // QUIT may ride along with the end of the message
+      LOG_DEBUG(SMTP_EOM);
+      message.print(F(SMTP_TERMINATE_CHAR CRLF QUIT_CMD CRLF));
+      message.flush();
+      f_QuitSent = true;
+      expectResponse(RESP_ACTION_OKAY, EOM_CMD, true);
+      f_Delivered = f_EmailSuccessful;
+      expectResponse(RESP_CLOSE, QUIT_CMD, true);
+    }
+    else {
+      message.flush();
+      LOG_DEBUG(SMTP_EOM);
+      sendCmd(SMTP_TERMINATE_CHAR, RESP_ACTION_OKAY, EOM_CMD, true); // send terminating character to end message
+      f_Delivered = f_EmailSuccessful;
+    }
+  }
+  else if (!last && f_EmailSuccessful) { // nobody took this one, clear the transaction for the next
+    LOG_DEBUG(SMTP_RSET);
+    sendCmd(RSET_CMD, RESP_ACTION_OKAY, RSET_CMD);
+  }
+
+  for (uint8_t i = 0; i < _recipientCount; i++) {
+    if (!(accepted[i] && f_Delivered)) {
+      _recipientDelivered[i] = false;
+    }
+  }
+
+  if (f_Delivered) {
+    return MESSAGE_DELIVERED;
   }
-  else { // otherwise... output error and return false
-    Serial.println(SMTP_CONNECT_FAILED_MSG);
+  return (f_EmailSuccessful && !f_AnyAccepted && !f_RetryLater) ? MESSAGE_REFUSED : MESSAGE_DEFERRED;
+}
+
+/* Reads the reply to a recipient's RCPT TO command, a refusal only fails that recipient */
+// A 4xx refusal (mailbox busy, greylisting) is noted so the message is kept for another attempt
+bool SMTP::expectRecipient(uint8_t index) {
+  if (!f_EmailSuccessful) {
     return false;
   }
+
+  int responseCode = readResponse();
+  if (responseCode == RESP_ACTION_OKAY || responseCode == RESP_WILL_FORWARD) {
+    return true;
+  }
+
+  if (responseCode == RESP_NO_RESPONSE || responseCode == RESP_MALFORMED) { // the session itself is in trouble
+    snprintf(_emailStatusMsg, sizeof(_emailStatusMsg), INVAL_RCPT_RESP_TEMPLATE, RESP_ACTION_OKAY, _recipients[index].c_str());
+    LOG_ERROR(SMTP_UNEXPECTED_REPLY, responseCode);
+    f_EmailSuccessful = false;
+  }
+  else {
+    LOG_WARN(SMTP_RCPT_REFUSED, index);
+    f_RetryLater = f_RetryLater || (responseCode >= RESP_TRANSIENT_MIN && responseCode <= RESP_TRANSIENT_MAX);
+  }
+  return false;
+}
+
+/* Emails a report, using its subject and HTML body, with its record attached */
+bool SMTP::sendReport(const ReportContent& report) {
+  clearMessages();
+  queueMessage(report.subject, report.writeBody, report.writeRecord);
+  return sendQueued();
+}
+
+/* Getter method to return whether the last session failed only because every recipient refused for good */
+bool SMTP::isPermanentFailure() {
+  return f_PermanentFailure;
+}
+
+/* Opens the SSL socket to the SMTP server, reusing the cached address and TLS session where possible */
+// With a cached session the server can agree to an abbreviated handshake, which skips the expensive
+// key exchange; a server that has forgotten the session just falls back to a full handshake.
+bool SMTP::connectServer() {
+  ProfileTimer timer(PHASE_TLS);
+  SMTPCache cache;
+  IPAddress serverAddr;
+  bool connected = false;
+
+  if (timeLeft(_connectBy) == 0) {
+    LOG_ERROR(SMTP_DEADLINE);
+    return false;
+  }
+
+  uint32_t serverId = RTCStore::crc32(&_port, sizeof(_port), RTCStore::crc32(_server, strlen(_server)));
+
+  if (RTCStore::load(RTC_SMTP_CACHE_SLOT, &cache, sizeof(cache)) && cache.serverId == serverId) {
+    memcpy((void*)&_tlsSession, cache.session, sizeof(_tlsSession)); // resume the last session
+  }
+  else { // nothing cached, or it belongs to a different server
+    memset(&cache, 0, sizeof(cache));
+    cache.serverId = serverId;
+  }
+
+  if (_secure) {
+    _client = &_smtpClient;
+    _smtpClient.setInsecure(); // the server certificate is not verified (as with the previous axTLS client)
+    _smtpClient.setSession(&_tlsSession); // offer the cached session, and have the client update it after the handshake
+  }
+  else {
+    _client = &_plainClient;
+  }
+  _client->setTimeout(min(timeLeft(_connectBy), (unsigned long)DEFAULT_CONNECT_TIMEOUT)); // bounds the TCP connect and TLS handshake
+
+  // Skip the DNS lookup while the cached address is still fresh
+  if (cache.serverAddr != 0 && (int32_t)(cache.addrExpires - WakeClock::now()) > 0) {
+    connected = _client->connect(IPAddress(cache.serverAddr), _port);
+    if (!connected) { // server may have moved, look it up again
+      LOG_WARN(SMTP_CACHED_ADDR_FAILED);
+      cache.serverAddr = 0;
+    }
+  }
+
+  if (!connected && WiFi.hostByName(_server, serverAddr, min(timeLeft(_connectBy), (unsigned long)DEFAULT_LOOKUP_TIMEOUT))) {
+    _client->setTimeout(min(timeLeft(_connectBy), (unsigned long)DEFAULT_CONNECT_TIMEOUT));
+    connected = _client->connect(serverAddr, _port);
+    if (connected) {
+      cache.serverAddr = (uint32_t)serverAddr;
+      cache.addrExpires = WakeClock::now() + DNS_CACHE_TTL;
+    }
+  }
+
+  if (!connected) { // don't offer a session that may be what's being refused
+    _tlsSession = BearSSL::Session();
+  }
+
+  memcpy(cache.session, (const void*)&_tlsSession, sizeof(cache.session));
+  RTCStore::save(RTC_SMTP_CACHE_SLOT, &cache, sizeof(cache));
+
+  if (connected) { // server greets us once the socket is open
+    _client->setTimeout(min(timeLeft(_doneBy), (unsigned long)DEFAULT_CONNECT_TIMEOUT)); // writes can't hold the session past its deadline either
+    commandSent();
+  }
+
+  return connected;
 }
 
 /* Getter method to return timeout for connecting to SMTP server */
@@ -157,10 +482,73 @@ int SMTP::getTimeout() {
   return _timeout;
 }
 
+/* Setter method to bound the next sessions, connecting must be done by connectBy and everything by doneBy */
+void SMTP::updateDeadline(unsigned long connectBy, unsigned long doneBy) {
+  _connectBy = connectBy;
+  _doneBy = doneBy;
+}
+
+/* Getter method to return the status message of the last session */
+const char* SMTP::getStatusMessage() {
+  return _emailStatusMsg;
+}
+
 /* Setter method to update recipient email address */
 // SHOULD ADD SOME WAY TO VERIFY VALID EMAIL FORMAT
 void SMTP::updateRecipientAddr(String newAddr) {
-  _recipientAddr = newAddr;
+  clearRecipients();
+  addRecipient(newAddr);
+}
+
+/* Adds another address every message is sent to */
+bool SMTP::addRecipient(String addr) {
+  if (_recipientCount >= SMTP_MAX_RECIPIENTS) {
+    return false;
+  }
+  _recipients[_recipientCount] = addr;
+  _recipientDelivered[_recipientCount] = false; // nothing sent to it yet
+  _recipientCount++;
+  return true;
+}
+
+/* Removes every recipient address */
+void SMTP::clearRecipients() {
+  _recipientCount = 0;
+}
+
+/* Getter method to return the number of recipient addresses */
+uint8_t SMTP::getRecipientCount() {
+  return _recipientCount;
+}
+
+/* Getter method to return whether every message of the last session reached the recipient at index */
+bool SMTP::getRecipientStatus(uint8_t index) {
+  return (index < _recipientCount) && _recipientDelivered[index];
+}
+
+/* Getter method to return the number of messages waiting for the next session */
+uint8_t SMTP::getQueuedCount() {
+  return _messageCount;
+}
+
+/* Drops every queued message */
+void SMTP::clearMessages() {
+  _messageCount = 0;
+}
+
+/* Setter method to send through a different server */
+// A collector on the local network can take plain SMTP from every node and forward one digest upstream,
+// which saves each node the TLS handshake and keeps the mail account's credentials off the nodes
+void SMTP::updateServer(const char* server, uint16_t port, bool secure) {
+  _server = server;
+  _port = port;
+  _secure = secure;
+}
+
+/* Setter method to update the base64 encoded login, NULL skips authentication */
+void SMTP::updateCredentials(const char* b64Username, const char* b64Password) {
+  _b64Username = b64Username;
+  _b64Password = b64Password;
 }
 
 /* Setter method to update timeout for connecting to SMTP server */
@@ -176,44 +564,246 @@ void SMTP::updateTimeout(int newTimeout) {
 }
 
 /* Issues SMTP command and checks the response if sending email hasn't already failed */
-void SMTP::sendCmd(String command, int expectedResponse, String cmdFriendlyName) {
+void SMTP::sendCmd(const char* command, int expectedResponse, const char* cmdFriendlyName, bool slow) {
   if (f_EmailSuccessful) { // if we haven't failed yet...
-    _smtpClient.println(command); // issue the specified command
-    if (readResponse() != expectedResponse) { // if the response code is not the expected one...
-        _emailStatusMsg = genInvalResponse(cmdFriendlyName, expectedResponse); // update status message
-        f_EmailSuccessful = false; // set the success flag to false
+    {
+      ReportWriter line(*_client); // command and CRLF go out in one write
+      line.print(command); // issue the specified command
+      line.print(F(CRLF));
+    }
+    commandSent();
+    expectResponse(expectedResponse, cmdFriendlyName, slow); // and validate whatever comes back
+  }
+}
+
+/* Writes MAIL FROM, the RCPT TO of every recipient and DATA to the server together (pipelining) */
+// They are collected in the writer's buffer, so a short envelope is a single write
+void SMTP::sendEnvelope() {
+  if (f_EmailSuccessful) { // if we haven't failed yet...
+    {
+      ReportWriter envelope(*_client);
+      envelope.print(F(MAIL_FROM_CMD CRLF));
+      for (uint8_t i = 0; i < _recipientCount; i++) {
+        writeRecipient(envelope, i);
       }
+      envelope.print(F(DATA_CMD CRLF));
+    }
+    commandSent();
   }
 }
 
-/* Reads entire response returned by the server. Returns the response code to the caller. */
-int SMTP::readResponse() {
-  String response = "";
-  int i = 0;
-  
-  delay(_timeout); // wait specified amount of time for a response
+/* Writes the RCPT TO command for the recipient at index */
+void SMTP::writeRecipient(ReportWriter& out, uint8_t index) {
+  out.printTemplate(PSTR(RCPT_TO_TEMPLATE), _recipients[index].c_str());
+}
 
-  while(_smtpClient.available()) { // while there is something to read...
-      char c = _smtpClient.read(); // read the character...
-      Serial.print(c); // output the character...
+/* Writes the header of a queued message, every recipient listed in its To line */
+void SMTP::writeHeader(ReportWriter& out, uint8_t index) {
+  out.printTemplate(PSTR(MESSAGE_START_TEMPLATE), _subjects[index]);
+  for (uint8_t i = 0; i < _recipientCount; i++) {
+    if (i > 0) {
+      out.print(F(MESSAGE_RECIPIENT_SEPARATOR));
+    }
+    out.print(_recipients[i].c_str());
+  }
+  out.print((_records[index] == NULL) ? F(MESSAGE_HEADER) : F(MULTIPART_HEADER)); // multipart when a record goes with the report
+}
 
-      if(i < 3) { // first 3 characters are the first response code
-        response += c;
-        i++;
+/* Greets the server with EHLO to learn its extensions, falling back to HELO for servers that don't speak ESMTP */
+void SMTP::sendEhlo() {
+  _capabilities = 0; // nothing is assumed until the server advertises it
+
+  if (f_EmailSuccessful) { // if we haven't failed yet...
+    _client->println(EHLO_CMD);
+    commandSent();
+    if (readResponse(true) != RESP_ACTION_OKAY) { // server didn't accept EHLO...
+      _capabilities = 0;
+      LOG_DEBUG(SMTP_HELO);
+      sendCmd(HELO_CMD, RESP_ACTION_OKAY, HELO_CMD); // so use the plain SMTP greeting
+    }
+  }
+}
+
+/* Records any extension we can use from a single line of the EHLO response */
+void SMTP::parseCapability(const char* line) {
+  if (strcmp(line, CAP_PIPELINING_KEYWORD) == 0) {
+    _capabilities |= CAP_PIPELINING;
+  }
+  else if (strncmp(line, CAP_AUTH_KEYWORD, strlen(CAP_AUTH_KEYWORD)) == 0) {
+    // mechanisms are a space separated list, e.g. "AUTH LOGIN PLAIN XOAUTH2"
+    const char* mech = line + strlen(CAP_AUTH_KEYWORD);
+    size_t len = strlen(CAP_AUTH_PLAIN_KEYWORD);
+    while ((mech = strstr(mech, CAP_AUTH_PLAIN_KEYWORD)) != NULL) {
+      if ((mech[-1] == ' ') && (mech[len] == ' ' || mech[len] == '\0')) {
+        _capabilities |= CAP_AUTH_PLAIN;
+        break;
       }
+      mech += len;
+    }
+  }
+}
+
+/* Returns the ms left before a millis() deadline, which is unlimited for NO_DEADLINE */
+unsigned long SMTP::timeLeft(unsigned long deadline) {
+  return (deadline == NO_DEADLINE) ? ULONG_MAX : Hal::timeUntil(deadline);
+}
+
+/* Notes when a command went out, so the time to its response can be measured */
+void SMTP::commandSent() {
+  _sentAt = Hal::millis();
+  f_RTTPending = true;
+}
+
+/* Authenticates with the AUTH PLAIN command built from the configured base64 username and password */
+// AUTH PLAIN takes base64("\0" + username + "\0" + password) as its single argument, which is encoded on its
+// way into the socket
+void SMTP::sendAuthPlain() {
+  uint8_t plain[AUTH_PLAIN_BUFFER_SIZE]; // raw bytes, with the NUL separators
+  size_t len = 0;
+
+  if (!f_EmailSuccessful) { // if we have already failed...
+    return;
+  }
+
+  plain[len++] = '\0'; // no separate authorization identity
+  len += b64Decode(_b64Username, plain + len, sizeof(plain) - len);
+  if (len < sizeof(plain)) {
+    plain[len++] = '\0';
+  }
+  len += b64Decode(_b64Password, plain + len, sizeof(plain) - len);
+
+  {
+    ReportWriter command(*_client);
+    command.print(F(AUTH_PLAIN_CMD " "));
+    Base64Writer argument(command, BASE64_SINGLE_LINE);
+    argument.write(plain, len);
+    argument.finish(); // ending the encoded line ends the command
+  }
+  commandSent();
+  expectResponse(RESP_AUTHENTICATED, AUTH_PLAIN_CMD);
+}
+
+/* Reads the next response and checks its code if sending email hasn't already failed */
+void SMTP::expectResponse(int expectedResponse, const char* cmdFriendlyName, bool slow) {
+  if (f_EmailSuccessful) { // if we haven't failed yet...
+    int responseCode = readResponse(false, slow);
+    if (responseCode != expectedResponse) { // if the response code is not the expected one...
+      setInvalResponse(cmdFriendlyName, expectedResponse); // update status message
+      LOG_ERROR(SMTP_UNEXPECTED_REPLY, responseCode);
+      f_EmailSuccessful = false; // set the success flag to false
+    }
+  }
+}
+
+/* Reads one complete response from the server. Returns the response code to the caller. */
+// A response is one or more CRLF terminated lines of the form "250-text" (more lines follow) or "250 text" (last line).
+// Returns as soon as the last line arrives rather than sleeping, and gives up at a deadline derived from the
+// measured round trip time (capped at _timeout ms). Slow responses wait on the server's own work rather than the
+// network, so they get the whole _timeout, aren't measured, and a miss doesn't back the estimate off. All are
+// cut short by the session deadline (_doneBy). The first response after a command is timed to refine the
+// estimate, later ones to the same write (pipelining) were already on their way.
+// When parseCapabilities is set, the text of each line is checked for ESMTP extensions (EHLO response).
+int SMTP::readResponse(bool parseCapabilities, bool slow) {
+  char code[4] = { 0 }; // reply code of the line currently being read
+  char text[RESP_LINE_BUFFER_SIZE]; // text following the reply code on the current line
+  int textLen = 0;
+  int linePos = 0; // number of characters read so far on the current line
+  bool f_LastLine = true; // whether the current line is the final line of the response
+  bool f_Received = false; // whether any part of a response has been seen
+  unsigned long start = Hal::millis();
+  unsigned long rttDeadline = slow ? (unsigned long)_timeout : min(RTTEstimator::getTimeout(), (unsigned long)_timeout);
+  unsigned long deadline = min(rttDeadline, timeLeft(_doneBy));
+  bool f_Measure = f_RTTPending && !slow;
+  ProfileTimer timer(PHASE_REPLY);
+
+  f_RTTPending = false;
+
+  while ((Hal::millis() - start) < deadline) { // until the deadline passes...
+    if (!_client->available()) { // nothing buffered yet...
+      if (!_client->connected()) { // server hung up so nothing more is coming
+        break;
+      }
+      Hal::yield(); // let the WiFi stack run while we wait
+      continue;
+    }
+
+    char c = _client->read(); // read the character...
+    f_Received = true;
+
+    if (c == '\n') { // end of a line...
+      if (parseCapabilities) {
+        text[textLen] = '\0';
+        parseCapability(text);
+      }
+      textLen = 0;
+      if (f_LastLine && linePos >= 3) { // last line of the response is complete
+        if (f_Measure) {
+          RTTEstimator::addSample(Hal::millis() - _sentAt);
+        }
+        // return response code converted to int or 0 if no valid response string in first 3 characters
+        int responseCode = atoi(code);
+        LOG_DEBUG(SMTP_REPLY, responseCode);
+        return responseCode;
+      }
+      linePos = 0; // otherwise start on the next continuation line
+      f_LastLine = true;
+      continue;
+    }
+
+    if (linePos < 3) { // first 3 characters are the response code
+      code[linePos] = c;
+    }
+    else if (linePos == 3) { // 4th character tells us whether more lines follow
+      f_LastLine = (c != '-');
+    }
+    else if (c != '\r' && textLen < (RESP_LINE_BUFFER_SIZE - 1)) { // the rest is the line's text
+      text[textLen++] = c;
+    }
+    linePos++;
+  }
+
+  if (!f_Received) { // return -1 if response not received before timeout
+    if (!slow && _client->connected() && deadline == rttDeadline) { // server is still there, so allow it longer next time
+      RTTEstimator::backOff();
+    }
+    return RESP_NO_RESPONSE;
+  }
+
+  return RESP_MALFORMED; // partial or garbled response
+}
+
+/* Base64 decodes a string into a buffer, ignoring padding and any characters outside the alphabet */
+// Returns the number of bytes written, which never exceeds maxLen
+size_t SMTP::b64Decode(const char* input, uint8_t* output, size_t maxLen) {
+  size_t len = 0;
+  uint32_t group = 0;
+  int bits = 0;
+
+  for (; *input != '\0' && len < maxLen; input++) {
+    char c = *input;
+    int value;
+
+    if (c >= 'A' && c <= 'Z') value = c - 'A';
+    else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+    else if (c >= '0' && c <= '9') value = c - '0' + 52;
+    else if (c == '+') value = 62;
+    else if (c == '/') value = 63;
+    else continue;
+
+    group = (group << 6) | value; // accumulate 6 bits at a time...
+    bits += 6;
+    if (bits >= 8) { // and emit a byte whenever we have one
+      bits -= 8;
+      output[len++] = (uint8_t)((group >> bits) & 0xFF);
     }
-  
-  if (response == "") { // return -1 if response not received before timeout
-    return -1;
   }
 
-  // else... return response code converted to int or 0 if no valid response string in first 3 characters
-  return response.toInt();
+  return len;
 }
 
-/* Generates the invalid response string from response code expected and the command sent */
-String SMTP::genInvalResponse(String command, int responseCode) {
-  return (INVAL_RESP_1 + String(responseCode) + INVAL_RESP_2 + command + INVAL_RESP_3);
+/* Sets the status message from the response code expected and the command sent */
+void SMTP::setInvalResponse(const char* command, int responseCode) {
+  snprintf(_emailStatusMsg, sizeof(_emailStatusMsg), INVAL_RESP_TEMPLATE, responseCode, command);
 }
 
 // ©2017 Jeremy Maxey-Vesperman
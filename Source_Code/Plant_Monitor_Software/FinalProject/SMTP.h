@@ -9,31 +9,95 @@
 // Include the necessary libraries
 #include "Arduino.h"
 #include <ESP8266WiFi.h>
+#include "Hal.h"
+#include "Transport.h"
+#include "ReportWriter.h"
+
+#define SMTP_MAX_RECIPIENTS 4 // addresses each message is sent to
+#define SMTP_MAX_MESSAGES 3 // messages that can wait for the next session
+#define SMTP_STATUS_MSG_SIZE 96 // longest status message kept, longer ones are cut short
+
+/* What became of a queued message in a session */
+enum MessageOutcome {
+	MESSAGE_DELIVERED, // the server queued it for at least one recipient
+	MESSAGE_REFUSED, // every recipient was refused for good (5xx), sending it again can't help
+	MESSAGE_DEFERRED // a recipient was refused for now (4xx) or the session failed, worth another attempt
+};
 
 /* SMTP class definition */
-class SMTP {
+class SMTP : public Transport {
 	public:
 		/* Constructors */
 		SMTP(); // default constructor inits to default timeout and recipient address
 		SMTP(String recipientAddr); // constructor that inits to different recipient address
 		
 		/* Public Functions and Methods */
-		bool sendUpdateEmail(String subject, String body); // function for sending update email
-		int getTimeout(); // function for getting the current timeout setting
-		void updateRecipientAddr(String newAddr); // method for updating the recipient address
-		void updateTimeout(int newTimeout); // method for updating the timeout
+		bool sendUpdateEmail(PGM_P subject, MessageBodyWriter writeBody); // function for sending update email
+		bool queueMessage(PGM_P subject, MessageBodyWriter writeBody, MessageBodyWriter writeRecord=NULL); // function for queueing a message (with an optional binary record attached) for the next session, returns false if the queue is full
+		bool sendQueued(); // function for delivering every queued message over a single connection, true if they all got out
+		uint8_t getQueuedCount(); // function for getting the number of messages still waiting to be delivered (worth another attempt)
+		void clearMessages(); // method for dropping every queued message
+		bool sendReport(const ReportContent& report) override; // function for emailing the report's HTML body with its CBOR record attached
+		bool isPermanentFailure() override; // function for checking whether the last session dropped messages every recipient refused for good, with nothing left to retry
+		int getTimeout() override; // function for getting the longest response deadline (ms)
+		void updateRecipientAddr(String newAddr); // method for replacing every recipient with a single address
+		bool addRecipient(String addr); // function for adding a recipient address, returns false if the list is full
+		void clearRecipients(); // method for removing every recipient address
+		uint8_t getRecipientCount(); // function for getting the number of recipient addresses
+		bool getRecipientStatus(uint8_t index); // function for getting whether every message of the last session reached a recipient
+		void updateTimeout(int newTimeout) override; // method for updating the longest response deadline (ms)
+		void updateDeadline(unsigned long connectBy, unsigned long doneBy) override; // method for setting when connecting and the whole session must be over
+		void updateServer(const char* server, uint16_t port, bool secure); // method for sending through a different server (e.g. a collector on the LAN)
+		void updateCredentials(const char* b64Username, const char* b64Password); // method for updating the base64 login, NULL to skip authentication
+		const char* getStatusMessage(); // function for getting what went wrong in the last session (or that it succeeded)
 	private:
 		/* Private Instance Variables */
-		WiFiClientSecure _smtpClient; // secure TCP client object
-		int _timeout; // how long to wait for a server response
-		String _recipientAddr; // email address of the recipient
-		String _emailStatusMsg; // output status message
-		bool f_EmailSuccessful; // output status flag
+		Hal::SecureClient _smtpClient; // secure TCP client object
+		Hal::PlainClient _plainClient; // TCP client object for servers without TLS
+		Hal::PlainClient* _client; // whichever of the two the current session uses
+		const char* _server; // name of the SMTP server
+		uint16_t _port; // port of the SMTP server
+		bool _secure; // whether the server expects TLS from the start (SMTPS)
+		const char* _b64Username; // base64 encoded login, NULL if the server doesn't need one
+		const char* _b64Password; // base64 encoded password
+		BearSSL::Session _tlsSession; // TLS session parameters, kept so the next handshake can resume
+		int _timeout; // longest deadline (ms) for a complete server response, RTTEstimator sets the actual one
+		unsigned long _sentAt; // millis() when the last command was written
+		unsigned long _connectBy; // millis() by which the connection must be open (NO_DEADLINE = none)
+		unsigned long _doneBy; // millis() by which the session must be over (NO_DEADLINE = none)
+		bool f_RTTPending; // whether the time to the next response is a round trip worth measuring
+		String _recipients[SMTP_MAX_RECIPIENTS]; // email addresses of the recipients
+		bool _recipientDelivered[SMTP_MAX_RECIPIENTS]; // whether every message of the last session reached each recipient
+		uint8_t _recipientCount; // number of recipient addresses
+		PGM_P _subjects[SMTP_MAX_MESSAGES]; // subject lines of the queued messages
+		MessageBodyWriter _bodies[SMTP_MAX_MESSAGES]; // body writers of the queued messages
+		MessageBodyWriter _records[SMTP_MAX_MESSAGES]; // writers of the records attached to the queued messages (NULL = none)
+		uint8_t _messageCount; // number of queued messages
+		char _emailStatusMsg[SMTP_STATUS_MSG_SIZE]; // output status message
+		bool f_EmailSuccessful; // output status flag, cleared once the session can't go on
+		bool f_QuitSent; // whether QUIT already went out along with the last message
+		bool f_RetryLater; // whether a recipient of the current message was refused for now (4xx) rather than for good
+		bool f_PermanentFailure; // whether the last session dropped a refused message and left nothing to retry
+		uint8_t _capabilities; // ESMTP extensions advertised by the server this session
 	
 		/* Private Functions and Methods */
-		void sendCmd(String command, int expectedResponse, String cmdFriendlyName); // method for sending commands and validating response codes
-		int readResponse(); // function for reading server responses
-		String genInvalResponse(String command, int responseCode); // function for generating an invalid server response error message
+		bool connectServer(); // function for opening the secure connection to the server
+		void login(); // method for greeting the server and authenticating once the connection is open
+		MessageOutcome sendMessage(uint8_t index, bool last); // function for delivering one queued message as its own mail transaction
+		bool expectRecipient(uint8_t index); // function for checking whether the server accepted a recipient
+		void sendCmd(const char* command, int expectedResponse, const char* cmdFriendlyName, bool slow=false); // method for sending commands and validating response codes
+		void sendEnvelope(); // method for writing MAIL FROM, every RCPT TO and DATA to the server at once
+		void writeRecipient(ReportWriter& out, uint8_t index); // method for writing the RCPT TO command of a recipient
+		void writeHeader(ReportWriter& out, uint8_t index); // method for writing the From, Subject, To and MIME lines of a queued message
+		void sendEhlo(); // method for negotiating ESMTP extensions with the server
+		void sendAuthPlain(); // method for authenticating with the single-step AUTH PLAIN command
+		void parseCapability(const char* line); // method for recording an extension advertised in the EHLO response
+		void expectResponse(int expectedResponse, const char* cmdFriendlyName, bool slow=false); // method for validating a response without sending a command
+		int readResponse(bool parseCapabilities=false, bool slow=false); // function for reading server responses
+		void commandSent(); // method for noting that the server now owes us a response
+		static unsigned long timeLeft(unsigned long deadline); // function to get the ms left before a deadline
+		static size_t b64Decode(const char* input, uint8_t* output, size_t maxLen); // function for base64 decoding a string into a buffer
+		void setInvalResponse(const char* command, int responseCode); // method for setting the status message for an invalid server response
 };
 
 #endif
@@ -0,0 +1,115 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "SampleBuffer.h"
+#include "RTCStore.h"
+#include "WakeClock.h"
+
+/* Variables */
+// Everything that is persisted in RTC memory between wakes
+struct SampleBufferState {
+  uint8_t head; // index the next reading will be written to
+  uint8_t count; // number of valid readings
+  uint8_t backlog; // whether readings may be waiting in the SampleLog (set while that isn't known)
+  uint8_t reserved; // keeps lastTime aligned
+  uint32_t lastTime; // WakeClock time of the newest reading
+  SampleRecord records[SAMPLE_BUFFER_CAPACITY];
+};
+
+static_assert(RTCStore::blocksFor(sizeof(SampleBufferState)) <= RTC_SAMPLE_BUFFER_BLOCKS, "SampleBuffer does not fit its RTC slot");
+static_assert(SAMPLE_BUFFER_CAPACITY <= UINT8_MAX, "head and count are kept in a byte");
+
+static SampleBufferState _state;
+
+/* Functions */
+
+// Function to restore the buffer from RTC memory
+// A CRC mismatch (first power up, brown-out, flashing) means the contents can't be trusted, so start empty
+// (and assume there is a backlog, the flash kept whatever was spilled before)
+bool SampleBuffer::begin() {
+  if (RTCStore::load(RTC_SAMPLE_BUFFER_SLOT, &_state, sizeof(_state)) &&
+      _state.head < SAMPLE_BUFFER_CAPACITY && _state.count <= SAMPLE_BUFFER_CAPACITY) {
+    return true;
+  }
+
+  memset(&_state, 0, sizeof(_state));
+  _state.backlog = true;
+  save();
+  return false;
+}
+
+// Method to add a set of readings, overwriting the oldest when the buffer is full
+void SampleBuffer::append(const float* sensors) {
+  uint32_t now = WakeClock::now();
+
+  NodeSensors::pack(sensors, _state.records[_state.head].values);
+  _state.records[_state.head].interval = (_state.count > 0) ? (uint16_t)min(now - _state.lastTime, (uint32_t)0xFFFF) : 0;
+  _state.lastTime = now;
+  _state.head = (_state.head + 1) % SAMPLE_BUFFER_CAPACITY;
+
+  if (_state.count < SAMPLE_BUFFER_CAPACITY) {
+    _state.count++;
+  }
+
+  save();
+}
+
+// Method to get a set of readings back, index 0 being the oldest held
+void SampleBuffer::getSample(int index, float* sensors) {
+  int oldest = (_state.head + SAMPLE_BUFFER_CAPACITY - _state.count) % SAMPLE_BUFFER_CAPACITY;
+
+  NodeSensors::unpack(_state.records[(oldest + index) % SAMPLE_BUFFER_CAPACITY].values, sensors);
+}
+
+// Function to get how many seconds a reading was taken before the newest, by adding up the intervals after it
+uint32_t SampleBuffer::getSampleAge(int index) {
+  int oldest = (_state.head + SAMPLE_BUFFER_CAPACITY - _state.count) % SAMPLE_BUFFER_CAPACITY;
+  uint32_t age = 0;
+
+  for (int i = index + 1; i < _state.count; i++) {
+    age += _state.records[(oldest + i) % SAMPLE_BUFFER_CAPACITY].interval;
+  }
+
+  return age;
+}
+
+// Function to get the number of readings held
+int SampleBuffer::getCount() {
+  return _state.count;
+}
+
+// Function to check whether the next append will overwrite a reading
+bool SampleBuffer::isFull() {
+  return (_state.count >= SAMPLE_BUFFER_CAPACITY);
+}
+
+// Function to check whether readings may be waiting in the SampleLog, so wakes without a backlog never mount the flash
+bool SampleBuffer::hasBacklog() {
+  return _state.backlog;
+}
+
+// Method to record whether readings are waiting in the SampleLog
+void SampleBuffer::setBacklog(bool f_Backlog) {
+  if (_state.backlog != f_Backlog) {
+    _state.backlog = f_Backlog;
+    save();
+  }
+}
+
+// Method to discard all readings (the backlog flag is left alone)
+void SampleBuffer::clear() {
+  _state.head = 0;
+  _state.count = 0;
+  save();
+}
+
+// Method to write the buffer back to RTC memory
+void SampleBuffer::save() {
+  RTCStore::save(RTC_SAMPLE_BUFFER_SLOT, &_state, sizeof(_state));
+}
+
+// ©2017 Jeremy Maxey-Vesperman
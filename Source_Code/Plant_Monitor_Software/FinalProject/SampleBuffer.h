@@ -0,0 +1,46 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SampleBuffer_h
+#define SampleBuffer_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include "SensorRegistry.h"
+
+/* Definitions */
+#define SAMPLE_BUFFER_BYTES 120 // RTC memory given to readings, the number of records depends on how many sensors there are (12 of the stock 4)
+#define SAMPLE_SENSOR_COUNT NodeSensors::count // readings per record, in NodeSensors order
+#define SAMPLE_BUFFER_CAPACITY (SAMPLE_BUFFER_BYTES / sizeof(SampleRecord)) // number of records kept across deep sleep
+
+/* Compact form of one set of readings, each packed to 16 bits as declared by its sensor type */
+struct SampleRecord {
+	int16_t values[SAMPLE_SENSOR_COUNT];
+	uint16_t interval; // seconds since the reading before it (readings are no longer evenly spaced, see ReportPolicy)
+};
+
+/* SampleBuffer class definition */
+// Ring buffer of readings kept in RTC memory so several wakes can be reported in one email, along with whether
+// the SampleLog in flash holds readings too (only wakes with a backlog pay for mounting the file system)
+class SampleBuffer {
+	public:
+		/* Public Functions and Methods */
+		static bool begin(); // function to restore the buffer from RTC memory, returns false if it had to be reset
+		static void append(const float* sensors); // method to add a set of readings, overwriting the oldest when full
+		static void getSample(int index, float* sensors); // method to get a set of readings back (0 = oldest)
+		static uint32_t getSampleAge(int index); // function to get how many seconds a reading was taken before the newest
+		static int getCount(); // function to get the number of readings held
+		static bool isFull(); // function to check whether the next append will overwrite a reading
+		static bool hasBacklog(); // function to check whether readings may be waiting in the SampleLog
+		static void setBacklog(bool f_Backlog); // method to record whether readings are waiting in the SampleLog
+		static void clear(); // method to discard all readings (after they have been reported)
+	private:
+		/* Private Functions and Methods */
+		static void save(); // method to write the buffer back to RTC memory
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,236 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "SampleLog.h"
+#include "SampleBuffer.h"
+#include "WakeClock.h"
+#include "EventLog.h"
+#include "Varint.h"
+#include <LittleFS.h>
+
+/* Definitions */
+#define LOG_DIR "/log"
+#define LOG_PATH_SIZE 16 // "/log/" plus an 8 digit sequence number
+#define LOG_RECORD_MAX (VARINT_MAX_BYTES * (1 + SAMPLE_SENSOR_COUNT)) // longest encoded record, every varint at its worst case
+
+/* Variables */
+static bool _mounted = false; // whether the filesystem has been mounted this wake
+static uint32_t _firstSegment; // sequence number of the oldest segment
+static uint32_t _nextSegment; // sequence number the next new segment gets (_firstSegment when there are none)
+static uint32_t _lastTime; // time of the last record in the newest segment, the base for the next delta
+static int16_t _lastValues[SAMPLE_SENSOR_COUNT]; // packed readings of that record
+static bool _deltasKnown = false; // whether _lastTime and _lastValues have been read back from the newest segment
+static bool _newestFull = false; // whether the newest segment has reached LOG_SEGMENT_BYTES
+
+// Read cursor
+static uint32_t _readSegment; // segment being read
+static uint32_t _readEnd; // sequence number after the last segment to read
+static uint32_t _uploadEnd; // sequence number after the last segment covered by rewind()
+static uint8_t _readBuffer[LOG_SEGMENT_BYTES + LOG_RECORD_MAX]; // current segment (never grows much past LOG_SEGMENT_BYTES)
+static size_t _readSize; // bytes in the buffer
+static size_t _readPos; // position of the next record in the buffer
+static uint32_t _readTime; // delta bases while reading
+static int16_t _readValues[SAMPLE_SENSOR_COUNT];
+
+/* Functions */
+
+// Function to add a record, starting a new segment once the newest is full
+bool SampleLog::append(uint32_t time, const float* sensors) {
+  char path[LOG_PATH_SIZE];
+  uint8_t record[LOG_RECORD_MAX];
+  int16_t values[SAMPLE_SENSOR_COUNT];
+  size_t len = 0;
+
+  if (!mount()) {
+    return false;
+  }
+  SampleBuffer::setBacklog(true); // before the write, so a reset part way through still finds the segment
+
+  // Continue the newest segment if it still has room, reading its last record back for the delta base
+  if (!_deltasKnown && _nextSegment != _firstSegment) {
+    _readSegment = _nextSegment - 1;
+    _readEnd = _nextSegment;
+    _readSize = 0;
+    _readPos = 0;
+    while (readNext(_lastTime, NULL)) { }
+    memcpy(_lastValues, _readValues, sizeof(_lastValues));
+    _deltasKnown = true;
+    _newestFull = (_readSize >= LOG_SEGMENT_BYTES);
+  }
+
+  if (_nextSegment == _firstSegment || _newestFull) { // no segment yet, or the newest is full
+    if ((_nextSegment - _firstSegment) >= LOG_MAX_SEGMENTS) { // make room by giving up the oldest readings
+      segmentPath(_firstSegment++, path);
+      LittleFS.remove(path);
+      LOG_WARN(SAMPLE_LOG_DROPPED);
+    }
+    _nextSegment++;
+    _lastTime = 0;
+    memset(_lastValues, 0, sizeof(_lastValues));
+    _deltasKnown = true;
+    _newestFull = false;
+  }
+
+  NodeSensors::pack(sensors, values);
+  len += Varint::put(record + len, (int32_t)(time - _lastTime));
+  for (int i = 0; i < SAMPLE_SENSOR_COUNT; i++) {
+    len += Varint::put(record + len, values[i] - _lastValues[i]);
+  }
+
+  segmentPath(_nextSegment - 1, path);
+  File segment = LittleFS.open(path, "a");
+  if (!segment) {
+    return false;
+  }
+  segment.write(record, len);
+  _newestFull = (segment.size() >= LOG_SEGMENT_BYTES); // full segments are left alone from here on
+  segment.close();
+
+  _lastTime = time;
+  memcpy(_lastValues, values, sizeof(_lastValues));
+  return true;
+}
+
+// Function to move every reading in the sample buffer into the log, emptying the buffer if they all made it
+bool SampleLog::spillSampleBuffer() {
+  float sensors[SAMPLE_SENSOR_COUNT];
+  uint32_t now = WakeClock::now();
+  int count = SampleBuffer::getCount();
+
+  for (int s = 0; s < count; s++) {
+    SampleBuffer::getSample(s, sensors);
+    if (!append(now - SampleBuffer::getSampleAge(s), sensors)) {
+      return false;
+    }
+  }
+
+  SampleBuffer::clear();
+  return true;
+}
+
+// Function to get the number of segments waiting to be uploaded
+int SampleLog::getSegmentCount() {
+  return (SampleBuffer::hasBacklog() && mount()) ? (int)(_nextSegment - _firstSegment) : 0;
+}
+
+// Method to start reading from the oldest record, over at most maxSegments segments
+// Without a backlog the flash isn't touched at all
+void SampleLog::rewind(int maxSegments) {
+  if (!SampleBuffer::hasBacklog() || !mount()) { // nothing to read
+    maxSegments = 0;
+  }
+
+  _readSegment = _firstSegment;
+  _readEnd = _firstSegment + min((uint32_t)maxSegments, _nextSegment - _firstSegment);
+  _uploadEnd = _readEnd;
+  _readSize = 0;
+  _readPos = 0;
+}
+
+// Function to read the next record, loading segments in turn; sensors may be NULL to only follow the deltas
+bool SampleLog::readNext(uint32_t& time, float* sensors) {
+  char path[LOG_PATH_SIZE];
+
+  while (_readPos >= _readSize) { // current segment used up...
+    if (_readSegment >= _readEnd) {
+      return false;
+    }
+
+    segmentPath(_readSegment++, path);
+    File segment = LittleFS.open(path, "r");
+    _readSize = segment ? segment.read(_readBuffer, sizeof(_readBuffer)) : 0;
+    segment.close();
+    _readPos = 0;
+    _readTime = 0; // each segment starts from a zero base
+    memset(_readValues, 0, sizeof(_readValues));
+  }
+
+  if (!decodeRecord(_readBuffer, _readSize, _readPos, _readTime, _readValues)) { // cut short (LittleFS makes this unlikely)
+    _readPos = _readSize;
+    return readNext(time, sensors);
+  }
+
+  time = _readTime;
+  if (sensors != NULL) {
+    NodeSensors::unpack(_readValues, sensors);
+  }
+  return true;
+}
+
+// Method to delete the segments covered by the last rewind, once they have been delivered
+void SampleLog::markUploaded() {
+  char path[LOG_PATH_SIZE];
+
+  if (!SampleBuffer::hasBacklog() || !mount()) {
+    return;
+  }
+
+  while (_firstSegment < _uploadEnd) { // an emptied log starts a new segment with the next record
+    segmentPath(_firstSegment++, path);
+    LittleFS.remove(path);
+  }
+  SampleBuffer::setBacklog(_firstSegment != _nextSegment);
+}
+
+// Function to mount the filesystem and find the oldest and newest segments, once per wake
+// Only wakes that spill or have a backlog to upload pay for this, normal wakes never touch the flash
+bool SampleLog::mount() {
+  if (_mounted) {
+    return true;
+  }
+
+  if (!LittleFS.begin()) {
+    LOG_ERROR(SAMPLE_LOG_FORMATTED);
+    if (!LittleFS.format() || !LittleFS.begin()) {
+      return false;
+    }
+  }
+
+  _firstSegment = UINT32_MAX;
+  _nextSegment = 0;
+
+  Dir dir = LittleFS.openDir(LOG_DIR);
+  while (dir.next()) {
+    uint32_t sequence = strtoul(dir.fileName().c_str(), NULL, 10);
+
+    _firstSegment = min(_firstSegment, sequence);
+    _nextSegment = max(_nextSegment, sequence + 1);
+  }
+
+  if (_firstSegment == UINT32_MAX) { // no segments, numbering starts over
+    _firstSegment = _nextSegment = 0;
+  }
+  SampleBuffer::setBacklog(_firstSegment != _nextSegment); // settles the flag left set by a power loss
+
+  _mounted = true;
+  return true;
+}
+
+// Method to build a segment's file name from its sequence number
+void SampleLog::segmentPath(uint32_t sequence, char* path) {
+  snprintf(path, LOG_PATH_SIZE, LOG_DIR "/%08lu", (unsigned long)sequence);
+}
+
+// Function to apply one record's deltas to the running time and values, which are left alone if the record is incomplete
+bool SampleLog::decodeRecord(const uint8_t* data, size_t size, size_t& pos, uint32_t& time, int16_t* values) {
+  int32_t deltas[1 + SAMPLE_SENSOR_COUNT];
+
+  for (int i = 0; i < (1 + SAMPLE_SENSOR_COUNT); i++) {
+    if (!Varint::get(data, size, pos, deltas[i])) {
+      return false;
+    }
+  }
+
+  time += deltas[0];
+  for (int i = 0; i < SAMPLE_SENSOR_COUNT; i++) {
+    values[i] += deltas[i + 1];
+  }
+
+  return true;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,40 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SampleLog_h
+#define SampleLog_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include "SensorRegistry.h"
+
+/* Definitions */
+#define LOG_SEGMENT_BYTES 192 // a segment is closed once it reaches this size (about 30 readings, one UDP report's worth)
+#define LOG_MAX_SEGMENTS 64 // oldest segment is dropped beyond this, bounding the flash used during a long outage
+
+/* SampleLog class definition */
+// Append-only log of readings on the flash filesystem, for readings that couldn't be delivered. Kept in small
+// segment files so the oldest can be uploaded and deleted a few at a time; LittleFS spreads the writes over
+// the flash. Each record is the WakeClock time and the readings packed as in the sample buffer, stored as
+// zig-zag varint deltas from the record before it (delta restarts at each segment), about 6 bytes a record.
+class SampleLog {
+	public:
+		/* Public Functions and Methods */
+		static bool append(uint32_t time, const float* sensors); // function to add a record, returns false if the filesystem isn't usable
+		static bool spillSampleBuffer(); // function to move every reading in the sample buffer into the log
+		static int getSegmentCount(); // function to get the number of segments waiting to be uploaded
+		static void rewind(int maxSegments); // method to start reading from the oldest record, over at most maxSegments segments
+		static bool readNext(uint32_t& time, float* sensors); // function to read the next record, returns false at the end
+		static void markUploaded(); // method to delete the segments covered by the last rewind (after they were delivered)
+	private:
+		/* Private Functions and Methods */
+		static bool mount(); // function to mount the filesystem and find the segments, once per wake
+		static void segmentPath(uint32_t sequence, char* path); // method to build a segment's file name
+		static bool decodeRecord(const uint8_t* data, size_t size, size_t& pos, uint32_t& time, int16_t* values); // function to apply one record's deltas
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
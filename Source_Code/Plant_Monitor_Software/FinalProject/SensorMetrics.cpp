@@ -6,13 +6,25 @@
 // Include necessary header files
 #include "Arduino.h"
 #include "SensorMetrics.h"
+#include "RTCStore.h"
+#include "ConstMath.h"
+#include "Hal.h"
 #include <SPI.h>
 #include <math.h>
 
 /* Definitions */
 
 // Delays
-#define SENSOR_STABILIZE_DELAY 500 // ms
+#define SENSOR_STABILIZE_DELAY 500 // longest we wait for sensor voltages to stabilize (ms)
+#define SETTLE_POLL_INTERVAL 5 // time between settling checks (ms)
+#define SETTLE_TOLERANCE 2 // largest change (ADC codes) between checks for a channel to count as settled
+#define SETTLE_STABLE_POLLS 3 // consecutive checks all channels must be within tolerance
+#define SETTLE_HISTORY_WEIGHT 8 // learned settle time moves 1/8 of the way towards each new observation
+
+// Conversions
+#define SENSOR_LOOKUP_TABLES 1 // convert external adc readings with the flash lookup tables (0 = calculate every time)
+#define ADC_INTERP_BITS 8 // fraction bits used when interpolating between table entries
+#define ADC_INTERP_ONE (1 << ADC_INTERP_BITS)
 
 // ADC reference info
 #define ADC_RESOLUTION 1024 // both adcs are 10-bit resolution
@@ -21,11 +33,11 @@
 
 // External ADC (MCP3008)
 #define EXTERN_ADC_SPI_FREQ 18000 // clock frequency for SPI comms with external adc
+#define EXTERN_ADC_CHANNELS 8 // MCP3008 has 8 channels
+#define BURST_DISCARD 1 // conversions thrown away after switching channel, clears what the last channel left on the sample cap
+#define BURST_TRIM_DIVISOR 4 // trimmed mean drops 1/4 of the samples from each end
 #define SENSOR_EN_PIN 4 // pin for powering the external adc chip and sensors
 #define SS_PIN 15 // Slave Select pin for external adc
-#define PHOTORESISTOR_CH 1 // channel of external adc that photoresistor is connected to
-#define THERMISTOR_CH 2 // channel of external adc that thermistor is connected to
-#define MOISTURE_SENSOR_CH 4 // channel of external adc that moisture sensor is connected to
 
 // Photoresistor info (WDYJ GM5539)
 #define PHOTORESISTOR_R2 9830 // photoresistor voltage divider circuit R2 value
@@ -55,44 +67,155 @@
 #define TEMP_F_CONST 459.67
 #define TEMP_C_CONST 273.15
 
-/* Constants */
+/* Lookup tables */
+// Every 10-bit code the external adc can return, converted ahead of time so a reading costs a flash read
+// instead of pow()/log() in soft-float. The tables are generated by the compiler from the constants above,
+// using the same maths as calcLux()/calcTempK() in double precision (ConstMath gives log and exp at compile time).
+#if SENSOR_LOOKUP_TABLES
+// Voltage at the adc pin for a code; the top code would put 0Ω across the divider, so it is taken half a code lower
+constexpr double tableVMeas(int adc) {
+  return (((adc < (ADC_RESOLUTION - 1)) ? adc : (adc - 0.5)) + 1.0) / ADC_RESOLUTION * EXTERN_ADC_V;
+}
+
+// R1 of a voltage divider for a code
+constexpr double tableVDivR1(int adc, double r2) {
+  return ((EXTERN_ADC_V * r2) - (tableVMeas(adc) * r2)) / tableVMeas(adc);
+}
+
+// Photoresistor curve, lux = R^m * 10^b
+struct LuxCurve {
+  static constexpr float at(int adc) {
+    return ConstMath::exp((PHOTORESISTOR_M * ConstMath::log(tableVDivR1(adc, PHOTORESISTOR_R2))) + (PHOTORESISTOR_B * ConstMath::log(10.0)));
+  }
+};
+
+// Thermistor Beta equation, 1/T = 1/T0 + ln(R/R0)/Beta (same as calcTempK() but with no special case at R0)
+struct TempKCurve {
+  static constexpr float at(int adc) {
+    return (THERMISTOR_T0 * THERMISTOR_BETA) / (THERMISTOR_BETA + (THERMISTOR_T0 * ConstMath::log(tableVDivR1(adc, THERMISTOR_R2) / THERMISTOR_R0)));
+  }
+};
+
+// Table of a curve evaluated at every adc code
+template <class Curve>
+struct ADCTable {
+  float values[ADC_RESOLUTION];
+
+  constexpr ADCTable() : values() {
+    for (int i = 0; i < ADC_RESOLUTION; i++) {
+      values[i] = Curve::at(i);
+    }
+  }
+};
+
+static constexpr ADCTable<LuxCurve> _LUX_TABLE PROGMEM = ADCTable<LuxCurve>();
+static constexpr ADCTable<TempKCurve> _TEMP_K_TABLE PROGMEM = ADCTable<TempKCurve>();
+#endif
 
-const int SensorMetrics::_SENSOR_DESCRIPTIONS_SIZE = 4;
-const String SensorMetrics::_SENSOR_DESCRIPTIONS[_SENSOR_DESCRIPTIONS_SIZE][2] = {	{"&emsp;&emsp;Light Intensity: ", " lux<br>"},
-											                                                              {"&emsp;&emsp;Temperature: ", "ºF<br>"},
-											                                                              {"&emsp;&emsp;Moisture Level: ", "%<br>"},
-											                                                              {"&emsp;&emsp;Battery Level: ", "V<br>"}};
+/* Variables */
+// Settling behaviour of this node's sensors, persisted in RTC memory between wakes
+struct SettleHistory {
+  uint16_t typicalMs; // smoothed settle time (0 = nothing learned yet)
+  uint16_t lastMs; // settle time observed on the most recent wake
+};
+
+static_assert(RTCStore::blocksFor(sizeof(SettleHistory)) <= RTC_SETTLE_HISTORY_BLOCKS, "SettleHistory does not fit its RTC slot");
+
+static SettleHistory _settle;
 
 /* Functions */
 
 // Function for turning on the external ADC and sensors
-void SensorMetrics::externADCOn() {
-	digitalWrite(SS_PIN, HIGH); // deselect the ADC (needs a falling edge)
-	digitalWrite(SENSOR_EN_PIN, HIGH); // turn on the ADC and sensors
-	delay(SENSOR_STABILIZE_DELAY); // give time for adc to turn on and sensor voltages to stabilize
+// Waits for the listed channels to settle before returning
+void SensorMetrics::externADCOn(const int* channels, const uint32_t* clocks, int channelCount) {
+	Hal::digitalWrite(SS_PIN, HIGH); // deselect the ADC (needs a falling edge)
+	Hal::digitalWrite(SENSOR_EN_PIN, HIGH); // turn on the ADC and sensors
+	waitForSettle(channels, clocks, channelCount); // give time for adc to turn on and sensor voltages to stabilize
+}
+
+// Function for waiting until the sensor voltages stop moving after power up
+// Polls the sensor channels and returns once successive readings agree, or after SENSOR_STABILIZE_DELAY at most.
+// The settle time observed is folded into a per-node typical value kept in RTC memory, and half of that
+// typical time is slept up front so the ADC isn't polled while the dividers are obviously still charging.
+unsigned long SensorMetrics::waitForSettle(const int* channels, const uint32_t* clocks, int channelCount) {
+  uint16_t previous[EXTERN_ADC_CHANNELS];
+  int stablePolls = 0;
+  unsigned long start = Hal::millis();
+  unsigned long settleTime;
+
+  if (!RTCStore::load(RTC_SETTLE_HISTORY_SLOT, &_settle, sizeof(_settle))) {
+    memset(&_settle, 0, sizeof(_settle));
+  }
+
+  channelCount = constrain(channelCount, 0, EXTERN_ADC_CHANNELS);
+  Hal::delay(min(_settle.typicalMs / 2, SENSOR_STABILIZE_DELAY));
+
+  for (int c = 0; c < channelCount; c++) {
+    Hal::spiSetFrequency(clocks[c]);
+    previous[c] = convertExternADC(channels[c]);
+  }
+
+  while (stablePolls < SETTLE_STABLE_POLLS && (Hal::millis() - start) < SENSOR_STABILIZE_DELAY) {
+    bool f_Stable = true;
+
+    Hal::delay(SETTLE_POLL_INTERVAL);
+    for (int c = 0; c < channelCount; c++) {
+      Hal::spiSetFrequency(clocks[c]);
+      uint16_t reading = convertExternADC(channels[c]);
+      if (abs((int)reading - (int)previous[c]) > SETTLE_TOLERANCE) {
+        f_Stable = false;
+      }
+      previous[c] = reading;
+    }
+
+    stablePolls = f_Stable ? (stablePolls + 1) : 0;
+  }
+  Hal::spiSetFrequency(EXTERN_ADC_SPI_FREQ);
+
+  settleTime = Hal::millis() - start;
+
+  // Learn this node's typical settle time (first observation is taken as is)
+  _settle.lastMs = settleTime;
+  if (_settle.typicalMs == 0) {
+    _settle.typicalMs = settleTime;
+  }
+  else { // step rounded to nearest, or a difference under SETTLE_HISTORY_WEIGHT ms would never move it
+    int difference = (int)settleTime - (int)_settle.typicalMs;
+    _settle.typicalMs += (difference + ((difference >= 0) ? SETTLE_HISTORY_WEIGHT / 2 : -SETTLE_HISTORY_WEIGHT / 2)) / SETTLE_HISTORY_WEIGHT;
+  }
+  RTCStore::save(RTC_SETTLE_HISTORY_SLOT, &_settle, sizeof(_settle));
+
+  return settleTime;
+}
+
+// Function to get the sensor settle time observed on the last power up (ms)
+unsigned long SensorMetrics::getSettleTime() {
+  return _settle.lastMs;
+}
+
+// Function to get this node's learned typical sensor settle time (ms)
+unsigned long SensorMetrics::getTypicalSettleTime() {
+  return _settle.typicalMs;
 }
 
 // Function for turning off the external ADC and sensors
 void SensorMetrics::externADCOff() {
-	digitalWrite(SS_PIN, LOW); // save energy by turning off the pin
-	digitalWrite(SENSOR_EN_PIN, LOW); // turn off the ADC and sensors
+	Hal::digitalWrite(SS_PIN, LOW); // save energy by turning off the pin
+	Hal::digitalWrite(SENSOR_EN_PIN, LOW); // turn off the ADC and sensors
 }
 
 // Function for setting up pins and SPI for external ADC and sensors
 void SensorMetrics::setupExternADC() {
-	pinMode(SENSOR_EN_PIN, OUTPUT);
-	pinMode(SS_PIN, OUTPUT);
+	Hal::pinMode(SENSOR_EN_PIN, OUTPUT);
+	Hal::pinMode(SS_PIN, OUTPUT);
 	
-	SPI.begin();
-	SPI.setBitOrder(MSBFIRST); // MSB bit sent first
-	SPI.setDataMode(SPI_MODE0);
-	SPI.setFrequency(EXTERN_ADC_SPI_FREQ); // 18kHz / 18 = 1ksa/s (1ms readings)
+	Hal::spiBegin(EXTERN_ADC_SPI_FREQ); // MSB first, mode 0, 18kHz / 18 = 1ksa/s (1ms readings)
 }
 
 // Function for getting readings from the ESP8266's internal ADC
 // ADC has an internal voltage reference of 1.1V
 int SensorMetrics::readInternADC() {
-  int reading = analogRead(A0); // read from A0 (ADC pin)
+  int reading = Hal::analogRead(); // read from A0 (ADC pin)
   
   return reading; // return the reading 
 }
@@ -104,22 +227,131 @@ int SensorMetrics::readExternADC(int ch) {
     return -1; // return -1 if passed invalid channel argument
   }
 
-  digitalWrite(SS_PIN, LOW); // select ADC
-  SPI.transfer(B00000001); // send 7 leading 0's and the START bit
+  Hal::digitalWrite(SS_PIN, LOW); // select ADC
+  Hal::spiTransfer(B00000001); // send 7 leading 0's and the START bit
   // send control bits (single-ended + channel address shifted into upper 4 bits)
-  uint8_t reading_upper = SPI.transfer((ch + 8) << 4); // store null bit + upper 2 bits of adc reading
-  uint8_t reading_lower = SPI.transfer(0); // store lower byte of adc reading
+  uint8_t reading_upper = Hal::spiTransfer((ch + 8) << 4); // store null bit + upper 2 bits of adc reading
+  uint8_t reading_lower = Hal::spiTransfer(0); // store lower byte of adc reading
 
-  digitalWrite(SS_PIN, HIGH); // deselect ADC
+  Hal::digitalWrite(SS_PIN, HIGH); // deselect ADC
 
   // clear null bit, shift first byte of reading into upper byte of int, bitwise OR second byte with lower byte of int
   return (((reading_upper & 3) << 8) + reading_lower); // return 10-bit ADC reading for specified channel
 }
 
+// Function for reading several external ADC channels in one burst
+// Takes `oversamples` conversions of each channel at its burst SPI clock and reduces them to one filtered value
+// (in ADC codes) plus the variance of the raw samples. The MCP3008 needs CS raised between conversions, so
+// the burst is one run of back to back 3 byte frames rather than a single CS window. Each channel's clock
+// comes from burstClock(): a high impedance divider needs a longer sample window than the fastest clock gives.
+void SensorMetrics::burstReadExternADC(const int* channels, const uint32_t* clocks, int channelCount, int oversamples, ADCFilter filter, ADCReading* readings) {
+  uint16_t samples[BURST_MAX_OVERSAMPLES];
+
+  oversamples = constrain(oversamples, 1, BURST_MAX_OVERSAMPLES);
+
+  for (int c = 0; c < channelCount; c++) {
+    int ch = channels[c];
+
+    if (ch >= EXTERN_ADC_CHANNELS || ch < 0) { // invalid channel, same convention as readExternADC()
+      readings[c].value = -1;
+      readings[c].variance = 0;
+      continue;
+    }
+
+    Hal::spiSetFrequency(clocks[c]); // speed up the bus as far as this channel allows
+    for (int i = 0; i < BURST_DISCARD; i++) {
+      convertExternADC(ch);
+    }
+    for (int i = 0; i < oversamples; i++) {
+      samples[i] = convertExternADC(ch);
+    }
+
+    readings[c] = filterSamples(samples, oversamples, filter);
+  }
+
+  Hal::spiSetFrequency(EXTERN_ADC_SPI_FREQ); // back to the normal clock for single reads
+}
+
+// Function for running one conversion on the external ADC using a single 3 byte SPI frame
+uint16_t SensorMetrics::convertExternADC(int ch) {
+  // 7 leading 0's and the START bit, single-ended + channel address, then clocks for the lower byte
+  uint8_t frame[3] = { B00000001, (uint8_t)((ch + 8) << 4), 0 };
+  uint8_t reply[3];
+
+  Hal::digitalWrite(SS_PIN, LOW); // select ADC
+  Hal::spiTransferBytes(frame, reply, sizeof(frame));
+  Hal::digitalWrite(SS_PIN, HIGH); // deselect ADC (starts the next conversion on the following falling edge)
+
+  return (((reply[1] & 3) << 8) + reply[2]); // 10-bit reading, null bit cleared
+}
+
+// Function for reducing a set of raw samples to a robust value and the variance of the samples
+// Sorts the samples in place (insertion sort, there are only a handful of them)
+ADCReading SensorMetrics::filterSamples(uint16_t* samples, int count, ADCFilter filter) {
+  ADCReading reading;
+  float sum = 0, sumSq = 0;
+
+  for (int i = 0; i < count; i++) {
+    sum += samples[i];
+    sumSq += (float)samples[i] * samples[i];
+  }
+  // unbiased sample variance, 0 for a single sample
+  reading.variance = (count > 1) ? ((sumSq - (sum * sum) / count) / (count - 1)) : 0;
+
+  for (int i = 1; i < count; i++) {
+    uint16_t sample = samples[i];
+    int j = i - 1;
+    while (j >= 0 && samples[j] > sample) {
+      samples[j + 1] = samples[j];
+      j--;
+    }
+    samples[j + 1] = sample;
+  }
+
+  if (filter == ADC_FILTER_MEDIAN) {
+    if (count % 2) {
+      reading.value = samples[count / 2];
+    }
+    else {
+      reading.value = (samples[(count / 2) - 1] + samples[count / 2]) / 2.0;
+    }
+  }
+  else { // trimmed mean, the outliers at either end are dropped before averaging
+    int trim = count / BURST_TRIM_DIVISOR;
+    float trimmedSum = 0;
+
+    for (int i = trim; i < count - trim; i++) {
+      trimmedSum += samples[i];
+    }
+    reading.value = trimmedSum / (count - (2 * trim));
+  }
+
+  return reading;
+}
+
+// Function to look up a converted value for an external adc reading in one of the flash tables
+// Whole codes are a single flash read. Fractional codes from oversampled reads are split into the table index
+// and a Q8 fixed point fraction, and interpolated linearly between the two neighbouring entries.
+float SensorMetrics::lookupADCTable(const float* table, float adc) {
+  int32_t code = (int32_t)((adc * ADC_INTERP_ONE) + 0.5); // reading in Q8 fixed point
+  code = constrain(code, (int32_t)0, (int32_t)((ADC_RESOLUTION - 1) * ADC_INTERP_ONE));
+
+  int index = code >> ADC_INTERP_BITS;
+  int frac = code & (ADC_INTERP_ONE - 1);
+  float value = pgm_read_float(&table[index]);
+
+  if (frac == 0) { // exact code, nothing to interpolate
+    return value;
+  }
+
+  float next = pgm_read_float(&table[index + 1]);
+  return value + (((next - value) * frac) / ADC_INTERP_ONE);
+}
+
 // Function to convert adc value into voltage measurement
-float SensorMetrics::getVMeas(int adc, bool externADC) {
+float SensorMetrics::getVMeas(float adc, bool externADC) {
   // Compute first part of vMeas by getting adc reading ratio
-  float vMeas = ((float(adc) + 1.0) / float(ADC_RESOLUTION)); // resolution is same between internal and external chip
+  float vMeas = ((adc + 1.0) / float(ADC_RESOLUTION)); // resolution is same between internal and external chip
 
   // If we are reading from external adc...
   if (externADC) {
@@ -167,7 +399,6 @@ float SensorMetrics::getVDivR1(float vMeas, int r2, bool externADC) {
 // Function to get light intensity reading (Lux) from photoresistor
 float SensorMetrics::getLux (bool externADC) {
   int prADC;
-  float lux, vMeas, photoResistor;
 
   // Read the adc channel that the photoresistor is attached to
   if (externADC) {
@@ -177,6 +408,23 @@ float SensorMetrics::getLux (bool externADC) {
     prADC = readInternADC();
   }
 
+  return adcToLux(prADC, externADC); // convert the reading to lux
+}
+
+// Function to convert a photoresistor adc reading (or filtered burst value) into light intensity (Lux)
+float SensorMetrics::adcToLux(float prADC, bool externADC) {
+#if SENSOR_LOOKUP_TABLES
+  if (externADC) { // curve for the external adc reference is precomputed
+    return lookupADCTable(_LUX_TABLE.values, prADC);
+  }
+#endif
+  return calcLux(prADC, externADC);
+}
+
+// Function to calculate light intensity (Lux) from a photoresistor adc reading using the sensor's curve
+float SensorMetrics::calcLux(float prADC, bool externADC) {
+  float lux, vMeas, photoResistor;
+
   vMeas = getVMeas(prADC, externADC); // convert adc reading to voltage
   // Get value of photoresistor based on vMeas and the value of the known R2 resistor in the voltage divider circuit
   photoResistor = getVDivR1(vMeas, PHOTORESISTOR_R2, externADC);
@@ -190,7 +438,6 @@ float SensorMetrics::getLux (bool externADC) {
 // Function to get temperature in Kelvin from thermistor
 float SensorMetrics::getTempK (bool externADC) {
   int thADC;
-  float tempK, vMeas, thermistor;
 
   // Read the adc channel that the thermistor is attached to
   if (externADC) {
@@ -200,6 +447,23 @@ float SensorMetrics::getTempK (bool externADC) {
     thADC = readInternADC();
   }
 
+  return adcToTempK(thADC, externADC); // convert the reading to Kelvin
+}
+
+// Function to convert a thermistor adc reading (or filtered burst value) into temperature in Kelvin
+float SensorMetrics::adcToTempK(float thADC, bool externADC) {
+#if SENSOR_LOOKUP_TABLES
+  if (externADC) { // curve for the external adc reference is precomputed
+    return lookupADCTable(_TEMP_K_TABLE.values, thADC);
+  }
+#endif
+  return calcTempK(thADC, externADC);
+}
+
+// Function to calculate temperature in Kelvin from a thermistor adc reading using the Beta equation
+float SensorMetrics::calcTempK(float thADC, bool externADC) {
+  float tempK, vMeas, thermistor;
+
   vMeas = getVMeas(thADC, externADC); // convert adc reading to voltage
   // Get value of thermistor based on vMeas and the value of the known R2 resistor in the voltage divider circuit
   thermistor = getVDivR1(vMeas, THERMISTOR_R2, externADC); 
@@ -219,9 +483,13 @@ float SensorMetrics::getTempK (bool externADC) {
 
 // Function to get temperature in Fahrenheit from thermistor
 float SensorMetrics::getTempF (bool externADC) {
-  float tempK, tempF;
+  return tempKToF(getTempK(externADC)); // get the temperature in Kelvin and convert to Fahrenheit
+}
+
+// Function to convert a temperature in Kelvin to Fahrenheit
+float SensorMetrics::tempKToF(float tempK) {
+  float tempF;
   
-  tempK = getTempK(externADC); // get the temperature in Kelvin
   tempF = ((tempK * TEMP_F_MULT) - TEMP_F_CONST); // convert to Fahrenheit from Kelvin
   
   return tempF; // return the temperature reading in Fahrenheit
@@ -240,9 +508,16 @@ float SensorMetrics::getTempC (bool externADC) {
 // Function to get moisture level %
 float SensorMetrics::getMoistureLvl(bool externADC) {
   int moistADC;
-  float moistLvl, vMoist, vMeas;
 
   moistADC = readExternADC(MOISTURE_SENSOR_CH); // get reading from external adc
+
+  return adcToMoistureLvl(moistADC, externADC); // convert the reading to %
+}
+
+// Function to convert a moisture sensor adc reading (or filtered burst value) into moisture level %
+float SensorMetrics::adcToMoistureLvl(float moistADC, bool externADC) {
+  float moistLvl, vMoist, vMeas;
+
   vMeas = getVMeas(moistADC, externADC); // convert to voltage using appropriate reference voltage
   vMoist = ((getVDivVin(MOISTURE_SENSOR_R1, MOISTURE_SENSOR_R2, vMeas)) * 1000); // calculate input voltage (mV) divider circuit with R1 drop
   moistLvl = map(vMoist, MOISTURE_MIN, MOISTURE_MAX, 0, 100); // map millivolts to %
@@ -262,28 +537,4 @@ float SensorMetrics::getBatteryLvl() {
   return vBat; // return the battery voltage reading
 }
 
-float* SensorMetrics::getSensors() {
-	float lux, temp, moisture, battery;
-	
-	setupExternADC(); // setup external ADC
-	externADCOn(); // turn on the ADC and sensors
-	
-	lux = getLux(); // get light intensity reading
-	temp = getTempF(); // get temperature reading
-	moisture = getMoistureLvl(); // get moisture level reading
-	battery = getBatteryLvl(); // get battery level reading
-	
-	// Create array of sensor values
-	float * sensors = new float[4];
-	
-	sensors[0] = lux;
-	sensors[1] = temp;
-	sensors[2] = moisture;
-	sensors[3] = battery;
-	
-	externADCOff(); // turn off the ADC and sensors
-	
-	return sensors; // return array of sensor values
-}
-
 // ©2017 Jeremy Maxey-Vesperman
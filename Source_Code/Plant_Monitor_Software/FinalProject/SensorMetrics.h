@@ -11,29 +11,67 @@
 #include <SPI.h>
 #include <math.h>
 
+/* Definitions */
+// External ADC (MCP3008) channels the sensors are wired to
+#define PHOTORESISTOR_CH 1 // channel of external adc that photoresistor is connected to
+#define THERMISTOR_CH 2 // channel of external adc that thermistor is connected to
+#define MOISTURE_SENSOR_CH 4 // channel of external adc that moisture sensor is connected to
+
+#define BURST_MAX_OVERSAMPLES 32 // most conversions a burst read takes per channel
+#define EXTERN_ADC_BURST_FREQ 1000000 // fastest clock for burst reads (MCP3008 max is 1.35MHz at 2.7V)
+// MCP3008 sampling: the hold capacitor charges through the source and the switch while the sample window
+// (1.5 clocks) is open, and must get within 1/2 LSB of the input, ln(2^11) = 7.62 time constants
+#define EXTERN_ADC_SWITCH_OHMS 1000.0
+#define EXTERN_ADC_SAMPLE_FARADS 20e-12
+#define EXTERN_ADC_SAMPLE_CLOCKS 1.5
+#define EXTERN_ADC_SETTLE_TAUS 7.62
+
+/* Ways of reducing a burst of samples to one value */
+enum ADCFilter {
+	ADC_FILTER_MEDIAN, // middle sample
+	ADC_FILTER_TRIMMED_MEAN // mean of the samples with the top and bottom quarter removed
+};
+
+/* Filtered result of a burst read of one channel */
+struct ADCReading {
+	float value; // filtered reading in ADC codes (-1 for an invalid channel)
+	float variance; // variance of the raw samples in ADC codes², a measure of how noisy the channel was
+};
+
 /* SensorMetrics class definition */
 class SensorMetrics {
 	public:
 		/* Public Functions and Methods */
-		static void externADCOn();
+		static void externADCOn(const int* channels, const uint32_t* clocks, int channelCount); // method to power the adc and sensors and wait for the listed channels to settle
 		static void externADCOff();
 		static void setupExternADC();
-		static float* getSensors(); // function to get all sensor readings
 		static float getLux (bool externADC=true); // function to get light intensity reading (Lux) from photoresistor
 		static float getTempK (bool externADC=true); // function to get temperature in Kelvin from thermistor
 		static float getTempF (bool externADC=true); // function to get temperature in Fahrenheit from thermistor
 		static float getTempC (bool externADC=true); // function to get temperature in Celsius from thermistor
 		static float getMoistureLvl(bool externADC=true); // function to get moisture level %
 		static float getBatteryLvl(); // function to get the battery voltage
-		
-		/* Public Class Constants */
-    static const int _SENSOR_DESCRIPTIONS_SIZE;
-		static const String _SENSOR_DESCRIPTIONS[][2];
+		static unsigned long getSettleTime(); // function to get the sensor settle time observed on the last power up (ms)
+		static unsigned long getTypicalSettleTime(); // function to get this node's learned typical sensor settle time (ms)
+		static void burstReadExternADC(const int* channels, const uint32_t* clocks, int channelCount, int oversamples, ADCFilter filter, ADCReading* readings); // method to oversample several external adc channels at once, each at its own clock
+		static constexpr uint32_t burstClock(float sourceOhms) { // function to get the fastest clock a channel's source impedance allows
+			return min((double)EXTERN_ADC_BURST_FREQ, EXTERN_ADC_SAMPLE_CLOCKS / (EXTERN_ADC_SETTLE_TAUS * (sourceOhms + EXTERN_ADC_SWITCH_OHMS) * EXTERN_ADC_SAMPLE_FARADS));
+		}
+		static float adcToLux(float prADC, bool externADC=true); // function to convert a photoresistor reading into light intensity (Lux)
+		static float adcToTempK(float thADC, bool externADC=true); // function to convert a thermistor reading into temperature in Kelvin
+		static float adcToMoistureLvl(float moistADC, bool externADC=true); // function to convert a moisture sensor reading into moisture level %
+		static float tempKToF(float tempK); // function to convert Kelvin to Fahrenheit
 	private:
 		/* Private Functions and Methods */
+		static unsigned long waitForSettle(const int* channels, const uint32_t* clocks, int channelCount); // function for waiting until sensor voltages stop moving after power up
 		static int readInternADC(); // function for getting readings from the ESP8266's internal ADC
 		static int readExternADC(int ch); // function for reading from external SPI ADC chip
-		static float getVMeas(int adc, bool externADC=true); // function to convert adc value into voltage 
+		static uint16_t convertExternADC(int ch); // function for one conversion on the external ADC in a single SPI frame
+		static ADCReading filterSamples(uint16_t* samples, int count, ADCFilter filter); // function for reducing raw samples to a filtered value and variance
+		static float calcLux(float prADC, bool externADC); // function to calculate light intensity from the photoresistor curve
+		static float calcTempK(float thADC, bool externADC); // function to calculate temperature from the thermistor Beta equation
+		static float lookupADCTable(const float* table, float adc); // function to look up (and interpolate) a converted reading in a flash table
+		static float getVMeas(float adc, bool externADC=true); // function to convert adc value into voltage 
 		static float getVDivVin(float r1, float r2, float vDrop, bool vDropAcrossR1=false); // function to calculate input voltage to voltage divider circuit
 		static float getVDivR1(float vMeas, int r2, bool externADC); // function to convert measured voltage into R1 value of a voltage divider circuit
 };
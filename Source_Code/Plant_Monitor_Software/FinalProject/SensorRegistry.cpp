@@ -0,0 +1,24 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "SensorRegistry.h"
+
+/* Constants */
+
+// Report strings for the sensor types in SensorRegistry.h, one CRLF terminated line per reading
+const char _SENSOR_REPORT_TEMPLATE[] PROGMEM = "<b>%s</b>%f%s\r\n";
+const char _SENSOR_ALERT_TEMPLATE[] PROGMEM = "<b>%s</b><font color=\"red\"><b>%f</b></font>%s\r\n";
+const char _LIGHT_LABEL[] PROGMEM = "&emsp;&emsp;Light Intensity: ";
+const char _LIGHT_UNIT[] PROGMEM = " lux<br>";
+const char _TEMPERATURE_LABEL[] PROGMEM = "&emsp;&emsp;Temperature: ";
+const char _TEMPERATURE_UNIT[] PROGMEM = "ºF<br>";
+const char _MOISTURE_LABEL[] PROGMEM = "&emsp;&emsp;Moisture Level: ";
+const char _MOISTURE_UNIT[] PROGMEM = "%<br>";
+const char _BATTERY_LABEL[] PROGMEM = "&emsp;&emsp;Battery Level: ";
+const char _BATTERY_UNIT[] PROGMEM = "V<br>";
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,225 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SensorRegistry_h
+#define SensorRegistry_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include "SensorMetrics.h"
+#include "ReportWriter.h"
+
+/* Definitions */
+#define INTERN_ADC_CHANNEL -1 // sensor is read by its own function (e.g. the ESP8266's internal adc) instead of the MCP3008
+#define SENSOR_OVERSAMPLES 9 // conversions per channel for each report (odd so the median is a real sample)
+#define NO_ALERT_BELOW -1e30f // alertBelow for sensors that have no lower alert threshold
+#define NO_ALERT_ABOVE 1e30f // alertAbove for sensors that have no upper alert threshold
+
+/* Report strings, kept in flash (defined in SensorRegistry.cpp) */
+extern const char _SENSOR_REPORT_TEMPLATE[]; // label, reading, unit (see ReportWriter)
+extern const char _SENSOR_ALERT_TEMPLATE[]; // same, for a reading outside its alert thresholds
+extern const char _LIGHT_LABEL[];
+extern const char _LIGHT_UNIT[];
+extern const char _TEMPERATURE_LABEL[];
+extern const char _TEMPERATURE_UNIT[];
+extern const char _MOISTURE_LABEL[];
+extern const char _MOISTURE_UNIT[];
+extern const char _BATTERY_LABEL[];
+extern const char _BATTERY_UNIT[];
+
+/* Sensor types */
+// Each sensor declares at compile time:
+//   channel                    MCP3008 channel, or INTERN_ADC_CHANNEL with a read() function instead
+//   sourceOhms                 largest Thevenin resistance the channel's divider presents, sets its burst clock
+//   convert(adc)               filtered adc reading to the reported value (external channels only)
+//   label(), unit()            flash strings for the report
+//   recordScale, recordOffset  how the value is packed into 16 bits for the sample buffer:
+//                              stored = value * recordScale + recordOffset
+//   deadband                   smallest change worth reporting (ReportPolicy)
+//   alertBelow, alertAbove     readings outside these are reported straight away (ReportPolicy)
+// To add a probe, declare its type here (report strings go in SensorRegistry.cpp) and add it to NodeSensors
+// at the bottom of this file; acquisition, the report and the sample buffer all follow from the list.
+
+// Photoresistor (WDYJ GM5539)
+struct LightSensor {
+	static constexpr int channel = PHOTORESISTOR_CH;
+	static constexpr float sourceOhms = 9830; // the divider's fixed resistor alone, photoresistor dark
+	static constexpr float recordScale = 1; // whole lux, 0 to 65535
+	static constexpr float recordOffset = -32768;
+	static constexpr float deadband = 200;
+	static constexpr float alertBelow = NO_ALERT_BELOW;
+	static constexpr float alertAbove = NO_ALERT_ABOVE;
+	static float convert(float adc) { return SensorMetrics::adcToLux(adc); }
+	static PGM_P label() { return _LIGHT_LABEL; }
+	static PGM_P unit() { return _LIGHT_UNIT; }
+};
+
+// Thermistor (Honeywell 192-103LET-A01)
+struct TemperatureSensor {
+	static constexpr int channel = THERMISTOR_CH;
+	static constexpr float sourceOhms = 9930; // the divider's fixed resistor alone, thermistor cold
+	static constexpr float recordScale = 10; // tenths of a degree
+	static constexpr float recordOffset = 0;
+	static constexpr float deadband = 2;
+	static constexpr float alertBelow = 40; // too cold for most house plants
+	static constexpr float alertAbove = 95;
+	static float convert(float adc) { return SensorMetrics::tempKToF(SensorMetrics::adcToTempK(adc)); }
+	static PGM_P label() { return _TEMPERATURE_LABEL; }
+	static PGM_P unit() { return _TEMPERATURE_UNIT; }
+};
+
+// Moisture sensor (XCSOURCE TE215), templated on channel so further probes can share the calibration
+template <int CH>
+struct MoistureSensor {
+	static constexpr int channel = CH;
+	static constexpr float sourceOhms = 98400; // 406.1k || 129.9k
+	static constexpr float recordScale = 10; // tenths of a percent
+	static constexpr float recordOffset = 0;
+	static constexpr float deadband = 5;
+	static constexpr float alertBelow = 20; // soil is dry, needs watering
+	static constexpr float alertAbove = NO_ALERT_ABOVE;
+	static float convert(float adc) { return SensorMetrics::adcToMoistureLvl(adc); }
+	static PGM_P label() { return _MOISTURE_LABEL; }
+	static PGM_P unit() { return _MOISTURE_UNIT; }
+};
+
+// Battery voltage divider on the ESP8266's internal adc
+struct BatterySensor {
+	static constexpr int channel = INTERN_ADC_CHANNEL;
+	static constexpr float sourceOhms = 0; // not on the MCP3008
+	static constexpr float recordScale = 1000; // millivolts
+	static constexpr float recordOffset = 0;
+	static constexpr float deadband = 0.1;
+	static constexpr float alertBelow = 3.3; // battery needs changing soon
+	static constexpr float alertAbove = NO_ALERT_ABOVE;
+	static float read() { return SensorMetrics::getBatteryLvl(); }
+	static PGM_P label() { return _BATTERY_LABEL; }
+	static PGM_P unit() { return _BATTERY_UNIT; }
+};
+
+/* SensorList definition */
+// Acquisition, report rendering and packing for a fixed list of sensor types. The loops over the list are
+// parameter pack expansions, so each sensor's functions are called directly (no virtual calls, no heap).
+template <class... Sensors>
+struct SensorList {
+	static constexpr int count = sizeof...(Sensors); // number of readings
+
+	static_assert(count <= 8, "alert flags are kept in 8 bits");
+
+	// Method to power the sensors, burst read every external channel and convert all readings (array of count)
+	static void read(float* values) {
+		int channels[count];
+		uint32_t clocks[count];
+		ADCReading readings[count];
+		int channelCount = 0;
+		int i = 0, r = 0;
+
+		// gather the MCP3008 channels in list order, each with the fastest clock its divider allows
+		((Sensors::channel != INTERN_ADC_CHANNEL ?
+		  (void)(channels[channelCount] = Sensors::channel, clocks[channelCount++] = burstClock<Sensors>()) : (void)0), ...);
+
+		if (channelCount > 0) {
+			SensorMetrics::setupExternADC(); // setup external ADC
+			SensorMetrics::externADCOn(channels, clocks, channelCount); // turn on the ADC and sensors
+			// Oversample all external channels in one burst so a single noisy conversion can't skew the report
+			SensorMetrics::burstReadExternADC(channels, clocks, channelCount, SENSOR_OVERSAMPLES, ADC_FILTER_MEDIAN, readings);
+		}
+
+		((values[i++] = acquire<Sensors>(readings, r)), ...);
+
+		if (channelCount > 0) {
+			SensorMetrics::externADCOff(); // turn off the ADC and sensors
+		}
+	}
+
+	// Method to write the label, value and unit of every reading, highlighting any outside its alert thresholds
+	static void writeReport(ReportWriter& report, const float* values) {
+		int i = 0;
+
+		((report.printTemplate(isAlert<Sensors>(values[i]) ? _SENSOR_ALERT_TEMPLATE : _SENSOR_REPORT_TEMPLATE,
+		                      Sensors::label(), values[i], Sensors::unit()), i++), ...);
+	}
+
+	// Function to get a flag (bit i for reading i) for every reading outside its alert thresholds
+	static uint8_t alerts(const float* values) {
+		uint8_t flags = 0;
+		int i = 0;
+
+		((flags |= (isAlert<Sensors>(values[i]) ? (1 << i) : 0), i++), ...);
+		return flags;
+	}
+
+	// Function to check whether any reading has moved further than its deadband from a reference set
+	static bool changed(const float* values, const float* reference) {
+		int i = 0;
+		bool moved = false;
+
+		((moved |= (fabsf(values[i] - reference[i]) > Sensors::deadband), i++), ...);
+		return moved;
+	}
+
+	// Function to get the largest change between two sets of readings, in units of each sensor's deadband
+	static float changeRate(const float* values, const float* reference) {
+		int i = 0;
+		float rate = 0;
+
+		((rate = max(rate, fabsf(values[i] - reference[i]) / Sensors::deadband), i++), ...);
+		return rate;
+	}
+
+	// Method to pack readings into 16 bits each
+	static void pack(const float* values, int16_t* record) {
+		int i = 0;
+
+		((record[i] = packValue<Sensors>(values[i]), i++), ...);
+	}
+
+	// Method to unpack 16 bit records back into readings
+	static void unpack(const int16_t* record, float* values) {
+		int i = 0;
+
+		((values[i] = (record[i] - Sensors::recordOffset) / Sensors::recordScale, i++), ...);
+	}
+
+	private:
+		// Function to get one sensor's burst clock, worked out at compile time
+		template <class Sensor>
+		static uint32_t burstClock() {
+			constexpr uint32_t clock = SensorMetrics::burstClock(Sensor::sourceOhms);
+			return clock;
+		}
+
+		// Function to get one sensor's value, from the next burst reading or its own read function
+		template <class Sensor>
+		static float acquire(const ADCReading* readings, int& r) {
+			if constexpr (Sensor::channel != INTERN_ADC_CHANNEL) {
+				return Sensor::convert(readings[r++].value);
+			}
+			else {
+				return Sensor::read();
+			}
+		}
+
+		// Function to check one value against its sensor's alert thresholds
+		template <class Sensor>
+		static bool isAlert(float value) {
+			return (value < Sensor::alertBelow) || (value > Sensor::alertAbove);
+		}
+
+		// Function to scale, round and saturate one value to 16 bits
+		template <class Sensor>
+		static int16_t packValue(float value) {
+			float stored = (value * Sensor::recordScale) + Sensor::recordOffset;
+			stored += (stored < 0) ? -0.5f : 0.5f;
+			return (int16_t)constrain(stored, -32768.0f, 32767.0f);
+		}
+};
+
+/* Sensors fitted to this node, in report order */
+typedef SensorList<LightSensor, TemperatureSensor, MoistureSensor<MOISTURE_SENSOR_CH>, BatterySensor> NodeSensors;
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
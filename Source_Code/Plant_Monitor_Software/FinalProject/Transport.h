@@ -0,0 +1,41 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Transport_h
+#define Transport_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+/* Function that writes part of a report (HTML body, binary record...) to the output it is given */
+typedef void (*MessageBodyWriter)(Print& out);
+
+/* Everything a transport may need to send one report, each transport uses the form that suits it */
+struct ReportContent {
+	PGM_P subject; // short flash string describing the report (email subject)
+	MessageBodyWriter writeBody; // writes the human readable (HTML) report
+	MessageBodyWriter writeRecord; // writes the machine readable (CBOR) record of the same readings
+};
+
+#define NO_DEADLINE 0 // deadline value for no limit
+
+/* Transport class definition */
+// Interface for the ways a node can deliver its reports (email, UDP telemetry...)
+class Transport {
+	public:
+		/* Constructors */
+		virtual ~Transport() { } // destructor for implementations
+
+		/* Public Functions and Methods */
+		virtual bool sendReport(const ReportContent& report) = 0; // function for delivering a report, returns false if it wasn't
+		virtual bool isPermanentFailure() = 0; // function for checking whether the last report was refused for good, so sending it again can't help
+		virtual int getTimeout() = 0; // function for getting the current timeout setting (ms)
+		virtual void updateTimeout(int newTimeout) = 0; // method for updating the timeout (ms), 0 or less resets it to the default
+		virtual void updateDeadline(unsigned long connectBy, unsigned long doneBy) = 0; // method for setting the millis() by which connecting and the whole send must be over (NO_DEADLINE = none)
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,150 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "UDPTelemetry.h"
+#include "ReportWriter.h"
+#include "EventLog.h"
+#include "Profiler.h"
+#include "RTCStore.h"
+#include "RTTEstimator.h"
+#include "Hal.h"
+
+/* Definitions */
+#define DEFAULT_LOOKUP_TIMEOUT 5000 // Default deadline (ms) for resolving the listener's name
+#define UDP_LOCAL_PORT 5685 // port the datagram goes out from, and the ack comes back to
+#define UDP_ACK_SIZE 4 // CRC-32 of the datagram, most significant byte first
+
+/* Print that passes the record on to the datagram, keeping the CRC of what went in and whether all of it fitted */
+class DatagramWriter : public Print {
+  public:
+    DatagramWriter(Print& out) : _out(out), _crc(0), f_Short(false) { }
+
+    size_t write(uint8_t c) override {
+      return write(&c, 1);
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+      size_t written = _out.write(buffer, size);
+      _crc = RTCStore::crc32(buffer, written, _crc);
+      f_Short = f_Short || (written < size);
+      return written;
+    }
+
+    uint32_t getCRC() { return _crc; }
+    bool isComplete() { return !f_Short; }
+  private:
+    Print& _out;
+    uint32_t _crc;
+    bool f_Short;
+};
+
+/* Constructors */
+// Constructor that sends to the specified listener
+UDPTelemetry::UDPTelemetry(const char* host, uint16_t port)
+  : _host(host), _port(port), _timeout(DEFAULT_LOOKUP_TIMEOUT), _lookupBy(NO_DEADLINE), _doneBy(NO_DEADLINE)
+{
+}
+
+/* Functions */
+
+/* Sends the report's binary record as a single datagram and waits for the listener to acknowledge it */
+// The record is built straight into the datagram, so it must fit in one (a little under 1.5 kB)
+bool UDPTelemetry::sendReport(const ReportContent& report) {
+  IPAddress listenerAddr;
+  unsigned long timeout = _timeout;
+
+  if (_lookupBy != NO_DEADLINE) {
+    timeout = min(timeout, Hal::timeUntil(_lookupBy));
+  }
+
+  if (timeout == 0 || !WiFi.hostByName(_host, listenerAddr, timeout)) { // also accepts a dotted address without a lookup
+    LOG_ERROR(UDP_LOOKUP_FAILED);
+    return false;
+  }
+
+  _udp.begin(UDP_LOCAL_PORT);
+  if (!_udp.beginPacket(listenerAddr, _port)) {
+    LOG_ERROR(UDP_SEND_FAILED);
+    _udp.stop();
+    return false;
+  }
+
+  DatagramWriter datagram(_udp);
+  {
+    ReportWriter record(datagram); // collects small writes into larger appends to the datagram
+    report.writeRecord(record);
+  }
+
+  if (!datagram.isComplete() || !_udp.endPacket()) { // a record cut short would never be acknowledged anyway
+    LOG_ERROR(UDP_SEND_FAILED);
+    _udp.stop();
+    return false;
+  }
+
+  bool f_Acked = waitForAck(datagram.getCRC());
+  _udp.stop();
+  if (!f_Acked) {
+    LOG_ERROR(UDP_NO_ACK);
+    return false;
+  }
+
+  LOG_INFO(UDP_SENT);
+  return true;
+}
+
+/* Waits for the listener to send back the CRC of the datagram, up to the round trip deadline (capped by _doneBy) */
+// Anything else arriving on the port (such as a late ack to an earlier attempt) is passed over. The ack is timed
+// to refine the round trip estimate, and a missed deadline backs it off the way a missed SMTP response does.
+bool UDPTelemetry::waitForAck(uint32_t crc) {
+  uint8_t ack[UDP_ACK_SIZE];
+  unsigned long start = Hal::millis();
+  unsigned long rttDeadline = RTTEstimator::getTimeout();
+  unsigned long deadline = (_doneBy == NO_DEADLINE) ? rttDeadline : min(rttDeadline, Hal::timeUntil(_doneBy));
+  ProfileTimer timer(PHASE_REPLY);
+
+  while ((Hal::millis() - start) < deadline) { // until the deadline passes...
+    if (_udp.parsePacket() == UDP_ACK_SIZE && _udp.read(ack, UDP_ACK_SIZE) == UDP_ACK_SIZE &&
+        (((uint32_t)ack[0] << 24) | ((uint32_t)ack[1] << 16) | ((uint32_t)ack[2] << 8) | ack[3]) == crc) {
+      RTTEstimator::addSample(Hal::millis() - start);
+      return true;
+    }
+    Hal::yield(); // let the WiFi stack run while we wait
+  }
+
+  if (deadline == rttDeadline) { // listener may only be slower than the estimate, so allow it longer next time
+    RTTEstimator::backOff();
+  }
+  return false;
+}
+
+/* Setter method to bound the lookup of the listener and the wait for its ack */
+void UDPTelemetry::updateDeadline(unsigned long connectBy, unsigned long doneBy) {
+  _lookupBy = connectBy;
+  _doneBy = doneBy;
+}
+
+/* Getter method to return whether the last report was refused for good */
+bool UDPTelemetry::isPermanentFailure() {
+  return false; // a datagram that wasn't acknowledged may well get through next time
+}
+
+/* Getter method to return timeout for resolving the listener */
+int UDPTelemetry::getTimeout() {
+  return _timeout;
+}
+
+/* Setter method to update timeout for resolving the listener */
+void UDPTelemetry::updateTimeout(int newTimeout) {
+  if (newTimeout > 0) { // if new timeout is a valid timeout setting...
+    _timeout = newTimeout; // update
+  }
+  else { // otherwise reset to default
+    _timeout = DEFAULT_LOOKUP_TIMEOUT;
+  }
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,45 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef UDPTelemetry_h
+#define UDPTelemetry_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include "Transport.h"
+
+/* UDPTelemetry class definition */
+// Sends the binary record of a report to a listener as a single UDP datagram. The listener acknowledges it by
+// sending back the datagram's CRC-32 (4 bytes, most significant first) to the port it came from; the report
+// only counts as delivered once that arrives, so a lost datagram or ack leaves the readings to go out again.
+class UDPTelemetry : public Transport {
+	public:
+		/* Constructors */
+		UDPTelemetry(const char* host, uint16_t port); // constructor that sends to the specified listener
+		
+		/* Public Functions and Methods */
+		bool sendReport(const ReportContent& report) override; // function for sending the report's record as one datagram, true once acknowledged
+		bool isPermanentFailure() override; // function for checking whether the last report was refused for good (never, the listener refuses nothing)
+		int getTimeout() override; // function for getting the current timeout setting
+		void updateTimeout(int newTimeout) override; // method for updating the timeout
+		void updateDeadline(unsigned long connectBy, unsigned long doneBy) override; // method for setting when the lookup and the ack must be over
+	private:
+		/* Private Functions and Methods */
+		bool waitForAck(uint32_t crc); // function to wait for the listener to acknowledge the datagram with this CRC
+
+		/* Private Instance Variables */
+		WiFiUDP _udp; // socket the datagram is sent from and the ack arrives on
+		const char* _host; // name or dotted address of the listener
+		uint16_t _port; // UDP port of the listener
+		int _timeout; // deadline (ms) for looking up the listener's address
+		unsigned long _lookupBy; // millis() by which the lookup must be over (NO_DEADLINE = none)
+		unsigned long _doneBy; // millis() by which the ack must have arrived (NO_DEADLINE = none)
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
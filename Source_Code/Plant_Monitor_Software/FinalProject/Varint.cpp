@@ -0,0 +1,45 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "Varint.h"
+
+/* Functions */
+
+// Function to zig-zag varint encode a value (small magnitudes of either sign take one byte)
+size_t Varint::put(uint8_t* buffer, int32_t value) {
+  uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+  size_t len = 0;
+
+  while (zigzag >= 0x80) {
+    buffer[len++] = (zigzag & 0x7F) | 0x80;
+    zigzag >>= 7;
+  }
+  buffer[len++] = zigzag;
+
+  return len;
+}
+
+// Function to decode a zig-zag varint, returns false if the data ends partway through
+bool Varint::get(const uint8_t* data, size_t size, size_t& pos, int32_t& value) {
+  uint32_t zigzag = 0;
+  int shift = 0;
+
+  while (pos < size && shift < (7 * VARINT_MAX_BYTES)) {
+    uint8_t b = data[pos++];
+
+    zigzag |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) {
+      value = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+      return true;
+    }
+    shift += 7;
+  }
+
+  return false;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,28 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Varint_h
+#define Varint_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+/* Definitions */
+#define VARINT_MAX_BYTES 5 // longest encoding of a 32 bit value
+
+/* Varint class definition */
+// Zig-zag varints: a signed value is folded so small magnitudes of either sign become small unsigned numbers,
+// then written 7 bits a byte, low bits first, with the top bit set on every byte but the last.
+// Shared by the flash sample log (SampleLog) and the RTC event log (EventLog).
+class Varint {
+	public:
+		/* Public Functions and Methods */
+		static size_t put(uint8_t* buffer, int32_t value); // function to encode a value, returns the bytes written (at most VARINT_MAX_BYTES)
+		static bool get(const uint8_t* data, size_t size, size_t& pos, int32_t& value); // function to decode the value at pos, returns false if the data ends partway through
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,58 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "WakeBudget.h"
+#include "Hal.h"
+
+/* Definitions */
+// *** MODIFY THESE TO MATCH THE BATTERY AND HOW LONG IT SHOULD LAST ***
+#define WAKE_CHARGE_BUDGET 2400 // charge one wake may use with a full battery (mA·s)
+#define RADIO_ON_CURRENT 80 // average draw while the radio is up (mA), the allowance assumes it is on throughout
+#define BATTERY_FULL_V 4.1 // at or above this the whole budget is available
+#define BATTERY_EMPTY_V 3.3 // at or below this only BUDGET_MIN_SCALE of it is
+#define BUDGET_MIN_SCALE 0.25f // share of the budget left for a nearly flat battery, enough for one short report
+
+/* Variables */
+static unsigned long _start = 0; // millis() when the wake's allowance started
+static unsigned long _allowance = (WAKE_CHARGE_BUDGET * 1000UL) / RADIO_ON_CURRENT; // time this wake may take (ms)
+
+/* Constants */
+// Share of the allowance (percent, counted from the start of the wake) each phase has to be over by
+static const uint8_t _PHASE_ENDS[BUDGET_PHASE_COUNT] = { 10, 45, 60, 100 }; // in BudgetPhase order
+
+/* Functions */
+
+// Method to start this wake's allowance, a lower battery gets less time
+void WakeBudget::begin(float batteryVolts) {
+  float scale = (batteryVolts - BATTERY_EMPTY_V) / (BATTERY_FULL_V - BATTERY_EMPTY_V);
+
+  scale = constrain(scale, BUDGET_MIN_SCALE, 1.0f);
+  _start = Hal::millis();
+  _allowance = (unsigned long)(scale * ((WAKE_CHARGE_BUDGET * 1000UL) / RADIO_ON_CURRENT));
+}
+
+// Function to get the time this wake may take
+unsigned long WakeBudget::getAllowance() {
+  return _allowance;
+}
+
+// Function to get the millis() by which a phase has to be over
+unsigned long WakeBudget::getDeadline(BudgetPhase phase) {
+  return _start + ((_allowance * _PHASE_ENDS[phase]) / 100);
+}
+
+// Function to get the time left before a phase's deadline
+unsigned long WakeBudget::timeLeft(BudgetPhase phase) {
+  return Hal::timeUntil(getDeadline(phase));
+}
+
+// Function to check whether the whole allowance has been used
+bool WakeBudget::isSpent() {
+  return timeLeft(BUDGET_SEND) == 0;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
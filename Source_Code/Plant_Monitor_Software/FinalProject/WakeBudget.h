@@ -0,0 +1,37 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef WakeBudget_h
+#define WakeBudget_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+/* Phases of a wake, in the order they run */
+enum BudgetPhase {
+	BUDGET_SENSORS, // powering and reading the sensors
+	BUDGET_WIFI, // joining the network
+	BUDGET_CONNECT, // opening the connection to the server (TLS handshake)
+	BUDGET_SEND, // delivering the report, retries included
+	BUDGET_PHASE_COUNT
+};
+
+/* WakeBudget class definition */
+// Turns a per-wake charge budget into time, scaled down as the battery runs low, and gives every phase a
+// deadline. Each deadline is a share of the allowance counted from the start of the wake, so time a phase
+// doesn't use is passed on to the next, and nothing can run past the end of the last one.
+class WakeBudget {
+	public:
+		/* Public Functions and Methods */
+		static void begin(float batteryVolts); // method to start this wake's allowance from the battery voltage
+		static unsigned long getAllowance(); // function to get the time this wake may take (ms)
+		static unsigned long getDeadline(BudgetPhase phase); // function to get the millis() by which a phase has to be over
+		static unsigned long timeLeft(BudgetPhase phase); // function to get the time left before a phase's deadline (ms, 0 = overrun)
+		static bool isSpent(); // function to check whether the whole allowance has been used
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
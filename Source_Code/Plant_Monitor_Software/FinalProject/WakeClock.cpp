@@ -0,0 +1,44 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "WakeClock.h"
+#include "RTCStore.h"
+#include "Hal.h"
+
+/* Variables */
+static uint64_t _elapsedMs = 0; // time since power up at the start of this wake
+
+static_assert(RTCStore::blocksFor(sizeof(_elapsedMs)) <= RTC_WAKE_CLOCK_BLOCKS, "WakeClock does not fit its RTC slot");
+
+/* Functions */
+
+// Function to restore the clock from RTC memory
+// Starts again from 0 if RTC memory was lost (power up, brown-out)
+bool WakeClock::begin() {
+  if (RTCStore::load(RTC_WAKE_CLOCK_SLOT, &_elapsedMs, sizeof(_elapsedMs))) {
+    return true;
+  }
+
+  _elapsedMs = 0;
+  return false;
+}
+
+// Function to get the seconds elapsed since power up
+uint32_t WakeClock::now() {
+  return (uint32_t)((_elapsedMs + Hal::millis()) / 1000);
+}
+
+// Method to account for time awake plus the coming sleep, then enter deep sleep
+// The deep sleep timer drifts by a few percent, so this is only as good as the RTC oscillator
+void WakeClock::deepSleep(uint64_t sleepTime, RFMode mode) {
+  _elapsedMs += Hal::millis() + (sleepTime / 1000);
+  RTCStore::save(RTC_WAKE_CLOCK_SLOT, &_elapsedMs, sizeof(_elapsedMs));
+
+  Hal::deepSleep(sleepTime, mode);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
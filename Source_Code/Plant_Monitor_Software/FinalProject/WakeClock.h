@@ -0,0 +1,24 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef WakeClock_h
+#define WakeClock_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+
+/* WakeClock class definition */
+// Keeps approximate time since power up across deep sleep, by adding up time spent awake and asleep
+class WakeClock {
+	public:
+		/* Public Functions and Methods */
+		static bool begin(); // function to restore the clock from RTC memory, returns false if it restarted from 0
+		static uint32_t now(); // function to get the seconds elapsed since power up
+		static void deepSleep(uint64_t sleepTime, RFMode mode=WAKE_RF_DEFAULT); // method to account for the sleep and then enter deep sleep (µs)
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
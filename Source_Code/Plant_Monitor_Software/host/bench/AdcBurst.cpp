@@ -0,0 +1,97 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Accuracy against bus time of MCP3008 burst reads, with gaussian and impulse noise injected by the SPI mock.
+// Sweeps the oversample count and filter at the derated per channel clocks, next to a single conversion per
+// channel at the old 18 kHz clock and the same bursts with every channel at the full clock.
+// Fails if the firmware's setting (SENSOR_OVERSAMPLES, median) is over its time or error limit.
+
+// Include necessary header files
+#include "SensorRegistry.h"
+#include "SimADC.h"
+#include "SimClock.h"
+#include "SimWorld.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Definitions */
+#define CHANNEL_COUNT 3
+#define TRIALS 300
+#define NOISE_SIGMA_LSB 2.0
+#define SPIKE_PER_MILLE 60
+#define SPIKE_LSB 150
+#define SLOW_SPI_FREQ 18000 // clock single reads used before burst reads
+#define LIMIT_US 5000 // the three channels at SENSOR_OVERSAMPLES
+#define LIMIT_RMS_LSB 1.5
+
+/* Result of one configuration */
+struct BurstResult {
+  double rmsLsb; // error of the filtered readings
+  double us; // bus time of a burst of the three channels
+};
+
+/* Constants */
+static const int _CHANNELS[CHANNEL_COUNT] = { LightSensor::channel, TemperatureSensor::channel, MoistureSensor<MOISTURE_SENSOR_CH>::channel };
+static const uint32_t _DERATED[CHANNEL_COUNT] = { SensorMetrics::burstClock(LightSensor::sourceOhms),
+                                                  SensorMetrics::burstClock(TemperatureSensor::sourceOhms),
+                                                  SensorMetrics::burstClock(MoistureSensor<MOISTURE_SENSOR_CH>::sourceOhms) };
+static const uint32_t _FULL_SPEED[CHANNEL_COUNT] = { EXTERN_ADC_BURST_FREQ, EXTERN_ADC_BURST_FREQ, EXTERN_ADC_BURST_FREQ };
+static const uint32_t _SLOW[CHANNEL_COUNT] = { SLOW_SPI_FREQ, SLOW_SPI_FREQ, SLOW_SPI_FREQ };
+
+/* Functions */
+
+// Function to time and score TRIALS bursts of one configuration
+static BurstResult runBursts(const uint32_t* clocks, int oversamples, ADCFilter filter) {
+  ADCReading readings[CHANNEL_COUNT];
+  double errorSq = 0;
+  uint64_t start = SimClock::now();
+
+  SimADC::setNoise(NOISE_SIGMA_LSB, SPIKE_PER_MILLE, SPIKE_LSB, 3);
+  for (int t = 0; t < TRIALS; t++) {
+    SensorMetrics::burstReadExternADC(_CHANNELS, clocks, CHANNEL_COUNT, oversamples, filter, readings);
+    for (int c = 0; c < CHANNEL_COUNT; c++) {
+      errorSq += pow(readings[c].value - SimADC::idealCode(SimADC::pinVolts(_CHANNELS[c])), 2);
+    }
+  }
+
+  return { sqrt(errorSq / (TRIALS * CHANNEL_COUNT)), (double)(SimClock::now() - start) / TRIALS };
+}
+
+int main() {
+  static const int OVERSAMPLES[] = { 1, 3, 5, 9, 15, 31 };
+  BurstResult setting = { 0, 0 };
+
+  SimWorld::setPlant(1.88, 1.41, 1.0);
+  SensorMetrics::setupExternADC();
+  SensorMetrics::externADCOn(_CHANNELS, _DERATED, CHANNEL_COUNT);
+
+  printf("MCP3008 burst reads, %.0f LSB gaussian noise and %d/1000 impulses of %d LSB\n", NOISE_SIGMA_LSB, SPIKE_PER_MILLE, SPIKE_LSB);
+  BurstResult slow = runBursts(_SLOW, 1, ADC_FILTER_MEDIAN);
+  printf("single conversions at %u Hz        %8.1f us  %6.2f LSB rms\n", SLOW_SPI_FREQ, slow.us, slow.rmsLsb);
+
+  printf("oversamples   median (derated)          trimmed mean (derated)    median (all at %u Hz)\n", EXTERN_ADC_BURST_FREQ);
+  for (size_t i = 0; i < sizeof(OVERSAMPLES) / sizeof(OVERSAMPLES[0]); i++) {
+    BurstResult median = runBursts(_DERATED, OVERSAMPLES[i], ADC_FILTER_MEDIAN);
+    BurstResult trimmed = runBursts(_DERATED, OVERSAMPLES[i], ADC_FILTER_TRIMMED_MEAN);
+    BurstResult fast = runBursts(_FULL_SPEED, OVERSAMPLES[i], ADC_FILTER_MEDIAN);
+
+    printf("%11d   %8.1f us %6.2f LSB   %8.1f us %6.2f LSB   %8.1f us %6.2f LSB\n", OVERSAMPLES[i],
+           median.us, median.rmsLsb, trimmed.us, trimmed.rmsLsb, fast.us, fast.rmsLsb);
+    if (OVERSAMPLES[i] == SENSOR_OVERSAMPLES) {
+      setting = median;
+    }
+  }
+
+  SensorMetrics::externADCOff();
+
+  bool f_Pass = (setting.us > 0 && setting.us <= LIMIT_US && setting.rmsLsb <= LIMIT_RMS_LSB);
+  if (!f_Pass) {
+    printf("%d oversamples with the median is over the limit of %d us / %.1f LSB\n", SENSOR_OVERSAMPLES, LIMIT_US, LIMIT_RMS_LSB);
+  }
+  return f_Pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
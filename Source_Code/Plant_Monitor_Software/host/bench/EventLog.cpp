@@ -0,0 +1,152 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Cost of logging: host time per record put in the RTC ring (event ID, varint argument, CRC and save), next to
+// the virtual time the same line takes printed over Serial at 115200 baud as it was before the ring, and a
+// call compiled out below LOG_LEVEL. Also how many records of a typical email wake the ring holds.
+// Fails if a record costs more than LIMIT_NS, or the ring can't hold a whole wake at the default level and
+// MIN_DEBUG_RECORDS of one logged at DEBUG.
+
+// Level the bench is built at, so LOG_DEBUG calls compile to nothing
+#define LOG_LEVEL LOG_LEVEL_INFO
+#define LOG_ECHO 0
+
+// Include necessary header files
+#include "EventLog.h"
+#include "SimClock.h"
+#include "SimNode.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Definitions */
+#define PASSES 20000 // times the wake's records are written
+#define NS_PER_S 1e9
+#define LIMIT_NS 2000 // host time per record
+#define MIN_DEBUG_RECORDS 16 // more than three times the five records of format pointers it held before
+#define CALL(event, arg) { EVENT_##event, arg, EVENT_LEVEL_##event }
+
+/* One logging call of a wake */
+struct LogCall {
+  LogEvent event;
+  long arg;
+  int level; // as listed in LogEvents.h
+};
+
+/* Constants */
+// What an email wake logs at DEBUG, in order
+static const LogCall _WAKE[] = {
+  CALL(WAKE_ALLOWANCE, 14000), CALL(CONNECTING, 0), CALL(SENSORS_SETTLED, 120), CALL(SAMPLES_HELD, 6),
+  CALL(CONNECTED, 812), CALL(ATTEMPT, 1), CALL(SMTP_CONNECTED, 0), CALL(SMTP_GREETING, 0),
+  CALL(SMTP_REPLY, 220), CALL(SMTP_EHLO, 0), CALL(SMTP_REPLY, 250), CALL(SMTP_AUTH_PLAIN, 0),
+  CALL(SMTP_REPLY, 235), CALL(SMTP_PIPELINE, 0), CALL(SMTP_REPLY, 250), CALL(SMTP_REPLY, 250),
+  CALL(SMTP_REPLY, 354), CALL(SMTP_BODY, 0), CALL(SMTP_EOM, 0), CALL(SMTP_REPLY, 250), CALL(SMTP_QUIT, 0),
+  CALL(EMAIL_SENT, 0), CALL(SMOOTHED_RTT, 140), CALL(FREE_HEAP, 31456), CALL(DEEP_SLEEP, 600)
+};
+static const int _WAKE_CALLS = sizeof(_WAKE) / sizeof(_WAKE[0]);
+
+/* Variables */
+static volatile int _sink; // keeps the stripped calls' surroundings from being optimised away
+
+/* Functions */
+
+// Function to get the host ns between two clock readings
+static double elapsedNs(const timespec& start, const timespec& end) {
+  return ((end.tv_sec - start.tv_sec) * NS_PER_S) + (end.tv_nsec - start.tv_nsec);
+}
+
+// Function to get the host ns per record written to the ring
+static double timeRing() {
+  timespec start, end;
+
+  EventLog::flush(Serial);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int p = 0; p < PASSES; p++) {
+    for (int c = 0; c < _WAKE_CALLS; c++) {
+      EventLog::write(_WAKE[c].event, _WAKE[c].arg);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  return elapsedNs(start, end) / ((double)PASSES * _WAKE_CALLS);
+}
+
+// Function to get the host ns per logging call compiled out below LOG_LEVEL
+static double timeStripped() {
+  timespec start, end;
+  int count = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int p = 0; p < PASSES; p++) {
+    for (int c = 0; c < _WAKE_CALLS; c++) {
+      LOG_DEBUG(SMTP_REPLY, _WAKE[c].arg);
+      count++;
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  _sink = count;
+  return elapsedNs(start, end) / ((double)PASSES * _WAKE_CALLS);
+}
+
+// Function to get the virtual µs per line of printing each record straight over Serial
+static double timeSerial() {
+  uint64_t us = 0;
+
+  EventLog::flush(Serial);
+  for (int c = 0; c < _WAKE_CALLS; c++) {
+    EventLog::write(_WAKE[c].event, _WAKE[c].arg);
+    uint64_t start = SimClock::now();
+    EventLog::flush(Serial); // the one record, as the blocking print did it
+    us += SimClock::now() - start;
+  }
+  return (double)us / _WAKE_CALLS;
+}
+
+// Function to get how many records of the wake, logged at maxLevel, the ring holds once it has wrapped
+// calls is set to the number the wake logs at that level
+static int ringHolds(int maxLevel, int& calls, int& bytes) {
+  EventLog::flush(Serial);
+  calls = 0;
+  for (int p = 0; p < 4; p++) {
+    for (int c = 0; c < _WAKE_CALLS; c++) {
+      if (_WAKE[c].level <= maxLevel) {
+        EventLog::write(_WAKE[c].event, _WAKE[c].arg);
+        calls += (p == 0) ? 1 : 0;
+      }
+    }
+  }
+  bytes = EventLog::getBytesUsed();
+  return EventLog::getCount();
+}
+
+int main() {
+  SimNode::powerCycle();
+  EventLog::begin();
+
+  double ringNs = timeRing();
+  double strippedNs = timeStripped();
+  double serialUs = timeSerial();
+  int calls = 0, bytes = 0;
+
+  printf("email wake: %d records logged at DEBUG\n", _WAKE_CALLS);
+  printf("ring record               %8.1f ns host (ID, varint, CRC and RTC save)\n", ringNs);
+  printf("compiled out (LOG_DEBUG)  %8.1f ns host\n", strippedNs);
+  printf("printed over Serial       %8.1f us per line at 115200 baud\n", serialUs);
+
+  int heldDebug = ringHolds(LOG_LEVEL_DEBUG, calls, bytes);
+  printf("ring holds %d of the %d records at DEBUG in %d bytes (%.1f bytes a record)\n",
+         heldDebug, calls, bytes, (double)bytes / heldDebug);
+  int heldInfo = ringHolds(LOG_LEVEL_INFO, calls, bytes);
+  printf("ring holds %d records at INFO, %.1f wakes of %d\n", heldInfo, (double)heldInfo / calls, calls);
+
+  bool f_Pass = (ringNs <= LIMIT_NS && heldDebug >= MIN_DEBUG_RECORDS && heldInfo >= calls);
+  if (!f_Pass) {
+    printf("logging is over its limit of %d ns a record, or the ring holds too little of a wake\n", LIMIT_NS);
+  }
+  return f_Pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
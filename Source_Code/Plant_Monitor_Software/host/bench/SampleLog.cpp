@@ -0,0 +1,127 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Size and speed of the flash backlog over a synthetic week of readings every ten minutes (daylight, a daily
+// temperature swing, soil drying out between waterings, a slowly draining battery, each with sensor noise):
+// flash bytes a record against the same readings as floats, packed as in the sample buffer and as CBOR in a
+// UDP report, then host and virtual flash time to append and to read back. Every reading must come back as
+// packed. Fails if a record takes more than LIMIT_BYTES_PER_RECORD of flash or LIMIT_APPEND_US of flash time.
+
+// Include necessary header files
+#include "SampleBuffer.h"
+#include "SampleLog.h"
+#include "SimClock.h"
+#include "SimFlash.h"
+#include "SimNode.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Definitions */
+#define WEEK_S (7 * 24 * 3600)
+#define INTERVAL_S 600 // between readings
+#define RECORDS (WEEK_S / INTERVAL_S)
+#define DAY_S (24 * 3600)
+#define WATERING_S (3 * DAY_S + 9 * 3600) // soil is watered once, three and a half days in
+#define NS_PER_S 1e9
+#define RAW_BYTES (4 + (SAMPLE_SENSOR_COUNT * 4)) // time and the readings as float
+#define PACKED_BYTES (4 + (SAMPLE_SENSOR_COUNT * 2)) // time and the readings packed to 16 bits
+#define CBOR_BYTES (1 + 5 + (SAMPLE_SENSOR_COUNT * 5)) // a "b" entry of a UDP report: array head, time, floats
+#define LIMIT_BYTES_PER_RECORD 8.0
+#define LIMIT_APPEND_US 5000 // virtual flash time of an append, open and write
+
+/* Variables */
+static uint32_t _random = 12345; // noise generator state, fixed so every run sees the same week
+static int16_t _expected[RECORDS][SAMPLE_SENSOR_COUNT]; // readings as packed, to check the read back against
+
+/* Functions */
+
+// Function to get uniform noise in [-1, 1)
+static double noise() {
+  _random = (_random * 1103515245U) + 12345U;
+  return (((_random >> 8) & 0xFFFF) / 32768.0) - 1;
+}
+
+// Method to fill in the readings taken t seconds into the week
+static void makeReadings(uint32_t t, float* sensors) {
+  double day = fmod(t, DAY_S) / DAY_S;
+  double sun = sin((day - 0.25) * 2 * M_PI); // above 0 from 6:00 to 18:00
+  double dried = (t < WATERING_S) ? t : (t - WATERING_S);
+
+  sensors[0] = (sun > 0) ? (float)((18000 * sun) + (400 * noise())) : 0; // lux
+  sensors[1] = (float)(71 + (4 * sun) + (0.3 * noise())); // ºF
+  sensors[2] = (float)(62 - (dried * 8.0 / DAY_S) + (0.4 * noise())); // %
+  sensors[3] = (float)(3.95 - (t * 0.06 / WEEK_S) + (0.004 * noise())); // V
+}
+
+// Function to get the host ns between two clock readings
+static double elapsedNs(const timespec& start, const timespec& end) {
+  return ((end.tv_sec - start.tv_sec) * NS_PER_S) + (end.tv_nsec - start.tv_nsec);
+}
+
+int main() {
+  float sensors[SAMPLE_SENSOR_COUNT];
+  int16_t values[SAMPLE_SENSOR_COUNT];
+  timespec start, end;
+  uint32_t time;
+  bool f_Pass = true;
+
+  SimFlash::erase();
+  SimNode::powerCycle();
+  SampleBuffer::begin();
+
+  // A week of readings into the log
+  uint64_t flashBytes = SimFlash::getStats().bytesWritten;
+  uint64_t virtualStart = SimClock::now();
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int r = 0; r < RECORDS; r++) {
+    makeReadings(r * INTERVAL_S, sensors);
+    NodeSensors::pack(sensors, _expected[r]);
+    f_Pass = SampleLog::append(r * INTERVAL_S, sensors) && f_Pass;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double appendNs = elapsedNs(start, end) / RECORDS;
+  double appendUs = (double)(SimClock::now() - virtualStart) / RECORDS;
+  flashBytes = SimFlash::getStats().bytesWritten - flashBytes;
+  int segments = SampleLog::getSegmentCount();
+
+  // And all of it back
+  int read = 0;
+  virtualStart = SimClock::now();
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  SampleLog::rewind(LOG_MAX_SEGMENTS);
+  while (SampleLog::readNext(time, sensors)) {
+    NodeSensors::pack(sensors, values);
+    if (read >= RECORDS || time != (uint32_t)(read * INTERVAL_S) || memcmp(values, _expected[read], sizeof(values)) != 0) {
+      f_Pass = false;
+    }
+    read++;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double readNs = elapsedNs(start, end) / RECORDS;
+  double readUs = (double)(SimClock::now() - virtualStart) / RECORDS;
+
+  double perRecord = (double)flashBytes / RECORDS;
+  printf("a week of readings every %d s: %d records in %d segments, %llu bytes of flash\n", INTERVAL_S, RECORDS, segments,
+         (unsigned long long)flashBytes);
+  printf("bytes a record   %5.2f log   %2d floats (%4.1fx)   %2d packed (%4.1fx)   %2d CBOR report entry (%4.1fx)\n",
+         perRecord, RAW_BYTES, RAW_BYTES / perRecord, PACKED_BYTES, PACKED_BYTES / perRecord, CBOR_BYTES, CBOR_BYTES / perRecord);
+  printf("append           %8.1f ns host   %8.1f us flash\n", appendNs, appendUs);
+  printf("read back        %8.1f ns host   %8.1f us flash\n", readNs, readUs);
+
+  if (read != RECORDS) {
+    printf("%d of the %d records came back\n", read, RECORDS);
+    f_Pass = false;
+  }
+  if (perRecord > LIMIT_BYTES_PER_RECORD || appendUs > LIMIT_APPEND_US) {
+    printf("over the limit of %.1f bytes / %d us a record\n", LIMIT_BYTES_PER_RECORD, LIMIT_APPEND_US);
+    f_Pass = false;
+  }
+  return f_Pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,93 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Host time per conversion of a reading to lux and to Kelvin: the compile time tables (SensorMetrics::adcToLux()
+// and adcToTempK(), a lookup and an interpolation) next to the float formulas they replace (pow() and log()).
+// Host nanoseconds only rank the two; the ESP8266 has no FPU, which widens the gap there.
+// Fails if a table is slower than its formula.
+
+// Include necessary header files
+#include "SensorMetrics.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Definitions */
+// Calibration as in SensorMetrics.cpp, for the float formulas
+#define EXTERN_ADC_V 2.84f
+#define ADC_RESOLUTION 1024
+#define PHOTORESISTOR_R2 9830
+#define PHOTORESISTOR_M -1.1116f
+#define PHOTORESISTOR_B 7.3113f
+#define THERMISTOR_R2 9930
+#define THERMISTOR_BETA 3974
+#define THERMISTOR_R0 10000
+#define THERMISTOR_T0 298.15f
+
+#define PASSES 2000 // sweeps over every code, and a fraction between codes
+#define NS_PER_S 1e9
+
+/* Variables */
+static volatile float _sink; // keeps the conversions from being optimised away
+
+/* Functions */
+
+// Function to get R1 of a divider from a reading, as getVDivR1() does
+static float divR1(float adc, int r2) {
+  float vMeas = ((adc + 1) / ADC_RESOLUTION) * EXTERN_ADC_V;
+  return ((EXTERN_ADC_V * r2) - (vMeas * r2)) / vMeas;
+}
+
+// Photoresistor curve in float, as calcLux() does it
+static float formulaLux(float adc, bool) {
+  return powf(divR1(adc, PHOTORESISTOR_R2), PHOTORESISTOR_M) * powf(10, PHOTORESISTOR_B);
+}
+
+// Thermistor Beta equation in float, as calcTempK() does it
+static float formulaTempK(float adc, bool) {
+  float ratio = logf(THERMISTOR_R0 / divR1(adc, THERMISTOR_R2));
+  return ((THERMISTOR_T0 * THERMISTOR_BETA) / ratio) / ((THERMISTOR_BETA / ratio) - THERMISTOR_T0);
+}
+
+// Function to get the host ns per conversion of one converter over the reading range
+static double timeConversion(float (*convert)(float, bool)) {
+  timespec start, end;
+  float sum = 0;
+
+  for (int code = 1; code < ADC_RESOLUTION - 1; code++) { // warm the caches before timing
+    sum += convert(code, true);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int p = 0; p < PASSES; p++) {
+    for (int code = 1; code < ADC_RESOLUTION - 1; code++) {
+      sum += convert(code + 0.375f, true);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  _sink = sum;
+  double ns = ((end.tv_sec - start.tv_sec) * NS_PER_S) + (end.tv_nsec - start.tv_nsec);
+  return ns / ((double)PASSES * (ADC_RESOLUTION - 2));
+}
+
+int main() {
+  double tableLux = timeConversion(SensorMetrics::adcToLux);
+  double floatLux = timeConversion(formulaLux);
+  double tableTemp = timeConversion(SensorMetrics::adcToTempK);
+  double floatTemp = timeConversion(formulaTempK);
+
+  printf("conversion     table        float formula\n");
+  printf("lux          %6.1f ns      %6.1f ns\n", tableLux, floatLux);
+  printf("Kelvin       %6.1f ns      %6.1f ns\n", tableTemp, floatTemp);
+
+  bool f_Pass = (tableLux < floatLux && tableTemp < floatTemp);
+  if (!f_Pass) {
+    printf("a table lookup is slower than the formula it replaces\n");
+  }
+  return f_Pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
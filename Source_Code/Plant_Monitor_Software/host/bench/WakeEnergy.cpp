@@ -0,0 +1,170 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Awake time and energy of each phase of a wake, for one way of delivering reports.
+// The node is powered up and run through a run of timer wakes while the soil slowly dries (so reports go
+// out as batches fill). The power up wake (startup wait, first report with a full TLS handshake where there is
+// one) is shown on its own, then every timer wake is classed as a hold (readings kept, radio off) or a report.
+// Fails if a class runs over its limit.
+
+// Include necessary header files
+#include "Profiler.h"
+#include "SimClock.h"
+#include "SimFlash.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include "SimWorld.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Definitions */
+#define BENCH_EMAIL 0 // Gmail over TLS
+#define BENCH_RELAY 1 // the collector's plain SMTP relay
+#define BENCH_UDP 2 // a CBOR datagram to the collector
+
+#define TIMER_WAKES 60 // wakes after the power up one
+#define DRY_VOLTS_PER_WAKE 0.004 // moisture probe output rises as the soil dries
+#define US_PER_MS 1000.0
+
+// Limits a wake of each class must stay under on average (ms awake, mJ drawn)
+#define HOLD_LIMIT_MS 150
+#define HOLD_LIMIT_MJ 10
+#if BENCH_VARIANT == BENCH_EMAIL
+#define BENCH_NAME "email (Gmail, TLS)"
+#define RTT_MS 60
+#define POWER_UP_LIMIT_MS 12500 // 5 s startup wait, channel scan, formatting the flash and a full handshake
+#define POWER_UP_LIMIT_MJ 3000
+#define REPORT_LIMIT_MS 1200
+#define REPORT_LIMIT_MJ 300
+#elif BENCH_VARIANT == BENCH_RELAY
+#define BENCH_NAME "email (collector relay)"
+#define RTT_MS 4
+#define POWER_UP_LIMIT_MS 10000
+#define POWER_UP_LIMIT_MJ 2400
+#define REPORT_LIMIT_MS 450
+#define REPORT_LIMIT_MJ 110
+#else
+#define BENCH_NAME "udp"
+#define RTT_MS 4
+#define POWER_UP_LIMIT_MS 10000
+#define POWER_UP_LIMIT_MJ 2400
+#define REPORT_LIMIT_MS 400
+#define REPORT_LIMIT_MJ 100
+#endif
+
+/* Kinds of wake */
+enum WakeClass {
+	CLASS_POWER_UP,
+	CLASS_HOLD,
+	CLASS_REPORT,
+	CLASS_COUNT
+};
+
+/* Totals for one kind of wake */
+struct ClassTotals {
+	uint32_t wakes;
+	double awakeMs;
+	double mj;
+	double sleepMj;
+	double phaseMs[PHASE_COUNT];
+	double phaseMj[PHASE_COUNT];
+};
+
+/* Constants */
+static const char* const _CLASS_NAMES[CLASS_COUNT] = { "power up", "hold", "report" };
+static const char* const _PHASE_NAMES[PHASE_COUNT] = { "awake", "startup", "sensors", "wifi", "tls", "reply", "report" };
+
+// Sketch entry point
+void setup();
+
+/* Functions */
+
+// Method to add a wake to the totals of its class
+static void addWake(ClassTotals& t, const SimWake& wake) {
+  t.wakes++;
+  t.awakeMs += wake.awakeUs / US_PER_MS;
+  t.mj += wake.energy.totalMj;
+  t.sleepMj += SimEnergy::sleepMj(wake.sleepUs);
+  for (int p = 0; p < PHASE_COUNT; p++) {
+    t.phaseMs[p] += wake.energy.phaseUs[p] / US_PER_MS;
+    t.phaseMj[p] += wake.energy.phaseMj[p];
+  }
+}
+
+// Function to print one kind of wake, returns false if it is over its limits
+static bool printClass(WakeClass c, const ClassTotals& totals, double limitMs, double limitMj) {
+  if (totals.wakes == 0) {
+    return true;
+  }
+
+  double awakeMs = totals.awakeMs / totals.wakes;
+  double mj = totals.mj / totals.wakes;
+  printf("%-13s wakes=%-3u awake=%8.1f ms  energy=%7.2f mJ  (+%.2f mJ asleep)\n",
+         _CLASS_NAMES[c], totals.wakes, awakeMs, mj, totals.sleepMj / totals.wakes);
+  for (int p = PHASE_STARTUP; p < PHASE_COUNT; p++) {
+    if (totals.phaseMs[p] > 0) {
+      printf("    %-8s %8.1f ms %7.2f mJ\n", _PHASE_NAMES[p], totals.phaseMs[p] / totals.wakes, totals.phaseMj[p] / totals.wakes);
+    }
+  }
+
+  bool f_Within = (awakeMs <= limitMs && mj <= limitMj);
+  if (!f_Within) {
+    printf("    over the limit of %.0f ms / %.0f mJ\n", limitMs, limitMj);
+  }
+  return f_Within;
+}
+
+int main() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+  ClassTotals totals[CLASS_COUNT] = {};
+  double moisture = 1.0;
+  bool f_Pass = true;
+
+  SimWorld::setUp(gmail, relay, listener);
+  SimWorld::setPlant(1.88, 1.41, moisture);
+  SimNetwork::link().rttMs = RTT_MS;
+  SimFlash::erase();
+  SimNode::powerCycle();
+
+  if (SimNode::wake(setup).result != WAKE_SLEPT) {
+    printf("power up wake did not sleep\n");
+    return EXIT_FAILURE;
+  }
+  addWake(totals[CLASS_POWER_UP], SimNode::lastWake());
+
+  for (int w = 0; w < TIMER_WAKES; w++) {
+    uint32_t sessions = gmail.getStats().sessions + relay.getStats().sessions + listener.getStats().datagrams;
+
+    moisture += DRY_VOLTS_PER_WAKE;
+    SimWorld::setPlant(1.88, 1.41, moisture);
+    const SimWake& wake = SimNode::wake(setup);
+    if (wake.result != WAKE_SLEPT) {
+      printf("wake %d ended with result %d\n", w, (int)wake.result);
+      return EXIT_FAILURE;
+    }
+
+    bool f_Report = (gmail.getStats().sessions + relay.getStats().sessions + listener.getStats().datagrams) != sessions;
+    addWake(totals[f_Report ? CLASS_REPORT : CLASS_HOLD], wake);
+  }
+
+  printf("Wake energy, reports by %s, %u ms round trip\n", BENCH_NAME, (unsigned)RTT_MS);
+  f_Pass &= printClass(CLASS_POWER_UP, totals[CLASS_POWER_UP], POWER_UP_LIMIT_MS, POWER_UP_LIMIT_MJ);
+  f_Pass &= printClass(CLASS_HOLD, totals[CLASS_HOLD], HOLD_LIMIT_MS, HOLD_LIMIT_MJ);
+  f_Pass &= printClass(CLASS_REPORT, totals[CLASS_REPORT], REPORT_LIMIT_MS, REPORT_LIMIT_MJ);
+
+  const SimNetStats& net = SimNetwork::getStats();
+  printf("network: %u joins (%u fast), %u TLS handshakes (%u resumed), %u datagrams\n",
+         net.associations, net.fastAssociations, net.fullHandshakes + net.resumedHandshakes, net.resumedHandshakes, net.datagrams);
+
+  if (totals[CLASS_REPORT].wakes == 0) {
+    printf("no report was sent\n");
+    f_Pass = false;
+  }
+  return f_Pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,90 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "../sim/SimADC.h"
+#include "../sim/SimBoard.h"
+#include "../sim/SimClock.h"
+
+/* Definitions */
+#define US_PER_MS 1000
+
+/* Variables */
+static uint64_t _random = 88172645463325252ULL; // xorshift state of random(), seeded by randomSeed()
+static uint64_t _secureRandom = 0x2545F4914F6CDD1DULL; // hardware RNG stand-in
+
+/* Functions */
+
+// Function to draw 64 random bits (xorshift64)
+static uint64_t nextRandom(uint64_t& state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+// Method to wait in virtual time
+void delay(unsigned long ms) {
+  SimClock::advance((uint64_t)ms * US_PER_MS);
+}
+
+// Method to let virtual time move on a little (one pass of the WiFi stack)
+void yield() {
+  SimClock::advance(SIM_YIELD_US);
+}
+
+// Functions to get the virtual time since boot, wrapping as the core's do
+unsigned long millis() {
+  return (uint32_t)(SimClock::now() / US_PER_MS);
+}
+
+unsigned long micros() {
+  return (uint32_t)SimClock::now();
+}
+
+// GPIO, wired up by SimBoard
+void pinMode(uint8_t pin, uint8_t mode) {
+  SimBoard::pinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  SimBoard::digitalWrite(pin, value);
+}
+
+int digitalRead(uint8_t pin) {
+  return SimBoard::digitalRead(pin);
+}
+
+// Function to read the internal ADC (only A0 exists)
+int analogRead(uint8_t pin) {
+  return (pin == A0) ? SimADC::readInternal() : 0;
+}
+
+// Function to re-map a number from one range to another
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return ((x - inMin) * (outMax - outMin) / (inMax - inMin)) + outMin;
+}
+
+// Functions to get pseudo random numbers
+long random(long howBig) {
+  return (howBig > 0) ? (long)(nextRandom(_random) % (uint64_t)howBig) : 0;
+}
+
+long random(long howSmall, long howBig) {
+  return (howSmall < howBig) ? (howSmall + random(howBig - howSmall)) : howSmall;
+}
+
+void randomSeed(unsigned long seed) {
+  _random = (seed != 0) ? seed : 1;
+}
+
+// Function to get a number from the hardware RNG
+// Kept separate from random() so seeding the latter doesn't make these repeat
+long secureRandom(long howBig) {
+  return (howBig > 0) ? (long)(nextRandom(_secureRandom) % (uint64_t)howBig) : 0;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,85 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+// Host stand-in for the parts of the ESP8266 Arduino core the firmware uses. Everything that touches
+// hardware (time, pins, ADC, RTC memory, sleep) is answered by the simulation models in ../sim.
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+/* Definitions */
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x00
+#define INPUT_PULLUP 0x02
+#define OUTPUT 0x01
+
+#define A0 17 // the only analog pin
+
+#define B00000001 1
+
+// Flash strings live in ordinary memory on the host
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+#define FPSTR(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t*>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t*>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t*>(addr))
+#define pgm_read_float(addr) (*reinterpret_cast<const float*>(addr))
+#define pgm_read_ptr(addr) (*reinterpret_cast<const void* const*>(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncpy_P strncpy
+#define strchr_P strchr
+
+class __FlashStringHelper;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+
+template <class T, class L, class H>
+inline T constrain(T value, L low, H high) { return (value < low) ? low : ((value > high) ? high : value); }
+
+/* Functions */
+void delay(unsigned long ms); // waits in virtual time
+void yield(); // lets virtual time move on a little
+unsigned long millis(); // virtual ms since boot
+unsigned long micros(); // virtual µs since boot
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+long secureRandom(long howBig);
+
+// Include the rest of the core the sketch sees through Arduino.h
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "Esp.h"
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,91 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "EEPROM.h"
+#include "../sim/SimFlash.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+/* Definitions */
+#define EEPROM_SECTOR_SIZE 4096 // largest size begin() accepts
+#define ERASED 0xFF // what unwritten flash reads as
+
+/* Variables */
+EEPROMClass EEPROM;
+
+/* Functions */
+
+// Function to get where the sector is kept
+static std::string sectorPath() {
+  return std::string(SimFlash::root()) + "/eeprom.bin";
+}
+
+// Method to read the sector into RAM, an unwritten sector reads as all 0xFF
+void EEPROMClass::begin(size_t size) {
+  size = (size > EEPROM_SECTOR_SIZE) ? EEPROM_SECTOR_SIZE : size;
+  delete[] _data;
+  _data = new uint8_t[size];
+  _size = size;
+  _dirty = false;
+  memset(_data, ERASED, size);
+
+  FILE* sector = fopen(sectorPath().c_str(), "rb");
+  if (sector != NULL) {
+    size_t read = fread(_data, 1, size, sector);
+    fclose(sector);
+    SimFlash::stats().bytesRead += read;
+  }
+  SimFlash::charge(SIM_FLASH_OPEN_US + (uint64_t)(size * SIM_FLASH_READ_US_PER_BYTE));
+}
+
+// Function to write the sector back if it was changed (erase and rewrite)
+bool EEPROMClass::commit() {
+  if (_data == NULL) {
+    return false;
+  }
+  if (!_dirty) {
+    return true;
+  }
+
+  FILE* sector = fopen(sectorPath().c_str(), "wb");
+  if (sector == NULL) {
+    return false;
+  }
+  bool written = (fwrite(_data, 1, _size, sector) == _size);
+  fclose(sector);
+
+  SimFlash::charge(SIM_FLASH_COMMIT_US);
+  SimFlash::stats().commits++;
+  SimFlash::stats().bytesWritten += _size;
+  _dirty = !written;
+  return written;
+}
+
+// Function to commit and free the RAM copy
+bool EEPROMClass::end() {
+  bool committed = commit();
+
+  delete[] _data;
+  _data = NULL;
+  _size = 0;
+  return committed;
+}
+
+// Function to read a byte
+uint8_t EEPROMClass::read(int address) {
+  return (_data != NULL && address >= 0 && (size_t)address < _size) ? _data[address] : 0;
+}
+
+// Method to change a byte
+void EEPROMClass::write(int address, uint8_t value) {
+  if (_data != NULL && address >= 0 && (size_t)address < _size && _data[address] != value) {
+    _data[address] = value;
+    _dirty = true;
+  }
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,40 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+
+/* EEPROMClass class definition */
+// The core's flash sector EEPROM emulation, kept in eeprom.bin under the simulated flash (SimFlash)
+class EEPROMClass {
+	public:
+		/* Constructors */
+		EEPROMClass() : _data(NULL), _size(0), _dirty(false) { }
+
+		/* Public Functions and Methods */
+		void begin(size_t size); // method to read the sector into RAM
+		bool commit(); // function to write the sector back if it was changed
+		bool end(); // function to commit and free the RAM copy
+		uint8_t read(int address); // function to read a byte
+		void write(int address, uint8_t value); // method to change a byte
+		const uint8_t* getConstDataPtr() const { return _data; } // function to get the RAM copy
+		uint8_t* getDataPtr() { _dirty = true; return _data; } // function to get the RAM copy for changing
+		size_t length() const { return _size; }
+	private:
+		/* Private Instance Variables */
+		uint8_t* _data; // RAM copy of the sector
+		size_t _size;
+		bool _dirty; // changed since it was read
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
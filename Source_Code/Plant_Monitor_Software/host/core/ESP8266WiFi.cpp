@@ -0,0 +1,124 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "ESP8266WiFi.h"
+#include "lwip/dhcp.h"
+#include "../sim/SimNetwork.h"
+
+/* Variables */
+ESP8266WiFiClass WiFi;
+static struct dhcp _dhcp; // the station's DHCP client
+static struct netif _station = { &_dhcp };
+struct netif* netif_default = &_station;
+static bool _leased = false; // whether the station joined with DHCP rather than a static configuration
+
+/* Constants */
+// Lease the access point's DHCP server hands out
+static const IPAddress _LEASE_IP(192, 168, 1, 50);
+static const IPAddress _LEASE_GATEWAY(192, 168, 1, 1);
+static const IPAddress _LEASE_SUBNET(255, 255, 255, 0);
+static const IPAddress _LEASE_DNS(192, 168, 1, 1);
+
+/* Functions */
+
+// Method to power the station up or the radio down
+bool ESP8266WiFiClass::mode(WiFiMode_t mode) {
+  SimNetwork::setRadio(mode != WIFI_OFF);
+  return true;
+}
+
+// Method to use a static configuration, an all zero address goes back to DHCP
+bool ESP8266WiFiClass::config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns) {
+  _staticIP = local;
+  _staticGateway = gateway;
+  _staticSubnet = subnet;
+  _staticDns = dns.isSet() ? dns : gateway;
+  return true;
+}
+
+// Method to start joining, on the given channel and access point if they are known
+wl_status_t ESP8266WiFiClass::begin(const char* ssid, const char* pass, int32_t channel, const uint8_t* bssid, bool connect) {
+  (void)pass;
+  if (connect) {
+    _leased = !_staticIP.isSet();
+    SimNetwork::associate(ssid, channel, bssid, !_leased);
+  }
+  return status();
+}
+
+// Function to check how joining is going
+wl_status_t ESP8266WiFiClass::status() {
+  return SimNetwork::isAssociated() ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+// Method to leave the network
+bool ESP8266WiFiClass::disconnect(bool wifiOff) {
+  SimNetwork::disassociate();
+  if (wifiOff) {
+    SimNetwork::setRadio(false);
+  }
+  return true;
+}
+
+// Methods to power the modem down and back up
+bool ESP8266WiFiClass::forceSleepBegin() {
+  SimNetwork::setRadio(false);
+  return true;
+}
+
+bool ESP8266WiFiClass::forceSleepWake() {
+  SimNetwork::setRadio(true);
+  return true;
+}
+
+// Function to get the access point's MAC address
+uint8_t* ESP8266WiFiClass::BSSID() {
+  return SimNetwork::link().bssid;
+}
+
+// Function to get the channel the access point is on
+int32_t ESP8266WiFiClass::channel() {
+  return SimNetwork::link().channel;
+}
+
+// Functions to get the IP configuration, static if one was set, otherwise the lease
+IPAddress ESP8266WiFiClass::localIP() {
+  return _staticIP.isSet() ? _staticIP : _LEASE_IP;
+}
+
+IPAddress ESP8266WiFiClass::gatewayIP() {
+  return _staticIP.isSet() ? _staticGateway : _LEASE_GATEWAY;
+}
+
+IPAddress ESP8266WiFiClass::subnetMask() {
+  return _staticIP.isSet() ? _staticSubnet : _LEASE_SUBNET;
+}
+
+IPAddress ESP8266WiFiClass::dnsIP(uint8_t index) {
+  (void)index;
+  return _staticIP.isSet() ? _staticDns : _LEASE_DNS;
+}
+
+// Function to check whether the station's address came from the DHCP server, whose lease length it then holds
+uint8_t dhcp_supplied_address(const struct netif* netif) {
+  (void)netif;
+  _dhcp.offered_t0_lease = SimNetwork::link().leaseS;
+  return (_leased && SimNetwork::isAssociated()) ? 1 : 0;
+}
+
+// Function to look a name up (a dotted address needs no lookup)
+int ESP8266WiFiClass::hostByName(const char* name, IPAddress& result, uint32_t timeout_ms) {
+  uint32_t address = 0;
+
+  if (!SimNetwork::resolve(name, address, timeout_ms)) {
+    result = IPAddress((uint32_t)0);
+    return 0;
+  }
+  result = IPAddress(address);
+  return 1;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,63 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef ESP8266WiFi_h
+#define ESP8266WiFi_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "WiFiClientSecure.h"
+
+/* Definitions */
+enum WiFiMode_t {
+	WIFI_OFF = 0,
+	WIFI_STA = 1
+};
+
+enum wl_status_t {
+	WL_IDLE_STATUS = 0,
+	WL_NO_SSID_AVAIL = 1,
+	WL_CONNECTED = 3,
+	WL_CONNECT_FAILED = 4,
+	WL_DISCONNECTED = 6
+};
+
+/* ESP8266WiFiClass class definition */
+// Station interface, answered by the simulated access point (SimNetwork)
+class ESP8266WiFiClass {
+	public:
+		/* Public Functions and Methods */
+		void persistent(bool persistent) { (void)persistent; } // method to choose whether settings are written to flash (nothing is kept)
+		bool mode(WiFiMode_t mode); // method to power the station up or the radio down
+		bool hostname(const char* name) { (void)name; return true; } // method to set the DHCP host name
+		bool hostname(const String& name) { return hostname(name.c_str()); }
+		bool config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns=IPAddress((uint32_t)0)); // method to use a static configuration (0.0.0.0 = DHCP)
+		wl_status_t begin(const char* ssid, const char* pass=NULL, int32_t channel=0, const uint8_t* bssid=NULL, bool connect=true); // method to start joining
+		wl_status_t status(); // function to check how joining is going
+		bool disconnect(bool wifiOff=false); // method to leave the network (and turn the radio off)
+		bool forceSleepBegin(); // method to power the modem down
+		bool forceSleepWake(); // method to power the modem back up
+		uint8_t* BSSID(); // function to get the access point's MAC address
+		int32_t channel(); // function to get the channel the access point is on
+		IPAddress localIP(); // functions to get the IP configuration
+		IPAddress gatewayIP();
+		IPAddress subnetMask();
+		IPAddress dnsIP(uint8_t index=0);
+		int hostByName(const char* name, IPAddress& result, uint32_t timeout_ms=10000); // function to look a name up, returns 1 on success
+	private:
+		/* Private Instance Variables */
+		IPAddress _staticIP; // 0.0.0.0 while DHCP is used
+		IPAddress _staticGateway;
+		IPAddress _staticSubnet;
+		IPAddress _staticDns;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,81 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Esp.h"
+#include "../sim/SimClock.h"
+#include "../sim/SimHeap.h"
+#include "../sim/SimNode.h"
+#include <string.h>
+
+/* Definitions */
+#define RTC_USER_BYTES (SIM_RTC_BLOCKS * 4)
+#define CPU_MHZ 80
+#define CHIP_ID 0x00C0FFEE
+
+/* Variables */
+EspClass ESP;
+static rst_info _resetInfo;
+
+/* Functions */
+
+// Method to enter deep sleep, which ends the wake
+void EspClass::deepSleep(uint64_t time_us, RFMode mode) {
+  SimNode::halt(WAKE_SLEPT, time_us, mode);
+}
+
+// Function to read RTC user memory (offset in 4 byte blocks)
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size) {
+  if (offset > SIM_RTC_BLOCKS || size > RTC_USER_BYTES - (offset * 4)) {
+    return false;
+  }
+  memcpy(data, SimNode::rtcMemory() + offset, size);
+  return true;
+}
+
+// Function to write RTC user memory (offset in 4 byte blocks)
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size) {
+  if (offset > SIM_RTC_BLOCKS || size > RTC_USER_BYTES - (offset * 4)) {
+    return false;
+  }
+  memcpy(SimNode::rtcMemory() + offset, data, size);
+  return true;
+}
+
+// Function to get why the chip last started
+rst_info* EspClass::getResetInfoPtr() {
+  _resetInfo.reason = SimNode::resetReason();
+  return &_resetInfo;
+}
+
+// Function to get the CPU cycle counter
+uint32_t EspClass::getCycleCount() {
+  return (uint32_t)(SimClock::now() * CPU_MHZ);
+}
+
+// Functions to get the state of the heap, which String allocates from
+uint32_t EspClass::getFreeHeap() {
+  return SimHeap::getFreeBytes();
+}
+
+uint32_t EspClass::getMaxFreeBlockSize() {
+  return SimHeap::getMaxFreeBlock();
+}
+
+uint8_t EspClass::getHeapFragmentation() {
+  return SimHeap::getFragmentation();
+}
+
+// Function to get the chip ID
+uint32_t EspClass::getChipId() {
+  return CHIP_ID;
+}
+
+// Method to reboot, which ends the wake
+void EspClass::restart() {
+  SimNode::halt(WAKE_RESTARTED);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,62 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Esp_h
+#define Esp_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+
+/* Definitions */
+// Why the chip last started (rst_info::reason)
+#define REASON_DEFAULT_RST 0 // power up
+#define REASON_WDT_RST 1
+#define REASON_EXCEPTION_RST 2
+#define REASON_SOFT_WDT_RST 3
+#define REASON_SOFT_RESTART 4
+#define REASON_DEEP_SLEEP_AWAKE 5 // deep sleep timer
+#define REASON_EXT_SYS_RST 6 // reset pin
+
+// How the radio comes up after deep sleep
+enum RFMode {
+	RF_DEFAULT = 0, // calibrated and powered
+	RF_CAL = 1,
+	RF_NO_CAL = 2,
+	RF_DISABLED = 4 // off, and can't be turned on until the next boot
+};
+#define WAKE_RF_DEFAULT RF_DEFAULT
+#define WAKE_RFCAL RF_CAL
+#define WAKE_NO_RFCAL RF_NO_CAL
+#define WAKE_RF_DISABLED RF_DISABLED
+
+/* Reset information */
+struct rst_info {
+	uint32_t reason; // REASON_ constant
+};
+
+/* EspClass class definition */
+// Chip level functions, answered by the simulated node (SimNode)
+class EspClass {
+	public:
+		/* Public Functions and Methods */
+		void deepSleep(uint64_t time_us, RFMode mode=RF_DEFAULT); // method to end the wake (does not return)
+		bool rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size); // function to read RTC user memory (offset in blocks)
+		bool rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size); // function to write RTC user memory (offset in blocks)
+		rst_info* getResetInfoPtr(); // function to get why the chip last started
+		uint32_t getCycleCount(); // function to get the CPU cycle counter (80 MHz)
+		uint32_t getFreeHeap(); // function to get the free heap (bytes)
+		uint32_t getMaxFreeBlockSize(); // function to get the largest free heap block (bytes)
+		uint8_t getHeapFragmentation(); // function to get the heap fragmentation (%)
+		uint32_t getChipId(); // function to get the chip ID
+		uint8_t getCpuFreqMHz() { return 80; } // function to get the CPU clock
+		void restart(); // method to reboot (does not return)
+};
+
+extern EspClass ESP;
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,202 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "FS.h"
+#include "LittleFS.h"
+#include "../sim/SimFlash.h"
+#include <errno.h>
+#include <sys/stat.h>
+#include <string>
+
+/* Definitions */
+#define FS_DIRECTORY "/fs" // file system area under the flash root
+#define FORMATTED_MARK "/.formatted" // present once the area has been formatted
+
+/* Variables */
+fs::FS LittleFS;
+
+/* Functions */
+
+// Function to get the host path of a file system path
+static std::string hostPath(const char* path) {
+  return std::string(SimFlash::root()) + FS_DIRECTORY + path;
+}
+
+// Method to create every directory above a path
+static void makeParents(const std::string& path) {
+  for (size_t slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+    mkdir(path.substr(0, slash).c_str(), 0755);
+  }
+}
+
+// Function to mount, fails on unformatted flash
+bool fs::FS::begin() {
+  struct stat info;
+
+  SimFlash::charge(SIM_FLASH_MOUNT_US);
+  SimFlash::stats().mounts++;
+  _mounted = (stat(hostPath(FORMATTED_MARK).c_str(), &info) == 0);
+  return _mounted;
+}
+
+// Function to erase the file system
+bool fs::FS::format() {
+  std::string area = hostPath("");
+  std::string command = "rm -rf '" + area + "'";
+
+  if (system(command.c_str()) != 0) {
+    return false;
+  }
+  makeParents(hostPath(FORMATTED_MARK));
+  FILE* mark = fopen(hostPath(FORMATTED_MARK).c_str(), "w");
+  if (mark == NULL) {
+    return false;
+  }
+  fclose(mark);
+
+  SimFlash::charge(SIM_FLASH_FORMAT_US);
+  SimFlash::stats().formats++;
+  _mounted = false;
+  return true;
+}
+
+// Function to open a file, creating its directories as LittleFS does
+fs::File fs::FS::open(const char* path, const char* mode) {
+  if (!_mounted) {
+    return File();
+  }
+
+  std::string file = hostPath(path);
+  if (mode[0] != 'r') {
+    makeParents(file);
+  }
+
+  std::string hostMode = std::string(mode) + "b";
+  SimFlash::charge(SIM_FLASH_OPEN_US);
+  SimFlash::stats().opens++;
+  return File(fopen(file.c_str(), hostMode.c_str()));
+}
+
+// Function to check whether a file exists
+bool fs::FS::exists(const char* path) {
+  struct stat info;
+
+  return _mounted && stat(hostPath(path).c_str(), &info) == 0;
+}
+
+// Function to delete a file
+bool fs::FS::remove(const char* path) {
+  SimFlash::charge(SIM_FLASH_OPEN_US);
+  return _mounted && ::remove(hostPath(path).c_str()) == 0;
+}
+
+// Function to list a directory (an empty listing if it doesn't exist)
+fs::Dir fs::FS::openDir(const char* path) {
+  std::string directory = hostPath(path);
+
+  SimFlash::charge(SIM_FLASH_OPEN_US);
+  return Dir(_mounted ? opendir(directory.c_str()) : NULL, directory.c_str());
+}
+
+// Function for writing one byte
+size_t fs::File::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+// Function for writing several bytes
+size_t fs::File::write(const uint8_t* buffer, size_t size) {
+  if (_file == NULL) {
+    return 0;
+  }
+
+  size_t written = fwrite(buffer, 1, size, _file);
+  SimFlash::charge((uint64_t)(written * SIM_FLASH_WRITE_US_PER_BYTE));
+  SimFlash::stats().bytesWritten += written;
+  return written;
+}
+
+// Function to get the bytes left to read
+int fs::File::available() {
+  if (_file == NULL) {
+    return 0;
+  }
+  long position = ftell(_file);
+  return (int)(size() - position);
+}
+
+// Function to read a byte
+int fs::File::read() {
+  uint8_t c;
+
+  return (read(&c, 1) == 1) ? c : -1;
+}
+
+// Function to read up to size bytes
+size_t fs::File::read(uint8_t* buffer, size_t size) {
+  if (_file == NULL) {
+    return 0;
+  }
+
+  size_t count = fread(buffer, 1, size, _file);
+  SimFlash::charge((uint64_t)(count * SIM_FLASH_READ_US_PER_BYTE));
+  SimFlash::stats().bytesRead += count;
+  return count;
+}
+
+// Function to look at the next byte
+int fs::File::peek() {
+  if (_file == NULL) {
+    return -1;
+  }
+
+  int c = fgetc(_file);
+  if (c != EOF) {
+    ungetc(c, _file);
+  }
+  return (c != EOF) ? c : -1;
+}
+
+// Function to get the length of the file
+size_t fs::File::size() {
+  struct stat info;
+
+  if (_file == NULL) {
+    return 0;
+  }
+  fflush(_file);
+  return (fstat(fileno(_file), &info) == 0) ? info.st_size : 0;
+}
+
+// Method to close the file
+void fs::File::close() {
+  if (_file != NULL) {
+    fclose(_file);
+    _file = NULL;
+  }
+}
+
+// Function to move to the next file, skipping the directory's own entries
+bool fs::Dir::next() {
+  struct dirent* entry;
+
+  while (_dir != NULL && (entry = readdir(_dir)) != NULL) {
+    if (entry->d_name[0] != '.') {
+      _name = entry->d_name;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Function to get the length of the current file
+size_t fs::Dir::fileSize() {
+  struct stat info;
+  String path = _path + "/" + _name;
+
+  return (stat(path.c_str(), &info) == 0) ? info.st_size : 0;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,90 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef FS_h
+#define FS_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include <stdio.h>
+#include <dirent.h>
+
+namespace fs {
+
+/* File class definition */
+// Open file on the simulated flash (a host file under SimFlash's fs/ directory)
+class File : public Stream {
+	public:
+		/* Constructors */
+		File(FILE* file=NULL) : _file(file) { }
+		File(const File&) = delete;
+		File(File&& other) : _file(other._file) { other._file = NULL; }
+		File& operator=(File&& other) { close(); _file = other._file; other._file = NULL; return *this; }
+		~File() { close(); }
+
+		/* Public Functions and Methods */
+		operator bool() const { return _file != NULL; } // function to check whether the file opened
+		size_t write(uint8_t c) override; // function for writing one byte
+		size_t write(const uint8_t* buffer, size_t size) override; // function for writing several bytes
+		using Print::write;
+		int available() override; // function to get the bytes left to read
+		int read() override; // function to read a byte (-1 at the end)
+		size_t read(uint8_t* buffer, size_t size); // function to read up to size bytes
+		int peek() override; // function to look at the next byte (-1 at the end)
+		size_t size(); // function to get the length of the file
+		void close(); // method to close the file
+	private:
+		/* Private Instance Variables */
+		FILE* _file;
+};
+
+/* Dir class definition */
+// Listing of a directory on the simulated flash
+class Dir {
+	public:
+		/* Constructors */
+		Dir(DIR* dir=NULL, const char* path="") : _dir(dir), _path(path) { }
+		Dir(const Dir&) = delete;
+		Dir(Dir&& other) : _dir(other._dir), _path(other._path), _name(other._name) { other._dir = NULL; }
+		~Dir() { if (_dir != NULL) closedir(_dir); }
+
+		/* Public Functions and Methods */
+		bool next(); // function to move to the next file, false when there are no more
+		String fileName() { return _name; } // function to get the name of the current file
+		size_t fileSize(); // function to get the length of the current file
+	private:
+		/* Private Instance Variables */
+		DIR* _dir; // NULL if the directory doesn't exist
+		String _path; // host path of the directory
+		String _name; // current file
+};
+
+/* FS class definition */
+// LittleFS on the simulated flash. It only mounts once formatted; mounting, opening and every byte moved
+// cost virtual time (SimFlash).
+class FS {
+	public:
+		/* Public Functions and Methods */
+		bool begin(); // function to mount, fails on unformatted flash
+		void end() { _mounted = false; } // method to unmount
+		bool format(); // function to erase the file system
+		File open(const char* path, const char* mode); // function to open a file ("r", "w" or "a"), creating its directories
+		bool exists(const char* path); // function to check whether a file exists
+		bool remove(const char* path); // function to delete a file
+		Dir openDir(const char* path); // function to list a directory
+	private:
+		/* Private Instance Variables */
+		bool _mounted = false;
+};
+
+};
+
+using fs::File;
+using fs::Dir;
+using fs::FS;
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,40 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "HardwareSerial.h"
+#include "../sim/SimSerial.h"
+
+/* Variables */
+HardwareSerial Serial;
+
+/* Functions */
+
+// Function for sending one byte
+size_t HardwareSerial::write(uint8_t c) {
+  SimSerial::write(&c, 1);
+  return 1;
+}
+
+// Function for sending several bytes
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  SimSerial::write(buffer, size);
+  return size;
+}
+
+// Functions for the scripted input
+int HardwareSerial::available() {
+  return SimSerial::available();
+}
+
+int HardwareSerial::read() {
+  return SimSerial::read();
+}
+
+int HardwareSerial::peek() {
+  return SimSerial::peek();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,31 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+// Include the necessary libraries
+#include "Stream.h"
+
+/* HardwareSerial class definition */
+// UART0, backed by SimSerial: output is captured (and echoed if asked), input comes from a script
+class HardwareSerial : public Stream {
+	public:
+		/* Public Functions and Methods */
+		void begin(unsigned long baud) { (void)baud; } // method to open the port (any baud rate works)
+		operator bool() const { return true; } // the port is always ready
+		size_t write(uint8_t c) override; // function for sending one byte
+		size_t write(const uint8_t* buffer, size_t size) override; // function for sending several bytes
+		using Print::write;
+		int available() override; // function to get the number of scripted bytes waiting
+		int read() override; // function to read the next scripted byte
+		int peek() override; // function to look at the next scripted byte
+};
+
+extern HardwareSerial Serial;
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
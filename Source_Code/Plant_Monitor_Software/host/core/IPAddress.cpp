@@ -0,0 +1,54 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "IPAddress.h"
+#include <stdio.h>
+
+/* Definitions */
+#define DOTTED_ADDRESS_SIZE 16 // "255.255.255.255" plus NUL
+
+/* Functions */
+
+// Function to parse a dotted address
+bool IPAddress::fromString(const char* address) {
+  uint32_t packed = 0;
+  int octet = -1, count = 0;
+
+  for (const char* c = address; ; c++) {
+    if (*c >= '0' && *c <= '9') {
+      octet = ((octet < 0) ? 0 : octet * 10) + (*c - '0');
+      if (octet > 255) {
+        return false;
+      }
+    }
+    else if ((*c == '.' || *c == '\0') && octet >= 0 && count < 4) {
+      packed |= (uint32_t)octet << (8 * count++);
+      octet = -1;
+      if (*c == '\0') {
+        break;
+      }
+    }
+    else {
+      return false;
+    }
+  }
+
+  if (count != 4) {
+    return false;
+  }
+  _address = packed;
+  return true;
+}
+
+// Function to format the dotted address
+String IPAddress::toString() const {
+  char dotted[DOTTED_ADDRESS_SIZE];
+
+  snprintf(dotted, sizeof(dotted), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+  return String(dotted);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
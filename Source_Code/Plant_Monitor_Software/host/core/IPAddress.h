@@ -0,0 +1,35 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef IPAddress_h
+#define IPAddress_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include "WString.h"
+
+/* IPAddress class definition */
+// IPv4 address, held as the core does with the first octet in the low byte
+class IPAddress {
+	public:
+		/* Constructors */
+		IPAddress() : _address(0) { } // constructor for the unset address
+		IPAddress(uint32_t address) : _address(address) { } // constructor from the packed form
+		IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _address(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) { } // constructor from the octets in order
+
+		/* Public Functions and Methods */
+		operator uint32_t() const { return _address; } // function to get the packed form
+		uint8_t operator[](int index) const { return (_address >> (8 * index)) & 0xFF; } // function to get an octet
+		bool isSet() const { return _address != 0; } // function to check whether the address was set
+		bool fromString(const char* address); // function to parse a dotted address, returns false if it isn't one
+		String toString() const; // function to format the dotted address
+	private:
+		/* Private Instance Variables */
+		uint32_t _address; // packed octets
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
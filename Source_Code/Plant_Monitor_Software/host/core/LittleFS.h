@@ -0,0 +1,16 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef LittleFS_h
+#define LittleFS_h
+
+// Include the necessary libraries
+#include "FS.h"
+
+extern fs::FS LittleFS;
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
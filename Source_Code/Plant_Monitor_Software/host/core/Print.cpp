@@ -0,0 +1,168 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Print.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+/* Definitions */
+#define PRINTF_BUFFER_SIZE 256 // longest printf() output, anything past it is cut off
+#define NUMBER_BUFFER_SIZE 33 // longest number printed in base 2, plus NUL
+
+/* Functions */
+
+// Function for writing several bytes, one at a time unless the output can do better
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+
+  while (size--) {
+    if (write(*buffer++) == 0) {
+      break;
+    }
+    n++;
+  }
+  return n;
+}
+
+// Function for writing a C string
+size_t Print::write(const char* str) {
+  return (str != NULL) ? write((const uint8_t*)str, strlen(str)) : 0;
+}
+
+size_t Print::print(const __FlashStringHelper* str) {
+  return write(reinterpret_cast<const char*>(str));
+}
+
+size_t Print::print(const String& str) {
+  return write((const uint8_t*)str.c_str(), str.length());
+}
+
+size_t Print::print(const char* str) {
+  return write(str);
+}
+
+size_t Print::print(char c) {
+  return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char value, int base) {
+  return print((unsigned long)value, base);
+}
+
+size_t Print::print(int value, int base) {
+  return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base) {
+  return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base) {
+  if (base == DEC && value < 0) {
+    return print('-') + printNumber(0UL - (unsigned long)value, base);
+  }
+  return printNumber((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+  return printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits) {
+  return printFloat(value, digits);
+}
+
+size_t Print::println() {
+  return write("\r\n");
+}
+
+size_t Print::printf(const char* format, ...) {
+  char buffer[PRINTF_BUFFER_SIZE];
+  va_list args;
+
+  va_start(args, format);
+  int len = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+
+  return (len > 0) ? write((const uint8_t*)buffer, std::min((size_t)len, sizeof(buffer) - 1)) : 0;
+}
+
+size_t Print::printf_P(const char* format, ...) {
+  char buffer[PRINTF_BUFFER_SIZE];
+  va_list args;
+
+  va_start(args, format);
+  int len = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+
+  return (len > 0) ? write((const uint8_t*)buffer, std::min((size_t)len, sizeof(buffer) - 1)) : 0;
+}
+
+// Function for writing an unsigned number in a base
+size_t Print::printNumber(unsigned long value, int base) {
+  char number[NUMBER_BUFFER_SIZE];
+  char* digit = &number[sizeof(number) - 1];
+
+  if (base < 2) {
+    base = DEC;
+  }
+
+  *digit = '\0';
+  do {
+    unsigned long d = value % base;
+    *--digit = (d < 10) ? ('0' + d) : ('A' + d - 10);
+    value /= base;
+  } while (value > 0);
+
+  return write(digit);
+}
+
+// Function for writing a float rounded to a number of decimals, the same way the core does
+size_t Print::printFloat(double value, int digits) {
+  size_t n = 0;
+
+  if (isnan(value)) {
+    return print("nan");
+  }
+  if (isinf(value)) {
+    return print("inf");
+  }
+  if (value > 4294967040.0 || value < -4294967040.0) {
+    return print("ovf");
+  }
+
+  if (value < 0.0) {
+    n += print('-');
+    value = -value;
+  }
+
+  double rounding = 0.5;
+  for (int i = 0; i < digits; i++) {
+    rounding /= 10.0;
+  }
+  value += rounding;
+
+  unsigned long whole = (unsigned long)value;
+  double remainder = value - (double)whole;
+  n += print(whole);
+
+  if (digits > 0) {
+    n += print('.');
+  }
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    unsigned int digit = (unsigned int)remainder;
+    n += print(digit);
+    remainder -= digit;
+  }
+
+  return n;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,56 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Print_h
+#define Print_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+/* Definitions */
+#define DEC 10
+#define HEX 16
+
+/* Print class definition */
+// Formatting base of every output (serial, sockets, report writers), same behaviour as the core's Print
+class Print {
+	public:
+		virtual ~Print() {}
+
+		/* Public Functions and Methods */
+		virtual size_t write(uint8_t c) = 0; // function for writing a single byte
+		virtual size_t write(const uint8_t* buffer, size_t size); // function for writing several bytes
+		size_t write(const char* str); // function for writing a C string
+		size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+		virtual void flush() { } // method for pushing out anything buffered
+
+		size_t print(const __FlashStringHelper* str);
+		size_t print(const String& str);
+		size_t print(const char* str);
+		size_t print(char c);
+		size_t print(unsigned char value, int base=DEC);
+		size_t print(int value, int base=DEC);
+		size_t print(unsigned int value, int base=DEC);
+		size_t print(long value, int base=DEC);
+		size_t print(unsigned long value, int base=DEC);
+		size_t print(double value, int digits=2);
+
+		size_t println();
+		template <class T> size_t println(const T& value) { size_t n = print(value); return n + println(); }
+		template <class T> size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+
+		size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+		size_t printf_P(const char* format, ...) __attribute__((format(printf, 2, 3)));
+	private:
+		/* Private Functions and Methods */
+		size_t printNumber(unsigned long value, int base); // function for writing an unsigned number in a base
+		size_t printFloat(double value, int digits); // function for writing a float rounded to a number of decimals
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,42 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SPI.h"
+#include "../sim/SimADC.h"
+#include <stddef.h>
+
+/* Definitions */
+#define SPI_BASE_CLOCK 80000000 // the clock is divided down from the CPU's
+
+/* Variables */
+SPIClass SPI;
+
+/* Functions */
+
+// Method to set the clock
+// The hardware divides 80 MHz by a whole number, so the clock is the fastest one at or below what was asked
+void SPIClass::setFrequency(uint32_t freq) {
+  uint32_t divider = (freq > 0) ? ((SPI_BASE_CLOCK + freq - 1) / freq) : SPI_BASE_CLOCK;
+
+  SimADC::setClock(SPI_BASE_CLOCK / divider);
+}
+
+// Function to exchange one byte
+uint8_t SPIClass::transfer(uint8_t data) {
+  return SimADC::transfer(data);
+}
+
+// Method to exchange several bytes (out NULL = send 0xFF, in NULL = discard)
+void SPIClass::transferBytes(const uint8_t* out, uint8_t* in, uint32_t size) {
+  for (uint32_t i = 0; i < size; i++) {
+    uint8_t received = SimADC::transfer((out != NULL) ? out[i] : 0xFF);
+    if (in != NULL) {
+      in[i] = received;
+    }
+  }
+}
+
+// ©2017 Jeremy Maxey-Vesperman
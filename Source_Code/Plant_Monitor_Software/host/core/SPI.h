@@ -0,0 +1,35 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SPI_h
+#define SPI_h
+
+// Include the necessary libraries
+#include <stdint.h>
+
+/* Definitions */
+#define MSBFIRST 1
+#define LSBFIRST 0
+#define SPI_MODE0 0x00
+
+/* SPIClass class definition */
+// HSPI bus with the simulated MCP3008 on it (SimADC); every byte takes 8 periods of the clock
+class SPIClass {
+	public:
+		/* Public Functions and Methods */
+		void begin() { } // method to claim the bus pins
+		void end() { }
+		void setBitOrder(uint8_t order) { (void)order; } // method to choose the bit order (the ADC is MSB first)
+		void setDataMode(uint8_t mode) { (void)mode; } // method to choose the clock mode (the ADC runs in mode 0)
+		void setFrequency(uint32_t freq); // method to set the clock
+		uint8_t transfer(uint8_t data); // function to exchange one byte
+		void transferBytes(const uint8_t* out, uint8_t* in, uint32_t size); // method to exchange several bytes
+};
+
+extern SPIClass SPI;
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,41 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "Arduino.h"
+#include "Stream.h"
+
+/* Functions */
+
+// Function to read up to length bytes, waiting up to the timeout for each
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+  size_t count = 0;
+
+  while (count < length) {
+    int c = timedRead();
+    if (c < 0) {
+      break;
+    }
+    buffer[count++] = (uint8_t)c;
+  }
+  return count;
+}
+
+// Function to read a byte, waiting up to the timeout (in virtual time) for one to arrive
+int Stream::timedRead() {
+  unsigned long start = millis();
+
+  do {
+    int c = read();
+    if (c >= 0) {
+      return c;
+    }
+    yield();
+  } while ((millis() - start) < _timeout);
+
+  return -1;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
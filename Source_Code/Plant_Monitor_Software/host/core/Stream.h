@@ -0,0 +1,40 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Stream_h
+#define Stream_h
+
+// Include the necessary libraries
+#include "Print.h"
+
+/* Definitions */
+#define STREAM_DEFAULT_TIMEOUT 1000 // ms readBytes() waits for each byte
+
+/* Stream class definition */
+// Input side of serial ports and sockets, same behaviour as the core's Stream
+class Stream : public Print {
+	public:
+		/* Constructors */
+		Stream() : _timeout(STREAM_DEFAULT_TIMEOUT) { }
+
+		/* Public Functions and Methods */
+		virtual int available() = 0; // function to get the number of bytes that can be read without waiting
+		virtual int read() = 0; // function to read one byte (-1 if there is none)
+		virtual int peek() = 0; // function to look at the next byte without reading it (-1 if there is none)
+		void setTimeout(unsigned long timeout) { _timeout = timeout; } // method to set how long reads wait for data (ms)
+		unsigned long getTimeout() const { return _timeout; }
+		virtual size_t readBytes(uint8_t* buffer, size_t length); // function to read up to length bytes, waiting up to the timeout for each
+		size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*)buffer, length); }
+	protected:
+		/* Protected Instance Variables */
+		unsigned long _timeout; // ms reads wait for data
+		
+		/* Protected Functions and Methods */
+		int timedRead(); // function to read a byte, waiting up to the timeout (-1 if none came)
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
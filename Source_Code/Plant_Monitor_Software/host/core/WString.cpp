@@ -0,0 +1,356 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "WString.h"
+#include "../sim/SimHeap.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <utility>
+
+/* Definitions */
+#define NUMBER_BUFFER_SIZE 34 // longest number printed in base 2, plus sign and NUL
+
+/* Constructors */
+// Constructor that copies a C string
+String::String(const char* cstr)
+  : _buffer(NULL), _capacity(0), _len(0)
+{
+  concat(cstr);
+}
+
+// Constructor that copies a flash string (ordinary memory on the host)
+String::String(const __FlashStringHelper* str)
+  : _buffer(NULL), _capacity(0), _len(0)
+{
+  concat(reinterpret_cast<const char*>(str));
+}
+
+// Copy constructor
+String::String(const String& str)
+  : _buffer(NULL), _capacity(0), _len(0)
+{
+  concat(str);
+}
+
+// Move constructor, takes over the other string's storage
+String::String(String&& str)
+  : _buffer(str._buffer), _capacity(str._capacity), _len(str._len)
+{
+  str._buffer = NULL;
+  str._capacity = 0;
+  str._len = 0;
+}
+
+// Constructor for a single character
+String::String(char c)
+  : _buffer(NULL), _capacity(0), _len(0)
+{
+  concat(c);
+}
+
+// Constructors that print a number in the specified base
+String::String(int value, unsigned char base)
+  : String((long)value, base)
+{
+}
+
+String::String(unsigned int value, unsigned char base)
+  : String((unsigned long)value, base)
+{
+}
+
+String::String(long value, unsigned char base)
+  : _buffer(NULL), _capacity(0), _len(0)
+{
+  char number[NUMBER_BUFFER_SIZE];
+
+  if (base == 10) {
+    snprintf(number, sizeof(number), "%ld", value);
+  }
+  else {
+    unsigned long magnitude = (value < 0) ? (0UL - (unsigned long)value) : (unsigned long)value;
+    String digits(magnitude, base);
+    snprintf(number, sizeof(number), "%s%s", (value < 0) ? "-" : "", digits.c_str());
+  }
+  concat(number);
+}
+
+String::String(unsigned long value, unsigned char base)
+  : _buffer(NULL), _capacity(0), _len(0)
+{
+  char number[NUMBER_BUFFER_SIZE];
+  char* digit = &number[sizeof(number) - 1];
+
+  *digit = '\0';
+  do {
+    unsigned long d = value % base;
+    *--digit = (d < 10) ? ('0' + d) : ('a' + d - 10);
+    value /= base;
+  } while (value > 0);
+  concat(digit);
+}
+
+String::String(float value, unsigned char decimals)
+  : String((double)value, decimals)
+{
+}
+
+String::String(double value, unsigned char decimals)
+  : _buffer(NULL), _capacity(0), _len(0)
+{
+  char number[NUMBER_BUFFER_SIZE + 32];
+
+  snprintf(number, sizeof(number), "%.*f", decimals, value);
+  concat(number);
+}
+
+// Destructor that frees the storage
+String::~String() {
+  SimHeap::release(_buffer);
+}
+
+/* Functions */
+
+// Assignment operators
+String& String::operator=(const String& rhs) {
+  if (this != &rhs) {
+    _len = 0;
+    concat(rhs);
+  }
+  return *this;
+}
+
+String& String::operator=(String&& rhs) {
+  if (this != &rhs) {
+    std::swap(_buffer, rhs._buffer);
+    std::swap(_capacity, rhs._capacity);
+    std::swap(_len, rhs._len);
+  }
+  return *this;
+}
+
+String& String::operator=(const char* cstr) {
+  _len = 0;
+  concat(cstr);
+  return *this;
+}
+
+// Function to make room for size characters
+// Grows the storage to exactly what is asked for, as the core's realloc based String does
+bool String::reserve(unsigned int size) {
+  if (_buffer != NULL && _capacity >= size) {
+    return true;
+  }
+
+  char* grown = static_cast<char*>(SimHeap::allocate(size + 1));
+  if (grown == NULL) { // out of memory, the string keeps what it had
+    return false;
+  }
+  if (_buffer != NULL) {
+    memcpy(grown, _buffer, _len);
+  }
+  grown[_len] = '\0';
+  SimHeap::release(_buffer);
+  _buffer = grown;
+  _capacity = size;
+  return true;
+}
+
+// Function to append characters
+bool String::concat(const char* cstr, unsigned int length) {
+  if (cstr == NULL) {
+    return false;
+  }
+  if (length == 0) {
+    return reserve(_len);
+  }
+
+  bool f_Self = (_buffer != NULL && cstr >= _buffer && cstr <= _buffer + _len); // appending part of this string
+  size_t offset = f_Self ? (cstr - _buffer) : 0;
+  if (!reserve(_len + length)) {
+    return false;
+  }
+
+  memmove(_buffer + _len, f_Self ? (_buffer + offset) : cstr, length);
+  _len += length;
+  _buffer[_len] = '\0';
+  return true;
+}
+
+bool String::concat(const String& str) {
+  return concat(str.c_str(), str._len);
+}
+
+bool String::concat(const char* cstr) {
+  return (cstr != NULL) && concat(cstr, strlen(cstr));
+}
+
+bool String::concat(const __FlashStringHelper* str) {
+  return concat(reinterpret_cast<const char*>(str));
+}
+
+bool String::concat(char c) {
+  return concat(&c, 1);
+}
+
+bool String::concat(int value) {
+  return concat(String(value));
+}
+
+bool String::concat(unsigned int value) {
+  return concat(String(value));
+}
+
+bool String::concat(long value) {
+  return concat(String(value));
+}
+
+bool String::concat(unsigned long value) {
+  return concat(String(value));
+}
+
+// Comparisons
+bool String::equals(const String& str) const {
+  return (_len == str._len) && (memcmp(c_str(), str.c_str(), _len) == 0);
+}
+
+bool String::equals(const char* cstr) const {
+  return strcmp(c_str(), (cstr != NULL) ? cstr : "") == 0;
+}
+
+// Searches
+bool String::startsWith(const String& prefix) const {
+  return (prefix._len <= _len) && (memcmp(c_str(), prefix.c_str(), prefix._len) == 0);
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  if (from >= _len) {
+    return -1;
+  }
+  const char* found = strchr(c_str() + from, c);
+  return (found != NULL) ? (int)(found - c_str()) : -1;
+}
+
+int String::indexOf(const String& str, unsigned int from) const {
+  if (from > _len) {
+    return -1;
+  }
+  const char* found = strstr(c_str() + from, str.c_str());
+  return (found != NULL) ? (int)(found - c_str()) : -1;
+}
+
+// Function to get one character
+char String::charAt(unsigned int index) const {
+  return (index < _len) ? _buffer[index] : '\0';
+}
+
+// Functions to copy part of the string
+String String::substring(unsigned int from) const {
+  return substring(from, _len);
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  String part;
+
+  if (from > to) {
+    std::swap(from, to);
+  }
+  if (from < _len) {
+    part.concat(c_str() + from, std::min(to, _len) - from);
+  }
+  return part;
+}
+
+// Function to parse a leading integer
+long String::toInt() const {
+  return atol(c_str());
+}
+
+// Method to upper case every character
+void String::toUpperCase() {
+  for (unsigned int i = 0; i < _len; i++) {
+    _buffer[i] = toupper((unsigned char)_buffer[i]);
+  }
+}
+
+// Method to remove leading and trailing white space
+void String::trim() {
+  unsigned int start = 0, end = _len;
+
+  while (start < end && isspace((unsigned char)_buffer[start])) {
+    start++;
+  }
+  while (end > start && isspace((unsigned char)_buffer[end - 1])) {
+    end--;
+  }
+  if (start > 0) {
+    memmove(_buffer, _buffer + start, end - start);
+  }
+  _len = end - start;
+  if (_buffer != NULL) {
+    _buffer[_len] = '\0';
+  }
+}
+
+/* Concatenation */
+String operator+(const String& lhs, const String& rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, char rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, int rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, unsigned int rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, long rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, unsigned long rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, const __FlashStringHelper* rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,87 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef WString_h
+#define WString_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+
+class __FlashStringHelper;
+
+/* String class definition */
+// Heap string with the subset of the core's String API the firmware uses. Storage comes from the node's
+// simulated heap (SimHeap), so its allocations count against the chip's and show up in the heap's stats.
+class String {
+	public:
+		/* Constructors */
+		String(const char* cstr=""); // constructor that copies a C string
+		String(const __FlashStringHelper* str); // constructor that copies a flash string
+		String(const String& str); // copy constructor
+		String(String&& str); // move constructor
+		explicit String(char c); // constructor for a single character
+		explicit String(int value, unsigned char base=10); // constructors that print a number
+		explicit String(unsigned int value, unsigned char base=10);
+		explicit String(long value, unsigned char base=10);
+		explicit String(unsigned long value, unsigned char base=10);
+		explicit String(float value, unsigned char decimals=2);
+		explicit String(double value, unsigned char decimals=2);
+		~String(); // destructor that frees the storage
+
+		/* Public Functions and Methods */
+		String& operator=(const String& rhs); // assignment operators
+		String& operator=(String&& rhs);
+		String& operator=(const char* cstr);
+		bool reserve(unsigned int size); // function to make room for size characters, returns false if out of memory
+		unsigned int length() const { return _len; } // function to get the number of characters
+		const char* c_str() const { return _buffer ? _buffer : ""; } // function to get the characters
+		bool concat(const char* cstr, unsigned int length); // function to append characters
+		bool concat(const String& str);
+		bool concat(const char* cstr);
+		bool concat(const __FlashStringHelper* str);
+		bool concat(char c);
+		bool concat(int value);
+		bool concat(unsigned int value);
+		bool concat(long value);
+		bool concat(unsigned long value);
+		template <class T> String& operator+=(const T& rhs) { concat(rhs); return *this; } // method to append anything concat() takes
+		bool equals(const String& str) const; // comparisons
+		bool equals(const char* cstr) const;
+		bool operator==(const String& rhs) const { return equals(rhs); }
+		bool operator==(const char* cstr) const { return equals(cstr); }
+		bool operator!=(const String& rhs) const { return !equals(rhs); }
+		bool operator!=(const char* cstr) const { return !equals(cstr); }
+		bool startsWith(const String& prefix) const; // searches
+		int indexOf(char c, unsigned int from=0) const;
+		int indexOf(const String& str, unsigned int from=0) const;
+		char charAt(unsigned int index) const; // function to get one character ('\0' past the end)
+		char operator[](unsigned int index) const { return charAt(index); }
+		String substring(unsigned int from) const; // function to copy the characters from a position on
+		String substring(unsigned int from, unsigned int to) const; // function to copy the characters between two positions
+		long toInt() const; // function to parse a leading integer
+		void toUpperCase(); // method to upper case every character
+		void trim(); // method to remove leading and trailing white space
+	private:
+		/* Private Instance Variables */
+		char* _buffer; // characters plus a terminating NUL (NULL while empty)
+		unsigned int _capacity; // characters the buffer can hold, not counting the NUL
+		unsigned int _len; // characters in use
+};
+
+/* Concatenation */
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+String operator+(const String& lhs, int rhs);
+String operator+(const String& lhs, unsigned int rhs);
+String operator+(const String& lhs, long rhs);
+String operator+(const String& lhs, unsigned long rhs);
+String operator+(const String& lhs, const __FlashStringHelper* rhs);
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,79 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "WiFiClient.h"
+#include "ESP8266WiFi.h"
+#include "../sim/SimNetwork.h"
+
+/* Functions */
+
+// Function to open the connection, waiting up to the stream timeout for the handshake
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+  stop();
+  _connection = SimNetwork::connect(ip, port, _timeout);
+  return (_connection >= 0) ? 1 : 0;
+}
+
+// Function to look the host up and open the connection
+int WiFiClient::connect(const char* host, uint16_t port) {
+  IPAddress address;
+
+  if (!WiFi.hostByName(host, address, _timeout)) {
+    return 0;
+  }
+  return connect(address, port);
+}
+
+// Function for sending one byte
+size_t WiFiClient::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+// Function for sending several bytes
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+  return (_connection >= 0) ? SimNetwork::send(_connection, buffer, size) : 0;
+}
+
+// Function to get the number of bytes that have arrived
+int WiFiClient::available() {
+  return (_connection >= 0) ? SimNetwork::available(_connection) : 0;
+}
+
+// Function to read one byte
+int WiFiClient::read() {
+  return (_connection >= 0) ? SimNetwork::read(_connection) : -1;
+}
+
+// Function to read what has arrived, up to size bytes
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+  size_t count = 0;
+  int c;
+
+  while (count < size && (c = read()) >= 0) {
+    buffer[count++] = (uint8_t)c;
+  }
+  return count;
+}
+
+// Function to look at the next byte
+int WiFiClient::peek() {
+  return (_connection >= 0) ? SimNetwork::peek(_connection) : -1;
+}
+
+// Method to close the connection
+void WiFiClient::stop() {
+  if (_connection >= 0) {
+    SimNetwork::close(_connection);
+    _connection = -1;
+  }
+}
+
+// Function to check whether the connection is open or has data left to read
+uint8_t WiFiClient::connected() {
+  return (_connection >= 0) && SimNetwork::isConnected(_connection);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,44 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef WiFiClient_h
+#define WiFiClient_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include "IPAddress.h"
+
+/* WiFiClient class definition */
+// TCP socket over the simulated network (SimNetwork). connect() and writes block in virtual time, reads
+// only return what has arrived by now.
+class WiFiClient : public Stream {
+	public:
+		/* Constructors */
+		WiFiClient() : _connection(-1) { }
+		virtual ~WiFiClient() { stop(); }
+
+		/* Public Functions and Methods */
+		virtual int connect(IPAddress ip, uint16_t port); // function to open the connection (timeout from setTimeout()), returns 1 on success
+		int connect(const char* host, uint16_t port); // function to look the host up and open the connection
+		size_t write(uint8_t c) override; // function for sending one byte
+		size_t write(const uint8_t* buffer, size_t size) override; // function for sending several bytes
+		using Print::write;
+		int available() override; // function to get the number of bytes that have arrived
+		int read() override; // function to read one byte (-1 if none has arrived)
+		int read(uint8_t* buffer, size_t size); // function to read what has arrived, up to size bytes
+		int peek() override; // function to look at the next byte (-1 if none has arrived)
+		void flush() override { } // method to wait for sent data to go out (writes already block)
+		void stop(); // method to close the connection
+		uint8_t connected(); // function to check whether the connection is open or has data left to read
+		operator bool() { return connected(); }
+		void setNoDelay(bool noDelay) { (void)noDelay; } // method to turn off Nagle (writes are sent straight away anyway)
+	protected:
+		/* Protected Instance Variables */
+		int _connection; // SimNetwork handle (-1 = none)
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
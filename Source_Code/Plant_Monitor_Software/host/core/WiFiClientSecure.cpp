@@ -0,0 +1,33 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "WiFiClientSecure.h"
+#include "../sim/SimNetwork.h"
+
+/* Functions */
+
+// Function to open the connection and run the handshake, both within the stream timeout
+int BearSSL::WiFiClientSecure::connect(IPAddress ip, uint16_t port) {
+  unsigned long start = millis();
+  uint32_t sessionId = (_session != NULL) ? _session->id() : 0;
+
+  if (!WiFiClient::connect(ip, port)) {
+    return 0;
+  }
+
+  unsigned long spent = millis() - start;
+  if (!SimNetwork::handshake(_connection, sessionId, (spent < _timeout) ? (_timeout - spent) : 0)) {
+    stop();
+    return 0;
+  }
+
+  if (_session != NULL) {
+    _session->setId(sessionId);
+  }
+  return 1;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,58 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef WiFiClientSecure_h
+#define WiFiClientSecure_h
+
+// Include the necessary libraries
+#include "WiFiClient.h"
+
+namespace BearSSL {
+
+/* Session class definition */
+// Parameters of a TLS session that a later handshake can resume, laid out like br_ssl_session_parameters
+// (the firmware keeps a copy in RTC memory). The simulated server's session ID sits in the first bytes.
+class Session {
+	public:
+		/* Constructors */
+		Session() : _sessionId(), _sessionIdLen(0), _version(0), _cipherSuite(0), _masterSecret() { }
+
+		/* Public Functions and Methods */
+		uint32_t id() const { uint32_t value; memcpy(&value, _sessionId, sizeof(value)); return (_sessionIdLen == sizeof(value)) ? value : 0; } // function to get the server's session ID (0 = none)
+		void setId(uint32_t value) { memcpy(_sessionId, &value, sizeof(value)); _sessionIdLen = sizeof(value); } // method to keep the session the server handed out
+	private:
+		/* Private Instance Variables */
+		uint8_t _sessionId[32];
+		uint8_t _sessionIdLen;
+		uint16_t _version;
+		uint16_t _cipherSuite;
+		uint8_t _masterSecret[48];
+};
+
+/* WiFiClientSecure class definition */
+// TLS socket: the TCP connection followed by a handshake that costs what BearSSL takes on the node, resumed
+// (one round trip, no key exchange) when the offered session is still in the server's cache
+class WiFiClientSecure : public WiFiClient {
+	public:
+		/* Constructors */
+		WiFiClientSecure() : _session(NULL) { }
+
+		/* Public Functions and Methods */
+		int connect(IPAddress ip, uint16_t port) override; // function to open the connection and run the handshake
+		using WiFiClient::connect;
+		void setInsecure() { } // method to skip certificate checks (nothing is checked here)
+		void setSession(Session* session) { _session = session; } // method to offer a session and have it updated after the handshake
+	private:
+		/* Private Instance Variables */
+		Session* _session; // session to offer and update (NULL = always a full handshake)
+};
+
+};
+
+using BearSSL::WiFiClientSecure;
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
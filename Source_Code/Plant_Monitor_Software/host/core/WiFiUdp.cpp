@@ -0,0 +1,76 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "WiFiUdp.h"
+#include "../sim/SimNetwork.h"
+
+/* Functions */
+
+// Function to start a datagram to a listener
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+  _remoteIP = ip;
+  _remotePort = port;
+  _outLen = 0;
+  if (_localPort == 0) {
+    _localPort = UDP_EPHEMERAL_PORT;
+  }
+  return 1;
+}
+
+// Function to send the datagram
+int WiFiUDP::endPacket() {
+  bool sent = SimNetwork::sendDatagram(_localPort, _remoteIP, _remotePort, _out, _outLen);
+
+  _outLen = 0;
+  return sent ? 1 : 0;
+}
+
+// Function for appending one byte
+size_t WiFiUDP::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+// Function for appending several bytes, as much as fits the datagram
+size_t WiFiUDP::write(const uint8_t* buffer, size_t size) {
+  size = std::min(size, sizeof(_out) - _outLen);
+  memcpy(_out + _outLen, buffer, size);
+  _outLen += size;
+  return size;
+}
+
+// Function to take the next datagram that has arrived on the local port
+int WiFiUDP::parsePacket() {
+  int size = SimNetwork::receiveDatagram(_localPort, _in, sizeof(_in));
+
+  _inPos = 0;
+  _inLen = (size > 0) ? size : 0;
+  return _inLen;
+}
+
+// Function to get the bytes left in the datagram
+int WiFiUDP::available() {
+  return _inLen - _inPos;
+}
+
+// Function to read a byte of the datagram
+int WiFiUDP::read() {
+  return (_inPos < _inLen) ? _in[_inPos++] : -1;
+}
+
+// Function to read the datagram, up to size bytes
+int WiFiUDP::read(uint8_t* buffer, size_t size) {
+  size = std::min(size, _inLen - _inPos);
+  memcpy(buffer, _in + _inPos, size);
+  _inPos += size;
+  return size;
+}
+
+// Function to look at the next byte of the datagram
+int WiFiUDP::peek() {
+  return (_inPos < _inLen) ? _in[_inPos] : -1;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,53 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef WiFiUdp_h
+#define WiFiUdp_h
+
+// Include the necessary libraries
+#include "Arduino.h"
+#include "IPAddress.h"
+
+/* Definitions */
+#define UDP_MAX_DATAGRAM 1472 // payload that fits one Ethernet frame
+#define UDP_EPHEMERAL_PORT 50000 // local port used when begin() wasn't called
+
+/* WiFiUDP class definition */
+// UDP socket over the simulated network (SimNetwork)
+class WiFiUDP : public Stream {
+	public:
+		/* Constructors */
+		WiFiUDP() : _localPort(0), _outLen(0), _inLen(0), _inPos(0), _remotePort(0) { }
+
+		/* Public Functions and Methods */
+		uint8_t begin(uint16_t port) { _localPort = port; return 1; } // method to listen on a local port
+		void stop() { _localPort = 0; } // method to stop listening
+		int beginPacket(IPAddress ip, uint16_t port); // function to start a datagram to a listener
+		int endPacket(); // function to send the datagram, returns 0 if there is no network
+		size_t write(uint8_t c) override; // function for appending one byte
+		size_t write(const uint8_t* buffer, size_t size) override; // function for appending several bytes
+		using Print::write;
+		int parsePacket(); // function to take the next datagram that has arrived, returns its size (0 = none)
+		int available() override; // function to get the bytes left in the datagram
+		int read() override; // function to read a byte of the datagram
+		int read(uint8_t* buffer, size_t size); // function to read the datagram, up to size bytes
+		int peek() override; // function to look at the next byte of the datagram
+		IPAddress remoteIP() { return _remoteIP; } // function to get where the datagram is for (or came from)
+		uint16_t remotePort() { return _remotePort; }
+	private:
+		/* Private Instance Variables */
+		uint16_t _localPort;
+		uint8_t _out[UDP_MAX_DATAGRAM]; // datagram being written
+		size_t _outLen;
+		uint8_t _in[UDP_MAX_DATAGRAM]; // datagram being read
+		size_t _inLen;
+		size_t _inPos;
+		IPAddress _remoteIP;
+		uint16_t _remotePort;
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,22 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef lwip_dhcp_h
+#define lwip_dhcp_h
+
+// Include the necessary libraries
+#include "netif.h"
+#include <stdint.h>
+
+/* DHCP client state, the lease the access point's server handed out (SimNetwork) */
+struct dhcp {
+	uint32_t offered_t0_lease; // lease length (s)
+};
+
+uint8_t dhcp_supplied_address(const struct netif* netif); // function to check whether the address came from DHCP
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
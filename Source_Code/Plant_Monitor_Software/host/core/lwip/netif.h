@@ -0,0 +1,25 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef lwip_netif_h
+#define lwip_netif_h
+
+// Include the necessary libraries
+#include <stddef.h>
+
+struct dhcp;
+
+/* Network interface, just the DHCP client state the firmware reads */
+struct netif {
+	struct dhcp* dhcp;
+};
+
+#define netif_dhcp_data(netif) ((netif)->dhcp)
+
+extern struct netif* netif_default; // the station interface
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,200 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimADC.h"
+#include "SimClock.h"
+#include <math.h>
+#include <algorithm>
+
+/* Definitions */
+#define US_PER_S 1e6
+#define DEFAULT_SPI_CLOCK 1000000
+#define START_BIT 0x01 // last bit of the first byte of a frame
+#define SINGLE_ENDED 0x80 // first bit of the second byte
+
+/* Variables */
+static SimChannel _channels[SIM_ADC_CHANNELS];
+static double _batteryVolts = 4.0;
+static double _sigmaLsb = 0; // gaussian noise on every conversion
+static uint16_t _spikePerMille = 0; // chance of an impulse on a conversion
+static int _spikeLsb = 0; // size of an impulse (either sign)
+static uint64_t _random = 1; // xorshift state
+
+static bool _powered = false;
+static bool _selected = false;
+static uint64_t _poweredAt = 0; // µs when sensor power came on
+static uint32_t _clock = DEFAULT_SPI_CLOCK;
+static double _capVolts = 0; // charge left on the sample capacitor
+static int _frameByte = 0; // byte of the current frame
+static int _code = 0; // result being shifted out
+static uint32_t _conversions = 0;
+
+/* Functions */
+
+// Method to put the chip back to its power up state
+void SimADC::reset() {
+  _powered = false;
+  _selected = false;
+  _capVolts = 0;
+  _frameByte = 0;
+  _conversions = 0;
+}
+
+// Method to script a source
+void SimADC::setChannel(int channel, double volts, double sourceOhms, double riseMs) {
+  if (channel >= 0 && channel < SIM_ADC_CHANNELS) {
+    _channels[channel] = { volts, sourceOhms, riseMs };
+  }
+}
+
+// Method to change what a source settles to
+void SimADC::setVolts(int channel, double volts) {
+  if (channel >= 0 && channel < SIM_ADC_CHANNELS) {
+    _channels[channel].volts = volts;
+  }
+}
+
+// Method to inject noise into every conversion
+void SimADC::setNoise(double sigmaLsb, uint16_t spikePerMille, int spikeLsb, uint64_t seed) {
+  _sigmaLsb = sigmaLsb;
+  _spikePerMille = spikePerMille;
+  _spikeLsb = spikeLsb;
+  _random = (seed != 0) ? seed : 1;
+}
+
+// Method to set the battery voltage behind A0
+void SimADC::setBattery(double volts) {
+  _batteryVolts = volts;
+}
+
+// Method to switch the chip and sensors, the sources start rising from 0 V when it comes on
+void SimADC::setPowered(bool on) {
+  if (on && !_powered) {
+    _poweredAt = SimClock::now();
+    _capVolts = 0;
+  }
+  _powered = on;
+}
+
+// Method to drive chip select, a falling edge starts a new frame
+void SimADC::setSelected(bool selected) {
+  if (selected && !_selected) {
+    _frameByte = 0;
+  }
+  _selected = selected;
+}
+
+// Method to set the SPI clock the conversions run at
+void SimADC::setClock(uint32_t hz) {
+  _clock = (hz > 0) ? hz : DEFAULT_SPI_CLOCK;
+}
+
+// Function to exchange one byte with the chip
+// A frame is the start bit, then the input select (sampled during the next clocks), then the result
+uint8_t SimADC::transfer(uint8_t out) {
+  uint8_t in = 0;
+
+  SimClock::advance((uint64_t)(8 * US_PER_S / _clock));
+
+  if (!_powered || !_selected) {
+    return 0;
+  }
+
+  switch (_frameByte) {
+    case 0:
+      _frameByte = (out & START_BIT) ? 1 : 0; // leading zeros until the start bit
+      break;
+    case 1:
+      _code = (out & SINGLE_ENDED) ? convert((out >> 4) & 0x07) : 0; // differential mode isn't used
+      in = (_code >> 8) & 0x03; // null bit then the top two bits
+      _frameByte = 2;
+      break;
+    case 2:
+      in = _code & 0xFF;
+      _frameByte = 3;
+      break;
+    default: // clocks past the end of the frame read zeros
+      break;
+  }
+  return in;
+}
+
+// Function to convert A0
+int SimADC::readInternal() {
+  double pin = _batteryVolts * SIM_BATTERY_R2 / (SIM_BATTERY_R1 + SIM_BATTERY_R2);
+
+  SimClock::advance(100); // a conversion takes about 100 µs
+  return std::min(std::max((int)floor(pin / SIM_INTERNAL_VREF * SIM_ADC_CODES), 0), SIM_ADC_CODES - 1);
+}
+
+// Function to get a source's voltage right now
+double SimADC::pinVolts(int channel) {
+  const SimChannel& source = _channels[channel];
+
+  if (!_powered) {
+    return 0;
+  }
+  if (source.riseMs <= 0) {
+    return source.volts;
+  }
+  double sinceMs = (SimClock::now() - _poweredAt) / 1000.0;
+  return source.volts * (1 - exp(-sinceMs / source.riseMs));
+}
+
+// Function to get the code a perfect converter gives for a voltage (the firmware takes code + 1 as the top of the step)
+int SimADC::idealCode(double volts) {
+  return (int)floor(volts / SIM_ADC_VREF * SIM_ADC_CODES);
+}
+
+// Function to get the number of conversions since reset
+uint32_t SimADC::getConversions() {
+  return _conversions;
+}
+
+// Function to get the SPI clock
+uint32_t SimADC::getClock() {
+  return _clock;
+}
+
+// Function to sample and convert one input
+// The capacitor only gets 1.5 clock periods to charge, through the source and switch resistance
+int SimADC::convert(int channel) {
+  const SimChannel& source = _channels[channel];
+  double sampleS = SIM_ADC_SAMPLE_CLOCKS / _clock;
+  double tauS = (source.sourceOhms + SIM_ADC_SWITCH_OHMS) * SIM_ADC_SAMPLE_PF * 1e-12;
+  double pin = pinVolts(channel);
+
+  _capVolts = pin + ((_capVolts - pin) * exp(-sampleS / tauS));
+  _conversions++;
+
+  double code = _capVolts / SIM_ADC_VREF * SIM_ADC_CODES;
+  if (_sigmaLsb > 0) {
+    code += gaussian() * _sigmaLsb;
+  }
+  if (_spikePerMille > 0 && (nextRandom() % 1000) < _spikePerMille) {
+    code += (nextRandom() & 1) ? _spikeLsb : -_spikeLsb;
+  }
+
+  return (int)std::min(std::max(floor(code), 0.0), (double)(SIM_ADC_CODES - 1));
+}
+
+// Function to draw from the unit normal distribution (Box-Muller)
+double SimADC::gaussian() {
+  double u1 = ((nextRandom() >> 11) + 1.0) / 9007199254740993.0; // (0, 1]
+  double u2 = (nextRandom() >> 11) / 9007199254740992.0;
+
+  return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+// Function to draw 64 random bits (xorshift64)
+uint64_t SimADC::nextRandom() {
+  _random ^= _random << 13;
+  _random ^= _random >> 7;
+  _random ^= _random << 17;
+  return _random;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
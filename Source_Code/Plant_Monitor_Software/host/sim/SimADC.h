@@ -0,0 +1,62 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimADC_h
+#define SimADC_h
+
+// Include the necessary libraries
+#include <stdint.h>
+
+/* Definitions */
+#define SIM_ADC_CHANNELS 8 // MCP3008 inputs
+#define SIM_ADC_CODES 1024 // both ADCs are 10 bit
+#define SIM_ADC_VREF 2.84 // MCP3008 reference (fed from a GPIO)
+#define SIM_ADC_SWITCH_OHMS 1000.0 // MCP3008 sampling switch resistance (datasheet)
+#define SIM_ADC_SAMPLE_PF 20.0 // MCP3008 sample and hold capacitance (datasheet)
+#define SIM_ADC_SAMPLE_CLOCKS 1.5 // clock periods the sample window stays open
+#define SIM_INTERNAL_VREF 1.1 // ESP8266 A0 range
+#define SIM_BATTERY_R1 389700.0 // battery divider feeding A0
+#define SIM_BATTERY_R2 128100.0
+
+/* One analog source wired to an MCP3008 input */
+struct SimChannel {
+	double volts; // what the source settles to at the pin
+	double sourceOhms; // Thevenin resistance the sample capacitor charges through
+	double riseMs; // time constant of the source after sensor power comes on (0 = instant)
+};
+
+/* SimADC class definition */
+// The MCP3008 on the SPI bus and the ESP8266's own A0 input (battery divider).
+// Conversions are modelled the way the chip does them: during the sample window (1.5 SPI clocks) the
+// 20 pF capacitor charges towards the pin voltage through the source and switch resistance, and keeps
+// whatever it had left from the previous conversion, so a high impedance source read too fast comes
+// out wrong. Gaussian and impulse noise can be injected on top of the result.
+class SimADC {
+	public:
+		/* Public Functions and Methods */
+		static void reset(); // method to put the chip back to its power up state (sample capacitor empty)
+		static void setChannel(int channel, double volts, double sourceOhms, double riseMs=0); // method to script a source
+		static void setVolts(int channel, double volts); // method to change what a source settles to
+		static void setNoise(double sigmaLsb, uint16_t spikePerMille=0, int spikeLsb=0, uint64_t seed=1); // method to inject noise into every conversion
+		static void setBattery(double volts); // method to set the battery voltage behind A0
+		static void setPowered(bool on); // method to switch the chip and sensors (SENSOR_EN)
+		static void setSelected(bool selected); // method to drive chip select (true = low)
+		static void setClock(uint32_t hz); // method to set the SPI clock the conversions run at
+		static uint8_t transfer(uint8_t out); // function to exchange one byte with the chip (takes 8 clock periods)
+		static int readInternal(); // function to convert A0
+		static double pinVolts(int channel); // function to get a source's voltage right now
+		static int idealCode(double volts); // function to get the code a perfect converter gives for a voltage
+		static uint32_t getConversions(); // function to get the number of conversions since reset
+		static uint32_t getClock(); // function to get the SPI clock
+	private:
+		/* Private Functions and Methods */
+		static int convert(int channel); // function to sample and convert one input
+		static double gaussian(); // function to draw from the unit normal distribution
+		static uint64_t nextRandom(); // function to draw 64 random bits
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,77 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimBoard.h"
+#include "SimADC.h"
+#include "SimEnergy.h"
+#include <string.h>
+
+/* Definitions */
+#define PIN_INPUT_PULLUP 0x02 // core's INPUT_PULLUP
+
+/* Variables */
+static uint8_t _levels[SIM_PIN_COUNT]; // level each pin is driven to
+static uint8_t _modes[SIM_PIN_COUNT];
+static bool _configButton = false; // set by the test before a wake, so a process local copy is enough
+
+/* Functions */
+
+// Method to put every pin back to its power up state (inputs, LEDs dark)
+void SimBoard::reset() {
+  memset(_modes, 0, sizeof(_modes));
+  memset(_levels, 0, sizeof(_levels));
+  _levels[SIM_RED_LED_PIN] = 1;
+  _levels[SIM_BLUE_LED_PIN] = 1;
+}
+
+// Method to set a pin's mode
+void SimBoard::pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < SIM_PIN_COUNT) {
+    _modes[pin] = mode;
+  }
+}
+
+// Method to drive a pin
+void SimBoard::digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin >= SIM_PIN_COUNT) {
+    return;
+  }
+
+  _levels[pin] = (value != 0);
+  switch (pin) {
+    case SIM_RED_LED_PIN:
+      SimEnergy::setLoad(LOAD_RED_LED, value == 0);
+      break;
+    case SIM_BLUE_LED_PIN:
+      SimEnergy::setLoad(LOAD_BLUE_LED, value == 0);
+      break;
+    case SIM_SENSOR_EN_PIN:
+      SimEnergy::setLoad(LOAD_SENSORS, value != 0);
+      SimADC::setPowered(value != 0);
+      break;
+    case SIM_ADC_CS_PIN:
+      SimADC::setSelected(value == 0);
+      break;
+    default:
+      break;
+  }
+}
+
+// Function to read a pin
+// Only the settings button is wired to an input, every other pin reads back what it was driven to
+int SimBoard::digitalRead(uint8_t pin) {
+  if (pin == SIM_CONFIG_PIN) {
+    return (_configButton || _modes[pin] != PIN_INPUT_PULLUP) ? 0 : 1;
+  }
+  return (pin < SIM_PIN_COUNT) ? _levels[pin] : 0;
+}
+
+// Method to hold or release the settings button
+void SimBoard::setConfigButton(bool held) {
+  _configButton = held;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
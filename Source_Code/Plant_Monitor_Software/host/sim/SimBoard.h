@@ -0,0 +1,36 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimBoard_h
+#define SimBoard_h
+
+// Include the necessary libraries
+#include <stdint.h>
+
+/* Definitions */
+// What the node's pins are wired to (see FinalProject.ino and SensorMetrics.cpp)
+#define SIM_RED_LED_PIN 0 // lit while low
+#define SIM_BLUE_LED_PIN 2 // lit while low
+#define SIM_SENSOR_EN_PIN 4 // powers the MCP3008 and the sensors while high
+#define SIM_CONFIG_PIN 5 // settings button, pulls the pin low while held
+#define SIM_ADC_CS_PIN 15 // MCP3008 chip select, active low
+#define SIM_PIN_COUNT 17
+
+/* SimBoard class definition */
+// GPIO of the node: drives the LEDs and sensor power in the energy model and the chip select of the ADC model,
+// and reads back the settings button
+class SimBoard {
+	public:
+		/* Public Functions and Methods */
+		static void reset(); // method to put every pin back to its power up state
+		static void pinMode(uint8_t pin, uint8_t mode); // method to set a pin's mode
+		static void digitalWrite(uint8_t pin, uint8_t value); // method to drive a pin
+		static int digitalRead(uint8_t pin); // function to read a pin
+		static void setConfigButton(bool held); // method to hold or release the settings button (kept across wakes)
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,44 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimClock.h"
+#include "SimEnergy.h"
+#include "SimNode.h"
+
+/* Variables */
+static uint64_t _nowUs = 0; // µs since boot
+
+/* Functions */
+
+// Function to get the µs since boot
+uint64_t SimClock::now() {
+  return _nowUs;
+}
+
+// Method to move time forward
+// The energy model integrates the current drawn over the step, and a wake that runs away is stopped
+void SimClock::advance(uint64_t us) {
+  SimEnergy::elapse(_nowUs, us);
+  _nowUs += us;
+
+  if (_nowUs > SIM_WAKE_LIMIT_US) {
+    SimNode::halt(WAKE_HUNG);
+  }
+}
+
+// Method to move time forward to a point
+void SimClock::advanceTo(uint64_t us) {
+  if (us > _nowUs) {
+    advance(us - _nowUs);
+  }
+}
+
+// Method to start again from boot
+void SimClock::reset() {
+  _nowUs = 0;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
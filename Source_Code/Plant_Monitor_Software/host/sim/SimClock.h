@@ -0,0 +1,30 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimClock_h
+#define SimClock_h
+
+// Include the necessary libraries
+#include <stdint.h>
+
+/* Definitions */
+#define SIM_YIELD_US 100 // virtual time one yield() takes, about one pass of the WiFi stack
+#define SIM_WAKE_LIMIT_US 600000000ULL // a wake still running after 10 virtual minutes is treated as hung
+
+/* SimClock class definition */
+// Virtual time since boot. Nothing in the simulation takes real time: waits, bus transfers, radio round
+// trips and CPU heavy work (TLS) all move this clock forward by what they would take on the node.
+class SimClock {
+	public:
+		/* Public Functions and Methods */
+		static uint64_t now(); // function to get the µs since boot
+		static void advance(uint64_t us); // method to move time forward (charges the energy model for the time)
+		static void advanceTo(uint64_t us); // method to move time forward to a point, if it isn't already past it
+		static void reset(); // method to start again from boot
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
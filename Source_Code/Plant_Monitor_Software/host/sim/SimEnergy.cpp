@@ -0,0 +1,148 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimEnergy.h"
+#include "SimClock.h"
+#include <string.h>
+#include <vector>
+
+/* Definitions */
+#define US_PER_S 1e6
+
+/* Variables */
+// Point where the current changed, with the energy drawn up to it, for charging phases after the fact
+struct EnergyStep {
+  uint64_t atUs;
+  double drawnMj; // drawn from boot up to atUs
+  double currentMa; // drawn from atUs until the next step
+};
+
+static bool _loads[LOAD_COUNT];
+static SimEnergyReport _report;
+static std::vector<EnergyStep> _steps;
+
+/* Constants */
+static const double _LOAD_MA[LOAD_COUNT] = { SIM_CPU_MA, SIM_RADIO_MA, SIM_SENSORS_MA, SIM_LED_MA, SIM_LED_MA };
+
+/* Functions */
+
+// Method to start a new wake with only the CPU on
+void SimEnergy::reset() {
+  memset(_loads, 0, sizeof(_loads));
+  memset(&_report, 0, sizeof(_report));
+  _loads[LOAD_CPU] = true;
+  _steps.clear();
+  _steps.push_back({ SimClock::now(), 0, current() });
+}
+
+// Method to switch a load on or off from now on
+void SimEnergy::setLoad(SimLoad load, bool on) {
+  if (_loads[load] == on) {
+    return;
+  }
+
+  _loads[load] = on;
+  _steps.push_back({ SimClock::now(), _report.totalMj, current() });
+}
+
+// Function to check whether a load is on
+bool SimEnergy::isOn(SimLoad load) {
+  return _loads[load];
+}
+
+// Method to charge the air time of bytes sent
+void SimEnergy::transmit(size_t bytes) {
+  double mj = SIM_TX_MA * SIM_SUPPLY_V * (bytes * SIM_TX_US_PER_BYTE) / US_PER_S;
+
+  _report.totalMj += mj;
+  _report.loadMj[LOAD_RADIO] += mj;
+  _report.txBytes += bytes;
+  _steps.push_back({ SimClock::now(), _report.totalMj, current() });
+}
+
+// Method to integrate the current over a step of the clock
+void SimEnergy::elapse(uint64_t fromUs, uint64_t us) {
+  (void)fromUs;
+  for (int l = 0; l < LOAD_COUNT; l++) {
+    if (_loads[l]) {
+      double mj = _LOAD_MA[l] * SIM_SUPPLY_V * us / US_PER_S;
+      _report.loadMj[l] += mj;
+      _report.totalMj += mj;
+    }
+  }
+  if (_loads[LOAD_RADIO]) {
+    _report.radioOnUs += us;
+  }
+}
+
+// Method to charge a profiled phase that just ended
+// The phase ran from elapsedUs ago until now, so it is charged the energy drawn in between
+void SimEnergy::phaseEnded(uint8_t phase, uint32_t elapsedUs) {
+  uint64_t now = SimClock::now();
+  uint64_t start = (elapsedUs < now) ? (now - elapsedUs) : 0;
+
+  if (phase >= SIM_MAX_PHASES) {
+    return;
+  }
+
+  _report.phaseMj[phase] += drawnBy(now) - drawnBy(start);
+  _report.phaseUs[phase] += elapsedUs;
+  _report.phaseCount[phase]++;
+}
+
+// Function to get what this wake has drawn so far
+const SimEnergyReport& SimEnergy::getReport() {
+  return _report;
+}
+
+// Function to get what a deep sleep of sleepUs draws
+double SimEnergy::sleepMj(uint64_t sleepUs) {
+  return SIM_SLEEP_MA * SIM_SUPPLY_V * sleepUs / US_PER_S;
+}
+
+// Function to get the energy drawn from boot up to a point in time
+// Finds the last step at or before the point (the latest one, where several share a time) and adds the
+// current drawn since it
+double SimEnergy::drawnBy(uint64_t us) {
+  size_t lo = 0, hi = _steps.size();
+
+  if (_steps.empty()) { // outside a wake (a test calling the firmware directly), nothing is drawn
+    return 0;
+  }
+
+  while (hi - lo > 1) {
+    size_t mid = (lo + hi) / 2;
+    if (_steps[mid].atUs <= us) {
+      lo = mid;
+    }
+    else {
+      hi = mid;
+    }
+  }
+
+  const EnergyStep& step = _steps[lo];
+  uint64_t since = (us > step.atUs) ? (us - step.atUs) : 0;
+  return step.drawnMj + (step.currentMa * SIM_SUPPLY_V * since / US_PER_S);
+}
+
+// Function to get the current drawn right now
+double SimEnergy::current() {
+  double ma = 0;
+
+  for (int l = 0; l < LOAD_COUNT; l++) {
+    if (_loads[l]) {
+      ma += _LOAD_MA[l];
+    }
+  }
+  return ma;
+}
+
+// Function the firmware's Hal::phaseEnded() calls in the host build (HAL_TRACE_PHASE)
+void simTracePhase(uint8_t phase, uint32_t elapsedUs) {
+  SimEnergy::phaseEnded(phase, elapsedUs);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
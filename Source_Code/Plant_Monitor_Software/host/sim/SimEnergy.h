@@ -0,0 +1,70 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimEnergy_h
+#define SimEnergy_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+
+/* Definitions */
+// Supply current of each part of the node (mA), typical ESP8266 datasheet figures
+#define SIM_CPU_MA 15.0 // CPU at 80 MHz with the modem asleep
+#define SIM_RADIO_MA 56.0 // radio powered and listening, on top of the CPU
+#define SIM_TX_MA 120.0 // transmitting, on top of listening
+#define SIM_TX_US_PER_BYTE 1.0 // air time per byte sent (TCP/UDP payload plus framing at 802.11g rates)
+#define SIM_SENSORS_MA 1.2 // MCP3008 and the sensor dividers, while SENSOR_EN is high
+#define SIM_LED_MA 3.0 // each indicator LED while lit
+#define SIM_SLEEP_MA 0.02 // deep sleep with the RTC running
+#define SIM_SUPPLY_V 3.3 // regulated supply the currents are drawn at
+
+#define SIM_MAX_PHASES 8 // phases the energy can be broken down into (Profiler's ProfilePhase values)
+
+/* Parts of the node that draw current while awake */
+enum SimLoad {
+	LOAD_CPU, // always on while awake
+	LOAD_RADIO, // modem powered (boot with the radio enabled, until forceSleepBegin() or WiFi off)
+	LOAD_SENSORS, // external ADC and sensor dividers
+	LOAD_RED_LED,
+	LOAD_BLUE_LED,
+	LOAD_COUNT // number of loads (not a load)
+};
+
+/* Energy drawn during one wake */
+struct SimEnergyReport {
+	double totalMj; // boot to deep sleep
+	double loadMj[LOAD_COUNT]; // share of the total drawn by each load (transmitting counts against the radio)
+	double phaseMj[SIM_MAX_PHASES]; // drawn during each profiled phase, summed over its occurrences (phases nest, so these overlap)
+	uint64_t phaseUs[SIM_MAX_PHASES]; // time spent in each profiled phase
+	uint16_t phaseCount[SIM_MAX_PHASES]; // occurrences of each profiled phase
+	uint64_t radioOnUs; // time the modem was powered
+	uint64_t txBytes; // bytes put on the air
+};
+
+/* SimEnergy class definition */
+// Integrates the current drawn over virtual time. The loads switch on and off as the firmware drives the
+// pins and the radio, and every phase the firmware's Profiler records is charged with what was drawn
+// between its start and end, so energy can be broken down the same way as awake time.
+class SimEnergy {
+	public:
+		/* Public Functions and Methods */
+		static void reset(); // method to start a new wake with only the CPU on
+		static void setLoad(SimLoad load, bool on); // method to switch a load on or off from now on
+		static bool isOn(SimLoad load); // function to check whether a load is on
+		static void transmit(size_t bytes); // method to charge the air time of bytes sent
+		static void elapse(uint64_t fromUs, uint64_t us); // method to integrate the current over a step of the clock
+		static void phaseEnded(uint8_t phase, uint32_t elapsedUs); // method to charge a profiled phase that just ended
+		static const SimEnergyReport& getReport(); // function to get what this wake has drawn so far
+		static double sleepMj(uint64_t sleepUs); // function to get what a deep sleep of sleepUs draws
+	private:
+		/* Private Functions and Methods */
+		static double drawnBy(uint64_t us); // function to get the energy drawn from boot up to a point in time (mJ)
+		static double current(); // function to get the current drawn right now (mA)
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,86 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimFlash.h"
+#include "SimClock.h"
+#include "SimShared.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+/* Variables */
+// Flash state shared with every wake
+struct FlashState {
+  char root[PATH_MAX];
+  char temporary[PATH_MAX]; // directory made for this run, removed at exit
+  SimFlashStats stats;
+};
+
+static FlashState* createState(); // makes a fresh temporary directory
+static FlashState* _shared = createState();
+
+/* Functions */
+
+// Method to remove the temporary directory when the run ends (wakes leave with _exit() and skip this)
+static void removeTemporary() {
+  std::string command = std::string("rm -rf '") + _shared->temporary + "'";
+
+  if (system(command.c_str()) != 0) {
+    perror("SimFlash");
+  }
+}
+
+// Function to create the shared state, with an empty temporary directory as the flash
+static FlashState* createState() {
+  FlashState* state = SimShared::create<FlashState>();
+
+  snprintf(state->temporary, sizeof(state->temporary), "/tmp/simflash.XXXXXX");
+  if (mkdtemp(state->temporary) == NULL) {
+    perror("SimFlash");
+    abort();
+  }
+  snprintf(state->root, sizeof(state->root), "%s", state->temporary);
+  atexit(removeTemporary);
+  return state;
+}
+
+// Method to use a directory as the flash
+void SimFlash::setRoot(const char* directory) {
+  snprintf(_shared->root, sizeof(_shared->root), "%s", directory);
+}
+
+// Function to get the directory
+const char* SimFlash::root() {
+  return _shared->root;
+}
+
+// Method to wipe the flash as it comes from the factory
+void SimFlash::erase() {
+  std::string command = std::string("rm -rf '") + root() + "/fs' '" + root() + "/eeprom.bin'";
+
+  if (system(command.c_str()) != 0) {
+    perror("SimFlash");
+  }
+}
+
+// Function to get what the flash was asked to do so far
+const SimFlashStats& SimFlash::getStats() {
+  return _shared->stats;
+}
+
+// Function for the file system and EEPROM shims to count their work
+SimFlashStats& SimFlash::stats() {
+  return _shared->stats;
+}
+
+// Method to charge flash time
+void SimFlash::charge(uint64_t us) {
+  SimClock::advance(us);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
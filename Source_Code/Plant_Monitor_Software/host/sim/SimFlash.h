@@ -0,0 +1,49 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimFlash_h
+#define SimFlash_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+
+/* Definitions */
+// Time the SPI flash takes (virtual µs), ESP8266 with LittleFS
+#define SIM_FLASH_MOUNT_US 25000 // reading the superblocks and walking the metadata
+#define SIM_FLASH_FORMAT_US 1500000 // erasing the file system area
+#define SIM_FLASH_OPEN_US 2000 // finding a file
+#define SIM_FLASH_READ_US_PER_BYTE 0.25
+#define SIM_FLASH_WRITE_US_PER_BYTE 3.0 // programming, erases amortised
+#define SIM_FLASH_COMMIT_US 40000 // EEPROM sector erase and rewrite
+
+/* What the flash was asked to do, accumulated over every wake */
+struct SimFlashStats {
+	uint32_t mounts;
+	uint32_t formats;
+	uint32_t opens;
+	uint32_t commits; // EEPROM sectors written
+	uint64_t bytesRead;
+	uint64_t bytesWritten;
+};
+
+/* SimFlash class definition */
+// SPI flash of the node, kept in a host directory so it survives every wake the way flash does: the file system
+// lives under fs/ (formatted once fs/.formatted exists), the emulated EEPROM sector in eeprom.bin. Every access
+// costs virtual time, so a wake that mounts or writes the file system pays for it.
+class SimFlash {
+	public:
+		/* Public Functions and Methods */
+		static void setRoot(const char* directory); // method to use a directory as the flash (before the first wake)
+		static const char* root(); // function to get the directory (a fresh temporary one, removed at exit, unless set)
+		static void erase(); // method to wipe the flash as it comes from the factory
+		static const SimFlashStats& getStats(); // function to get what the flash was asked to do so far
+		static SimFlashStats& stats(); // function for the file system and EEPROM shims to count their work
+		static void charge(uint64_t us); // method to charge flash time
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,166 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimHeap.h"
+#include <math.h>
+
+/* Definitions */
+#define FRAGMENTATION_FULL 100
+
+/* Header at the start of every chunk of the arena, free or in use */
+struct ChunkHeader {
+  uint32_t bytes; // size of the chunk, header included (a multiple of SIM_HEAP_BLOCK)
+  uint32_t used; // whether the chunk is allocated
+};
+
+static_assert(sizeof(ChunkHeader) == SIM_HEAP_BLOCK, "a chunk header must take exactly one block");
+static_assert(SIM_HEAP_BYTES % SIM_HEAP_BLOCK == 0, "the arena must be a whole number of blocks");
+
+/* Variables */
+alignas(SIM_HEAP_BLOCK) static uint8_t _arena[SIM_HEAP_BYTES];
+static bool f_Initialized = false;
+static SimHeapStats _stats;
+static SimHeapHook _hook = NULL;
+
+/* Functions */
+
+// Function to get the header of the chunk at an offset in the arena
+// The whole arena is made one free chunk on first use
+static ChunkHeader* chunkAt(size_t offset) {
+  if (!f_Initialized) {
+    reinterpret_cast<ChunkHeader*>(_arena)->bytes = SIM_HEAP_BYTES;
+    reinterpret_cast<ChunkHeader*>(_arena)->used = 0;
+    f_Initialized = true;
+  }
+  return reinterpret_cast<ChunkHeader*>(_arena + offset);
+}
+
+// Method to merge the free chunks that follow a free chunk into it
+// Freeing doesn't merge, so the walks over the arena do it as they pass
+static void coalesce(size_t offset) {
+  ChunkHeader* chunk = chunkAt(offset);
+
+  while (offset + chunk->bytes < SIM_HEAP_BYTES && !chunkAt(offset + chunk->bytes)->used) {
+    chunk->bytes += chunkAt(offset + chunk->bytes)->bytes;
+  }
+}
+
+// Function to allocate size bytes from the first free chunk large enough
+void* SimHeap::allocate(size_t size) {
+  size_t need = (((size + SIM_HEAP_BLOCK - 1) / SIM_HEAP_BLOCK) + 1) * SIM_HEAP_BLOCK; // rounded up, plus the header
+  void* ptr = NULL;
+
+  for (size_t offset = 0; offset < SIM_HEAP_BYTES && ptr == NULL; offset += chunkAt(offset)->bytes) {
+    ChunkHeader* chunk = chunkAt(offset);
+    if (chunk->used) {
+      continue;
+    }
+    coalesce(offset);
+    if (chunk->bytes < need) {
+      continue;
+    }
+
+    if (chunk->bytes >= need + (2 * SIM_HEAP_BLOCK)) { // split off the rest if it can hold anything
+      chunkAt(offset + need)->bytes = chunk->bytes - need;
+      chunkAt(offset + need)->used = 0;
+      chunk->bytes = need;
+    }
+    chunk->used = 1;
+    ptr = _arena + offset + SIM_HEAP_BLOCK;
+
+    _stats.allocations++;
+    _stats.usedBytes += chunk->bytes;
+    if (_stats.usedBytes > _stats.peakBytes) {
+      _stats.peakBytes = _stats.usedBytes;
+    }
+  }
+
+  if (ptr == NULL) {
+    _stats.failures++;
+  }
+  if (_hook != NULL) {
+    _hook(size, ptr);
+  }
+  return ptr;
+}
+
+// Method to free an allocation, its chunk is merged with free neighbours by later walks
+void SimHeap::release(void* ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+
+  ChunkHeader* chunk = reinterpret_cast<ChunkHeader*>(static_cast<uint8_t*>(ptr) - SIM_HEAP_BLOCK);
+  chunk->used = 0;
+  _stats.usedBytes -= chunk->bytes;
+  _stats.frees++;
+}
+
+// Function to get the bytes free, headers of the free chunks included (as the core counts them)
+uint32_t SimHeap::getFreeBytes() {
+  uint32_t free = 0;
+
+  for (size_t offset = 0; offset < SIM_HEAP_BYTES; offset += chunkAt(offset)->bytes) {
+    if (!chunkAt(offset)->used) {
+      coalesce(offset);
+      free += chunkAt(offset)->bytes;
+    }
+  }
+  return free;
+}
+
+// Function to get the largest allocation that would succeed
+uint32_t SimHeap::getMaxFreeBlock() {
+  uint32_t largest = 0;
+
+  for (size_t offset = 0; offset < SIM_HEAP_BYTES; offset += chunkAt(offset)->bytes) {
+    if (!chunkAt(offset)->used) {
+      coalesce(offset);
+      if (chunkAt(offset)->bytes - SIM_HEAP_BLOCK > largest) {
+        largest = chunkAt(offset)->bytes - SIM_HEAP_BLOCK;
+      }
+    }
+  }
+  return largest;
+}
+
+// Function to get the fragmentation: 100 - 100 * sqrt(sum of the free chunks squared) / free bytes,
+// which is 0 when everything free is one chunk and approaches 100 as it splits into many small ones
+uint8_t SimHeap::getFragmentation() {
+  double free = 0;
+  double sumSquares = 0;
+
+  for (size_t offset = 0; offset < SIM_HEAP_BYTES; offset += chunkAt(offset)->bytes) {
+    if (!chunkAt(offset)->used) {
+      coalesce(offset);
+      double bytes = chunkAt(offset)->bytes;
+      free += bytes;
+      sumSquares += bytes * bytes;
+    }
+  }
+  return (free == 0) ? FRAGMENTATION_FULL : (uint8_t)(FRAGMENTATION_FULL - ((FRAGMENTATION_FULL * sqrt(sumSquares)) / free));
+}
+
+// Function to get the counts since the last reset
+const SimHeapStats& SimHeap::getStats() {
+  return _stats;
+}
+
+// Method to zero the counts, what is in use stays and becomes the peak
+void SimHeap::resetStats() {
+  uint32_t used = _stats.usedBytes;
+
+  _stats = SimHeapStats();
+  _stats.usedBytes = used;
+  _stats.peakBytes = used;
+}
+
+// Method to have a function called on every allocation
+void SimHeap::setHook(SimHeapHook hook) {
+  _hook = hook;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
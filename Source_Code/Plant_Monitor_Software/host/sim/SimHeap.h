@@ -0,0 +1,49 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimHeap_h
+#define SimHeap_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+
+/* Definitions */
+#define SIM_HEAP_BYTES 40000 // free heap at the start of setup() with WiFi and TLS buffers allocated lazily
+#define SIM_HEAP_BLOCK 8 // allocation granularity, a header takes one block (as umm_malloc's does)
+
+/* Function called on every allocation the firmware makes (ptr is NULL if it failed) */
+typedef void (*SimHeapHook)(size_t size, void* ptr);
+
+/* What the heap was asked to do since the last resetStats() */
+struct SimHeapStats {
+	uint32_t allocations; // successful allocations
+	uint32_t failures; // allocations with no free block large enough
+	uint32_t frees;
+	uint32_t usedBytes; // bytes allocated now, headers included
+	uint32_t peakBytes; // most bytes allocated at once
+};
+
+/* SimHeap class definition */
+// The node's heap: a first fit allocator over an arena the size of what the ESP8266 has free, which String
+// (and anything else in the core stand-ins that would use malloc on the chip) allocates from. Blocks go back
+// with no compaction, so fragmentation and a failed allocation look as they would on the chip. Every wake
+// starts from the heap as static initialisation left it, like a reset does; stats belong to the wake.
+class SimHeap {
+	public:
+		/* Public Functions and Methods */
+		static void* allocate(size_t size); // function to allocate size bytes, NULL if no free block is large enough
+		static void release(void* ptr); // method to free an allocation (NULL is ignored)
+		static uint32_t getFreeBytes(); // function to get the bytes free
+		static uint32_t getMaxFreeBlock(); // function to get the largest allocation that would succeed
+		static uint8_t getFragmentation(); // function to get the fragmentation (%) as the ESP8266 core computes it
+		static const SimHeapStats& getStats(); // function to get the counts since the last reset
+		static void resetStats(); // method to zero the counts, and bring the peak down to what is in use now
+		static void setHook(SimHeapHook hook); // method to have a function called on every allocation (NULL = none)
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,559 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimNetwork.h"
+#include "SimClock.h"
+#include "SimEnergy.h"
+#include "SimShared.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+/* Definitions */
+#define US_PER_MS 1000
+#define PACKET_OVERHEAD 54 // 802.11, IP and TCP/UDP headers on each write
+
+/* Variables */
+// State that outlives a wake: the profile, the statistics, the servers' TLS session caches and the random stream
+struct NetworkState {
+  SimLink link;
+  SimNetStats stats;
+  uint32_t sessions[SIM_TLS_SESSION_CACHE]; // session IDs the servers remember (0 = empty)
+  uint8_t nextSession; // cache entry the next session replaces
+  uint32_t sessionSerial; // last session ID handed out
+  uint64_t random; // xorshift state
+};
+
+// Byte on its way to the node
+struct InboundByte {
+  uint64_t at; // µs it arrives
+  uint8_t value;
+};
+
+// Node side of a TCP connection
+struct Connection {
+  SimPeer* peer;
+  bool open; // node hasn't closed it
+  bool greeted; // peer has been told about the connection
+  uint64_t hangUpAt; // µs the peer's side closes (0 = still open)
+  uint64_t lastDelivery; // µs the last reply arrives, replies stay in order
+  uint64_t flightStart; // µs the bytes in flight were sent
+  size_t inFlight; // bytes sent but not yet acknowledged
+  std::deque<InboundByte> inbound;
+};
+
+// Server on a TCP or UDP port
+struct Endpoint {
+  uint32_t address;
+  uint16_t port;
+  bool tls;
+  SimPeer* peer;
+  SimDatagramPeer* datagramPeer;
+};
+
+// Datagram on its way to the node
+struct InboundDatagram {
+  uint64_t at;
+  uint16_t port;
+  std::vector<uint8_t> data;
+};
+
+static NetworkState* createState(); // fills in a typical home network
+static NetworkState* _shared = createState();
+
+static std::vector<Endpoint> _endpoints;
+static std::vector<std::pair<std::string, uint32_t> > _hosts;
+static std::vector<Connection> _connections;
+static std::vector<InboundDatagram> _datagrams;
+static bool _radioEnabled = true; // radio was calibrated at boot
+static bool _joining = false;
+static bool _joined = false;
+static bool _fastJoin = false;
+static uint64_t _joinAt = 0; // µs joining completes
+static uint64_t _replyAt = 0; // µs replies to the write being handled arrive (0 = not drawn yet)
+
+/* Functions */
+
+// Function to create the shared state, with a typical home network and one server round trip of 60 ms
+static NetworkState* createState() {
+  static const uint8_t bssid[SIM_BSSID_SIZE] = { 0x18, 0xFE, 0x34, 0x12, 0x34, 0x56 };
+  NetworkState* state = SimShared::create<NetworkState>();
+  SimLink& link = state->link;
+
+  link.apUp = true;
+  link.ssid[0] = '\0'; // any network name is accepted
+  memcpy(link.bssid, bssid, sizeof(bssid));
+  link.channel = 6;
+  link.scanMs = 1800;
+  link.assocMs = 250;
+  link.dhcpMs = 600;
+  link.leaseS = 86400;
+  link.dnsMs = 40;
+  link.rttMs = 60;
+  link.jitterMs = 0;
+  link.lossPerMille = 0;
+  link.serversUp = true;
+  state->random = 0x9E3779B97F4A7C15ULL;
+  return state;
+}
+
+// Function to get the network profile
+SimLink& SimNetwork::link() {
+  return _shared->link;
+}
+
+// Function to get what went over the network so far
+const SimNetStats& SimNetwork::getStats() {
+  return _shared->stats;
+}
+
+// Method to zero the statistics
+void SimNetwork::resetStats() {
+  memset(&_shared->stats, 0, sizeof(_shared->stats));
+}
+
+// Method to add a DNS entry
+void SimNetwork::addHost(const char* name, uint32_t address) {
+  _hosts.push_back(std::make_pair(std::string(name), address));
+}
+
+// Method to put a server on a TCP port
+void SimNetwork::listen(uint32_t address, uint16_t port, SimPeer* peer, bool tls) {
+  _endpoints.push_back({ address, port, tls, peer, NULL });
+}
+
+// Method to put a server on a UDP port
+void SimNetwork::listenDatagrams(uint32_t address, uint16_t port, SimDatagramPeer* peer) {
+  _endpoints.push_back({ address, port, false, NULL, peer });
+}
+
+// Method to queue round trips for the next replies
+void SimNetwork::scriptLatency(const uint32_t* rttMs, size_t count) {
+  SimLink& link = _shared->link;
+
+  count = std::min(count, (size_t)SIM_LATENCY_SCRIPT_SIZE);
+  memcpy(link.latencyScript, rttMs, count * sizeof(*rttMs));
+  link.scriptLength = count;
+  link.scriptPos = 0;
+}
+
+// Method to make the servers forget every TLS session
+void SimNetwork::forgetSessions() {
+  memset(_shared->sessions, 0, sizeof(_shared->sessions));
+}
+
+// Method to start a wake
+// Nothing the radio or sockets were doing survives deep sleep
+void SimNetwork::boot(bool radioEnabled) {
+  _connections.clear();
+  _datagrams.clear();
+  _radioEnabled = radioEnabled;
+  _joining = false;
+  _joined = false;
+  setRadio(radioEnabled); // a calibrated radio is powered from boot until it is put to sleep
+}
+
+// Method to power the modem up or down (it can't come up on a wake that booted without it)
+void SimNetwork::setRadio(bool on) {
+  on = on && _radioEnabled;
+  if (!on) {
+    disassociate();
+  }
+  SimEnergy::setLoad(LOAD_RADIO, on);
+}
+
+// Method to start joining
+// A BSSID and channel skip the scan, but only work if the access point is still there; a static
+// configuration skips DHCP
+void SimNetwork::associate(const char* ssid, int32_t channel, const uint8_t* bssid, bool staticConfig) {
+  const SimLink& link = _shared->link;
+  uint32_t ms = link.assocMs;
+
+  _joining = false;
+  _joined = false;
+  setRadio(true);
+
+  if (!SimEnergy::isOn(LOAD_RADIO) || !link.apUp || (link.ssid[0] != '\0' && strcmp(ssid, link.ssid) != 0)) {
+    return; // never joins
+  }
+
+  if (bssid != NULL) {
+    if (memcmp(bssid, link.bssid, SIM_BSSID_SIZE) != 0 || channel != link.channel) {
+      return; // stale settings, nothing answers
+    }
+  }
+  else {
+    ms += link.scanMs;
+  }
+  if (!staticConfig) {
+    ms += link.dhcpMs;
+  }
+
+  _fastJoin = (bssid != NULL);
+  _joining = true;
+  _joinAt = SimClock::now() + ((uint64_t)ms * US_PER_MS);
+}
+
+// Method to leave the network
+void SimNetwork::disassociate() {
+  _joining = false;
+  _joined = false;
+}
+
+// Function to check whether joining has finished
+bool SimNetwork::isAssociated() {
+  if (_joining && SimClock::now() >= _joinAt) {
+    _joining = false;
+    _joined = true;
+    _shared->stats.associations++;
+    if (_fastJoin) {
+      _shared->stats.fastAssociations++;
+    }
+  }
+  return _joined;
+}
+
+// Function for a test wake to join the network as it is (any SSID, scanning, DHCP) and wait for it a
+// millisecond at a time, as a sketch polling WiFi.status() would; false if it hadn't joined by timeoutMs
+bool SimNetwork::join(unsigned long timeoutMs) {
+  associate("", 0, NULL, false);
+  for (unsigned long ms = 0; ms < timeoutMs && !isAssociated(); ms++) {
+    SimClock::advance(US_PER_MS);
+  }
+  return isAssociated();
+}
+
+// Function to look a name up (a dotted address needs no lookup)
+bool SimNetwork::resolve(const char* name, uint32_t& address, unsigned long timeoutMs) {
+  const SimLink& link = _shared->link;
+  unsigned int a, b, c, d;
+  char trailing;
+
+  if (sscanf(name, "%u.%u.%u.%u%c", &a, &b, &c, &d, &trailing) == 4 && a < 256 && b < 256 && c < 256 && d < 256) {
+    address = a | (b << 8) | (c << 16) | (d << 24);
+    return true;
+  }
+  if (!isAssociated()) {
+    return false;
+  }
+
+  _shared->stats.lookups++;
+  if (!link.serversUp || link.dnsMs > timeoutMs) {
+    SimClock::advance((uint64_t)timeoutMs * US_PER_MS);
+    return false;
+  }
+  SimClock::advance((uint64_t)link.dnsMs * US_PER_MS);
+
+  for (size_t i = 0; i < _hosts.size(); i++) {
+    if (_hosts[i].first == name) {
+      address = _hosts[i].second;
+      return true;
+    }
+  }
+  return false; // no such name
+}
+
+// Function to open a connection, blocking for the TCP handshake
+int SimNetwork::connect(uint32_t address, uint16_t port, unsigned long timeoutMs) {
+  uint64_t timeoutUs = (uint64_t)timeoutMs * US_PER_MS;
+  const Endpoint* endpoint = NULL;
+
+  _replyAt = 0;
+  for (size_t i = 0; i < _endpoints.size(); i++) {
+    if (_endpoints[i].address == address && _endpoints[i].port == port && _endpoints[i].peer != NULL) {
+      endpoint = &_endpoints[i];
+    }
+  }
+
+  if (!isAssociated()) { // no route
+    _shared->stats.connectFailures++;
+    return -1;
+  }
+  if (!_shared->link.serversUp) { // SYNs go unanswered
+    SimClock::advance(timeoutUs);
+    _shared->stats.connectFailures++;
+    return -1;
+  }
+  if (endpoint == NULL) { // nothing listening, reset
+    SimClock::advance(std::min(timeoutUs, (uint64_t)SIM_CONNECT_REFUSED_MS * US_PER_MS));
+    _shared->stats.connectFailures++;
+    return -1;
+  }
+
+  uint64_t handshakeUs = nextRoundTrip();
+  if (lost()) {
+    handshakeUs += (uint64_t)SIM_RETRANSMIT_MS * US_PER_MS;
+    _shared->stats.lostSegments++;
+  }
+  if (handshakeUs > timeoutUs) {
+    SimClock::advance(timeoutUs);
+    _shared->stats.connectFailures++;
+    return -1;
+  }
+  SimClock::advance(handshakeUs);
+  SimEnergy::transmit(PACKET_OVERHEAD * 2); // SYN and ACK
+
+  Connection connection = {};
+  connection.peer = endpoint->peer;
+  connection.open = true;
+  _connections.push_back(connection);
+  _shared->stats.connects++;
+
+  int handle = _connections.size() - 1;
+  if (!endpoint->tls) { // a TLS server only speaks once the handshake is done
+    _connections[handle].greeted = true;
+    _replyAt = 0;
+    endpoint->peer->accepted(handle);
+  }
+  return handle;
+}
+
+// Function to run the TLS handshake
+// A session the server still remembers is resumed in one round trip without the key exchange, otherwise a
+// full handshake takes two round trips and the CPU heavy part, and hands out a new session
+bool SimNetwork::handshake(int connection, uint32_t& sessionId, unsigned long timeoutMs) {
+  Connection& c = _connections[connection];
+  bool f_Resumed = false;
+
+  if (!c.open) {
+    return false;
+  }
+  for (int s = 0; sessionId != 0 && s < SIM_TLS_SESSION_CACHE; s++) {
+    f_Resumed = f_Resumed || (_shared->sessions[s] == sessionId);
+  }
+
+  uint64_t us = f_Resumed ? (nextRoundTrip() + ((uint64_t)SIM_TLS_RESUME_CPU_MS * US_PER_MS))
+                          : ((2 * nextRoundTrip()) + ((uint64_t)SIM_TLS_FULL_CPU_MS * US_PER_MS));
+  if (us > (uint64_t)timeoutMs * US_PER_MS) {
+    SimClock::advance((uint64_t)timeoutMs * US_PER_MS);
+    close(connection);
+    return false;
+  }
+  SimClock::advance(us);
+  SimEnergy::transmit(f_Resumed ? 300 : 600); // hellos, key exchange and finished messages
+
+  if (f_Resumed) {
+    _shared->stats.resumedHandshakes++;
+  }
+  else {
+    sessionId = ++_shared->sessionSerial;
+    _shared->sessions[_shared->nextSession] = sessionId;
+    _shared->nextSession = (_shared->nextSession + 1) % SIM_TLS_SESSION_CACHE;
+    _shared->stats.fullHandshakes++;
+  }
+
+  c.greeted = true;
+  _replyAt = 0;
+  c.peer->accepted(connection);
+  return true;
+}
+
+// Function to write to the server
+// The peer handles the bytes straight away; lwIP only lets a couple of segments be in flight, so a long
+// write waits a round trip for each window's worth to be acknowledged
+size_t SimNetwork::send(int connection, const uint8_t* data, size_t size) {
+  Connection& c = _connections[connection];
+  const SimLink& link = _shared->link;
+
+  if (!c.open || (c.hangUpAt != 0 && SimClock::now() >= c.hangUpAt)) {
+    return 0;
+  }
+
+  uint64_t rttUs = (uint64_t)link.rttMs * US_PER_MS;
+  if (SimClock::now() - c.flightStart >= rttUs) {
+    c.inFlight = 0;
+    c.flightStart = SimClock::now();
+  }
+  c.inFlight += size;
+  while (c.inFlight > SIM_TCP_WINDOW) { // wait for the acknowledgement of the oldest window
+    SimClock::advanceTo(c.flightStart + rttUs);
+    c.inFlight -= SIM_TCP_WINDOW;
+    c.flightStart = SimClock::now();
+  }
+
+  SimEnergy::transmit(size + PACKET_OVERHEAD);
+  _shared->stats.bytesSent += size;
+
+  _replyAt = 0;
+  if (c.greeted) {
+    c.peer->received(connection, data, size);
+  }
+  return size;
+}
+
+// Function to get the number of bytes that have arrived
+int SimNetwork::available(int connection) {
+  const Connection& c = _connections[connection];
+  uint64_t now = SimClock::now();
+  int count = 0;
+
+  for (std::deque<InboundByte>::const_iterator b = c.inbound.begin(); b != c.inbound.end() && b->at <= now; ++b) {
+    count++;
+  }
+  return count;
+}
+
+// Function to read a byte that has arrived
+int SimNetwork::read(int connection) {
+  Connection& c = _connections[connection];
+  int value = peek(connection);
+
+  if (value >= 0) {
+    c.inbound.pop_front();
+    _shared->stats.bytesReceived++;
+  }
+  return value;
+}
+
+// Function to look at the next byte that has arrived
+int SimNetwork::peek(int connection) {
+  const Connection& c = _connections[connection];
+
+  if (c.inbound.empty() || c.inbound.front().at > SimClock::now()) {
+    return -1;
+  }
+  return c.inbound.front().value;
+}
+
+// Function to check whether the connection is open or has data left to read
+bool SimNetwork::isConnected(int connection) {
+  const Connection& c = _connections[connection];
+  bool f_HungUp = (c.hangUpAt != 0 && SimClock::now() >= c.hangUpAt);
+
+  return c.open && (!f_HungUp || available(connection) > 0);
+}
+
+// Method to close the connection
+void SimNetwork::close(int connection) {
+  Connection& c = _connections[connection];
+
+  if (c.open) {
+    c.open = false;
+    c.inbound.clear();
+    if (c.greeted) {
+      c.peer->closed(connection);
+    }
+  }
+}
+
+// Method for a peer to send to the node
+// Everything a peer sends while handling one write arrives together, a round trip after the write, plus
+// however long the server spent on it
+void SimNetwork::reply(int connection, const char* data, size_t size, uint32_t delayMs) {
+  Connection& c = _connections[connection];
+
+  if (_replyAt == 0) {
+    uint64_t rtt = nextRoundTrip();
+    if (lost()) {
+      rtt += (uint64_t)SIM_RETRANSMIT_MS * US_PER_MS;
+      _shared->stats.lostSegments++;
+    }
+    _replyAt = SimClock::now() + rtt;
+  }
+
+  uint64_t at = std::max(_replyAt + ((uint64_t)delayMs * US_PER_MS), c.lastDelivery);
+  for (size_t i = 0; i < size; i++) {
+    c.inbound.push_back({ at, (uint8_t)data[i] });
+  }
+  c.lastDelivery = at;
+}
+
+// Method for a peer to close its side once its replies are out
+void SimNetwork::hangUp(int connection) {
+  Connection& c = _connections[connection];
+
+  c.hangUpAt = std::max(std::max(c.lastDelivery, SimClock::now()), (uint64_t)1);
+}
+
+// Function to send a datagram from the node
+// UDP can't tell whether it arrived, so this only fails without a network
+bool SimNetwork::sendDatagram(uint16_t fromPort, uint32_t address, uint16_t port, const uint8_t* data, size_t size) {
+  if (!isAssociated()) {
+    return false;
+  }
+
+  SimEnergy::transmit(size + PACKET_OVERHEAD);
+  _shared->stats.datagrams++;
+  _shared->stats.bytesSent += size;
+
+  if (!_shared->link.serversUp || lost()) {
+    _shared->stats.lostDatagrams++;
+    return true;
+  }
+
+  _replyAt = 0;
+  for (size_t i = 0; i < _endpoints.size(); i++) {
+    if (_endpoints[i].address == address && _endpoints[i].port == port && _endpoints[i].datagramPeer != NULL) {
+      _endpoints[i].datagramPeer->received(fromPort, data, size);
+    }
+  }
+  return true;
+}
+
+// Method for a peer to answer the datagram it is handling
+void SimNetwork::replyDatagram(uint16_t toPort, const uint8_t* data, size_t size) {
+  if (lost()) {
+    _shared->stats.lostDatagrams++;
+    return;
+  }
+  if (_replyAt == 0) {
+    _replyAt = SimClock::now() + nextRoundTrip();
+  }
+  _datagrams.push_back({ _replyAt, toPort, std::vector<uint8_t>(data, data + size) });
+}
+
+// Function to take a datagram that reached the node's port
+int SimNetwork::receiveDatagram(uint16_t port, uint8_t* buffer, size_t size) {
+  for (size_t i = 0; i < _datagrams.size(); i++) {
+    InboundDatagram& datagram = _datagrams[i];
+
+    if (datagram.port == port && datagram.at <= SimClock::now()) {
+      size_t length = std::min(size, datagram.data.size());
+      memcpy(buffer, datagram.data.data(), length);
+      _shared->stats.bytesReceived += length;
+      _datagrams.erase(_datagrams.begin() + i);
+      return length;
+    }
+  }
+  return -1;
+}
+
+// Function to get how long the next reply takes to come back
+// Scripted round trips are used up first (across wakes), then the profile's round trip plus jitter
+uint64_t SimNetwork::nextRoundTrip() {
+  SimLink& link = _shared->link;
+  uint32_t ms;
+
+  if (link.scriptPos < link.scriptLength) {
+    ms = link.latencyScript[link.scriptPos++];
+  }
+  else {
+    ms = link.rttMs + ((link.jitterMs > 0) ? (random() % (link.jitterMs + 1)) : 0);
+  }
+  return (uint64_t)ms * US_PER_MS;
+}
+
+// Function to decide whether the next packet is lost
+bool SimNetwork::lost() {
+  uint16_t perMille = _shared->link.lossPerMille;
+
+  return (perMille > 0) && ((random() % 1000) < perMille);
+}
+
+// Function to draw 32 random bits (xorshift64, shared so every wake draws new numbers)
+uint32_t SimNetwork::random() {
+  uint64_t& state = _shared->random;
+
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return (uint32_t)(state >> 32);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
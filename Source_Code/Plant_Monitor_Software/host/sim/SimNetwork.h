@@ -0,0 +1,130 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimNetwork_h
+#define SimNetwork_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+
+/* Definitions */
+#define SIM_SSID_SIZE 33
+#define SIM_BSSID_SIZE 6
+#define SIM_LATENCY_SCRIPT_SIZE 64 // scripted round trips that can be queued up
+#define SIM_TCP_WINDOW 2920 // bytes lwIP lets the node have in flight (TCP_SND_BUF, two segments)
+#define SIM_RETRANSMIT_MS 1000 // a lost segment or SYN is resent after this (lwIP's minimum RTO)
+#define SIM_TLS_FULL_CPU_MS 1600 // full handshake on the 80 MHz CPU (BearSSL, ECDHE + RSA 2048 certificate)
+#define SIM_TLS_RESUME_CPU_MS 60 // abbreviated handshake with a resumed session
+#define SIM_TLS_SESSION_CACHE 8 // sessions a server remembers
+#define SIM_CONNECT_REFUSED_MS 5 // a closed port answers straight away with a reset
+#define SIM_JOIN_WAIT_MS 5000 // a test wake's join() gives up after this
+
+/* Network the node joins, kept in shared memory so tests can change it between wakes */
+struct SimLink {
+	bool apUp; // whether the access point is there at all
+	char ssid[SIM_SSID_SIZE]; // network it serves
+	uint8_t bssid[SIM_BSSID_SIZE]; // its MAC address
+	uint8_t channel; // WiFi channel it is on
+	uint16_t scanMs; // finding the access point on an unknown channel
+	uint16_t assocMs; // authenticating and associating once it is found
+	uint16_t dhcpMs; // getting a lease (skipped with a static configuration)
+	uint32_t leaseS; // length of the leases the DHCP server hands out
+	uint16_t dnsMs; // a name lookup
+	uint32_t rttMs; // round trip to the servers
+	uint32_t jitterMs; // up to this much is added to each round trip
+	uint16_t lossPerMille; // chance a SYN, a reply or a datagram is lost
+	bool serversUp; // false = the uplink is down and every connection attempt times out
+	uint32_t latencyScript[SIM_LATENCY_SCRIPT_SIZE]; // round trips (ms) for the next replies, used before rttMs
+	uint16_t scriptLength; // entries in the script
+	uint16_t scriptPos; // next entry to use, carries on across wakes
+};
+
+/* What went over the network, accumulated over every wake */
+struct SimNetStats {
+	uint32_t associations; // successful joins
+	uint32_t fastAssociations; // of those, on a known channel and BSSID
+	uint32_t lookups; // DNS queries sent
+	uint32_t connects; // TCP connections opened
+	uint32_t connectFailures; // TCP connections that timed out or were refused
+	uint32_t fullHandshakes; // TLS handshakes with a key exchange
+	uint32_t resumedHandshakes; // TLS handshakes that resumed a session
+	uint32_t lostSegments; // replies and SYNs that had to be resent
+	uint32_t datagrams; // datagrams sent by the node
+	uint32_t lostDatagrams; // of those, lost on the way
+	uint32_t bytesSent; // TCP and UDP payload sent by the node
+	uint32_t bytesReceived; // TCP and UDP payload read by the node
+};
+
+/* Server side of a TCP connection */
+class SimPeer {
+	public:
+		virtual ~SimPeer() { }
+		virtual void accepted(int connection) { (void)connection; } // method called when the node connects (send a greeting here)
+		virtual void received(int connection, const uint8_t* data, size_t size) = 0; // method called with each write the node makes
+		virtual void closed(int connection) { (void)connection; } // method called when the node closes the connection
+};
+
+/* Server side of a UDP port */
+class SimDatagramPeer {
+	public:
+		virtual ~SimDatagramPeer() { }
+		virtual void received(uint16_t fromPort, const uint8_t* data, size_t size) = 0; // method called with each datagram the node sends
+};
+
+/* SimNetwork class definition */
+// Access point, DNS and servers the node talks to. Connections are loopback sockets: the node's bytes are handed
+// straight to a SimPeer in the same process, and what the peer sends back reaches the node one (scripted,
+// jittered or lossy) round trip later in virtual time. TLS is modelled by its cost: round trips plus CPU time,
+// with a server side session cache so resumption across wakes can be seen.
+class SimNetwork {
+	public:
+		/* Set up (before the first wake) */
+		static SimLink& link(); // function to get the network profile
+		static const SimNetStats& getStats(); // function to get what went over the network so far
+		static void resetStats(); // method to zero the statistics
+		static void addHost(const char* name, uint32_t address); // method to add a DNS entry
+		static void listen(uint32_t address, uint16_t port, SimPeer* peer, bool tls=false); // method to put a server on a TCP port
+		static void listenDatagrams(uint32_t address, uint16_t port, SimDatagramPeer* peer); // method to put a server on a UDP port
+		static void scriptLatency(const uint32_t* rttMs, size_t count); // method to queue round trips for the next replies
+		static void forgetSessions(); // method to make the servers forget every TLS session (e.g. a server restart)
+
+		/* Radio and association (WiFi) */
+		static void boot(bool radioEnabled); // method to start a wake, with the radio calibrated at boot or not
+		static void setRadio(bool on); // method to power the modem up or down
+		static void associate(const char* ssid, int32_t channel, const uint8_t* bssid, bool staticConfig); // method to start joining
+		static void disassociate(); // method to leave the network
+		static bool isAssociated(); // function to check whether joining has finished
+		static bool join(unsigned long timeoutMs=SIM_JOIN_WAIT_MS); // function for a test wake to join the network as it is and wait for it, false if it didn't
+		static bool resolve(const char* name, uint32_t& address, unsigned long timeoutMs); // function to look a name up
+
+		/* Node side of a TCP connection */
+		static int connect(uint32_t address, uint16_t port, unsigned long timeoutMs); // function to open a connection, -1 if it can't be
+		static bool handshake(int connection, uint32_t& sessionId, unsigned long timeoutMs); // function to run the TLS handshake, resuming sessionId if the server still has it
+		static size_t send(int connection, const uint8_t* data, size_t size); // function to write to the server
+		static int available(int connection); // function to get the number of bytes that have arrived
+		static int read(int connection); // function to read a byte that has arrived (-1 if none)
+		static int peek(int connection); // function to look at the next byte that has arrived (-1 if none)
+		static bool isConnected(int connection); // function to check whether the connection is open or has data left
+		static void close(int connection); // method to close the connection
+
+		/* Server side of a TCP connection */
+		static void reply(int connection, const char* data, size_t size, uint32_t delayMs=0); // method for a peer to send to the node (after working on it for delayMs)
+		static void hangUp(int connection); // method for a peer to close its side once its replies are out
+
+		/* UDP */
+		static bool sendDatagram(uint16_t fromPort, uint32_t address, uint16_t port, const uint8_t* data, size_t size); // function to send a datagram from the node
+		static void replyDatagram(uint16_t toPort, const uint8_t* data, size_t size); // method for a peer to answer the datagram it is handling
+		static int receiveDatagram(uint16_t port, uint8_t* buffer, size_t size); // function to take a datagram that reached the node's port (-1 if none)
+	private:
+		/* Private Functions and Methods */
+		static uint64_t nextRoundTrip(); // function to get how long the next reply takes to come back (µs)
+		static bool lost(); // function to decide whether the next packet is lost
+		static uint32_t random(); // function to draw 32 random bits
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
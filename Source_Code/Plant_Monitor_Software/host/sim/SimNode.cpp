@@ -0,0 +1,174 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimNode.h"
+#include "SimADC.h"
+#include "SimBoard.h"
+#include "SimClock.h"
+#include "SimNetwork.h"
+#include "SimShared.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Definitions */
+// Values of the core's REASON_ and RF_ constants (Esp.h isn't included here, the simulation doesn't depend on the core)
+#define RESET_POWER_UP 0
+#define RESET_WATCHDOG 1
+#define RESET_EXCEPTION 2
+#define RESET_RESTART 4
+#define RESET_DEEP_SLEEP 5
+#define RF_MODE_DISABLED 4
+
+/* Variables */
+// Chip state that survives deep sleep, and the outcome of the wakes so far
+struct NodeState {
+  uint32_t rtc[SIM_RTC_BLOCKS];
+  uint32_t resetReason;
+  uint8_t bootMode;
+  uint32_t wakes;
+  SimWake last;
+};
+
+static NodeState* createState(); // starts as if just powered up
+static NodeState* _shared = createState();
+static bool _awake = false; // this process is a wake
+
+/* Functions */
+
+// Function to create the shared state
+static NodeState* createState() {
+  _shared = SimShared::create<NodeState>();
+  SimNode::powerCycle();
+  return _shared;
+}
+
+// Function to boot the node and run it until it sleeps
+// The wake runs in a child so a crash or a hang ends the wake rather than the test, and every static of the
+// firmware starts from its initial value again
+const SimWake& SimNode::wake(Entry entry) {
+  fflush(NULL); // don't let the child flush what the parent buffered
+
+  pid_t child = fork();
+  if (child < 0) {
+    perror("SimNode");
+    abort();
+  }
+
+  if (child == 0) {
+    _awake = true;
+    alarm(SIM_REAL_LIMIT_S);
+    memset(&_shared->last, 0, sizeof(_shared->last));
+    SimClock::reset();
+    SimEnergy::reset();
+    SimBoard::reset();
+    SimADC::reset();
+    SimNetwork::boot(_shared->bootMode != RF_MODE_DISABLED);
+
+    entry();
+    halt(WAKE_RETURNED);
+  }
+
+  int status = 0;
+  waitpid(child, &status, 0);
+  _shared->wakes++;
+
+  if (WIFSIGNALED(status)) { // the child never got to record how it ended
+    _shared->last.result = (WTERMSIG(status) == SIGALRM) ? WAKE_HUNG : WAKE_CRASHED;
+  }
+  else if (WEXITSTATUS(status) != 0) { // a check failed inside the wake
+    _shared->last.result = WAKE_CRASHED;
+  }
+
+  switch (_shared->last.result) {
+    case WAKE_SLEPT:
+      _shared->resetReason = RESET_DEEP_SLEEP;
+      _shared->bootMode = _shared->last.nextMode;
+      break;
+    case WAKE_RESTARTED:
+      _shared->resetReason = RESET_RESTART;
+      _shared->bootMode = 0;
+      break;
+    case WAKE_CRASHED:
+      _shared->resetReason = RESET_EXCEPTION;
+      _shared->bootMode = 0;
+      break;
+    default: // a node that never sleeps is eventually reset by the watchdog
+      _shared->resetReason = RESET_WATCHDOG;
+      _shared->bootMode = 0;
+      break;
+  }
+  return _shared->last;
+}
+
+// Method to take the battery out and put it back
+// RTC memory comes up with whatever the cells settle to, never zeros the firmware could trust
+void SimNode::powerCycle() {
+  uint32_t garbage = 0x6D2B79F5;
+
+  for (int b = 0; b < SIM_RTC_BLOCKS; b++) {
+    garbage ^= garbage << 13;
+    garbage ^= garbage >> 17;
+    garbage ^= garbage << 5;
+    _shared->rtc[b] = garbage;
+  }
+  _shared->resetReason = RESET_POWER_UP;
+  _shared->bootMode = 0;
+}
+
+// Function to get the outcome of the last wake
+const SimWake& SimNode::lastWake() {
+  return _shared->last;
+}
+
+// Function to get the number of wakes so far
+uint32_t SimNode::wakeCount() {
+  return _shared->wakes;
+}
+
+// Function to check whether this process is a wake in progress
+bool SimNode::isAwake() {
+  return _awake;
+}
+
+// Method to end the wake
+// Records how it ended for the parent, then leaves without running destructors, as a reset would
+void SimNode::halt(WakeResult result, uint64_t sleepUs, uint8_t nextMode) {
+  if (!_awake) { // firmware called directly by a test, not inside a wake
+    fprintf(stderr, "SimNode: halted outside a wake (result %d)\n", (int)result);
+    fflush(NULL);
+    _exit(EXIT_FAILURE);
+  }
+
+  _shared->last.result = result;
+  _shared->last.awakeUs = SimClock::now();
+  _shared->last.sleepUs = sleepUs;
+  _shared->last.nextMode = nextMode;
+  _shared->last.energy = SimEnergy::getReport();
+
+  fflush(NULL);
+  _exit(EXIT_SUCCESS);
+}
+
+// Function to get the RTC user memory
+uint32_t* SimNode::rtcMemory() {
+  return _shared->rtc;
+}
+
+// Function to get why this wake started
+uint32_t SimNode::resetReason() {
+  return _shared->resetReason;
+}
+
+// Function to get the RFMode this wake booted with
+uint8_t SimNode::bootMode() {
+  return _shared->bootMode;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
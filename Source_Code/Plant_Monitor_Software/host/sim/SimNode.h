@@ -0,0 +1,60 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimNode_h
+#define SimNode_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include "SimEnergy.h"
+
+/* Definitions */
+#define SIM_RTC_BLOCKS 128 // 512 bytes of RTC user memory
+#define SIM_REAL_LIMIT_S 60 // real seconds a wake may run before it is killed (a loop that never yields)
+
+/* How a wake ended */
+enum WakeResult {
+	WAKE_SLEPT, // went into deep sleep, as every wake should
+	WAKE_RETURNED, // setup() returned without sleeping (the node would sit in an empty loop())
+	WAKE_HUNG, // still awake after SIM_WAKE_LIMIT_US of virtual time, or SIM_REAL_LIMIT_S of real time
+	WAKE_CRASHED, // the firmware crashed
+	WAKE_RESTARTED // ESP.restart()
+};
+
+/* Outcome of one wake */
+struct SimWake {
+	WakeResult result;
+	uint64_t awakeUs; // boot to sleep (virtual)
+	uint64_t sleepUs; // deep sleep asked for
+	uint8_t nextMode; // RFMode asked for the next wake
+	SimEnergyReport energy; // drawn while awake
+};
+
+/* SimNode class definition */
+// The node across deep sleeps. Each wake boots the firmware in a child process with fresh statics, the way a
+// wake from deep sleep starts with fresh RAM; only the RTC memory, the reset reason and the radio mode carry
+// over (kept in shared memory), along with the flash (a host directory, see SimFlash). ESP.deepSleep() ends
+// the child, so the firmware runs unmodified.
+class SimNode {
+	public:
+		typedef void (*Entry)(); // function the wake starts in (the sketch's setup())
+
+		/* Public Functions and Methods */
+		static const SimWake& wake(Entry entry); // function to boot the node and run it until it sleeps
+		static void powerCycle(); // method to take the battery out and put it back (RTC memory lost)
+		static const SimWake& lastWake(); // function to get the outcome of the last wake
+		static uint32_t wakeCount(); // function to get the number of wakes so far
+		static bool isAwake(); // function to check whether this process is a wake in progress
+		[[noreturn]] static void halt(WakeResult result, uint64_t sleepUs=0, uint8_t nextMode=0); // method to end the wake
+
+		/* Chip state the core reads */
+		static uint32_t* rtcMemory(); // function to get the RTC user memory
+		static uint32_t resetReason(); // function to get why this wake started
+		static uint8_t bootMode(); // function to get the RFMode this wake booted with
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,104 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimSerial.h"
+#include "SimClock.h"
+#include "SimShared.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Variables */
+// Console state shared with every wake
+struct SerialState {
+  char output[SIM_SERIAL_OUTPUT_SIZE + 1];
+  size_t outputLen;
+  char input[SIM_SERIAL_INPUT_SIZE];
+  size_t inputLen;
+  size_t inputPos;
+  bool echo;
+};
+
+static SerialState* createState(); // echo follows SIM_ECHO
+static SerialState* _shared = createState();
+
+/* Functions */
+
+// Function to create the shared state
+static SerialState* createState() {
+  SerialState* state = SimShared::create<SerialState>();
+
+  state->echo = (getenv("SIM_ECHO") != NULL);
+  return state;
+}
+
+// Method to copy the node's output to stdout
+void SimSerial::setEcho(bool echo) {
+  _shared->echo = echo;
+}
+
+// Method to queue input for the node
+void SimSerial::type(const char* text) {
+  if (_shared->inputPos == _shared->inputLen) {
+    _shared->inputPos = _shared->inputLen = 0;
+  }
+
+  size_t len = strlen(text);
+  len = (len < SIM_SERIAL_INPUT_SIZE - _shared->inputLen) ? len : (SIM_SERIAL_INPUT_SIZE - _shared->inputLen);
+  memcpy(_shared->input + _shared->inputLen, text, len);
+  _shared->inputLen += len;
+}
+
+// Function to get the output captured since the last clear
+const char* SimSerial::output() {
+  _shared->output[_shared->outputLen] = '\0';
+  return _shared->output;
+}
+
+// Method to forget the captured output
+void SimSerial::clearOutput() {
+  _shared->outputLen = 0;
+}
+
+// Method for the node to send bytes
+// Sending takes the UART's time, the output buffer drops its oldest half when it fills
+void SimSerial::write(const uint8_t* data, size_t size) {
+  SimClock::advance((uint64_t)size * SIM_SERIAL_BYTE_US);
+
+  if (_shared->echo) {
+    fwrite(data, 1, size, stdout);
+  }
+
+  for (size_t i = 0; i < size; i++) {
+    if (_shared->outputLen == SIM_SERIAL_OUTPUT_SIZE) {
+      memmove(_shared->output, _shared->output + (SIM_SERIAL_OUTPUT_SIZE / 2), SIM_SERIAL_OUTPUT_SIZE / 2);
+      _shared->outputLen = SIM_SERIAL_OUTPUT_SIZE / 2;
+    }
+    _shared->output[_shared->outputLen++] = data[i];
+  }
+}
+
+// Function to get the number of input bytes waiting
+int SimSerial::available() {
+  return _shared->inputLen - _shared->inputPos;
+}
+
+// Function to read an input byte
+int SimSerial::read() {
+  int c = peek();
+
+  if (c >= 0) {
+    _shared->inputPos++;
+  }
+  return c;
+}
+
+// Function to look at the next input byte
+int SimSerial::peek() {
+  return (available() > 0) ? (uint8_t)_shared->input[_shared->inputPos] : -1;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,36 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimSerial_h
+#define SimSerial_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+
+/* Definitions */
+#define SIM_SERIAL_OUTPUT_SIZE 65536 // console output kept for the test to look at (older output is dropped)
+#define SIM_SERIAL_INPUT_SIZE 1024 // scripted input waiting to be read
+#define SIM_SERIAL_BYTE_US 87 // one byte at 115200 baud
+
+/* SimSerial class definition */
+// Serial console of the node. Output is captured in shared memory so a test can check what a wake printed
+// (and echoed to stdout if asked, or if SIM_ECHO is set); input is typed in by the test ahead of time.
+class SimSerial {
+	public:
+		/* Public Functions and Methods */
+		static void setEcho(bool echo); // method to copy the node's output to stdout
+		static void type(const char* text); // method to queue input for the node
+		static const char* output(); // function to get the output captured since the last clear
+		static void clearOutput(); // method to forget the captured output
+		static void write(const uint8_t* data, size_t size); // method for the node to send bytes
+		static int available(); // function to get the number of input bytes waiting
+		static int read(); // function to read an input byte (-1 if none)
+		static int peek(); // function to look at the next input byte (-1 if none)
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,25 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimShared.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+/* Functions */
+
+// Function to map zeroed memory shared with every later child process
+void* SimShared::allocate(size_t size) {
+  void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+  if (memory == MAP_FAILED) {
+    perror("SimShared");
+    abort();
+  }
+  return memory;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
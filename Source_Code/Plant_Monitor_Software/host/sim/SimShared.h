@@ -0,0 +1,27 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimShared_h
+#define SimShared_h
+
+// Include the necessary libraries
+#include <stddef.h>
+#include <new>
+
+/* SimShared class definition */
+// Memory that outlives a simulated wake. Every wake runs in a child process (see SimNode), so whatever the
+// firmware leaves behind that the hardware would keep (RTC memory, server state, statistics) is placed in
+// anonymous shared mappings made before the first wake. Allocate at start up (static initialisers or
+// constructors that run before SimNode::wake()); a mapping made inside a wake is private to it.
+class SimShared {
+	public:
+		/* Public Functions and Methods */
+		static void* allocate(size_t size); // function to map zeroed memory shared with every later child process
+		template <class T> static T* create() { return new (allocate(sizeof(T))) T(); } // function to construct an object in shared memory
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
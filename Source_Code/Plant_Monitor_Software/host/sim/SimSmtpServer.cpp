@@ -0,0 +1,258 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimSmtpServer.h"
+#include "SimClock.h"
+#include "SimShared.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+/* Definitions */
+#define GREETING "220 smtp.sim ESMTP ready\r\n"
+#define EHLO_REPLY_START "250-smtp.sim at your service\r\n250-SIZE 35882577\r\n"
+#define EHLO_PIPELINING "250-PIPELINING\r\n"
+#define EHLO_AUTH_PLAIN "250-AUTH LOGIN PLAIN\r\n"
+#define EHLO_AUTH_LOGIN "250-AUTH LOGIN\r\n"
+#define EHLO_REPLY_END "250 SMTPUTF8\r\n"
+
+/* Variables */
+struct SimSmtpServer::Shared {
+  SimSmtpOptions options;
+  SimSmtpStats stats;
+  size_t transcriptLen;
+  char transcript[SIM_SMTP_TRANSCRIPT_SIZE + 1];
+  size_t messageLen;
+  char message[SIM_SMTP_MESSAGE_SIZE + 1];
+};
+
+/* Constructors */
+// Constructor with every extension advertised and every recipient accepted
+SimSmtpServer::SimSmtpServer()
+  : _shared(SimShared::create<Shared>()),
+    f_Data(false),
+    f_AuthLogin(false),
+    _loginStep(0),
+    _recipients(0),
+    _commandsInWrite(0),
+    _openedAt(0),
+    _messageLen(0)
+{
+  _shared->options.pipelining = true;
+  _shared->options.authPlain = true;
+  _shared->options.refuseCode = 550;
+  _shared->options.endOfDataCode = 250;
+}
+
+/* Functions */
+
+// Function to get the behaviour
+SimSmtpOptions& SimSmtpServer::options() {
+  return _shared->options;
+}
+
+// Function to get what the server has seen
+const SimSmtpStats& SimSmtpServer::getStats() {
+  return _shared->stats;
+}
+
+// Function to get the commands and replies
+const char* SimSmtpServer::transcript() {
+  _shared->transcript[_shared->transcriptLen] = '\0';
+  return _shared->transcript;
+}
+
+// Function to get the text of the last message queued
+const char* SimSmtpServer::lastMessage() {
+  _shared->message[_shared->messageLen] = '\0';
+  return _shared->message;
+}
+
+// Method to forget the transcript, message and statistics
+void SimSmtpServer::clear() {
+  memset(&_shared->stats, 0, sizeof(_shared->stats));
+  _shared->transcriptLen = 0;
+  _shared->messageLen = 0;
+}
+
+// Method called when the node connects, greets it
+void SimSmtpServer::accepted(int connection) {
+  _line.clear();
+  f_Data = false;
+  f_AuthLogin = false;
+  _recipients = 0;
+  _openedAt = SimClock::now();
+  _shared->stats.sessions++;
+
+  send(connection, GREETING);
+  if (_shared->options.hangUpAfterGreeting) {
+    SimNetwork::hangUp(connection);
+  }
+}
+
+// Method called with each write the node makes, handles every complete line in it
+void SimSmtpServer::received(int connection, const uint8_t* data, size_t size) {
+  _commandsInWrite = 0;
+  _shared->stats.writes++;
+
+  for (size_t i = 0; i < size; i++) {
+    if (data[i] != '\n') {
+      _line += (char)data[i];
+      continue;
+    }
+
+    bool f_Cr = (!_line.empty() && _line.back() == '\r');
+    if (f_Cr) {
+      _line.pop_back();
+    }
+    else if (f_Data) {
+      _shared->stats.bareLineFeeds++;
+    }
+    onLine(connection, _line);
+    _line.clear();
+  }
+
+  if (_commandsInWrite > 1) {
+    _shared->stats.pipelinedWrites++;
+  }
+}
+
+// Method called when the node closes the connection
+void SimSmtpServer::closed(int connection) {
+  (void)connection;
+  SimSmtpStats& stats = _shared->stats;
+
+  if (stats.sessionCount < SIM_SMTP_SESSION_LOG) {
+    stats.sessionUs[stats.sessionCount++] = SimClock::now() - _openedAt;
+  }
+}
+
+// Method to handle one line from the node
+void SimSmtpServer::onLine(int connection, const std::string& line) {
+  SimSmtpOptions& options = _shared->options;
+  SimSmtpStats& stats = _shared->stats;
+  char reply[64];
+
+  if (f_Data) { // message text, up to the lone dot
+    if (line == ".") {
+      f_Data = false;
+      _shared->messageLen = _messageLen;
+      note("C: ", line);
+      snprintf(reply, sizeof(reply), "%u %s\r\n", options.endOfDataCode, (options.endOfDataCode == 250) ? "2.0.0 OK queued" : "not queued");
+      if (options.endOfDataCode == 250) {
+        stats.messages++;
+      }
+      send(connection, reply, options.endOfDataMs);
+      return;
+    }
+    stats.longestLine = std::max(stats.longestLine, (uint32_t)line.size());
+    std::string text = line + "\r\n";
+    size_t room = SIM_SMTP_MESSAGE_SIZE - _messageLen;
+    size_t length = std::min(room, text.size());
+    memcpy(_shared->message + _messageLen, text.data(), length);
+    _messageLen += length;
+    return;
+  }
+
+  note("C: ", line);
+  stats.commands++;
+  _commandsInWrite++;
+
+  if (f_AuthLogin) { // username, then password
+    if (++_loginStep == 1) {
+      send(connection, "334 UGFzc3dvcmQ6\r\n");
+    }
+    else {
+      f_AuthLogin = false;
+      stats.authLogin++;
+      send(connection, "235 2.7.0 Accepted\r\n");
+    }
+    return;
+  }
+
+  std::string verb = line.substr(0, 4);
+  if (verb == "EHLO") {
+    std::string ehlo = EHLO_REPLY_START;
+    ehlo += options.pipelining ? EHLO_PIPELINING : "";
+    ehlo += options.authPlain ? EHLO_AUTH_PLAIN : EHLO_AUTH_LOGIN;
+    ehlo += EHLO_REPLY_END;
+    send(connection, ehlo.c_str());
+  }
+  else if (verb == "HELO") {
+    send(connection, "250 smtp.sim\r\n");
+  }
+  else if (line.compare(0, 10, "AUTH PLAIN") == 0 && options.authPlain) {
+    stats.authPlain++;
+    send(connection, "235 2.7.0 Accepted\r\n");
+  }
+  else if (line == "AUTH LOGIN") {
+    f_AuthLogin = true;
+    _loginStep = 0;
+    send(connection, "334 VXNlcm5hbWU6\r\n");
+  }
+  else if (verb == "MAIL") {
+    _recipients = 0;
+    send(connection, "250 2.1.0 OK\r\n");
+  }
+  else if (verb == "RCPT") {
+    if (options.refusePattern[0] != '\0' && line.find(options.refusePattern) != std::string::npos) {
+      stats.recipientsRefused++;
+      snprintf(reply, sizeof(reply), "%u recipient refused\r\n", options.refuseCode);
+      send(connection, reply);
+    }
+    else {
+      _recipients++;
+      stats.recipientsAccepted++;
+      send(connection, "250 2.1.5 OK\r\n");
+    }
+  }
+  else if (verb == "DATA") {
+    if (_recipients == 0) {
+      send(connection, "554 5.5.1 no valid recipients\r\n");
+    }
+    else {
+      f_Data = true;
+      _messageLen = 0;
+      send(connection, "354 Go ahead\r\n");
+    }
+  }
+  else if (verb == "RSET") {
+    _recipients = 0;
+    send(connection, "250 2.1.5 Flushed\r\n");
+  }
+  else if (verb == "QUIT") {
+    send(connection, "221 2.0.0 closing connection\r\n");
+    SimNetwork::hangUp(connection);
+  }
+  else {
+    send(connection, "502 5.5.1 unrecognized command\r\n");
+  }
+}
+
+// Method to reply and note it in the transcript
+void SimSmtpServer::send(int connection, const char* text, uint32_t delayMs) {
+  std::string lines(text);
+
+  for (size_t start = 0, end; (end = lines.find("\r\n", start)) != std::string::npos; start = end + 2) {
+    note("S: ", lines.substr(start, end - start));
+  }
+  SimNetwork::reply(connection, text, strlen(text), delayMs);
+}
+
+// Method to add a line to the transcript, dropping the older half when it fills
+void SimSmtpServer::note(const char* prefix, const std::string& line) {
+  std::string entry = prefix + line + "\n";
+
+  if (_shared->transcriptLen + entry.size() > SIM_SMTP_TRANSCRIPT_SIZE) {
+    size_t half = SIM_SMTP_TRANSCRIPT_SIZE / 2;
+    memmove(_shared->transcript, _shared->transcript + half, _shared->transcriptLen - half);
+    _shared->transcriptLen -= half;
+  }
+  memcpy(_shared->transcript + _shared->transcriptLen, entry.data(), std::min(entry.size(), (size_t)SIM_SMTP_TRANSCRIPT_SIZE));
+  _shared->transcriptLen += std::min(entry.size(), (size_t)SIM_SMTP_TRANSCRIPT_SIZE);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
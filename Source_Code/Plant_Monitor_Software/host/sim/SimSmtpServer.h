@@ -0,0 +1,88 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimSmtpServer_h
+#define SimSmtpServer_h
+
+// Include the necessary libraries
+#include "SimNetwork.h"
+#include <string>
+
+/* Definitions */
+#define SIM_SMTP_PATTERN_SIZE 32
+#define SIM_SMTP_TRANSCRIPT_SIZE 65536 // commands and replies kept (older ones are dropped)
+#define SIM_SMTP_MESSAGE_SIZE 65536 // text of the last message accepted
+#define SIM_SMTP_SESSION_LOG 256 // session durations kept
+
+/* How the server behaves, set by the test before the wakes */
+struct SimSmtpOptions {
+	bool pipelining; // advertise PIPELINING
+	bool authPlain; // advertise AUTH PLAIN (AUTH LOGIN is always offered)
+	char refusePattern[SIM_SMTP_PATTERN_SIZE]; // RCPT TO addresses containing this are refused ("" = none)
+	uint16_t refuseCode; // reply they get (4xx = try later, 5xx = never)
+	uint16_t endOfDataCode; // reply to the end of a message (250 = queued)
+	uint32_t endOfDataMs; // time the server takes to queue a message
+	bool hangUpAfterGreeting; // close as soon as the greeting is out
+};
+
+/* What the server has seen, accumulated over every wake */
+struct SimSmtpStats {
+	uint32_t sessions; // connections greeted
+	uint32_t messages; // messages queued
+	uint32_t recipientsAccepted;
+	uint32_t recipientsRefused;
+	uint32_t commands; // command lines received (message text not counted)
+	uint32_t writes; // writes the node made (a pipelined batch is one)
+	uint32_t pipelinedWrites; // writes that carried more than one command
+	uint32_t authPlain; // logins by AUTH PLAIN
+	uint32_t authLogin; // logins by AUTH LOGIN
+	uint32_t longestLine; // longest line of message text (RFC 5322 allows 998)
+	uint32_t bareLineFeeds; // message lines that ended in LF without CR
+	uint32_t sessionCount; // durations in sessionUs
+	uint64_t sessionUs[SIM_SMTP_SESSION_LOG]; // connect to close of each session (virtual µs)
+};
+
+/* SimSmtpServer class definition */
+// Stand-in SMTP server (Gmail or the collector) on a loopback port. Accepts any login, refuses recipients
+// matching a pattern, and keeps a transcript, the last message and statistics in shared memory so a test can
+// check them after the wakes.
+class SimSmtpServer : public SimPeer {
+	public:
+		/* Constructors */
+		SimSmtpServer(); // constructor with every extension advertised and every recipient accepted (before the first wake)
+
+		/* Public Functions and Methods */
+		SimSmtpOptions& options(); // function to get the behaviour, for changing between wakes
+		const SimSmtpStats& getStats(); // function to get what the server has seen
+		const char* transcript(); // function to get the commands and replies ("C: " and "S: " lines)
+		const char* lastMessage(); // function to get the text of the last message queued
+		void clear(); // method to forget the transcript, message and statistics
+
+		/* Called by SimNetwork */
+		void accepted(int connection) override;
+		void received(int connection, const uint8_t* data, size_t size) override;
+		void closed(int connection) override;
+	private:
+		/* Private Instance Variables */
+		struct Shared; // options, statistics, transcript and message in shared memory
+		Shared* _shared;
+		std::string _line; // partial line of the current connection
+		bool f_Data; // reading message text
+		bool f_AuthLogin; // waiting for the AUTH LOGIN username (1) or password (2)
+		int _loginStep;
+		int _recipients; // accepted for the current message
+		int _commandsInWrite; // command lines in the write being handled
+		uint64_t _openedAt; // µs the session opened
+		size_t _messageLen; // text of the message being received
+
+		/* Private Functions and Methods */
+		void onLine(int connection, const std::string& line); // method to handle one line from the node
+		void send(int connection, const char* text, uint32_t delayMs=0); // method to reply and note it in the transcript
+		void note(const char* prefix, const std::string& line); // method to add a line to the transcript
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
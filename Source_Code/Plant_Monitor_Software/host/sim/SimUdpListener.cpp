@@ -0,0 +1,68 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimUdpListener.h"
+#include "SimShared.h"
+#include <string.h>
+
+/* Definitions */
+#define ACK_SIZE 4
+#define CRC32_POLYNOMIAL 0xEDB88320 // reflected IEEE 802.3, as RTCStore uses
+
+/* Constructors */
+SimUdpListener::SimUdpListener()
+  : _stats(SimShared::create<SimUdpStats>()), _acking(true)
+{
+}
+
+/* Functions */
+
+// Function to get what has arrived
+const SimUdpStats& SimUdpListener::getStats() {
+  return *_stats;
+}
+
+// Method to forget what has arrived
+void SimUdpListener::clear() {
+  memset(_stats, 0, sizeof(*_stats));
+}
+
+// Method to stop (or resume) acknowledging datagrams
+void SimUdpListener::setAcking(bool acking) {
+  _acking = acking;
+}
+
+// Method called with each datagram the node sends, answered with its CRC
+void SimUdpListener::received(uint16_t fromPort, const uint8_t* data, size_t size) {
+  size = (size < sizeof(_stats->last)) ? size : sizeof(_stats->last);
+
+  _stats->datagrams++;
+  _stats->bytes += size;
+  _stats->lastSize = size;
+  memcpy(_stats->last, data, size);
+
+  if (_acking) {
+    uint32_t crc = crc32(data, size);
+    uint8_t ack[ACK_SIZE] = { (uint8_t)(crc >> 24), (uint8_t)(crc >> 16), (uint8_t)(crc >> 8), (uint8_t)crc };
+    SimNetwork::replyDatagram(fromPort, ack, sizeof(ack));
+    _stats->acks++;
+  }
+}
+
+// Function to get the CRC-32 of a datagram (the firmware's RTCStore isn't linked into the sim library)
+uint32_t SimUdpListener::crc32(const uint8_t* data, size_t size) {
+  uint32_t crc = 0xFFFFFFFF;
+
+  while (size--) {
+    crc ^= *data++;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ ((crc & 1) ? CRC32_POLYNOMIAL : 0);
+    }
+  }
+  return ~crc;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,50 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimUdpListener_h
+#define SimUdpListener_h
+
+// Include the necessary libraries
+#include "SimNetwork.h"
+
+/* Definitions */
+#define SIM_UDP_DATAGRAM_SIZE 1472
+
+/* What the listener has received, accumulated over every wake */
+struct SimUdpStats {
+	uint32_t datagrams; // datagrams that arrived
+	uint32_t acks; // acks sent back for them
+	uint64_t bytes; // their payload
+	uint32_t lastSize; // size of the last one
+	uint8_t last[SIM_UDP_DATAGRAM_SIZE]; // the last one
+};
+
+/* SimUdpListener class definition */
+// Stand-in telemetry listener on a loopback UDP port, keeps what arrives in shared memory and acknowledges each
+// datagram the way UDPTelemetry expects, with its CRC-32 (most significant byte first)
+class SimUdpListener : public SimDatagramPeer {
+	public:
+		/* Constructors */
+		SimUdpListener(); // constructor (before the first wake)
+
+		/* Public Functions and Methods */
+		const SimUdpStats& getStats(); // function to get what has arrived
+		void clear(); // method to forget what has arrived
+		void setAcking(bool acking); // method to stop (or resume) acknowledging, a listener that lost its storage or a one-way firewall
+
+		/* Called by SimNetwork */
+		void received(uint16_t fromPort, const uint8_t* data, size_t size) override;
+	private:
+		/* Private Functions and Methods */
+		static uint32_t crc32(const uint8_t* data, size_t size); // function to get the CRC-32 of a datagram
+
+		/* Private Instance Variables */
+		SimUdpStats* _stats; // in shared memory
+		bool _acking; // whether datagrams are acknowledged (set before a wake)
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,39 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "SimWorld.h"
+#include "SimADC.h"
+
+/* Definitions */
+// MCP3008 inputs and the Thevenin resistance of each divider (see SensorMetrics)
+#define LIGHT_CH 1
+#define LIGHT_OHMS 3300.0 // 9.83k against the photoresistor in daylight
+#define LIGHT_RISE_MS 2.0
+#define THERM_CH 2
+#define THERM_OHMS 4980.0 // 9.93k against the 10k thermistor at room temperature
+#define THERM_RISE_MS 2.0
+#define MOISTURE_CH 4
+#define MOISTURE_OHMS 98400.0 // 406.1k || 129.9k
+#define MOISTURE_RISE_MS 30.0 // probe output settling in the soil
+
+/* Functions */
+
+// Method to put the servers on the network
+void SimWorld::setUp(SimSmtpServer& gmail, SimSmtpServer& relay, SimUdpListener& listener) {
+  SimNetwork::addHost(SIM_GMAIL_HOST, SIM_GMAIL_IP);
+  SimNetwork::listen(SIM_GMAIL_IP, SIM_GMAIL_PORT, &gmail, true);
+  SimNetwork::listen(SIM_COLLECTOR_IP, SIM_RELAY_PORT, &relay);
+  SimNetwork::listenDatagrams(SIM_COLLECTOR_IP, SIM_TELEMETRY_PORT, &listener);
+}
+
+// Method to wire up the sensors with their source resistances
+void SimWorld::setPlant(double lightVolts, double thermVolts, double moistureVolts) {
+  SimADC::setChannel(LIGHT_CH, lightVolts, LIGHT_OHMS, LIGHT_RISE_MS);
+  SimADC::setChannel(THERM_CH, thermVolts, THERM_OHMS, THERM_RISE_MS);
+  SimADC::setChannel(MOISTURE_CH, moistureVolts, MOISTURE_OHMS, MOISTURE_RISE_MS);
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,34 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef SimWorld_h
+#define SimWorld_h
+
+// Include the necessary libraries
+#include "SimSmtpServer.h"
+#include "SimUdpListener.h"
+
+/* Definitions */
+// Where the firmware's default servers are (see SMTP.cpp and FinalProject.ino)
+#define SIM_GMAIL_HOST "smtp.gmail.com"
+#define SIM_GMAIL_IP (142 | (250 << 8) | (102 << 16) | (108U << 24)) // 142.250.102.108, packed like IPAddress
+#define SIM_GMAIL_PORT 465
+#define SIM_COLLECTOR_IP (192 | (168 << 8) | (1 << 16) | (10U << 24)) // 192.168.1.10
+#define SIM_RELAY_PORT 2525
+#define SIM_TELEMETRY_PORT 5684
+
+/* SimWorld class definition */
+// Everything around a node as the firmware's defaults expect it: Gmail over TLS, the collector's SMTP relay
+// and telemetry listener on the LAN, and the plant's sensors wired to the MCP3008
+class SimWorld {
+	public:
+		/* Public Functions and Methods */
+		static void setUp(SimSmtpServer& gmail, SimSmtpServer& relay, SimUdpListener& listener); // method to put the servers on the network
+		static void setPlant(double lightVolts=1.88, double thermVolts=1.41, double moistureVolts=1.0); // method to wire up the sensors with their source resistances
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
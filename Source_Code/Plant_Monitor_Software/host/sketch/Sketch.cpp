@@ -0,0 +1,9 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// The sketch as the Arduino IDE builds it, compiled once per REPORT_OVER_UDP / USE_SMTP_RELAY variant
+#include "FinalProject.ino"
+
+// ©2017 Jeremy Maxey-Vesperman
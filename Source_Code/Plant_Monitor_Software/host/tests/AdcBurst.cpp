@@ -0,0 +1,160 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Burst reads of the MCP3008 through the SPI mock (SimADC): each channel's clock is derated for its divider
+// so the ~98k moisture divider reads true, and the median and trimmed mean filters hold up against the
+// gaussian and impulse noise injected into the conversions, with a variance estimate that tracks the noise; and
+// the settle time learned over wakes follows sensors that settle a few milliseconds slower than it.
+
+// Include necessary header files
+#include "SensorRegistry.h"
+#include "Check.h"
+#include "SimADC.h"
+#include "SimNode.h"
+#include "SimWorld.h"
+#include <math.h>
+#include <stdio.h>
+
+/* Definitions */
+#define CHANNEL_COUNT 3
+#define TRIALS 200
+#define NOISE_SIGMA_LSB 2.0
+#define SPIKE_PER_MILLE 60 // one conversion in about 17 is an impulse
+#define SPIKE_LSB 150
+#define QUICK_RISE_MS 10.0 // moisture probe settling at power up, then on the wakes after
+#define SLOW_RISE_MS 14.0
+#define SETTLE_WAKES 30
+#define SETTLE_HISTORY_WEIGHT 8 // as SensorMetrics has it
+#define SLEEP_MS 1000
+
+/* Constants */
+static const int _CHANNELS[CHANNEL_COUNT] = { LightSensor::channel, TemperatureSensor::channel, MoistureSensor<MOISTURE_SENSOR_CH>::channel };
+static const uint32_t _DERATED[CHANNEL_COUNT] = { SensorMetrics::burstClock(LightSensor::sourceOhms),
+                                                  SensorMetrics::burstClock(TemperatureSensor::sourceOhms),
+                                                  SensorMetrics::burstClock(MoistureSensor<MOISTURE_SENSOR_CH>::sourceOhms) };
+static const uint32_t _FULL_SPEED[CHANNEL_COUNT] = { EXTERN_ADC_BURST_FREQ, EXTERN_ADC_BURST_FREQ, EXTERN_ADC_BURST_FREQ };
+
+/* Functions */
+
+// Function to get how far a reading is from what a perfect converter gives for the channel (LSB)
+static double errorLsb(int c, float value) {
+  return value - SimADC::idealCode(SimADC::pinVolts(_CHANNELS[c]));
+}
+
+// Derating: at the full clock the moisture divider can't charge the sample capacitor in one conversion, so
+// the first ones after switching channel are off and the variance is inflated with no noise at all
+static void testDerating() {
+  ADCReading derated[CHANNEL_COUNT];
+  ADCReading fullSpeed[CHANNEL_COUNT];
+
+  printf("burst clocks: light %u Hz, temperature %u Hz, moisture %u Hz\n", _DERATED[0], _DERATED[1], _DERATED[2]);
+  CHECK(_DERATED[0] <= EXTERN_ADC_BURST_FREQ && _DERATED[1] <= EXTERN_ADC_BURST_FREQ);
+  CHECK(_DERATED[2] < EXTERN_ADC_BURST_FREQ / 5);
+
+  SimADC::setNoise(0);
+  for (int oversamples = 1; oversamples <= SENSOR_OVERSAMPLES; oversamples += SENSOR_OVERSAMPLES - 1) {
+    SensorMetrics::burstReadExternADC(_CHANNELS, _DERATED, CHANNEL_COUNT, oversamples, ADC_FILTER_MEDIAN, derated);
+    SensorMetrics::burstReadExternADC(_CHANNELS, _FULL_SPEED, CHANNEL_COUNT, oversamples, ADC_FILTER_MEDIAN, fullSpeed);
+    printf("moisture, %d oversamples: derated clock off by %.1f LSB (variance %.1f), full clock off by %.1f LSB (variance %.1f)\n",
+           oversamples, errorLsb(2, derated[2].value), derated[2].variance, errorLsb(2, fullSpeed[2].value), fullSpeed[2].variance);
+
+    for (int c = 0; c < CHANNEL_COUNT; c++) {
+      CHECK(fabs(errorLsb(c, derated[c].value)) <= 1);
+      CHECK(derated[c].variance <= 0.5f);
+    }
+    if (oversamples == 1) {
+      CHECK(fabs(errorLsb(2, fullSpeed[2].value)) > 5);
+    }
+    else {
+      CHECK(fullSpeed[2].variance > 5);
+    }
+  }
+}
+
+// Filtering: against impulses the median and trimmed mean stay close where single conversions don't
+static void testFiltering(ADCFilter filter, const char* name) {
+  ADCReading readings[CHANNEL_COUNT];
+  double singleSq = 0, filteredSq = 0, worst = 0;
+
+  SimADC::setNoise(NOISE_SIGMA_LSB, SPIKE_PER_MILLE, SPIKE_LSB, 7);
+  for (int t = 0; t < TRIALS; t++) {
+    SensorMetrics::burstReadExternADC(_CHANNELS, _DERATED, CHANNEL_COUNT, 1, filter, readings);
+    for (int c = 0; c < CHANNEL_COUNT; c++) {
+      singleSq += pow(errorLsb(c, readings[c].value), 2);
+    }
+
+    SensorMetrics::burstReadExternADC(_CHANNELS, _DERATED, CHANNEL_COUNT, SENSOR_OVERSAMPLES, filter, readings);
+    for (int c = 0; c < CHANNEL_COUNT; c++) {
+      double error = errorLsb(c, readings[c].value);
+      filteredSq += error * error;
+      worst = max(worst, fabs(error));
+    }
+  }
+
+  double singleRms = sqrt(singleSq / (TRIALS * CHANNEL_COUNT));
+  double filteredRms = sqrt(filteredSq / (TRIALS * CHANNEL_COUNT));
+  printf("%-12s single conversion %5.1f LSB rms, %d oversamples %4.2f LSB rms (worst %.1f)\n",
+         name, singleRms, SENSOR_OVERSAMPLES, filteredRms, worst);
+  CHECK(filteredRms < singleRms / 5);
+  CHECK(worst <= 4 * NOISE_SIGMA_LSB);
+}
+
+// Variance: with gaussian noise only, the estimate comes out near sigma squared
+static void testVariance() {
+  ADCReading readings[CHANNEL_COUNT];
+  double sum = 0;
+
+  SimADC::setNoise(NOISE_SIGMA_LSB, 0, 0, 11);
+  for (int t = 0; t < TRIALS; t++) {
+    SensorMetrics::burstReadExternADC(_CHANNELS, _DERATED, CHANNEL_COUNT, SENSOR_OVERSAMPLES, ADC_FILTER_MEDIAN, readings);
+    for (int c = 0; c < CHANNEL_COUNT; c++) {
+      sum += readings[c].variance;
+    }
+  }
+
+  double variance = sum / (TRIALS * CHANNEL_COUNT);
+  double expected = (NOISE_SIGMA_LSB * NOISE_SIGMA_LSB) + (1.0 / 12); // plus the quantisation of the codes
+  printf("variance estimate %.2f LSB^2, injected %.2f\n", variance, expected);
+  CHECK(fabs(variance - expected) < 0.25 * expected);
+}
+
+// Settle learning: after a power up with quick sensors, the typical settle time follows slower ones to within
+// half a step of what each wake sees, rather than stopping as soon as it is less than a whole step away
+static void testSettleLearning() {
+  SimNode::powerCycle();
+  SimADC::setNoise(0);
+  SimADC::setChannel(_CHANNELS[2], 1.0, MoistureSensor<MOISTURE_SENSOR_CH>::sourceOhms, QUICK_RISE_MS);
+  for (int w = 0; w <= SETTLE_WAKES; w++) {
+    SensorMetrics::externADCOn(_CHANNELS, _DERATED, CHANNEL_COUNT);
+    SensorMetrics::externADCOff();
+    if (w == 0) {
+      printf("settle: %lu ms learned at power up", SensorMetrics::getTypicalSettleTime());
+      SimADC::setChannel(_CHANNELS[2], 1.0, MoistureSensor<MOISTURE_SENSOR_CH>::sourceOhms, SLOW_RISE_MS);
+    }
+    delay(SLEEP_MS);
+  }
+
+  long typical = SensorMetrics::getTypicalSettleTime(), last = SensorMetrics::getSettleTime();
+  printf(", %ld ms after %d slower wakes, the last of which took %ld ms\n", typical, SETTLE_WAKES, last);
+  CHECK(typical > SETTLE_HISTORY_WEIGHT); // it was learned, from more than nothing
+  CHECK(labs(typical - last) < SETTLE_HISTORY_WEIGHT / 2);
+}
+
+int main() {
+  SimWorld::setPlant(1.88, 1.41, 1.0);
+  SensorMetrics::setupExternADC();
+  SensorMetrics::externADCOn(_CHANNELS, _DERATED, CHANNEL_COUNT);
+
+  testDerating();
+  testFiltering(ADC_FILTER_MEDIAN, "median");
+  testFiltering(ADC_FILTER_TRIMMED_MEAN, "trimmed mean");
+  testVariance();
+
+  SensorMetrics::externADCOff();
+  testSettleLearning();
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
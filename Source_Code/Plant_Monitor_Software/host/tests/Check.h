@@ -0,0 +1,29 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef Check_h
+#define Check_h
+
+// Include the necessary libraries
+#include <stdio.h>
+#include <stdlib.h>
+
+// Minimal checks for the host tests: a failed check is reported and the test carries on, then
+// CHECK_RESULT() is returned from main() so ctest sees the failure
+static int _checkFailures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			_checkFailures++; \
+		} \
+	} while (0)
+
+#define CHECK_RESULT() ((_checkFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
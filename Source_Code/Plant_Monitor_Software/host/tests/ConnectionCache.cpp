@@ -0,0 +1,87 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Cached access point and IP settings: a fast join that only failed because the caller's timeout was
+// shorter than FAST_CONNECT_TIMEOUT must leave the cache alone, while one that had its whole window and
+// still failed (the access point moved channel) must drop it and fall back to a full join. Once half the DHCP
+// lease has passed the cached address isn't reused, a full join renews the lease and caches it again.
+
+// Include necessary header files
+#include "ConnectionManager.h"
+#include "WakeClock.h"
+#include "Check.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include <stdio.h>
+
+/* Definitions */
+#define TEST_SSID "PlantNet"
+#define TEST_PASS "secret"
+#define LONG_TIMEOUT 20000
+#define SHORT_TIMEOUT 1000 // less than FAST_CONNECT_TIMEOUT
+#define SLOW_ASSOC_MS 2000 // access point busy, longer than SHORT_TIMEOUT
+#define LEASE_S 600 // short lease, so half of it passes in a few wakes
+#define SLEEP_S 200 // between the lease wakes
+#define US_PER_S 1000000ULL
+
+/* Variables */
+static unsigned long _joinTimeout = LONG_TIMEOUT; // set before each wake, the child gets a copy
+static uint32_t _sleepS = 0; // deep sleep after each wake
+
+/* Functions */
+
+// Wake that joins the network and goes back to sleep
+static void join() {
+  WakeClock::begin(); // as the sketch does, the lease is timed on it
+  ConnectionManager::connect(TEST_SSID, TEST_PASS, "plant-node", _joinTimeout);
+  WakeClock::deepSleep(_sleepS * US_PER_S);
+}
+
+// Function to run a wake and tell whether it joined on the cached settings
+static bool joinedFast(unsigned long timeout) {
+  uint32_t fast = SimNetwork::getStats().fastAssociations;
+
+  _joinTimeout = timeout;
+  CHECK(SimNode::wake(join).result == WAKE_SLEPT);
+  return SimNetwork::getStats().fastAssociations != fast;
+}
+
+int main() {
+  SimLink& link = SimNetwork::link();
+  uint16_t assocMs = link.assocMs;
+
+  SimNode::powerCycle();
+  CHECK(!joinedFast(LONG_TIMEOUT)); // nothing cached yet, full join saves the settings
+  CHECK(joinedFast(LONG_TIMEOUT));
+
+  // Caller's budget runs out before the fast path's window: the settings weren't proven stale
+  link.assocMs = SLOW_ASSOC_MS;
+  uint32_t joins = SimNetwork::getStats().associations;
+  CHECK(!joinedFast(SHORT_TIMEOUT));
+  CHECK(SimNetwork::getStats().associations == joins);
+  link.assocMs = assocMs;
+  CHECK(joinedFast(LONG_TIMEOUT));
+
+  // Access point moved: the whole window passes, the cache goes and a full join finds the new channel
+  link.channel = 11;
+  CHECK(!joinedFast(LONG_TIMEOUT));
+  CHECK(joinedFast(LONG_TIMEOUT)); // cached again, on the new channel
+
+  // Lease half over: renewed with a full join rather than reused as a static configuration, then cached again
+  link.leaseS = LEASE_S;
+  _sleepS = SLEEP_S;
+  SimNode::powerCycle();
+  CHECK(!joinedFast(LONG_TIMEOUT)); // lease obtained at 0 s
+  CHECK(joinedFast(LONG_TIMEOUT)); // 200 s
+  CHECK(!joinedFast(LONG_TIMEOUT)); // 400 s, past half of it
+  CHECK(joinedFast(LONG_TIMEOUT)); // 600 s, renewed at 400 s
+  CHECK(!joinedFast(LONG_TIMEOUT)); // 800 s
+
+  const SimNetStats& stats = SimNetwork::getStats();
+  printf("%u joins, %u on cached settings\n", stats.associations, stats.fastAssociations);
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,106 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// RTC ring of log records: records come back from RTC memory and print with their level tag and filled in
+// format, the oldest make way once the ring is full (and are counted), and records left by firmware with a
+// different event table are discarded instead of being printed against the wrong formats.
+
+// Include necessary header files
+#include "EventLog.h"
+#include "RTCStore.h"
+#include "Check.h"
+#include "SimNode.h"
+#include "SimSerial.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Definitions */
+#define RING_BYTES 48 // LogRing, as in EventLog.cpp
+#define WRAP_RECORDS 100 // written into the ring to wrap it several times
+#define FIRST_REPLY 1000 // argument of the first of them (two byte varints)
+#define LINE_SIZE 64
+
+/* Functions */
+
+// Function to print the records to the console and get what was printed
+static const char* flushed() {
+  SimSerial::clearOutput();
+  EventLog::flush(Serial);
+  return SimSerial::output();
+}
+
+// Records: survive a reload from RTC memory, print oldest first, arguments of either sign
+static void testRecords() {
+  EventLog::flush(Serial);
+  EventLog::write(EVENT_ATTEMPT, 2);
+  EventLog::write(EVENT_SMTP_REPLY, -1);
+  EventLog::write(EVENT_EMAIL_SENT);
+  CHECK(EventLog::getBytesUsed() == 5); // ID and a one byte varint twice, then an ID alone
+
+  CHECK(EventLog::begin()); // what the next wake finds
+  CHECK(EventLog::getCount() == 3);
+  CHECK(strcmp(flushed(), "I Attempt #2\r\nD Reply -1\r\nI Email Sent Successfully!\r\n") == 0);
+  CHECK(EventLog::getCount() == 0);
+  CHECK(strcmp(flushed(), "") == 0);
+}
+
+// Wraparound: the newest records are kept whole and in order, the ones overwritten are counted
+static void testWraparound() {
+  char line[LINE_SIZE];
+
+  EventLog::flush(Serial);
+  for (int r = 0; r < WRAP_RECORDS; r++) {
+    EventLog::write(EVENT_SMTP_REPLY, FIRST_REPLY + r);
+  }
+  int count = EventLog::getCount();
+  CHECK(count > 0 && EventLog::getDropped() == WRAP_RECORDS - count);
+  CHECK(EventLog::begin());
+
+  const char* output = flushed();
+  snprintf(line, sizeof(line), "(%d older records overwritten)\r\n", WRAP_RECORDS - count);
+  CHECK(strncmp(output, line, strlen(line)) == 0);
+  output += strlen(line);
+  for (int r = WRAP_RECORDS - count; r < WRAP_RECORDS; r++) {
+    snprintf(line, sizeof(line), "D Reply %d\r\n", FIRST_REPLY + r);
+    CHECK(strncmp(output, line, strlen(line)) == 0);
+    output += strlen(line);
+  }
+  CHECK(*output == '\0');
+  printf("%d records of three bytes held, %d overwritten\n", count, WRAP_RECORDS - count);
+}
+
+// Reflash: a ring written against another event table is dropped, though its CRC is good
+static void testOtherFirmware() {
+  uint8_t ring[RING_BYTES];
+
+  EventLog::flush(Serial);
+  EventLog::write(EVENT_ATTEMPT, 1);
+  CHECK(RTCStore::load(RTC_EVENT_LOG_SLOT, ring, sizeof(ring)));
+  ring[0] ^= 0x5A; // table ID comes first
+  CHECK(RTCStore::save(RTC_EVENT_LOG_SLOT, ring, sizeof(ring)));
+
+  CHECK(!EventLog::begin());
+  CHECK(EventLog::getCount() == 0);
+  CHECK(strcmp(flushed(), "") == 0);
+  CHECK(EventLog::begin()); // the reset ring is valid from then on
+
+  SimNode::powerCycle(); // and after power loss it starts over too
+  CHECK(!EventLog::begin());
+  CHECK(EventLog::getCount() == 0);
+}
+
+int main() {
+  static_assert(RTCStore::blocksFor(RING_BYTES) == RTC_EVENT_LOG_BLOCKS, "RING_BYTES no longer matches the slot");
+
+  SimNode::powerCycle();
+  EventLog::begin();
+
+  testRecords();
+  testWraparound();
+  testOtherFirmware();
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
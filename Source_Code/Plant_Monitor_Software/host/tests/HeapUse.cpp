@@ -0,0 +1,148 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Watches the node's heap (SimHeap) through its allocation hook. Sending a queued message to several recipients,
+// one of them refused, must not allocate at all whatever extensions the server offers: commands, the envelope,
+// the headers, the AUTH PLAIN credentials and the report are streamed through fixed buffers. Whole wakes of the
+// sketch are then run to report the peak heap use and the worst fragmentation along the way.
+
+// Include necessary header files
+#include "SMTP.h"
+#include "Check.h"
+#include "SimFlash.h"
+#include "SimHeap.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include "SimShared.h"
+#include "SimWorld.h"
+#include <stdio.h>
+
+/* Definitions */
+#define REFUSED_PATTERN "away"
+#define SKETCH_WAKES 40
+#define RECORD_BYTES 300 // binary record attached to the second message
+#define FRAGMENTATION_LIMIT 10 // % the heap may reach over the sketch's wakes
+
+/* What the allocation hook saw during a wake */
+struct HeapResult {
+	uint32_t allocations;
+	uint32_t largest; // largest allocation asked for (bytes)
+	uint32_t failures;
+	uint32_t peakBytes; // most heap in use at once
+	uint8_t fragmentation; // worst fragmentation (%) right after an allocation
+	uint32_t delivered; // messages sendQueued() got out
+};
+
+/* Variables */
+static HeapResult* _result = SimShared::create<HeapResult>();
+static bool f_Watching = false; // whether allocations are counted
+
+// Sketch entry point
+void setup();
+
+/* Functions */
+
+// Allocation hook, counts what the firmware allocates while watched
+static void countAllocation(size_t size, void* ptr) {
+  if (!f_Watching) {
+    return;
+  }
+  if (ptr == NULL) {
+    _result->failures++;
+    return;
+  }
+
+  _result->allocations++;
+  _result->largest = max(_result->largest, (uint32_t)size);
+  _result->peakBytes = max(_result->peakBytes, SimHeap::getStats().usedBytes);
+  _result->fragmentation = max(_result->fragmentation, SimHeap::getFragmentation());
+}
+
+// Function to write the message body
+static void writeBody(Print& out) {
+  out.print(F("<p>Soil moisture: 42 %</p>\r\n"));
+}
+
+// Function to write a binary record
+static void writeRecord(Print& out) {
+  for (int i = 0; i < RECORD_BYTES; i++) {
+    out.write((uint8_t)i);
+  }
+}
+
+// Wake that joins the network and sends two messages to three recipients, watching only the send
+static void sendQueued() {
+  SimNetwork::join();
+
+  SMTP smtp("grower@example.com");
+  smtp.addRecipient("greenhouse@example.com");
+  smtp.addRecipient("away@example.com");
+  smtp.queueMessage(PSTR("Heap test"), writeBody);
+  smtp.queueMessage(PSTR("Heap test with record"), writeBody, writeRecord);
+
+  f_Watching = true;
+  _result->delivered = smtp.getQueuedCount();
+  smtp.sendQueued();
+  _result->delivered -= smtp.getQueuedCount();
+  f_Watching = false;
+  ESP.deepSleep(0);
+}
+
+// Function to run a send with the server offering the given extensions
+static void runSend(SimSmtpServer& gmail, bool pipelining, bool authPlain) {
+  *_result = HeapResult();
+  gmail.clear();
+  gmail.options().pipelining = pipelining;
+  gmail.options().authPlain = authPlain;
+
+  CHECK(SimNode::wake(sendQueued).result == WAKE_SLEPT);
+  printf("PIPELINING %-3s AUTH PLAIN %-3s: %u messages sent, %u allocations (largest %u bytes)\n",
+         pipelining ? "on" : "off", authPlain ? "on" : "off", _result->delivered, _result->allocations, _result->largest);
+
+  CHECK(_result->delivered == 2);
+  CHECK(gmail.getStats().messages == 2);
+  CHECK(gmail.getStats().recipientsRefused == 2);
+  CHECK(_result->allocations == 0);
+}
+
+// Wake of the whole sketch, watched from start to sleep
+static void watchedSketch() {
+  f_Watching = true;
+  setup();
+}
+
+int main() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+
+  SimWorld::setUp(gmail, relay, listener);
+  SimWorld::setPlant(1.88, 1.41, 1.0);
+  strcpy(gmail.options().refusePattern, REFUSED_PATTERN);
+  SimHeap::setHook(countAllocation);
+  SimNode::powerCycle();
+
+  runSend(gmail, false, false);
+  runSend(gmail, true, false);
+  runSend(gmail, false, true);
+  runSend(gmail, true, true);
+
+  gmail.options().refusePattern[0] = '\0';
+  SimFlash::erase();
+  SimNode::powerCycle();
+  *_result = HeapResult();
+  for (int w = 0; w < SKETCH_WAKES; w++) {
+    CHECK(SimNode::wake(watchedSketch).result == WAKE_SLEPT);
+  }
+  printf("%d sketch wakes: %u allocations (largest %u bytes), peak %u of %u bytes in use, worst fragmentation %u %%\n",
+         SKETCH_WAKES, _result->allocations, _result->largest, _result->peakBytes, SIM_HEAP_BYTES, _result->fragmentation);
+  CHECK(gmail.getStats().messages > 0);
+  CHECK(_result->failures == 0);
+  CHECK(_result->fragmentation <= FRAGMENTATION_LIMIT);
+
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,213 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Phase profiler: durations land in the right histogram buckets with the right min, mean and max, counters
+// halve instead of wrapping, the statistics survive deep sleep in RTC memory and start over after a power
+// loss. The summary a report carries is read back with the host decoder (tools/ProfileSummary), from a report
+// written here, from a report of a node that didn't yet end its lines with CRLF, and from the emails the
+// sketch sends, where a node with a slow access point has to be flagged.
+
+// Include necessary header files
+#include "Profiler.h"
+#include "ProfileSummary.h"
+#include "Check.h"
+#include "SimFlash.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include "SimWorld.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Definitions */
+#define US_PER_MS 1000UL
+#define OVERFLOW_DURATION_MS 42
+#define CLAMPED_DURATION_MS 70000UL // past what min and max can hold
+#define FIRST_BUCKET_LIMIT_MS 10
+#define TEXT_SIZE 2048
+#define SKETCH_REPORTS 2 // the first goes out on the first wake, with no whole wake recorded yet
+#define SKETCH_WAKES_MAX 200
+#define SLOW_ASSOC_MS 4000 // a weak access point
+
+static_assert(PROFILE_SUMMARY_BUCKETS == PROFILE_HISTOGRAM_BUCKETS, "the decoder must read as many buckets as the node writes");
+
+/* Collects printed text in memory */
+class TextSink : public Print {
+	public:
+		TextSink() : _length(0) { _text[0] = '\0'; }
+		size_t write(uint8_t c) override {
+			if (_length < TEXT_SIZE - 1) {
+				_text[_length++] = c;
+				_text[_length] = '\0';
+			}
+			return 1;
+		}
+		using Print::write;
+		const char* text() const { return _text; }
+	private:
+		char _text[TEXT_SIZE];
+		size_t _length;
+};
+
+/* Constants */
+// One duration per histogram bucket, shortest first
+static const uint32_t _BUCKET_DURATIONS_MS[PROFILE_HISTOGRAM_BUCKETS] = { 5, 50, 300, 1500, 3000, 7000 };
+
+// Summary as nodes wrote it before its lines ended in CRLF
+static const char _UNTERMINATED_REPORT[] =
+  "<h2><u>seedling-7</u></h2><br><h3>&emsp;Timing (ms):</h3><br>"
+  "&emsp;&emsp;awake: n=12 min=4100 mean=5200 max=9800 hist=0/0/0/0/10/2<br>"
+  "&emsp;&emsp;wifi: n=12 min=900 mean=3100 max=6200 hist=0/0/1/4/5/2<br>"
+  "&emsp;&emsp;reply: n=96 min=40 mean=80 max=300 hist=0/90/6/0/0/0<br></body></html>";
+
+// Sketch entry point
+void setup();
+
+/* Functions */
+
+// Bucketing and the statistics of one phase
+static void testRecording() {
+  uint32_t totalMs = 0;
+
+  CHECK(!Profiler::begin()); // nothing valid in RTC memory after the power cycle
+  for (int b = 0; b < PROFILE_HISTOGRAM_BUCKETS; b++) {
+    Profiler::record(PHASE_REPLY, _BUCKET_DURATIONS_MS[b] * US_PER_MS);
+    totalMs += _BUCKET_DURATIONS_MS[b];
+  }
+  Profiler::record(PHASE_TLS, (FIRST_BUCKET_LIMIT_MS * US_PER_MS) - 1); // just under a bucket limit
+
+  const PhaseStats& reply = Profiler::getStats(PHASE_REPLY);
+  CHECK(reply.count == PROFILE_HISTOGRAM_BUCKETS);
+  CHECK(reply.minMs == _BUCKET_DURATIONS_MS[0]);
+  CHECK(reply.maxMs == _BUCKET_DURATIONS_MS[PROFILE_HISTOGRAM_BUCKETS - 1]);
+  CHECK(reply.totalMs == totalMs);
+  for (int b = 0; b < PROFILE_HISTOGRAM_BUCKETS; b++) {
+    CHECK(reply.histogram[b] == 1);
+  }
+  CHECK(Profiler::getStats(PHASE_TLS).histogram[0] == 1);
+  CHECK(Profiler::getStats(PHASE_SENSORS).count == 0);
+
+  Profiler::record(PHASE_STARTUP, CLAMPED_DURATION_MS * US_PER_MS);
+  CHECK(Profiler::getStats(PHASE_STARTUP).maxMs == 0xFFFF);
+  CHECK(Profiler::getStats(PHASE_STARTUP).totalMs == CLAMPED_DURATION_MS); // the mean isn't clamped
+}
+
+// Counters halve rather than wrap, keeping the mean and the histogram's shape
+static void testOverflow() {
+  for (uint32_t i = 0; i < 0x10000; i++) {
+    Profiler::record(PHASE_SENSORS, OVERFLOW_DURATION_MS * US_PER_MS);
+  }
+
+  const PhaseStats& sensors = Profiler::getStats(PHASE_SENSORS);
+  printf("after 65536 records: n=%u mean=%u, bucket count %u\n", sensors.count, sensors.totalMs / sensors.count, sensors.histogram[1]);
+  CHECK(sensors.count > 0x7FFF && sensors.count < 0xFFFF);
+  CHECK(sensors.totalMs / sensors.count == OVERFLOW_DURATION_MS);
+  CHECK(sensors.histogram[1] > 0x7F && sensors.histogram[0] == 0);
+}
+
+// The statistics survive deep sleep, and start over when RTC memory is lost
+static void testPersistence() {
+  PhaseStats before = Profiler::getStats(PHASE_REPLY);
+
+  Profiler::end(); // saved as the wake ends, with its awake time
+  CHECK(Profiler::begin());
+  CHECK(memcmp(&Profiler::getStats(PHASE_REPLY), &before, sizeof(before)) == 0);
+  CHECK(Profiler::getStats(PHASE_AWAKE).count == 1);
+
+  SimNode::powerCycle();
+  CHECK(!Profiler::begin());
+  CHECK(Profiler::getStats(PHASE_REPLY).count == 0);
+}
+
+// What the node writes decodes back to its statistics
+static void testDecode() {
+  static const char* const NAMES[PHASE_COUNT] = { "awake", "startup", "sensors", "wifi", "tls", "reply", "report" };
+  static DecodedProfile profile;
+  TextSink sink;
+
+  Profiler::begin();
+  for (int b = 0; b < PROFILE_HISTOGRAM_BUCKETS; b++) {
+    Profiler::record(PHASE_WIFI, _BUCKET_DURATIONS_MS[b] * US_PER_MS);
+    Profiler::record(PHASE_REPLY, _BUCKET_DURATIONS_MS[b] * US_PER_MS / 2);
+  }
+  {
+    ReportWriter report(sink);
+    report.printTemplate(PSTR("<h2><u>%r</u></h2><br>\r\n"), "test-node");
+    Profiler::writeReport(report);
+  }
+
+  CHECK(ProfileSummary::decode(sink.text(), profile));
+  CHECK(strcmp(profile.node, "test-node") == 0);
+  CHECK(profile.phaseCount == 2); // phases never recorded are left out
+  for (int p = 0; p < PHASE_COUNT; p++) {
+    const PhaseStats& stats = Profiler::getStats((ProfilePhase)p);
+    const DecodedPhase* phase = ProfileSummary::find(profile, NAMES[p]);
+
+    CHECK((phase != NULL) == (stats.count > 0));
+    if (phase != NULL) {
+      CHECK(phase->count == stats.count && phase->minMs == stats.minMs && phase->maxMs == stats.maxMs);
+      CHECK(phase->meanMs == stats.totalMs / stats.count);
+      for (int b = 0; b < PROFILE_HISTOGRAM_BUCKETS; b++) {
+        CHECK(phase->histogram[b] == stats.histogram[b]);
+      }
+    }
+  }
+
+  CHECK(ProfileSummary::decode(_UNTERMINATED_REPORT, profile));
+  CHECK(strcmp(profile.node, "seedling-7") == 0);
+  CHECK(profile.phaseCount == 3);
+  CHECK(ProfileSummary::find(profile, "reply") != NULL && ProfileSummary::find(profile, "reply")->histogram[1] == 90);
+  CHECK(ProfileSummary::print(stdout, profile) == 1); // slow WiFi
+
+  CHECK(!ProfileSummary::decode("<html><body>no timing here</body></html>", profile));
+}
+
+// Function to run the sketch until it has emailed a report, then decode the timing summary it carried
+// Returns the number of warnings the decoder printed
+static int decodeSketchReport(SimSmtpServer& gmail, uint16_t assocMs) {
+  static DecodedProfile profile;
+  int wakes = 0;
+
+  gmail.clear();
+  SimFlash::erase();
+  SimNode::powerCycle();
+  SimNetwork::link().assocMs = assocMs;
+  while (wakes < SKETCH_WAKES_MAX && gmail.getStats().messages < SKETCH_REPORTS) {
+    CHECK(SimNode::wake(setup).result == WAKE_SLEPT);
+    wakes++;
+  }
+
+  CHECK(ProfileSummary::decode(gmail.lastMessage(), profile));
+  const DecodedPhase* awake = ProfileSummary::find(profile, "awake");
+  const DecodedPhase* wifi = ProfileSummary::find(profile, "wifi");
+  CHECK(awake != NULL && awake->count == (uint32_t)(wakes - 1)); // the wake sending the report isn't over yet
+  CHECK(wifi != NULL && wifi->minMs >= assocMs);
+  CHECK(ProfileSummary::find(profile, "reply") != NULL);
+
+  printf("report after %d wakes, association %u ms:\n", wakes, assocMs);
+  return ProfileSummary::print(stdout, profile);
+}
+
+int main() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+
+  SimNode::powerCycle();
+  testRecording();
+  testOverflow();
+  testPersistence();
+  testDecode();
+
+  SimWorld::setUp(gmail, relay, listener);
+  SimWorld::setPlant(1.88, 1.41, 1.0);
+  uint16_t assocMs = SimNetwork::link().assocMs;
+  CHECK(decodeSketchReport(gmail, assocMs) == 0);
+  CHECK(decodeSketchReport(gmail, SLOW_ASSOC_MS) > 0);
+  SimNetwork::link().assocMs = assocMs;
+
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
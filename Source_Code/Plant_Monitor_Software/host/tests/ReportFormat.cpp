@@ -0,0 +1,59 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Runs the sketch until it has emailed a few digests and checks the messages Gmail got: every line CRLF
+// terminated and within the 998 characters RFC 5322 allows, however long the series, and the headers intact.
+
+// Include necessary header files
+#include "Check.h"
+#include "SimFlash.h"
+#include "SimNode.h"
+#include "SimWorld.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Definitions */
+#define MAX_WAKES 200
+#define REPORTS_WANTED 3
+#define RFC5322_LINE_LIMIT 998
+#define DRY_VOLTS_PER_WAKE 0.004
+
+// Sketch entry point
+void setup();
+
+/* Functions */
+
+int main() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+  double moisture = 1.0;
+
+  SimWorld::setUp(gmail, relay, listener);
+  SimWorld::setPlant(1.88, 1.41, moisture);
+  SimFlash::erase();
+  SimNode::powerCycle();
+
+  for (int w = 0; w < MAX_WAKES && gmail.getStats().messages < REPORTS_WANTED; w++) {
+    moisture += DRY_VOLTS_PER_WAKE;
+    SimWorld::setPlant(1.88, 1.41, moisture);
+    CHECK(SimNode::wake(setup).result == WAKE_SLEPT);
+  }
+
+  const SimSmtpStats& stats = gmail.getStats();
+  const char* message = gmail.lastMessage();
+  printf("%u reports, longest line %u characters, %u bare line feeds, last report %u bytes\n",
+         stats.messages, stats.longestLine, stats.bareLineFeeds, (unsigned)strlen(message));
+
+  CHECK(stats.messages >= REPORTS_WANTED);
+  CHECK(stats.longestLine <= RFC5322_LINE_LIMIT);
+  CHECK(stats.bareLineFeeds == 0);
+  CHECK(strstr(message, "seconds ago:</u><br>\r\n") != NULL);
+  CHECK(strstr(message, "charset=\"ISO-8859-1\"\r\n") != NULL);
+  CHECK(strstr(message, "Mime-Version: 1.0\r\n") != NULL);
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,100 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// The sketch against a server that refuses the report: refused for good (5xx), the wake makes one session and
+// drops the readings, with nothing retried or moved to flash and nothing carried into later reports; refused for
+// now (4xx), it retries, keeps the readings in flash and delivers them late once the server takes them.
+
+// Include necessary header files
+#include "Check.h"
+#include "SimFlash.h"
+#include "SimNode.h"
+#include "SimWorld.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Definitions */
+#define MAX_WAKES 200
+#define EVERY_ADDRESS "@" // refusal pattern every recipient matches
+#define RETRY_ATTEMPTS 3 // as the sketch has it
+#define REFUSED_REPORTS 2 // reports refused for good before the server is asked for a transient refusal
+#define BACKLOG_HEADER "Delivered Late:" // section of a report holding the readings kept in flash
+
+/* What the wake that reported did */
+struct ReportWake {
+	bool reported; // whether a wake made a session before MAX_WAKES
+	uint32_t sessions; // sessions that wake made
+	uint64_t flashWritten; // bytes it wrote to flash
+};
+
+// Sketch entry point
+void setup();
+
+/* Functions */
+
+// Function to run the sketch until a wake talks to the server, and what that wake did
+static ReportWake runUntilReport(SimSmtpServer& gmail) {
+  ReportWake report = {};
+
+  for (int w = 0; w < MAX_WAKES && !report.reported; w++) {
+    uint32_t sessions = gmail.getStats().sessions;
+    uint64_t written = SimFlash::getStats().bytesWritten;
+
+    CHECK(SimNode::wake(setup).result == WAKE_SLEPT);
+    report.sessions = gmail.getStats().sessions - sessions;
+    report.flashWritten = SimFlash::getStats().bytesWritten - written;
+    report.reported = (report.sessions > 0);
+  }
+  return report;
+}
+
+// Refused for good: one session per report, the readings dropped rather than spilled or sent again
+static void testPermanentRefusal(SimSmtpServer& gmail) {
+  strcpy(gmail.options().refusePattern, EVERY_ADDRESS);
+  gmail.options().refuseCode = 550;
+
+  for (int r = 0; r < REFUSED_REPORTS; r++) {
+    ReportWake report = runUntilReport(gmail);
+    printf("refused for good: %u session(s), %llu bytes to flash\n", report.sessions, (unsigned long long)report.flashWritten);
+    CHECK(report.reported);
+    CHECK(report.sessions == 1);
+    CHECK(report.flashWritten == 0);
+  }
+  CHECK(gmail.getStats().messages == 0);
+}
+
+// Refused for now: every attempt made, the readings spilled, and delivered late once the server takes them
+static void testTransientRefusal(SimSmtpServer& gmail) {
+  gmail.options().refuseCode = 451;
+
+  ReportWake report = runUntilReport(gmail);
+  printf("refused for now: %u session(s), %llu bytes to flash\n", report.sessions, (unsigned long long)report.flashWritten);
+  CHECK(report.reported);
+  CHECK(report.sessions == RETRY_ATTEMPTS);
+  CHECK(report.flashWritten > 0);
+
+  gmail.options().refusePattern[0] = '\0';
+  report = runUntilReport(gmail);
+  CHECK(report.reported && report.sessions == 1);
+  CHECK(gmail.getStats().messages == 1);
+  CHECK(strstr(gmail.lastMessage(), BACKLOG_HEADER) != NULL);
+}
+
+int main() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+
+  SimWorld::setUp(gmail, relay, listener);
+  SimWorld::setPlant();
+  SimFlash::erase();
+  SimNode::powerCycle();
+
+  testPermanentRefusal(gmail);
+  testTransientRefusal(gmail);
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,134 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// RTC memory ring of readings: it keeps the newest SAMPLE_BUFFER_CAPACITY readings in order as it wraps
+// around, survives a reload from RTC memory, and starts over empty when its CRC says the contents can't be
+// trusted (a corrupted block, or whatever RTC memory holds after a brown-out). The flag saying whether the
+// flash log holds readings survives both, and is set again when the buffer starts over.
+
+// Include necessary header files
+#include "SampleBuffer.h"
+#include "RTCStore.h"
+#include "Check.h"
+#include "SimNode.h"
+#include <stdio.h>
+
+/* Definitions */
+#define EXTRA_READINGS 5 // appended past a full buffer
+
+/* Functions */
+
+// Method to fill in a set of readings that is different for every n and survives packing
+static void makeReadings(int n, float* sensors) {
+  sensors[0] = 1000 + n; // lux
+  sensors[1] = 60 + (n * 0.5f); // ºF
+  sensors[2] = 40 + n; // %
+  sensors[3] = 3.7f - (n * 0.01f); // V
+}
+
+// Function to check that a held reading is the one that was appended n-th
+static bool isReading(int index, int n) {
+  float expected[SAMPLE_SENSOR_COUNT];
+  float held[SAMPLE_SENSOR_COUNT];
+
+  makeReadings(n, expected);
+  SampleBuffer::getSample(index, held);
+  for (int i = 0; i < SAMPLE_SENSOR_COUNT; i++) {
+    if (fabsf(held[i] - expected[i]) > 0.01f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Method to append readings 0 to count - 1
+static void appendReadings(int count) {
+  float sensors[SAMPLE_SENSOR_COUNT];
+
+  for (int n = 0; n < count; n++) {
+    makeReadings(n, sensors);
+    SampleBuffer::append(sensors);
+  }
+}
+
+// Wraparound: once full, each append drops the oldest reading and the rest stay in order
+static void testWraparound() {
+  int total = SAMPLE_BUFFER_CAPACITY + EXTRA_READINGS;
+
+  SampleBuffer::clear();
+  appendReadings(SAMPLE_BUFFER_CAPACITY - 1);
+  CHECK(!SampleBuffer::isFull());
+  SampleBuffer::clear();
+
+  appendReadings(total);
+  CHECK(SampleBuffer::isFull());
+  CHECK(SampleBuffer::getCount() == (int)SAMPLE_BUFFER_CAPACITY);
+  for (int i = 0; i < SampleBuffer::getCount(); i++) {
+    CHECK(isReading(i, EXTRA_READINGS + i));
+  }
+
+  CHECK(SampleBuffer::begin()); // what a wake finds after deep sleep
+  CHECK(SampleBuffer::getCount() == (int)SAMPLE_BUFFER_CAPACITY);
+  CHECK(isReading(0, EXTRA_READINGS));
+  CHECK(isReading(SAMPLE_BUFFER_CAPACITY - 1, total - 1));
+
+  SampleBuffer::clear();
+  CHECK(SampleBuffer::getCount() == 0);
+}
+
+// Corruption: any changed bit fails the CRC and the buffer starts over instead of reporting garbage
+static void testCorruption() {
+  uint8_t* rtc = reinterpret_cast<uint8_t*>(SimNode::rtcMemory() + RTC_SAMPLE_BUFFER_SLOT);
+  size_t slotBytes = 4 + 8 + (SAMPLE_BUFFER_CAPACITY * sizeof(SampleRecord)); // CRC, head, count, backlog flag and time, then the records
+  int detected = 0;
+
+  for (size_t offset = 0; offset < slotBytes; offset += 7) {
+    SampleBuffer::clear();
+    appendReadings(3);
+    rtc[offset] ^= (1 << (offset % 8));
+    if (!SampleBuffer::begin()) {
+      detected++;
+      CHECK(SampleBuffer::getCount() == 0);
+    }
+  }
+  CHECK(detected == (int)((slotBytes + 6) / 7));
+
+  SimNode::powerCycle(); // brown-out leaves RTC memory holding anything
+  CHECK(!SampleBuffer::begin());
+  CHECK(SampleBuffer::getCount() == 0);
+  CHECK(SampleBuffer::begin()); // the reset buffer is valid from then on
+
+  printf("wraparound over %u records and %d corrupted slots checked\n", (unsigned)SAMPLE_BUFFER_CAPACITY, detected);
+}
+
+// Backlog flag: kept through a reload and a clear, set when the buffer can't be trusted (the flash may hold anything)
+static void testBacklogFlag() {
+  SampleBuffer::setBacklog(false);
+  appendReadings(2);
+  CHECK(SampleBuffer::begin());
+  CHECK(!SampleBuffer::hasBacklog());
+
+  SampleBuffer::setBacklog(true);
+  SampleBuffer::clear();
+  CHECK(SampleBuffer::begin());
+  CHECK(SampleBuffer::hasBacklog());
+
+  SampleBuffer::setBacklog(false);
+  SimNode::powerCycle();
+  CHECK(!SampleBuffer::begin());
+  CHECK(SampleBuffer::hasBacklog());
+}
+
+int main() {
+  SimNode::powerCycle();
+  SampleBuffer::begin();
+
+  testWraparound();
+  testCorruption();
+  testBacklogFlag();
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
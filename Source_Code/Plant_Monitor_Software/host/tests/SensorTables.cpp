@@ -0,0 +1,119 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Accuracy of the compile time conversion tables: ConstMath's log and exp against the C library over the
+// range the curves need and well beyond, then every lux and temperature table entry (and interpolated
+// fractional codes) against the same curves in double precision, next to the float formulas the tables replace.
+
+// Include necessary header files
+#include "ConstMath.h"
+#include "SensorMetrics.h"
+#include "Check.h"
+#include <math.h>
+#include <stdio.h>
+
+/* Definitions */
+// Calibration as in SensorMetrics.cpp, for the reference curves
+#define EXTERN_ADC_V 2.84
+#define ADC_RESOLUTION 1024
+#define PHOTORESISTOR_R2 9830
+#define PHOTORESISTOR_M -1.1116
+#define PHOTORESISTOR_B 7.3113
+#define THERMISTOR_R2 9930
+#define THERMISTOR_BETA 3974
+#define THERMISTOR_R0 10000
+#define THERMISTOR_T0 298.15
+
+#define MATH_LIMIT 4e-15 // relative error allowed of ConstMath against the C library
+#define TABLE_LIMIT 1e-7 // relative error allowed of a whole code entry (rounding to float)
+#define INTERP_LIMIT 2e-3 // relative error allowed of an interpolated fractional code, within the usable range
+#define INTERP_FIRST 16 // below this the curves bend too sharply between codes for linear interpolation (dark, hot)
+#define FRACTIONS 8 // fractional codes checked between two entries
+
+// The tables depend on these being constant expressions
+static_assert(ConstMath::log(1.0) == 0, "ConstMath::log is not usable at compile time");
+static_assert(ConstMath::exp(0.0) == 1, "ConstMath::exp is not usable at compile time");
+
+/* Functions */
+
+// Function to get R1 of a divider from a reading
+template <class T>
+static T divR1(T adc, int r2) {
+  T vMeas = ((adc + 1) / ADC_RESOLUTION) * (T)EXTERN_ADC_V;
+  return (((T)EXTERN_ADC_V * r2) - (vMeas * r2)) / vMeas;
+}
+
+// Photoresistor curve, in float as calcLux() does it or in double as the reference
+template <class T>
+static T curveLux(T adc) {
+  return pow(divR1(adc, PHOTORESISTOR_R2), (T)PHOTORESISTOR_M) * pow((T)10, (T)PHOTORESISTOR_B);
+}
+
+// Thermistor Beta equation, in float as calcTempK() does it or in double as the reference
+template <class T>
+static T curveTempK(T adc) {
+  T ratio = log(THERMISTOR_R0 / divR1(adc, THERMISTOR_R2));
+  return (((T)THERMISTOR_T0 * THERMISTOR_BETA) / ratio) / ((THERMISTOR_BETA / ratio) - (T)THERMISTOR_T0);
+}
+
+// Function to get the relative difference of two values
+static double relative(double value, double reference) {
+  return fabs(value - reference) / fabs(reference);
+}
+
+// ConstMath against the C library
+static void testConstMath() {
+  double worstLog = 0, worstExp = 0;
+
+  for (double x = 1e-9; x < 1e12; x *= 1.0137) {
+    double reference = log(x);
+    double error = (fabs(reference) > 1e-3) ? relative(ConstMath::log(x), reference) : fabs(ConstMath::log(x) - reference);
+    worstLog = fmax(worstLog, error);
+  }
+  for (double x = -60; x <= 60; x += 0.0371) {
+    worstExp = fmax(worstExp, relative(ConstMath::exp(x), exp(x)));
+  }
+
+  printf("ConstMath: log worst relative error %.2g, exp %.2g\n", worstLog, worstExp);
+  CHECK(worstLog < MATH_LIMIT);
+  CHECK(worstExp < MATH_LIMIT);
+}
+
+// Tables against the curves in double precision, whole codes and interpolated fractional codes
+static void testTables() {
+  double worstLux = 0, worstTemp = 0, worstLuxInterp = 0, worstTempInterp = 0, worstLuxFloat = 0, worstTempFloat = 0;
+
+  for (int code = 0; code < ADC_RESOLUTION - 1; code++) { // top code is moved half a code down in the table
+    if (code == 511) {
+      continue; // thermistor at exactly R0, where the Beta equation divides by zero (calcTempK() special cases it)
+    }
+    worstLux = fmax(worstLux, relative(SensorMetrics::adcToLux(code), curveLux<double>(code)));
+    worstTemp = fmax(worstTemp, relative(SensorMetrics::adcToTempK(code), curveTempK<double>(code)));
+    worstLuxFloat = fmax(worstLuxFloat, relative(curveLux<float>(code), curveLux<double>(code)));
+    worstTempFloat = fmax(worstTempFloat, relative(curveTempK<float>(code), curveTempK<double>(code)));
+
+    for (int f = 1; f < FRACTIONS && code >= INTERP_FIRST && code < ADC_RESOLUTION - INTERP_FIRST; f++) {
+      double adc = code + ((double)f / FRACTIONS);
+      worstLuxInterp = fmax(worstLuxInterp, relative(SensorMetrics::adcToLux(adc), curveLux<double>(adc)));
+      worstTempInterp = fmax(worstTempInterp, relative(SensorMetrics::adcToTempK(adc), curveTempK<double>(adc)));
+    }
+  }
+
+  printf("lux table: worst relative error %.2g at whole codes (float formula %.2g), %.2g interpolated\n", worstLux, worstLuxFloat, worstLuxInterp);
+  printf("temperature table: worst relative error %.2g at whole codes (float formula %.2g), %.2g interpolated\n", worstTemp, worstTempFloat, worstTempInterp);
+  CHECK(worstLux < TABLE_LIMIT);
+  CHECK(worstTemp < TABLE_LIMIT);
+  CHECK(worstLux < worstLuxFloat);
+  CHECK(worstLuxInterp < INTERP_LIMIT);
+  CHECK(worstTempInterp < INTERP_LIMIT);
+}
+
+int main() {
+  testConstMath();
+  testTables();
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
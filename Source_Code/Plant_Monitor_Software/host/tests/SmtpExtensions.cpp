@@ -0,0 +1,82 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Sends the same message to a stand-in server that advertises or hides PIPELINING and AUTH PLAIN, in every
+// combination. The client has to deliver each time, use only what was advertised, and need fewer round
+// trips the more the server offers.
+
+// Include necessary header files
+#include "SMTP.h"
+#include "Check.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include "SimWorld.h"
+#include <stdio.h>
+
+/* Definitions */
+#define TEST_RECIPIENT "grower@example.com"
+#define RTT_MS 100
+#define US_PER_MS 1000.0
+
+/* Functions */
+
+// Function to write the message body
+static void writeBody(Print& out) {
+  out.print(F("<p>Soil moisture: 42 %</p>\r\n"));
+}
+
+// Wake that joins the network and sends one email
+static void sendOne() {
+  SimNetwork::join();
+
+  SMTP smtp(TEST_RECIPIENT);
+  smtp.sendUpdateEmail(PSTR("Extensions test"), writeBody);
+  ESP.deepSleep(0);
+}
+
+// Function to send one message with the server offering the given extensions, returns the round trips it took
+static double runSession(SimSmtpServer& gmail, bool pipelining, bool authPlain) {
+  gmail.clear();
+  gmail.options().pipelining = pipelining;
+  gmail.options().authPlain = authPlain;
+
+  CHECK(SimNode::wake(sendOne).result == WAKE_SLEPT);
+
+  const SimSmtpStats& stats = gmail.getStats();
+  double roundTrips = (stats.sessionCount > 0) ? stats.sessionUs[0] / US_PER_MS / RTT_MS : 0;
+  printf("PIPELINING %-3s AUTH PLAIN %-3s: %4.1f round trips, %u commands (%u pipelined writes), login by %s\n",
+         pipelining ? "on" : "off", authPlain ? "on" : "off", roundTrips, stats.commands, stats.pipelinedWrites,
+         (stats.authPlain > 0) ? "AUTH PLAIN" : ((stats.authLogin > 0) ? "AUTH LOGIN" : "nothing"));
+
+  CHECK(stats.messages == 1);
+  CHECK(stats.recipientsAccepted == 1);
+  CHECK(stats.authPlain == (authPlain ? 1U : 0U));
+  CHECK(stats.authLogin == (authPlain ? 0U : 1U));
+  CHECK(pipelining || stats.pipelinedWrites == 0);
+  CHECK(!pipelining || stats.pipelinedWrites > 0);
+  return roundTrips;
+}
+
+int main() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+
+  SimWorld::setUp(gmail, relay, listener);
+  SimNetwork::link().rttMs = RTT_MS;
+  SimNode::powerCycle();
+
+  double plain = runSession(gmail, false, false);
+  double pipelined = runSession(gmail, true, false);
+  double authPlain = runSession(gmail, false, true);
+  double both = runSession(gmail, true, true);
+
+  CHECK(pipelined < plain);
+  CHECK(authPlain < plain);
+  CHECK(both < pipelined && both < authPlain);
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
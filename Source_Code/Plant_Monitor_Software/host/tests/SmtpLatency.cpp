@@ -0,0 +1,182 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Runs the SMTP client against the stand-in Gmail server over links of increasing latency, and against a
+// server that is slow to queue the message, and prints how long each session took end to end.
+// Every session has to deliver, and has to take no more than a fixed number of round trips plus the
+// handshake's CPU time: a blind wait or an extra exchange would show up as time the link doesn't account for.
+// Then runs wakes that keep the round trip estimate in RTC memory against scripted profiles: a latency spike
+// mid-session, which has to back the deadline off and be recovered from on the next wake, and a lossy link,
+// where every session has to get through despite TCP resending lost segments.
+
+// Include necessary header files
+#include "SMTP.h"
+#include "RTTEstimator.h"
+#include "Check.h"
+#include "SimClock.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include "SimShared.h"
+#include "SimWorld.h"
+#include <stdio.h>
+
+/* Definitions */
+#define TEST_RECIPIENT "grower@example.com"
+#define SESSION_ROUND_TRIPS 10 // TCP, TLS (2), greeting, EHLO, AUTH, MAIL..DATA, message, QUIT, plus one spare
+#define SESSION_SLACK_MS 50 // writing the message out, millis() granularity
+#define SLOW_QUEUE_MS 2500 // time the slow server takes to queue a message
+#define US_PER_MS 1000.0
+#define SPIKE_MS 2000 // round trip of the replies caught in the latency spike
+#define SETTLE_SESSIONS 4 // sessions for the estimate to come down from its initial deadline
+#define LOSSY_PER_MILLE 100 // segments lost on the lossy link
+#define LOSSY_SESSIONS 24
+#define RTT_FLOOR_MS 1250 // RTTEstimator's shortest deadline
+
+/* What a session measured, written by the wake */
+struct SessionResult {
+  bool sent;
+  uint64_t elapsedUs; // sendUpdateEmail() call to return
+  char status[64];
+  unsigned long timeoutBefore; // RTTEstimator deadline the wake started with (ms)
+  unsigned long timeoutAfter; // and ended with
+  unsigned long srtt; // smoothed round trip it ended with (ms)
+};
+
+/* Variables */
+static SessionResult* _result = SimShared::create<SessionResult>();
+
+/* Functions */
+
+// Function to write the message body
+static void writeBody(Print& out) {
+  out.print(F("<p>Soil moisture: 42 %</p>\r\n"));
+}
+
+// Wake that joins the network and sends one email
+static void sendOne() {
+  SimNetwork::join();
+
+  SMTP smtp(TEST_RECIPIENT);
+  uint64_t start = SimClock::now();
+  _result->sent = smtp.sendUpdateEmail(PSTR("Latency test"), writeBody);
+  _result->elapsedUs = SimClock::now() - start;
+  snprintf(_result->status, sizeof(_result->status), "%s", smtp.getStatusMessage());
+  _result->timeoutAfter = RTTEstimator::getTimeout();
+  _result->srtt = RTTEstimator::getSmoothedRTT();
+  ESP.deepSleep(0);
+}
+
+// Wake that sends one email starting from the round trip estimate in RTC memory, the way the sketch does
+static void sendPersisted() {
+  RTTEstimator::begin();
+  _result->timeoutBefore = RTTEstimator::getTimeout();
+  sendOne();
+}
+
+// Function to run one session from power up and print how long it took, returns the client's time (ms)
+static double runSession(SimSmtpServer& gmail, uint32_t rttMs, uint32_t queueMs) {
+  uint32_t messages = gmail.getStats().messages;
+
+  SimNetwork::link().rttMs = rttMs;
+  SimNetwork::forgetSessions(); // a full handshake every time, so sessions compare
+  gmail.options().endOfDataMs = queueMs;
+  SimNode::powerCycle(); // no cached address, session or RTT estimate
+
+  CHECK(SimNode::wake(sendOne).result == WAKE_SLEPT);
+  CHECK(_result->sent);
+  CHECK(gmail.getStats().messages == messages + 1);
+
+  const SimSmtpStats& stats = gmail.getStats();
+  double sessionMs = (stats.sessionCount > 0) ? stats.sessionUs[stats.sessionCount - 1] / US_PER_MS : 0;
+  double elapsedMs = _result->elapsedUs / US_PER_MS;
+  printf("rtt %5u ms, queueing %4u ms: client %8.1f ms, server session %8.1f ms (%4.1f round trips)  %s\n",
+         rttMs, queueMs, elapsedMs, sessionMs, (elapsedMs - SIM_TLS_FULL_CPU_MS - SimNetwork::link().dnsMs - queueMs) / rttMs, _result->status);
+  return elapsedMs;
+}
+
+// Function to run a session from the estimate left by the last one, prints and returns whether it delivered
+static bool runPersisted(const char* label) {
+  CHECK(SimNode::wake(sendPersisted).result == WAKE_SLEPT);
+  printf("%-8s %s in %7.1f ms, deadline %5lu -> %5lu ms, srtt %4lu ms  %s\n", label, _result->sent ? "sent  " : "failed",
+         _result->elapsedUs / US_PER_MS, _result->timeoutBefore, _result->timeoutAfter, _result->srtt, _result->status);
+  return _result->sent;
+}
+
+// A spike in the middle of a session fails it and backs the deadline off, the next session on a normal link
+// delivers and brings the deadline back down to what the link needs
+static void testLatencySpike(SimSmtpServer& gmail) {
+  uint32_t spike[SIM_LATENCY_SCRIPT_SIZE];
+
+  SimNetwork::link().rttMs = 60;
+  SimNetwork::link().lossPerMille = 0;
+  gmail.options().endOfDataMs = 0;
+  SimNode::powerCycle();
+
+  for (int s = 0; s < SETTLE_SESSIONS; s++) {
+    CHECK(runPersisted("settle"));
+  }
+  unsigned long settled = _result->timeoutAfter;
+  CHECK(settled == RTT_FLOOR_MS); // 60 ms round trips need no more than the floor
+
+  // Connect and handshake at the usual round trip, then every reply caught in the spike
+  for (size_t i = 0; i < SIM_LATENCY_SCRIPT_SIZE; i++) {
+    spike[i] = (i < 3) ? 60 : SPIKE_MS;
+  }
+  SimNetwork::scriptLatency(spike, 6);
+  CHECK(!runPersisted("spike"));
+  CHECK(_result->timeoutAfter == 2 * settled); // backed off once
+  SimNetwork::scriptLatency(NULL, 0);
+
+  CHECK(runPersisted("after"));
+  CHECK(_result->timeoutAfter == settled); // measured again, backoff cleared
+}
+
+// On a lossy link a lost segment costs a retransmission (SIM_RETRANSMIT_MS) on top of the round trip, which the
+// deadline's floor leaves room for: sessions are slower, but none has to be given up and started over
+static void testLossyLink() {
+  int delivered = 0;
+  uint32_t lost = SimNetwork::getStats().lostSegments;
+
+  SimNetwork::link().rttMs = 60;
+  SimNetwork::link().lossPerMille = LOSSY_PER_MILLE;
+  SimNode::powerCycle();
+
+  for (int s = 0; s < LOSSY_SESSIONS; s++) {
+    delivered += runPersisted("lossy") ? 1 : 0;
+  }
+  SimNetwork::link().lossPerMille = 0;
+  lost = SimNetwork::getStats().lostSegments - lost;
+
+  printf("%d/1000 lost: %d of %d sessions delivered through %u lost segments\n", LOSSY_PER_MILLE, delivered, LOSSY_SESSIONS, lost);
+  CHECK(lost > 0);
+  CHECK(delivered == LOSSY_SESSIONS);
+}
+
+int main() {
+  static const uint32_t RTT_MS[] = { 5, 30, 120, 400 };
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+
+  SimWorld::setUp(gmail, relay, listener);
+
+  for (size_t i = 0; i < sizeof(RTT_MS) / sizeof(RTT_MS[0]); i++) {
+    double elapsedMs = runSession(gmail, RTT_MS[i], 0);
+    double limitMs = SESSION_ROUND_TRIPS * RTT_MS[i] + SIM_TLS_FULL_CPU_MS + SimNetwork::link().dnsMs + SESSION_SLACK_MS;
+    CHECK(elapsedMs <= limitMs);
+  }
+
+  // A server that takes its time over the message is waited for, not given up on
+  double elapsedMs = runSession(gmail, 60, SLOW_QUEUE_MS);
+  CHECK(elapsedMs <= SESSION_ROUND_TRIPS * 60 + SIM_TLS_FULL_CPU_MS + SimNetwork::link().dnsMs + SLOW_QUEUE_MS + SESSION_SLACK_MS);
+
+  CHECK(gmail.getStats().sessionCount == gmail.getStats().sessions);
+
+  testLatencySpike(gmail);
+  testLossyLink();
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
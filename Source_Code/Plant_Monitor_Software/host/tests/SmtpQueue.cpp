@@ -0,0 +1,146 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// What the message queue keeps after a session: delivered messages leave it, messages every recipient refused
+// for good (5xx) are dropped and reported rather than sent again, and messages refused for now (4xx) or caught
+// in a failed session stay for the next attempt, which delivers them once the server takes them.
+
+// Include necessary header files
+#include "SMTP.h"
+#include "Check.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include "SimShared.h"
+#include "SimWorld.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Definitions */
+#define REFUSED_PATTERN "away"
+#define QUEUED_MESSAGES 2
+
+/* What a wake's sessions left behind */
+struct QueueResult {
+  bool sent; // what sendQueued() returned the first time
+  uint8_t queued; // messages still queued after it
+  bool permanent; // what isPermanentFailure() said after it
+  bool delivered[2]; // getRecipientStatus() of the two recipients
+  bool retrySent; // what a second sendQueued() returned, once the server takes every recipient
+  uint8_t retryQueued;
+  char status[SMTP_STATUS_MSG_SIZE];
+};
+
+/* Variables */
+static QueueResult* _result = SimShared::create<QueueResult>();
+static SimSmtpServer* _gmail; // reachable from the wake, its options live in shared memory
+static const char* _recipients[2]; // addresses the wake sends to (NULL = none)
+
+/* Functions */
+
+// Function to write the message body
+static void writeBody(Print& out) {
+  out.print(F("<p>Soil moisture: 42 %</p>\r\n"));
+}
+
+// Wake that queues two messages for the recipients, sends them, then lets the server take everyone and sends again
+static void sendTwice() {
+  SimNetwork::join();
+
+  SMTP smtp(_recipients[0]);
+  if (_recipients[1] != NULL) {
+    smtp.addRecipient(_recipients[1]);
+  }
+  smtp.queueMessage(PSTR("Queue test"), writeBody);
+  smtp.queueMessage(PSTR("Queue test, second"), writeBody);
+
+  _result->sent = smtp.sendQueued();
+  _result->queued = smtp.getQueuedCount();
+  _result->permanent = smtp.isPermanentFailure();
+  for (uint8_t i = 0; i < 2; i++) {
+    _result->delivered[i] = smtp.getRecipientStatus(i);
+  }
+  snprintf(_result->status, sizeof(_result->status), "%s", smtp.getStatusMessage());
+
+  _gmail->options().refusePattern[0] = '\0';
+  SimNetwork::link().serversUp = true;
+  _result->retrySent = smtp.sendQueued();
+  _result->retryQueued = smtp.getQueuedCount();
+  ESP.deepSleep(0);
+}
+
+// Function to run the wake against a server refusing REFUSED_PATTERN with refuseCode, returns messages the server queued
+static uint32_t runWake(const char* first, const char* second, uint16_t refuseCode, bool serversUp) {
+  uint32_t messages = _gmail->getStats().messages;
+
+  _recipients[0] = first;
+  _recipients[1] = second;
+  strcpy(_gmail->options().refusePattern, REFUSED_PATTERN);
+  _gmail->options().refuseCode = refuseCode;
+  SimNetwork::link().serversUp = serversUp;
+
+  CHECK(SimNode::wake(sendTwice).result == WAKE_SLEPT);
+  printf("%-22s %-20s refused %u, servers %-4s: %s, %u left, then %s with %u left  %s\n", first, (second != NULL) ? second : "",
+         refuseCode, serversUp ? "up" : "down", _result->sent ? "sent" : "not sent", _result->queued,
+         _result->retrySent ? "sent" : "not sent", _result->retryQueued, _result->status);
+  return _gmail->getStats().messages - messages;
+}
+
+// Refused for good by the only recipient: both messages dropped straight away, never sent again
+static void testPermanentRefusal() {
+  CHECK(runWake("away@example.com", NULL, 550, true) == 0);
+  CHECK(!_result->sent);
+  CHECK(_result->queued == 0);
+  CHECK(_result->permanent); // so the sketch neither retries nor keeps the readings
+  CHECK(!_result->delivered[0]);
+  CHECK(strstr(_result->status, "refused") != NULL);
+  CHECK(_result->retrySent && _result->retryQueued == 0); // nothing was left to send
+}
+
+// Refused for now: both kept and delivered by the next attempt
+static void testTransientRefusal() {
+  CHECK(runWake("away@example.com", NULL, 450, true) == QUEUED_MESSAGES);
+  CHECK(!_result->sent);
+  CHECK(_result->queued == QUEUED_MESSAGES);
+  CHECK(!_result->permanent);
+  CHECK(!_result->delivered[0]);
+  CHECK(strstr(_result->status, "for now") != NULL);
+  CHECK(_result->retrySent && _result->retryQueued == 0);
+}
+
+// Session failed (server unreachable): both kept and delivered by the next attempt
+static void testConnectionFailure() {
+  CHECK(runWake("grower@example.com", NULL, 550, false) == QUEUED_MESSAGES);
+  CHECK(!_result->sent);
+  CHECK(_result->queued == QUEUED_MESSAGES);
+  CHECK(!_result->permanent);
+  CHECK(strstr(_result->status, "connect") != NULL);
+  CHECK(_result->retrySent && _result->retryQueued == 0);
+}
+
+// One recipient refused for good, the other accepted: delivered, and the refused address is the one that says so
+static void testPartialRefusal() {
+  CHECK(runWake("grower@example.com", "away@example.com", 550, true) == QUEUED_MESSAGES);
+  CHECK(_result->sent);
+  CHECK(_result->queued == 0);
+  CHECK(_result->delivered[0] && !_result->delivered[1]);
+}
+
+int main() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+
+  SimWorld::setUp(gmail, relay, listener);
+  _gmail = &gmail;
+  SimNode::powerCycle();
+
+  testPermanentRefusal();
+  testTransientRefusal();
+  testConnectionFailure();
+  testPartialRefusal();
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
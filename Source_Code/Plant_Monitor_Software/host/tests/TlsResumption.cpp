@@ -0,0 +1,106 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Sends an email on each of a run of wakes and checks what the RTC cache saves: after the first wake the
+// server address is no longer looked up and the TLS session is resumed, until the server forgets its
+// sessions (the client must fall back to a full handshake and still deliver) or the battery comes out.
+
+// Include necessary header files
+#include "SMTP.h"
+#include "Check.h"
+#include "SimClock.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include "SimShared.h"
+#include "SimWorld.h"
+#include <stdio.h>
+
+/* Definitions */
+#define TEST_RECIPIENT "grower@example.com"
+#define RESUMED_WAKES 4
+#define US_PER_MS 1000.0
+
+/* What a wake's session did */
+enum Handshake {
+  HANDSHAKE_NONE,
+  HANDSHAKE_FULL,
+  HANDSHAKE_RESUMED
+};
+
+/* Variables */
+static uint64_t* _elapsedUs = SimShared::create<uint64_t>(); // sendUpdateEmail() call to return, written by the wake
+
+/* Functions */
+
+// Function to write the message body
+static void writeBody(Print& out) {
+  out.print(F("<p>Soil moisture: 42 %</p>\r\n"));
+}
+
+// Wake that joins the network and sends one email
+static void sendOne() {
+  SimNetwork::join();
+
+  SMTP smtp(TEST_RECIPIENT);
+  uint64_t start = SimClock::now();
+  smtp.sendUpdateEmail(PSTR("Resumption test"), writeBody);
+  *_elapsedUs = SimClock::now() - start;
+  ESP.deepSleep(60 * 1000000ULL);
+}
+
+// Function to run a wake that sends an email, returns the handshake its session used
+static Handshake sendWake(SimSmtpServer& gmail, const char* label) {
+  SimNetStats before = SimNetwork::getStats();
+  uint32_t messages = gmail.getStats().messages;
+
+  CHECK(SimNode::wake(sendOne).result == WAKE_SLEPT);
+  CHECK(gmail.getStats().messages == messages + 1);
+
+  const SimNetStats& after = SimNetwork::getStats();
+  Handshake handshake = HANDSHAKE_NONE;
+  if (after.resumedHandshakes != before.resumedHandshakes) {
+    handshake = HANDSHAKE_RESUMED;
+  }
+  else if (after.fullHandshakes != before.fullHandshakes) {
+    handshake = HANDSHAKE_FULL;
+  }
+
+  printf("%-22s %-8s handshake, %u DNS lookups, session %7.1f ms\n", label,
+         (handshake == HANDSHAKE_RESUMED) ? "resumed" : ((handshake == HANDSHAKE_FULL) ? "full" : "no"),
+         after.lookups - before.lookups, *_elapsedUs / US_PER_MS);
+  return handshake;
+}
+
+int main() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+
+  SimWorld::setUp(gmail, relay, listener);
+  SimNode::powerCycle();
+
+  CHECK(sendWake(gmail, "first wake") == HANDSHAKE_FULL);
+  CHECK(SimNetwork::getStats().lookups == 1);
+  double fullMs = *_elapsedUs / US_PER_MS;
+
+  for (int w = 0; w < RESUMED_WAKES; w++) {
+    CHECK(sendWake(gmail, "later wake") == HANDSHAKE_RESUMED);
+    CHECK(*_elapsedUs / US_PER_MS < fullMs - (SIM_TLS_FULL_CPU_MS - SIM_TLS_RESUME_CPU_MS));
+  }
+  CHECK(SimNetwork::getStats().lookups == 1); // address came from RTC memory every time
+
+  SimNetwork::forgetSessions(); // server restarted, the cached session is refused
+  CHECK(sendWake(gmail, "server restarted") == HANDSHAKE_FULL);
+  CHECK(sendWake(gmail, "next wake") == HANDSHAKE_RESUMED);
+
+  SimNode::powerCycle(); // battery out, RTC memory gone
+  CHECK(sendWake(gmail, "after power loss") == HANDSHAKE_FULL);
+  CHECK(SimNetwork::getStats().lookups == 2);
+  CHECK(sendWake(gmail, "next wake") == HANDSHAKE_RESUMED);
+
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,359 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// UDP telemetry against the listener stand-in: a record goes out as exactly one datagram that decodes back to
+// what was written and is acknowledged, nothing is sent when the listener can't be looked up in time, and the
+// sketch's own records (readings and the backlog from flash after an outage) arrive whole and inside one
+// datagram. Readings the listener never acknowledged are kept and go out again, and wakes without a backlog
+// never mount the flash.
+
+// Include necessary header files
+#include "UDPTelemetry.h"
+#include "CborWriter.h"
+#include "SampleBuffer.h"
+#include "SampleLog.h"
+#include "NodeConfig.h"
+#include "CborReader.h"
+#include "Check.h"
+#include "SimFlash.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include "SimShared.h"
+#include "SimWorld.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Definitions */
+#define CBOR_HEAD_MAX 5 // initial byte and a four byte argument
+#define CBOR_SMALL_HEAD 1 // counts and lengths up to 23 fit in the initial byte
+#define CBOR_FLOAT_SIZE 5
+#define TELEMETRY_HOST "192.168.1.10" // as the sketch has it
+#define TEXT_SIZE 40 // longest key or hostname read back, plus NUL
+#define SKETCH_WAKES_MAX 20 // wakes for the sketch to send a report
+#define OUTAGE_WAKES 60 // wakes with the access point down, enough to spill readings to flash several times
+#define RECOVERY_WAKES_MAX 40 // wakes for the backlog to be worked through once it is back
+#define UNACKED_REPORTS 2 // reports the listener takes in but doesn't acknowledge
+
+/* What a sketch record held */
+struct DecodedRecord {
+  uint32_t samples; // entries of "s" (and "a")
+  uint32_t backlog; // entries of "b"
+};
+
+/* Constants */
+static const uint32_t _TEST_AGES[] = { 600, 300, 0 };
+static const float _TEST_READINGS[] = { 1234.5f, 296.25f, 41.0f };
+
+/* Variables */
+static bool* _sent = SimShared::create<bool>(); // what sendReport() returned, written by the wake
+
+/* Functions */
+
+// Function to write a small record of known content
+static void writeTestRecord(Print& out) {
+  CborWriter record(out);
+
+  record.beginMap(3);
+  record.writeTextP(PSTR("id"));
+  record.writeText("bench-node");
+  record.writeTextP(PSTR("a"));
+  record.beginArray(sizeof(_TEST_AGES) / sizeof(_TEST_AGES[0]));
+  for (size_t i = 0; i < sizeof(_TEST_AGES) / sizeof(_TEST_AGES[0]); i++) {
+    record.writeUInt(_TEST_AGES[i]);
+  }
+  record.writeTextP(PSTR("s"));
+  record.beginArray();
+  for (size_t i = 0; i < sizeof(_TEST_READINGS) / sizeof(_TEST_READINGS[0]); i++) {
+    record.writeFloat(_TEST_READINGS[i]);
+  }
+  record.endArray();
+}
+
+// Wake that sends the test record to the listener
+static void sendDirect() {
+  UDPTelemetry telemetry(TELEMETRY_HOST, SIM_TELEMETRY_PORT);
+  ReportContent report = { PSTR("unused"), NULL, writeTestRecord };
+
+  SimNetwork::join();
+  *_sent = telemetry.sendReport(report);
+  ESP.deepSleep(60 * 1000000ULL);
+}
+
+// Wake that sends to a name nobody answers for
+static void sendUnknownHost() {
+  UDPTelemetry telemetry("collector.invalid", SIM_TELEMETRY_PORT);
+  ReportContent report = { PSTR("unused"), NULL, writeTestRecord };
+
+  SimNetwork::join();
+  *_sent = telemetry.sendReport(report);
+  ESP.deepSleep(60 * 1000000ULL);
+}
+
+// Wake that sends after its lookup deadline has already passed
+static void sendLate() {
+  UDPTelemetry telemetry(TELEMETRY_HOST, SIM_TELEMETRY_PORT);
+  ReportContent report = { PSTR("unused"), NULL, writeTestRecord };
+
+  SimNetwork::join();
+  telemetry.updateDeadline(millis(), millis());
+  delay(10);
+  *_sent = telemetry.sendReport(report);
+  ESP.deepSleep(60 * 1000000ULL);
+}
+
+void setup();
+
+// Function to decode one of the sketch's records, checking its layout and that it fills the datagram exactly
+static bool decodeSketchRecord(const uint8_t* data, size_t size, DecodedRecord& decoded) {
+  CborReader reader(data, size);
+  char key[TEXT_SIZE];
+  char hostname[TEXT_SIZE];
+  uint32_t entries, count, ages, value;
+  float reading;
+
+  if (!reader.readMap(entries) || entries != 6) {
+    return false;
+  }
+  bool f_Valid = reader.readText(key, sizeof(key)) && strcmp(key, "id") == 0 && reader.readText(hostname, sizeof(hostname))
+              && reader.readText(key, sizeof(key)) && strcmp(key, "t") == 0 && reader.readUInt(value)
+              && reader.readText(key, sizeof(key)) && strcmp(key, "al") == 0 && reader.readUInt(value)
+              && reader.readText(key, sizeof(key)) && strcmp(key, "a") == 0 && reader.readArray(ages);
+  for (uint32_t s = 0; f_Valid && s < ages; s++) {
+    f_Valid = reader.readUInt(value);
+  }
+
+  f_Valid = f_Valid && reader.readText(key, sizeof(key)) && strcmp(key, "s") == 0 && reader.readArray(decoded.samples)
+         && decoded.samples == ages;
+  for (uint32_t s = 0; f_Valid && s < decoded.samples; s++) {
+    f_Valid = reader.readArray(count) && count == (uint32_t)SAMPLE_SENSOR_COUNT;
+    for (uint32_t v = 0; f_Valid && v < count; v++) {
+      f_Valid = reader.readFloat(reading);
+    }
+  }
+
+  f_Valid = f_Valid && reader.readText(key, sizeof(key)) && strcmp(key, "b") == 0 && reader.readArray(count)
+         && count == CBOR_READER_INDEFINITE;
+  decoded.backlog = 0;
+  while (f_Valid && !reader.readBreak()) {
+    f_Valid = reader.readArray(count) && count == (uint32_t)(1 + SAMPLE_SENSOR_COUNT) && reader.readUInt(value);
+    for (uint32_t v = 1; f_Valid && v < count; v++) {
+      f_Valid = reader.readFloat(reading);
+    }
+    decoded.backlog++;
+  }
+
+  return f_Valid && reader.atEnd(); // nothing cut off, nothing after
+}
+
+// Function to get the longest record the sketch can write: the longest hostname, a full sample buffer, and a
+// segment of the backlog made of the smallest log records (one byte a varint) that doesn't close until it
+// reaches LOG_SEGMENT_BYTES, every number at its longest
+static size_t longestSketchRecord() {
+  static_assert(SAMPLE_BUFFER_CAPACITY <= 23 && SAMPLE_SENSOR_COUNT < 23, "arrays no longer have one byte heads");
+  size_t sample = CBOR_SMALL_HEAD + (SAMPLE_SENSOR_COUNT * CBOR_FLOAT_SIZE);
+  size_t backlogEntry = CBOR_SMALL_HEAD + CBOR_HEAD_MAX + (SAMPLE_SENSOR_COUNT * CBOR_FLOAT_SIZE);
+  size_t segmentRecords = (LOG_SEGMENT_BYTES + SAMPLE_SENSOR_COUNT) / (1 + SAMPLE_SENSOR_COUNT); // closes on reaching the limit
+  size_t keys = 3 + 2 + 3 + 2 + 2 + 2; // "id", "t", "al", "a", "s" and "b" with their heads
+
+  return CBOR_SMALL_HEAD + keys + 2 + (CONFIG_HOSTNAME_SIZE - 1) + (2 * CBOR_HEAD_MAX) // map, keys, hostname, "t" and "al"
+       + CBOR_SMALL_HEAD + (SAMPLE_BUFFER_CAPACITY * CBOR_HEAD_MAX) // "a"
+       + CBOR_SMALL_HEAD + (SAMPLE_BUFFER_CAPACITY * sample) // "s"
+       + 1 + (segmentRecords * backlogEntry) + 1; // "b" and its break
+}
+
+// A record written by UDPTelemetry arrives as one datagram holding exactly what was written
+static void testDirect(SimUdpListener& listener, SimSmtpServer& gmail) {
+  char text[TEXT_SIZE];
+  uint32_t count, value;
+  float reading;
+
+  listener.clear();
+  CHECK(SimNode::wake(sendDirect).result == WAKE_SLEPT);
+  CHECK(*_sent);
+
+  const SimUdpStats& stats = listener.getStats();
+  CHECK(stats.datagrams == 1);
+  CHECK(stats.acks == 1);
+  CborReader reader(stats.last, stats.lastSize);
+  CHECK(reader.readMap(count) && count == 3);
+  CHECK(reader.readText(text, sizeof(text)) && strcmp(text, "id") == 0);
+  CHECK(reader.readText(text, sizeof(text)) && strcmp(text, "bench-node") == 0);
+  CHECK(reader.readText(text, sizeof(text)) && strcmp(text, "a") == 0);
+  CHECK(reader.readArray(count) && count == sizeof(_TEST_AGES) / sizeof(_TEST_AGES[0]));
+  for (uint32_t i = 0; i < count; i++) {
+    CHECK(reader.readUInt(value) && value == _TEST_AGES[i]);
+  }
+  CHECK(reader.readText(text, sizeof(text)) && strcmp(text, "s") == 0);
+  CHECK(reader.readArray(count) && count == CBOR_READER_INDEFINITE);
+  for (size_t i = 0; i < sizeof(_TEST_READINGS) / sizeof(_TEST_READINGS[0]); i++) {
+    CHECK(reader.readFloat(reading) && reading == _TEST_READINGS[i]);
+  }
+  CHECK(reader.readBreak());
+  CHECK(reader.atEnd());
+
+  CborReader whole(stats.last, stats.lastSize);
+  CHECK(whole.skip() && whole.atEnd());
+  CHECK(gmail.getStats().sessions == 0); // telemetry never touches the mail server
+  printf("test record: %u bytes in one datagram\n", stats.lastSize);
+}
+
+// Nothing is sent if the listener's address can't be had within the deadline
+static void testLookupFailure(SimUdpListener& listener) {
+  listener.clear();
+
+  CHECK(SimNode::wake(sendUnknownHost).result == WAKE_SLEPT);
+  CHECK(!*_sent);
+  CHECK(SimNode::wake(sendLate).result == WAKE_SLEPT);
+  CHECK(!*_sent);
+  CHECK(listener.getStats().datagrams == 0);
+}
+
+// Function to run sketch wakes until a datagram arrives (or maxWakes), returns the wakes run
+static int wakeUntilDatagram(SimUdpListener& listener, int maxWakes) {
+  uint32_t datagrams = listener.getStats().datagrams;
+  int wakes = 0;
+
+  while (wakes < maxWakes && listener.getStats().datagrams == datagrams) {
+    CHECK(SimNode::wake(setup).result == WAKE_SLEPT);
+    wakes++;
+  }
+  return wakes;
+}
+
+// Without an ack the report counts as undelivered, even though the datagram arrived
+static void testNoAck(SimUdpListener& listener) {
+  listener.clear();
+  listener.setAcking(false);
+
+  CHECK(SimNode::wake(sendDirect).result == WAKE_SLEPT);
+  CHECK(!*_sent);
+  CHECK(listener.getStats().datagrams == 1);
+  CHECK(listener.getStats().acks == 0);
+  listener.setAcking(true);
+}
+
+// The sketch's reports arrive as complete records of the documented layout, and with no backlog only the first
+// wake after power up mounts the flash (to find out there is none)
+static void testSketch(SimUdpListener& listener, SimSmtpServer& gmail) {
+  DecodedRecord decoded;
+
+  listener.clear();
+  gmail.clear();
+  SimFlash::erase();
+  SimNode::powerCycle();
+  uint32_t mounts = 0;
+
+  for (int r = 0; r < 2; r++) {
+    SimWorld::setPlant(1.88, 1.41, (r == 0) ? 1.0 : 1.6); // soil dried out, so the second report isn't skipped
+    int wakes = wakeUntilDatagram(listener, SKETCH_WAKES_MAX);
+    const SimUdpStats& stats = listener.getStats();
+    CHECK(stats.datagrams == (uint32_t)(r + 1));
+    CHECK(decodeSketchRecord(stats.last, stats.lastSize, decoded));
+    CHECK(decoded.samples >= 1 && decoded.samples <= SAMPLE_BUFFER_CAPACITY);
+    CHECK(decoded.backlog == 0);
+    printf("sketch report after %d wakes: %u samples, %u bytes\n", wakes, decoded.samples, stats.lastSize);
+    if (r == 0) {
+      mounts = SimFlash::getStats().mounts; // the first wake after power up has to look (formatting the flash here)
+    }
+  }
+  CHECK(gmail.getStats().sessions == 0);
+  CHECK(SimFlash::getStats().mounts == mounts); // none of the wakes since the first report touched the flash
+  SimWorld::setPlant(1.88, 1.41, 1.0);
+}
+
+// Readings in reports the listener didn't acknowledge are kept in flash and delivered with a later report
+static void testUnacknowledged(SimUdpListener& listener) {
+  DecodedRecord decoded;
+  uint32_t backlog = 0;
+
+  listener.clear();
+  SimFlash::erase();
+  SimNode::powerCycle();
+
+  listener.setAcking(false);
+  for (int r = 0; r < UNACKED_REPORTS; r++) {
+    SimWorld::setPlant(1.88, 1.41, (r % 2 == 0) ? 1.6 : 1.0); // changed readings, so each report is due
+    CHECK(wakeUntilDatagram(listener, SKETCH_WAKES_MAX) < SKETCH_WAKES_MAX);
+  }
+  CHECK(listener.getStats().acks == 0);
+  listener.setAcking(true);
+
+  // What went unacknowledged comes back as backlog, until the log is empty
+  uint32_t datagrams = listener.getStats().datagrams;
+  do {
+    SimWorld::setPlant(1.88, 1.41, (listener.getStats().datagrams % 2 == 0) ? 1.6 : 1.0);
+    if (wakeUntilDatagram(listener, SKETCH_WAKES_MAX) == SKETCH_WAKES_MAX) {
+      break;
+    }
+    CHECK(decodeSketchRecord(listener.getStats().last, listener.getStats().lastSize, decoded));
+    backlog += decoded.backlog;
+  } while (decoded.backlog > 0 && listener.getStats().datagrams - datagrams < RECOVERY_WAKES_MAX);
+
+  printf("%d unacknowledged reports: %u readings delivered late\n", UNACKED_REPORTS, backlog);
+  CHECK(backlog >= UNACKED_REPORTS); // at least a reading from each
+  CHECK(decoded.backlog == 0);
+  CHECK(listener.getStats().acks == listener.getStats().datagrams - datagrams);
+  SimWorld::setPlant(1.88, 1.41, 1.0);
+}
+
+// After an outage the backlog comes back from flash a segment per report, each record whole and in one datagram
+static void testBacklog(SimUdpListener& listener) {
+  DecodedRecord decoded;
+  uint32_t backlog = 0;
+  uint32_t largest = 0;
+  int reports = 0;
+
+  listener.clear();
+  SimFlash::erase();
+  SimNode::powerCycle();
+
+  SimNetwork::link().apUp = false;
+  for (int w = 0; w < OUTAGE_WAKES; w++) {
+    CHECK(SimNode::wake(setup).result == WAKE_SLEPT);
+  }
+  CHECK(listener.getStats().datagrams == 0);
+  SimNetwork::link().apUp = true;
+
+  // Reports carry backlog until the log is empty, then carry none
+  do {
+    if (wakeUntilDatagram(listener, RECOVERY_WAKES_MAX) == RECOVERY_WAKES_MAX) {
+      break;
+    }
+    const SimUdpStats& stats = listener.getStats();
+    CHECK(stats.lastSize < SIM_UDP_DATAGRAM_SIZE); // filled to the limit would mean it was cut short
+    CHECK(decodeSketchRecord(stats.last, stats.lastSize, decoded));
+    backlog += decoded.backlog;
+    largest = max(largest, stats.lastSize);
+    reports++;
+  } while (decoded.backlog > 0 && reports < RECOVERY_WAKES_MAX);
+
+  printf("outage of %d wakes: %u backlog readings over %d reports, largest datagram %u bytes (longest possible %u)\n",
+         OUTAGE_WAKES, backlog, reports, largest, (unsigned)longestSketchRecord());
+  CHECK(longestSketchRecord() <= SIM_UDP_DATAGRAM_SIZE); // a segment per report always fits
+  CHECK(reports >= 2);
+  CHECK(backlog > 0);
+  CHECK(decoded.backlog == 0); // worked through
+}
+
+int main() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+
+  SimWorld::setUp(gmail, relay, listener);
+  SimWorld::setPlant(1.88, 1.41, 1.0);
+  SimNode::powerCycle();
+
+  testDirect(listener, gmail);
+  testLookupFailure(listener);
+  testNoAck(listener);
+  testSketch(listener, gmail);
+  testUnacknowledged(listener);
+  testBacklog(listener);
+
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,188 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Wake budget: the allowance shrinks with the battery and the phase deadlines follow it, a join that the WiFi
+// share cuts short ends without dropping the cached settings, and the sketch's awake time stays bounded by the
+// allowance however bad the network gets (replies and connects from 50 ms to a minute, servers unreachable, the
+// access point gone, most segments lost), on a full and on a nearly flat battery. Prints the worst case of each.
+
+// Include necessary header files
+#include "WakeBudget.h"
+#include "WakeClock.h"
+#include "ConnectionManager.h"
+#include "Profiler.h"
+#include "Check.h"
+#include "SimADC.h"
+#include "SimFlash.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include "SimShared.h"
+#include "SimWorld.h"
+#include <stdio.h>
+
+/* Definitions */
+#define FULL_V 4.15
+#define LOW_V 3.35
+#define TEST_SSID "PlantNet"
+#define TEST_PASS "secret"
+#define WIFI_CONNECT_TIMEOUT 15000 // as the sketch has it
+#define FAST_CONNECT_TIMEOUT 3000 // as ConnectionManager has it
+#define SLOW_ASSOC_MS 4000 // busy access point, slower than the fast path's window
+#define PROFILE_WAKES 3 // wakes run against each profile, the first from power up
+#define OVERRUN_SLACK_MS 250 // what a wake may do after its allowance: moving the readings to flash, going to sleep
+#define US_PER_MS 1000.0
+
+/* A network the node might find itself on */
+struct NetProfile {
+	const char* name;
+	uint32_t rttMs; // round trip to the servers
+	uint32_t endOfDataMs; // time the server takes to queue a message
+	uint16_t lossPerMille;
+	bool serversUp;
+	bool apUp;
+};
+
+/* Constants */
+static const NetProfile _PROFILES[] = {
+	{ "50 ms round trip", 50, 0, 0, true, true },
+	{ "2 s round trip", 2000, 0, 0, true, true },
+	{ "20 s round trip", 20000, 0, 0, true, true },
+	{ "60 s round trip", 60000, 0, 0, true, true },
+	{ "60 s to queue", 60, 60000, 0, true, true },
+	{ "half of all lost", 60, 0, 500, true, true },
+	{ "servers down", 60, 0, 0, false, true },
+	{ "access point gone", 60, 0, 0, true, false }
+};
+
+/* Variables */
+static unsigned long* _joinTimeout = SimShared::create<unsigned long>(); // what the budget left the join, from the wake
+
+// Sketch entry point
+void setup();
+
+/* Functions */
+
+// Function to get the allowance the sketch works out for a battery voltage
+static unsigned long allowanceFor(float volts) {
+  WakeBudget::begin(volts);
+  return WakeBudget::getAllowance();
+}
+
+// Allowance by battery voltage, and the phase deadlines inside it
+static void testAllowance() {
+  unsigned long full = allowanceFor(4.3);
+  unsigned long half = allowanceFor(3.7);
+  unsigned long flat = allowanceFor(3.0);
+
+  printf("allowance: %lu ms full, %lu ms at 3.7 V, %lu ms flat\n", full, half, flat);
+  CHECK(half < full && flat < half);
+  CHECK(flat == full / 4); // never less than a quarter
+  CHECK(allowanceFor(LOW_V) >= flat);
+
+  WakeBudget::begin(4.3);
+  unsigned long previous = millis();
+  for (int p = 0; p < BUDGET_PHASE_COUNT; p++) {
+    CHECK(WakeBudget::getDeadline((BudgetPhase)p) > previous);
+    previous = WakeBudget::getDeadline((BudgetPhase)p);
+  }
+  CHECK(previous == millis() + full);
+  CHECK(!WakeBudget::isSpent());
+}
+
+// Wake that joins with what the WiFi share leaves after slow sensors, the way the sketch's beginConnecting() does
+static void joinOnBudget() {
+  WakeClock::begin(); // as the sketch does, the cached lease is timed on it
+  WakeBudget::begin(3.0); // nearly flat, the share is close to FAST_CONNECT_TIMEOUT
+  delay(WakeBudget::timeLeft(BUDGET_SENSORS)); // sensors used up their whole share
+  *_joinTimeout = min((unsigned long)WIFI_CONNECT_TIMEOUT, WakeBudget::timeLeft(BUDGET_WIFI));
+  ConnectionManager::connect(TEST_SSID, TEST_PASS, "plant-node", *_joinTimeout);
+  WakeClock::deepSleep(0);
+}
+
+// Wake that joins with all the time it wants
+static void joinUnhurried() {
+  WakeClock::begin();
+  ConnectionManager::connect(TEST_SSID, TEST_PASS, "plant-node", WIFI_CONNECT_TIMEOUT);
+  WakeClock::deepSleep(0);
+}
+
+// A join ended by the WiFi share is not a sign of stale settings
+static void testDeadlineKeepsCache() {
+  SimLink& link = SimNetwork::link();
+  uint16_t assocMs = link.assocMs;
+
+  SimNode::powerCycle();
+  CHECK(SimNode::wake(joinUnhurried).result == WAKE_SLEPT); // full join caches the settings
+
+  link.assocMs = SLOW_ASSOC_MS;
+  uint32_t joins = SimNetwork::getStats().associations;
+  CHECK(SimNode::wake(joinOnBudget).result == WAKE_SLEPT);
+  printf("join cut short by the budget after %lu ms\n", *_joinTimeout);
+  CHECK(*_joinTimeout < FAST_CONNECT_TIMEOUT);
+  CHECK(SimNetwork::getStats().associations == joins);
+
+  link.assocMs = assocMs;
+  uint32_t fast = SimNetwork::getStats().fastAssociations;
+  CHECK(SimNode::wake(joinUnhurried).result == WAKE_SLEPT);
+  CHECK(SimNetwork::getStats().fastAssociations == fast + 1); // still cached
+}
+
+// Function to run the sketch against a network, returns the longest a wake stayed up past its startup (ms)
+static double worstAwake(const NetProfile& profile, SimSmtpServer& gmail, unsigned long allowance) {
+  SimLink& link = SimNetwork::link();
+  double worstMs = 0;
+
+  link.rttMs = profile.rttMs;
+  link.lossPerMille = profile.lossPerMille;
+  link.serversUp = profile.serversUp;
+  link.apUp = profile.apUp;
+  gmail.options().endOfDataMs = profile.endOfDataMs;
+
+  SimNode::powerCycle();
+  for (int w = 0; w < PROFILE_WAKES; w++) {
+    const SimWake& wake = SimNode::wake(setup);
+    CHECK(wake.result == WAKE_SLEPT);
+
+    double awakeMs = (wake.awakeUs - wake.energy.phaseUs[PHASE_STARTUP]) / US_PER_MS; // budget starts after startup
+    worstMs = (awakeMs > worstMs) ? awakeMs : worstMs;
+  }
+  CHECK(worstMs <= allowance + OVERRUN_SLACK_MS);
+  return worstMs;
+}
+
+// Awake time against the allowance over every network, on a full and a nearly flat battery
+static void testBounded() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+  const float volts[] = { FULL_V, LOW_V };
+
+  SimWorld::setUp(gmail, relay, listener);
+  SimWorld::setPlant();
+  SimFlash::erase();
+
+  for (float v : volts) {
+    unsigned long allowance = allowanceFor(v);
+    double worstMs = 0;
+
+    SimADC::setBattery(v);
+    printf("battery %.2f V, allowance %lu ms\n", v, allowance);
+    for (const NetProfile& profile : _PROFILES) {
+      double awakeMs = worstAwake(profile, gmail, allowance);
+      printf("    %-18s longest wake %8.1f ms\n", profile.name, awakeMs);
+      worstMs = (awakeMs > worstMs) ? awakeMs : worstMs;
+    }
+    printf("    worst case %.1f ms of the %lu ms allowed\n", worstMs, allowance);
+  }
+}
+
+int main() {
+  testAllowance();
+  testDeadlineKeepsCache();
+  testBounded();
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,83 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Association overlapped with the sensors on reporting wakes: the time from the end of startup to the start of
+// the report has to come close to the longer of the sensor phase and the join, not to their sum. Checked on the
+// power up wake, where a full join (scan, association, DHCP) hides the sensors, and on a later reporting wake,
+// where slow sensors hide a join on the cached settings.
+
+// Include necessary header files
+#include "Profiler.h"
+#include "Check.h"
+#include "SimADC.h"
+#include "SimFlash.h"
+#include "SimNetwork.h"
+#include "SimNode.h"
+#include "SimWorld.h"
+#include <stdio.h>
+
+/* Definitions */
+#define MOISTURE_CH 4 // as SimWorld wires it
+#define MOISTURE_OHMS 98400.0
+#define SLOW_MOISTURE_RISE_MS 120.0 // wet soil, the probe takes most of SENSOR_STABILIZE_DELAY to settle
+#define SLACK_MS 30 // awake time outside the phases (RTC memory, logging, LEDs)
+#define WAKES_MAX 40
+#define US_PER_MS 1000.0
+
+// Sketch entry point
+void setup();
+
+/* Functions */
+
+// Function to check one reporting wake, returns the time overlapping saved (ms)
+static double checkOverlap(const char* name, const SimWake& wake) {
+  const uint64_t* phaseUs = wake.energy.phaseUs;
+  double sensorsMs = phaseUs[PHASE_SENSORS] / US_PER_MS;
+  double wifiMs = phaseUs[PHASE_WIFI] / US_PER_MS;
+  double betweenMs = (wake.awakeUs - phaseUs[PHASE_STARTUP] - phaseUs[PHASE_REPORT]) / US_PER_MS;
+  double longerMs = (sensorsMs > wifiMs) ? sensorsMs : wifiMs;
+
+  printf("%-18s sensors %7.1f ms  join %7.1f ms  sum %7.1f ms  awake for both %7.1f ms  saved %7.1f ms\n",
+         name, sensorsMs, wifiMs, sensorsMs + wifiMs, betweenMs, (sensorsMs + wifiMs) - betweenMs);
+  CHECK(phaseUs[PHASE_REPORT] > 0);
+  CHECK(betweenMs >= longerMs);
+  CHECK(betweenMs <= longerMs + SLACK_MS);
+  return (sensorsMs + wifiMs) - betweenMs;
+}
+
+int main() {
+  SimSmtpServer gmail;
+  SimSmtpServer relay;
+  SimUdpListener listener;
+
+  SimWorld::setUp(gmail, relay, listener);
+  SimWorld::setPlant();
+  SimADC::setChannel(MOISTURE_CH, 1.0, MOISTURE_OHMS, SLOW_MOISTURE_RISE_MS);
+  SimFlash::erase();
+  SimNode::powerCycle();
+
+  // Power up: nothing cached, the full join takes longer than the sensors
+  uint32_t fast = SimNetwork::getStats().fastAssociations;
+  CHECK(SimNode::wake(setup).result == WAKE_SLEPT);
+  CHECK(listener.getStats().datagrams == 1);
+  CHECK(SimNetwork::getStats().fastAssociations == fast);
+  double savedFull = checkOverlap("full join", SimNode::lastWake());
+  CHECK(savedFull > SimNode::lastWake().energy.phaseUs[PHASE_SENSORS] / US_PER_MS - SLACK_MS);
+
+  // Next reporting wake: the cached settings join faster than the sensors settle
+  uint32_t datagrams = listener.getStats().datagrams;
+  for (int w = 0; w < WAKES_MAX && listener.getStats().datagrams == datagrams; w++) {
+    SimADC::setVolts(MOISTURE_CH, 1.0 + (0.05 * (w + 1))); // soil drying, so the readings are worth reporting
+    CHECK(SimNode::wake(setup).result == WAKE_SLEPT);
+  }
+  CHECK(listener.getStats().datagrams == datagrams + 1);
+  CHECK(SimNetwork::getStats().fastAssociations == fast + 1);
+  double savedCached = checkOverlap("cached join", SimNode::lastWake());
+  CHECK(savedCached > SimNode::lastWake().energy.phaseUs[PHASE_WIFI] / US_PER_MS - SLACK_MS);
+
+  return CHECK_RESULT();
+}
+
+// ©2017 Jeremy Maxey-Vesperman
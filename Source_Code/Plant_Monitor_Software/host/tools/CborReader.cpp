@@ -0,0 +1,235 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "CborReader.h"
+#include <string.h>
+
+/* Definitions */
+// Major types and additional information, as in CborWriter.cpp
+#define CBOR_UNSIGNED 0
+#define CBOR_NEGATIVE 1
+#define CBOR_BYTES 2
+#define CBOR_TEXT 3
+#define CBOR_ARRAY 4
+#define CBOR_MAP 5
+#define CBOR_TAG 6 // CborWriter never writes tags
+#define CBOR_SIMPLE 7
+
+#define CBOR_INLINE_MAX 23
+#define CBOR_ARG_1 24
+#define CBOR_ARG_2 25
+#define CBOR_ARG_4 26
+#define CBOR_ARG_8 27
+#define CBOR_INDEFINITE 31
+#define CBOR_BREAK 0xFF
+
+#define SKIP_DEPTH_MAX 16 // nesting skip() follows, the records are three deep
+
+/* Constructors */
+// Constructor that reads from the specified buffer
+CborReader::CborReader(const uint8_t* data, size_t size)
+  : _data(data), _size(size), _pos(0)
+{
+}
+
+/* Functions */
+
+// Function to read an item's type and argument, in whichever form it was written
+// The argument of an indefinite length item is CBOR_READER_INDEFINITE
+bool CborReader::readHead(uint8_t& majorType, uint8_t& info, uint64_t& argument) {
+  if (_pos >= _size) {
+    return false;
+  }
+
+  majorType = _data[_pos] >> 5;
+  info = _data[_pos] & 0x1F;
+  size_t length = 0;
+  if (info <= CBOR_INLINE_MAX) {
+    argument = info;
+  }
+  else if (info >= CBOR_ARG_1 && info <= CBOR_ARG_8) {
+    length = (size_t)1 << (info - CBOR_ARG_1);
+  }
+  else if (info == CBOR_INDEFINITE) {
+    argument = CBOR_READER_INDEFINITE;
+  }
+  else {
+    return false; // reserved
+  }
+
+  if (_pos + 1 + length > _size) {
+    return false;
+  }
+  if (length > 0) {
+    argument = 0;
+    for (size_t b = 1; b <= length; b++) { // big endian
+      argument = (argument << 8) | _data[_pos + b];
+    }
+  }
+  _pos += 1 + length;
+  return true;
+}
+
+// Function to read a head of the given type, leaving the position alone if the next item is another type
+bool CborReader::readHeadOf(uint8_t majorType, uint64_t& argument) {
+  size_t start = _pos;
+  uint8_t type, info;
+
+  if (!readHead(type, info, argument) || type != majorType) {
+    _pos = start;
+    return false;
+  }
+  return true;
+}
+
+// Function to read an unsigned integer
+bool CborReader::readUInt(uint32_t& value) {
+  size_t start = _pos;
+  uint64_t argument;
+
+  if (!readHeadOf(CBOR_UNSIGNED, argument) || argument > UINT32_MAX) {
+    _pos = start;
+    return false;
+  }
+  value = (uint32_t)argument;
+  return true;
+}
+
+// Function to read a signed integer, written as either major type
+bool CborReader::readInt(int32_t& value) {
+  size_t start = _pos;
+  uint64_t argument;
+
+  if (readHeadOf(CBOR_UNSIGNED, argument) && argument <= INT32_MAX) {
+    value = (int32_t)argument;
+    return true;
+  }
+  _pos = start;
+  if (readHeadOf(CBOR_NEGATIVE, argument) && argument <= INT32_MAX) {
+    value = -1 - (int32_t)argument;
+    return true;
+  }
+  _pos = start;
+  return false;
+}
+
+// Function to read a single precision float
+bool CborReader::readFloat(float& value) {
+  size_t start = _pos;
+  uint8_t type, info;
+  uint64_t argument;
+
+  if (!readHead(type, info, argument) || type != CBOR_SIMPLE || info != CBOR_ARG_4) {
+    _pos = start;
+    return false;
+  }
+  uint32_t bits = (uint32_t)argument;
+  memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+// Function to read a text string, NUL terminated, into a buffer of size bytes
+bool CborReader::readText(char* text, size_t size) {
+  size_t start = _pos;
+  uint64_t length;
+
+  if (!readHeadOf(CBOR_TEXT, length) || length == CBOR_READER_INDEFINITE || length >= size || _pos + length > _size) {
+    _pos = start;
+    return false;
+  }
+  memcpy(text, _data + _pos, length);
+  text[length] = '\0';
+  _pos += length;
+  return true;
+}
+
+// Function to read the start of an array, count is CBOR_READER_INDEFINITE if it runs until a break
+bool CborReader::readArray(uint32_t& count) {
+  uint64_t argument;
+
+  if (!readHeadOf(CBOR_ARRAY, argument)) {
+    return false;
+  }
+  count = (uint32_t)argument;
+  return true;
+}
+
+// Function to read the start of a map, count is in key/value pairs
+bool CborReader::readMap(uint32_t& count) {
+  uint64_t argument;
+
+  if (!readHeadOf(CBOR_MAP, argument)) {
+    return false;
+  }
+  count = (uint32_t)argument;
+  return true;
+}
+
+// Function to read the break that ends an indefinite array or map
+bool CborReader::readBreak() {
+  if (_pos >= _size || _data[_pos] != CBOR_BREAK) {
+    return false;
+  }
+  _pos++;
+  return true;
+}
+
+// Function to step over the next item, with everything nested in it
+bool CborReader::skip() {
+  uint64_t remaining[SKIP_DEPTH_MAX]; // items left in each open array or map (CBOR_READER_INDEFINITE until a break)
+  int depth = 0;
+  size_t start = _pos;
+
+  do {
+    if (depth > 0 && remaining[depth - 1] == CBOR_READER_INDEFINITE && readBreak()) {
+      depth--;
+    }
+    else {
+      uint8_t type, info;
+      uint64_t argument;
+      if (!readHead(type, info, argument) || type == CBOR_TAG) {
+        _pos = start;
+        return false;
+      }
+      if (depth > 0 && remaining[depth - 1] != CBOR_READER_INDEFINITE) {
+        remaining[depth - 1]--;
+      }
+
+      if (type == CBOR_BYTES || type == CBOR_TEXT) {
+        if (argument == CBOR_READER_INDEFINITE || _pos + argument > _size) {
+          _pos = start;
+          return false;
+        }
+        _pos += argument;
+      }
+      else if (type == CBOR_ARRAY || type == CBOR_MAP) {
+        if (depth == SKIP_DEPTH_MAX) {
+          _pos = start;
+          return false;
+        }
+        remaining[depth++] = (type == CBOR_MAP && argument != CBOR_READER_INDEFINITE) ? (argument * 2) : argument;
+      }
+    }
+
+    while (depth > 0 && remaining[depth - 1] == 0) { // finished containers close
+      depth--;
+    }
+  } while (depth > 0);
+
+  return true;
+}
+
+// Function to get how many bytes have been read
+size_t CborReader::getPosition() {
+  return _pos;
+}
+
+// Function to check whether every byte has been read
+bool CborReader::atEnd() {
+  return _pos == _size;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,49 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef CborReader_h
+#define CborReader_h
+
+// Include the necessary libraries
+#include <stddef.h>
+#include <stdint.h>
+
+/* Definitions */
+#define CBOR_READER_INDEFINITE UINT32_MAX // count given for an array or map left open, items run until a break
+
+/* CborReader class definition */
+// Reads back the CBOR items CborWriter writes (unsigned and negative integers, single precision floats, text,
+// arrays and maps of definite or indefinite length), checking every item against the end of the data.
+// Each read returns false and leaves the position alone when the next item is of another type or cut short.
+class CborReader {
+	public:
+		/* Constructors */
+		CborReader(const uint8_t* data, size_t size); // constructor that reads from the specified buffer
+
+		/* Public Functions and Methods */
+		bool readUInt(uint32_t& value); // function to read an unsigned integer
+		bool readInt(int32_t& value); // function to read a signed integer
+		bool readFloat(float& value); // function to read a single precision float
+		bool readText(char* text, size_t size); // function to read a text string, NUL terminated (false if it doesn't fit)
+		bool readArray(uint32_t& count); // function to read the start of an array (CBOR_READER_INDEFINITE if left open)
+		bool readMap(uint32_t& count); // function to read the start of a map, in key/value pairs
+		bool readBreak(); // function to read the break that ends an indefinite array or map
+		bool skip(); // function to step over the next item, with everything nested in it
+		size_t getPosition(); // function to get how many bytes have been read
+		bool atEnd(); // function to check whether every byte has been read
+	private:
+		/* Private Instance Variables */
+		const uint8_t* _data; // the encoded items
+		size_t _size; // their length
+		size_t _pos; // next byte to read
+
+		/* Private Functions and Methods */
+		bool readHead(uint8_t& majorType, uint8_t& info, uint64_t& argument); // function to read an item's type and argument
+		bool readHeadOf(uint8_t majorType, uint64_t& argument); // function to read a head of the given type, or nothing
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman
@@ -0,0 +1,95 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Prints the timing summary of emailed reports, one table per file (or standard input), so where the nodes' awake
+// time goes can be compared between nodes and bad WiFi spotted:
+//   decode_profile report1.eml report2.eml ...
+// Exits with 1 if any node got a warning, 2 if a file couldn't be read or holds no summary.
+
+// Include necessary header files
+#include "ProfileSummary.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+
+using std::max;
+
+/* Definitions */
+#define EXIT_WARNINGS 1
+#define EXIT_NO_SUMMARY 2 // outranks EXIT_WARNINGS
+#define READ_CHUNK 4096
+
+/* Functions */
+
+// Function to read a whole file into a NUL terminated buffer, NULL if it can't be read (caller frees)
+static char* readAll(FILE* in) {
+  size_t length = 0;
+  size_t capacity = READ_CHUNK;
+  char* text = static_cast<char*>(malloc(capacity + 1));
+
+  while (text != NULL) {
+    length += fread(text + length, 1, capacity - length, in);
+    if (length < capacity) {
+      break;
+    }
+    capacity *= 2;
+    char* grown = static_cast<char*>(realloc(text, capacity + 1));
+    if (grown == NULL) {
+      free(text);
+    }
+    text = grown;
+  }
+
+  if (text != NULL) {
+    text[length] = '\0';
+  }
+  return text;
+}
+
+// Function to decode and print one report, returns the exit status it calls for
+static int decodeReport(FILE* in, const char* name) {
+  char* message = readAll(in);
+  static DecodedProfile profile;
+  int status = EXIT_SUCCESS;
+
+  if (message == NULL || !ProfileSummary::decode(message, profile)) {
+    fprintf(stderr, "%s: no timing summary\n", name);
+    status = EXIT_NO_SUMMARY;
+  }
+  else if (ProfileSummary::print(stdout, profile) > 0) {
+    status = EXIT_WARNINGS;
+  }
+
+  free(message);
+  return status;
+}
+
+int main(int argc, char** argv) {
+  int status = EXIT_SUCCESS;
+
+  if (argc < 2) {
+    return decodeReport(stdin, "standard input");
+  }
+
+  for (int i = 1; i < argc; i++) {
+    FILE* in = fopen(argv[i], "rb");
+    if (in == NULL) {
+      perror(argv[i]);
+      status = EXIT_NO_SUMMARY;
+      continue;
+    }
+
+    if (i > 1) {
+      printf("\n");
+    }
+    int fileStatus = decodeReport(in, argv[i]);
+    status = max(status, fileStatus);
+    fclose(in);
+  }
+
+  return status;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
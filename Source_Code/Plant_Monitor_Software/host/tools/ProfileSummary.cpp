@@ -0,0 +1,178 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+// Include necessary header files
+#include "ProfileSummary.h"
+#include <string.h>
+
+/* Definitions */
+#define LINE_BREAK "<br>"
+#define TIMING_HEADING "Timing (ms):"
+#define NODE_HEADING_START "<h2><u>"
+#define NODE_HEADING_END "</u></h2>"
+#define PHASE_INDENT "&emsp;"
+#define PHASE_LINE_FORMAT "%15[^:]: n=%u min=%u mean=%u max=%u hist=%u/%u/%u/%u/%u/%u"
+#define PHASE_LINE_FIELDS 11
+#define LINE_BUFFER_SIZE 256 // longest line looked at, summary lines are well under
+#define HISTOGRAM_COLUMN_WIDTH 6
+
+// What the warnings look for
+#define AWAKE_PHASE "awake"
+#define WIFI_PHASE "wifi"
+#define REPLY_PHASE "reply"
+#define SLOW_BUCKET 3 // durations of 2 s and over
+#define WIFI_SLOW_MEAN_MS 3000 // association this slow on average points at a weak signal or a busy AP
+#define WIFI_SLOW_SHARE 0.25 // or this many associations taking 2 s or more...
+#define WIFI_SLOW_MIN_COUNT 4 // out of at least this many (the first join after power up scans every channel)
+#define REPLY_SLOW_MEAN_MS 1000 // server replies this slow on average point at the route or the server
+
+/* Constants */
+static const char* const _BUCKET_LABELS[PROFILE_SUMMARY_BUCKETS] = { "<10ms", "<100ms", "<500ms", "<2s", "<5s", ">=5s" };
+
+/* Functions */
+
+// Function to copy the next <br> separated line of a message, returns where the one after starts (NULL at the end)
+static const char* nextLine(const char* text, char* line, size_t size) {
+  const char* end = strstr(text, LINE_BREAK);
+  size_t length = (end != NULL) ? (size_t)(end - text) : strlen(text);
+  size_t copied = (length < size - 1) ? length : (size - 1);
+
+  memcpy(line, text, copied);
+  line[copied] = '\0';
+  return (end != NULL) ? (end + strlen(LINE_BREAK)) : NULL;
+}
+
+// Function to skip the white space and indentation in front of a line's text
+static const char* skipIndent(const char* line) {
+  for (;;) {
+    if (*line == ' ' || *line == '\t' || *line == '\r' || *line == '\n') {
+      line++;
+    }
+    else if (strncmp(line, PHASE_INDENT, strlen(PHASE_INDENT)) == 0) {
+      line += strlen(PHASE_INDENT);
+    }
+    else {
+      return line;
+    }
+  }
+}
+
+// Method to pick the node's hostname out of the report heading
+static void decodeNode(const char* message, DecodedProfile& profile) {
+  const char* start = strstr(message, NODE_HEADING_START);
+  const char* end = (start != NULL) ? strstr(start, NODE_HEADING_END) : NULL;
+
+  profile.node[0] = '\0';
+  if (end != NULL) {
+    start += strlen(NODE_HEADING_START);
+    size_t length = (size_t)(end - start);
+    if (length >= sizeof(profile.node)) {
+      length = sizeof(profile.node) - 1;
+    }
+    memcpy(profile.node, start, length);
+    profile.node[length] = '\0';
+  }
+}
+
+// Function to decode the timing summary of a report
+// Phase lines follow the heading until the first line that isn't one
+bool ProfileSummary::decode(const char* message, DecodedProfile& profile) {
+  char line[LINE_BUFFER_SIZE];
+  const char* text = strstr(message, TIMING_HEADING);
+
+  profile.phaseCount = 0;
+  decodeNode(message, profile);
+  if (text == NULL) {
+    return false;
+  }
+
+  text = nextLine(text, line, sizeof(line)); // the rest of the heading's line
+  while (text != NULL && profile.phaseCount < PROFILE_SUMMARY_MAX_PHASES) {
+    DecodedPhase& phase = profile.phases[profile.phaseCount];
+
+    text = nextLine(text, line, sizeof(line));
+    const char* fields = skipIndent(line);
+    if (sscanf(fields, PHASE_LINE_FORMAT, phase.name, &phase.count, &phase.minMs, &phase.meanMs, &phase.maxMs,
+               &phase.histogram[0], &phase.histogram[1], &phase.histogram[2], &phase.histogram[3],
+               &phase.histogram[4], &phase.histogram[5]) != PHASE_LINE_FIELDS) {
+      break; // end of the summary
+    }
+    profile.phaseCount++;
+  }
+
+  return true;
+}
+
+// Function to get a phase by name
+const DecodedPhase* ProfileSummary::find(const DecodedProfile& profile, const char* name) {
+  for (int p = 0; p < profile.phaseCount; p++) {
+    if (strcmp(profile.phases[p].name, name) == 0) {
+      return &profile.phases[p];
+    }
+  }
+  return NULL;
+}
+
+// Function to get the range of durations a histogram bucket counts
+const char* ProfileSummary::bucketLabel(int bucket) {
+  return _BUCKET_LABELS[bucket];
+}
+
+// Function to print the table and any warnings
+// A phase's share is the part of all the recorded awake time it took (count times mean of each), so a phase
+// that doesn't happen every wake (wifi, report) counts for as often as it happens
+int ProfileSummary::print(FILE* out, const DecodedProfile& profile) {
+  const DecodedPhase* awake = find(profile, AWAKE_PHASE);
+  const DecodedPhase* wifi = find(profile, WIFI_PHASE);
+  const DecodedPhase* reply = find(profile, REPLY_PHASE);
+  int warnings = 0;
+
+  fprintf(out, "node %s\n", (profile.node[0] != '\0') ? profile.node : "(unnamed)");
+  fprintf(out, "%-10s %7s %7s %7s %7s %6s ", "phase", "n", "min", "mean", "max", "share");
+  for (int b = 0; b < PROFILE_SUMMARY_BUCKETS; b++) {
+    fprintf(out, " %*s", HISTOGRAM_COLUMN_WIDTH, _BUCKET_LABELS[b]);
+  }
+  fprintf(out, "\n");
+
+  for (int p = 0; p < profile.phaseCount; p++) {
+    const DecodedPhase& phase = profile.phases[p];
+
+    fprintf(out, "%-10s %7u %7u %7u %7u ", phase.name, phase.count, phase.minMs, phase.meanMs, phase.maxMs);
+    if (awake != NULL && awake->meanMs > 0 && &phase != awake) {
+      fprintf(out, "%5.1f%%", (100.0 * phase.count * phase.meanMs) / ((double)awake->count * awake->meanMs));
+    }
+    else {
+      fprintf(out, "%6s", "");
+    }
+    for (int b = 0; b < PROFILE_SUMMARY_BUCKETS; b++) {
+      fprintf(out, " %*u", HISTOGRAM_COLUMN_WIDTH, phase.histogram[b]);
+    }
+    fprintf(out, "\n");
+  }
+
+  if (wifi != NULL && wifi->count > 0) {
+    uint32_t slow = 0;
+    for (int b = SLOW_BUCKET; b < PROFILE_SUMMARY_BUCKETS; b++) {
+      slow += wifi->histogram[b];
+    }
+    uint32_t counted = 0;
+    for (int b = 0; b < PROFILE_SUMMARY_BUCKETS; b++) {
+      counted += wifi->histogram[b];
+    }
+    if (wifi->meanMs >= WIFI_SLOW_MEAN_MS || (counted >= WIFI_SLOW_MIN_COUNT && slow >= WIFI_SLOW_SHARE * counted)) {
+      fprintf(out, "warning: slow WiFi, association takes %u ms on average and %u of %u took 2 s or more\n",
+              wifi->meanMs, slow, counted);
+      warnings++;
+    }
+  }
+  if (reply != NULL && reply->count > 0 && reply->meanMs >= REPLY_SLOW_MEAN_MS) {
+    fprintf(out, "warning: slow server, replies take %u ms on average\n", reply->meanMs);
+    warnings++;
+  }
+
+  return warnings;
+}
+
+// ©2017 Jeremy Maxey-Vesperman
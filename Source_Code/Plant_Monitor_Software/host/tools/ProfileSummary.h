@@ -0,0 +1,51 @@
+/*
+ *  Authored by Jeremy Maxey-Vesperman with consultation from Zachary Goldasich
+ *  Submitted 12/14/2017
+ */
+
+#ifndef ProfileSummary_h
+#define ProfileSummary_h
+
+// Include the necessary libraries
+#include <stdint.h>
+#include <stdio.h>
+
+/* Definitions */
+#define PROFILE_SUMMARY_BUCKETS 6 // histogram buckets in a summary line (PROFILE_HISTOGRAM_BUCKETS on the node)
+#define PROFILE_SUMMARY_MAX_PHASES 16 // phase lines kept from one summary
+#define PROFILE_SUMMARY_NAME_SIZE 16 // longest phase name kept, plus NUL
+#define PROFILE_SUMMARY_NODE_SIZE 40 // longest node name kept, plus NUL
+
+/* One phase line of a summary */
+struct DecodedPhase {
+	char name[PROFILE_SUMMARY_NAME_SIZE];
+	uint32_t count; // durations recorded
+	uint32_t minMs;
+	uint32_t meanMs;
+	uint32_t maxMs;
+	uint32_t histogram[PROFILE_SUMMARY_BUCKETS]; // durations by bucket, as labelled by ProfileSummary::bucketLabel()
+};
+
+/* Everything decoded from one report */
+struct DecodedProfile {
+	char node[PROFILE_SUMMARY_NODE_SIZE]; // hostname from the report heading ("" if there was none)
+	int phaseCount;
+	DecodedPhase phases[PROFILE_SUMMARY_MAX_PHASES];
+};
+
+/* ProfileSummary class definition */
+// Reads the timing summary (see Profiler::writeReport()) back out of an emailed report, and prints it as a table
+// with each phase's share of the awake time and warnings for what looks wrong (slow WiFi, a slow server).
+// Lines are split at <br>, so reports from nodes that didn't yet end them with CRLF decode too.
+class ProfileSummary {
+	public:
+		/* Public Functions and Methods */
+		static bool decode(const char* message, DecodedProfile& profile); // function to decode the summary in a report, returns false if it has none
+		static const DecodedPhase* find(const DecodedProfile& profile, const char* name); // function to get a phase by name (NULL if not recorded)
+		static const char* bucketLabel(int bucket); // function to get the range of durations a histogram bucket counts
+		static int print(FILE* out, const DecodedProfile& profile); // function to print the table and warnings, returns the number of warnings
+};
+
+#endif
+
+// ©2017 Jeremy Maxey-Vesperman